@@ -1,6 +1,38 @@
 #include "BasicShaderHeader.hlsli"
 
+// MMDのマテリアル(トゥーン、スフィアマップ、スペキュラー)
 float4 BasicPS(Output input) : SV_TARGET
 {
-    return float4(tex.Sample(smp, input.uv));
+    Material material = materials[materialIndex];
+
+    float3 N = normalize(input.normal);
+    float3 L = -lightDirection.xyz;
+    float3 V = normalize(-input.viewPos);
+    float NdotL = dot(N, L);
+
+    // 陰影はトゥーンで付けるので、ここでは明るさだけを決める
+    float4 color = float4(saturate(material.ambient + material.diffuse.rgb * lightColor.rgb), material.diffuse.a);
+    color *= tex.Sample(smp, input.uv);
+
+    // スフィアはビュー空間の法線のXYをUVにする。モードはマテリアル毎に一定なので分岐が揃う
+    if (material.sphereMode != 0)
+    {
+        float2 sphereUv = N.xy * float2(0.5, -0.5) + 0.5;
+        float3 sphere = sphereMaps.Sample(clampSmp, float3(sphereUv, material.sphereIndex)).rgb;
+        color.rgb = material.sphereMode == 1 ? color.rgb * sphere : color.rgb + sphere;
+    }
+
+    // アトラスのtoonIndex行の中央を引く。縦は行の中央なので隣の行は混ざらない
+    float toonWidth;
+    float toonHeight;
+    toonAtlas.GetDimensions(toonWidth, toonHeight);
+
+    float2 toonUv = float2(0.5 - NdotL * 0.5, (material.toonIndex + 0.5) / toonHeight);
+    color.rgb *= toonAtlas.Sample(clampSmp, toonUv).rgb;
+
+    float3 H = normalize(L + V);
+    float specular = pow(saturate(dot(N, H)), max(material.specularPower, 1.0));
+    color.rgb += material.specular * lightColor.rgb * specular;
+
+    return saturate(color);
 }
\ No newline at end of file
@@ -1,13 +1,56 @@
+#include "../Common/VertexDecode.hlsli"
+
 Texture2D<float4> tex : register(t0);
 SamplerState smp : register(s0);
 
+// マテリアルのテーブル(全マテリアルで共有)
+// トゥーンは1行が1本の階調、スフィアは1層が1枚
+Texture2D<float4> toonAtlas : register(t1);
+Texture2DArray<float4> sphereMaps : register(t2);
+
+// Material.hのMaterialConstantsと同じ並び
+struct Material
+{
+    float4 diffuse;
+    float3 specular;
+    float specularPower;
+    float3 ambient;
+    uint toonIndex;
+    uint sphereIndex;
+    uint sphereMode;    // 0:なし 1:乗算 2:加算
+    uint2 padding;
+};
+
+StructuredBuffer<Material> materials : register(t3);
+
+// トゥーンとスフィア用(クランプ)
+SamplerState clampSmp : register(s1);
+
 struct Output
 {
     float4 svpos : SV_POSITION;
+    float3 normal : NORMAL;         // ビュー空間
+    float3 viewPos : POSITION;      // ビュー空間
     float2 uv : TEXCOORD;
 };
 
+// フレーム毎(ルートCBV)
 cbuffer cbuff0 : register(b0)
 {
-    matrix mat;
+    matrix viewProj;
+    matrix view;
+    float4 lightDirection;  // ビュー空間、光の進む向き
+    float4 lightColor;
+};
+
+// ドロー毎(ルート定数)
+cbuffer cbuff1 : register(b1)
+{
+    matrix world;
+};
+
+// マテリアル番号(ルート定数)
+cbuffer cbuff2 : register(b2)
+{
+    uint materialIndex;
 };
\ No newline at end of file
@@ -1,9 +1,17 @@
 #include "BasicShaderHeader.hlsli"
 
-Output BasicVS( float4 pos : POSITION, float2 uv : TEXCOORD )
+// VertexFormat.hのCompactStaticVertex(法線はR16G16_SNORM、UVはR16G16_FLOAT)
+Output BasicVS( float4 pos : POSITION, float2 octNormal : NORMAL, float2 uv : TEXCOORD )
 {
+    float3 normal = DecodeOct(octNormal);
+
     Output output;
-    output.svpos = mul(mat, pos);
+    float4 worldPos = mul(world, pos);
+    output.svpos = mul(viewProj, worldPos);
+    output.viewPos = mul(view, worldPos).xyz;
+
+    // ワールド行列は均等スケールだけなので、逆転置を使わずにそのまま回す
+    output.normal = mul((float3x3)view, mul((float3x3)world, normal));
     output.uv = uv;
     return output;
 }
\ No newline at end of file
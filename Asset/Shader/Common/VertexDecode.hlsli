@@ -0,0 +1,12 @@
+// VertexFormat.hの圧縮頂点を戻す関数
+
+// 八面体エンコードされた法線を戻す(VertexFormat::DecodeOctと同じ計算)
+float3 DecodeOct(float2 e)
+{
+    float3 n = float3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+    {
+        n.xy = (1.0 - abs(n.yx)) * ((n.xy >= 0.0) ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
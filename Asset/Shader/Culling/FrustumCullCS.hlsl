@@ -0,0 +1,64 @@
+// IndirectCommand.hのIndirectObjectと一致させる
+struct ObjectData
+{
+    float3 center;
+    float radius;
+    uint indexCount;
+    uint startIndex;
+    int baseVertex;
+    uint objectId;
+};
+
+// IndirectCommand.hのIndirectCommand(ルート定数 + D3D12_DRAW_INDEXED_ARGUMENTS)
+struct IndirectCommand
+{
+    uint objectId;
+    uint indexCountPerInstance;
+    uint instanceCount;
+    uint startIndexLocation;
+    int baseVertexLocation;
+    uint startInstanceLocation;
+};
+
+// IndirectCommand.hのIndirectCullParams
+cbuffer CullParams : register(b0)
+{
+    float4 planes[6];
+    uint objectCount;
+};
+
+StructuredBuffer<ObjectData> objects : register(t0);
+RWStructuredBuffer<IndirectCommand> commands : register(u0);
+RWByteAddressBuffer commandCount : register(u1);
+
+[numthreads(64, 1, 1)]
+void FrustumCullCS(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= objectCount)
+    {
+        return;
+    }
+
+    ObjectData object = objects[id.x];
+
+    for (uint idx = 0; idx < 6; ++idx)
+    {
+        if (dot(planes[idx].xyz, object.center) + planes[idx].w < -object.radius)
+        {
+            return;
+        }
+    }
+
+    uint slot;
+    commandCount.InterlockedAdd(0, 1, slot);
+
+    IndirectCommand command;
+    command.objectId = object.objectId;
+    command.indexCountPerInstance = object.indexCount;
+    command.instanceCount = 1;
+    command.startIndexLocation = object.startIndex;
+    command.baseVertexLocation = object.baseVertex;
+    command.startInstanceLocation = 0;
+
+    commands[slot] = command;
+}
@@ -0,0 +1,25 @@
+#include "../Common/VertexDecode.hlsli"
+
+cbuffer cbuff0 : register(b0)
+{
+    matrix mat;
+};
+
+StructuredBuffer<float4x4> boneMatrices : register(t1);
+
+// VertexFormat.hのCompactSkinAttrib8/16に対応する入力
+struct SkinInput
+{
+    float4 pos : POSITION;
+    float2 octNormal : NORMAL;    // R16G16_SNORM
+    float2 uv : TEXCOORD;         // R16G16_FLOAT
+    uint4 boneIndex : BLENDINDICES;
+    float4 boneWeight : BLENDWEIGHT; // R8G8B8A8_UNORM
+};
+
+struct SkinOutput
+{
+    float4 svpos : SV_POSITION;
+    float2 uv : TEXCOORD;
+    float3 normal : NORMAL;
+};
@@ -0,0 +1,15 @@
+#include "SkinShaderHeader.hlsli"
+
+SkinOutput SkinVS(SkinInput input)
+{
+    float4x4 skin = boneMatrices[input.boneIndex.x] * input.boneWeight.x
+                  + boneMatrices[input.boneIndex.y] * input.boneWeight.y
+                  + boneMatrices[input.boneIndex.z] * input.boneWeight.z
+                  + boneMatrices[input.boneIndex.w] * input.boneWeight.w;
+
+    SkinOutput output;
+    output.svpos = mul(mat, mul(skin, float4(input.pos.xyz, 1.0)));
+    output.uv = input.uv;
+    output.normal = normalize(mul((float3x3)skin, DecodeOct(input.octNormal)));
+    return output;
+}
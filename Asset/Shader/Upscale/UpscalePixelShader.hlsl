@@ -0,0 +1,6 @@
+#include "UpscaleShaderHeader.hlsli"
+
+float4 UpscalePS(Output input) : SV_TARGET
+{
+    return sceneTex.Sample(smp, min(input.uv * uvScale, uvMax));
+}
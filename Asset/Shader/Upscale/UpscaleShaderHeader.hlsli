@@ -0,0 +1,15 @@
+Texture2D<float4> sceneTex : register(t0);
+SamplerState smp : register(s0);
+
+// ルート定数
+cbuffer UpscaleParam : register(b0)
+{
+    float2 uvScale; // 描画した範囲 / シーンターゲット全体
+    float2 uvMax;   // 範囲外のテクセルを拾わないための上限
+};
+
+struct Output
+{
+    float4 svpos : SV_POSITION;
+    float2 uv : TEXCOORD;
+};
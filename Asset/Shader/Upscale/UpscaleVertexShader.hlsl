@@ -0,0 +1,11 @@
+#include "UpscaleShaderHeader.hlsli"
+
+// 頂点バッファなしで画面全体を覆う三角形を作る
+Output UpscaleVS(uint vertexId : SV_VertexID)
+{
+    Output output;
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.svpos = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    output.uv = uv;
+    return output;
+}
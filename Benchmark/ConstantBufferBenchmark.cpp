@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "../Source/ConstantBuffer/ConstantBuffer.h"
+#include "../Source/Math/MathTypes.h"
+
+// Renderと同じブロック構成(Frame:ルートCBV、Draw:ワールド行列のルート定数)で
+// カメラが止まっている時と動いている時の1フレームあたりのアップロード量とFlushの時間を測る
+namespace
+{
+	// Render::FrameConstantsと同じ並び
+	struct FrameConstants
+	{
+		Float4x4 viewProj;
+		Float4x4 view;
+		Float4 lightDirection;
+		Float4 lightColor;
+	};
+
+	const int Frames = 1000000;
+
+	double ElapsedMs(std::chrono::steady_clock::time_point begin)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	void Run(const char* name, bool cameraMoves, bool modelMoves)
+	{
+		// アップロードヒープの代わりにCPUのメモリに書く
+		std::vector<std::unique_ptr<uint8_t[]>> buffers;
+
+		ConstantBufferSystem system;
+		system.Init(
+			[&buffers](uint32_t size, ConstantVersion& version)
+			{
+				buffers.emplace_back(new uint8_t[size]());
+				version.cpuAddress = buffers.back().get();
+				return true;
+			},
+			[](ConstantVersion&) {});
+
+		ConstantBlock* frameBlock = system.CreateBlock("Frame", ConstantFrequency::PerFrame, sizeof(FrameConstants), 1, ConstantBinding::RootCbv);
+		ConstantBlock* drawBlock = system.CreateBlock("Draw", ConstantFrequency::PerDraw, sizeof(Float4x4), 2);
+
+		FrameConstants frame = {};
+		frame.viewProj = Math::Identity();
+		frame.view = Math::Identity();
+		frame.lightColor = { 1.0F, 1.0F, 1.0F, 1.0F };
+		Float4x4 world = Math::Identity();
+
+		uint64_t uploaded = 0;
+		uint64_t rootConstants = 0;
+		uint64_t skipped = 0;
+
+		auto begin = std::chrono::steady_clock::now();
+		for (int i = 0; i < Frames; ++i)
+		{
+			if (cameraMoves)
+			{
+				frame.view.m[3][0] = static_cast<float>(i);
+				frame.viewProj.m[3][0] = static_cast<float>(i);
+			}
+			if (modelMoves)
+			{
+				world.m[3][1] = static_cast<float>(i);
+			}
+
+			frameBlock->Set(frame);
+			drawBlock->Set(world);
+			system.Flush();
+
+			uploaded += system.Stats().bytesUploaded;
+			rootConstants += system.Stats().rootConstantBytes;
+			skipped += system.Stats().blocksSkipped;
+		}
+		double ms = ElapsedMs(begin);
+
+		std::printf("%-14s uploaded %6.1f B/frame  root constants %5.1f B/frame  skipped %.2f blocks/frame  %.1f ns/frame\n",
+			name, static_cast<double>(uploaded) / Frames, static_cast<double>(rootConstants) / Frames,
+			static_cast<double>(skipped) / Frames, ms * 1.0e6 / Frames);
+	}
+}
+
+int main()
+{
+	std::printf("Frame %zu bytes (root CBV), Draw %zu bytes (root constants), %d frames\n", sizeof(FrameConstants), sizeof(Float4x4), Frames);
+	Run("static", false, false);
+	Run("model moves", false, true);
+	Run("camera moves", true, true);
+
+	return 0;
+}
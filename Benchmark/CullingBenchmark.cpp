@@ -0,0 +1,148 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../Source/Culling/Bvh.h"
+#include "../Source/Culling/SkinnedBounds.h"
+
+// ステージのBVHの構築とクエリ、総当たりとの比較、スキンメッシュの球の更新を測る
+namespace
+{
+	const size_t ObjectCount = 100000;
+	const int ViewCount = 64;
+
+	const size_t BoneCount = 200;
+	const size_t SkinVertexCount = 60000;
+	const int SkinIterations = 1000;
+
+	Float4x4 LookForwardLH(float yaw, float fovY, float nearZ, float farZ)
+	{
+		// 原点から水平方向yawを見るビュー×プロジェクション
+		float s = std::sin(yaw);
+		float c = std::cos(yaw);
+		Float4x4 view = Math::Identity();
+		view.m[0][0] = c;
+		view.m[0][2] = s;
+		view.m[2][0] = -s;
+		view.m[2][2] = c;
+
+		float yScale = 1.0F / std::tan(fovY * 0.5F);
+		float range = farZ / (farZ - nearZ);
+		Float4x4 proj = {};
+		proj.m[0][0] = yScale;
+		proj.m[1][1] = yScale;
+		proj.m[2][2] = range;
+		proj.m[2][3] = 1.0F;
+		proj.m[3][2] = -range * nearZ;
+
+		return Math::Multiply(view, proj);
+	}
+
+	double ElapsedMs(std::chrono::steady_clock::time_point begin)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+	}
+}
+
+int main()
+{
+	std::mt19937 random(2024);
+	std::uniform_real_distribution<float> position(-1000.0F, 1000.0F);
+	std::uniform_real_distribution<float> size(0.5F, 8.0F);
+
+	std::vector<Aabb> boxes(ObjectCount);
+	for (Aabb& box : boxes)
+	{
+		Float3 min = { position(random), position(random) * 0.05F, position(random) };
+		box.Expand(min);
+		box.Expand(Float3{ min.x + size(random), min.y + size(random), min.z + size(random) });
+	}
+
+	Bvh bvh;
+	auto buildBegin = std::chrono::steady_clock::now();
+	bvh.Build(boxes);
+	double buildMs = ElapsedMs(buildBegin);
+
+	std::vector<uint32_t> visible;
+	visible.reserve(ObjectCount);
+
+	double bvhMs = 0.0;
+	double bruteMs = 0.0;
+	size_t bvhVisible = 0;
+	size_t bruteVisible = 0;
+
+	for (int view = 0; view < ViewCount; ++view)
+	{
+		FrustumSimd frustum(Frustum::FromViewProjection(LookForwardLH(6.2831853F * view / ViewCount, 1.0F, 0.1F, 400.0F)));
+
+		visible.clear();
+		auto begin = std::chrono::steady_clock::now();
+		bvh.Query(frustum, visible);
+		bvhMs += ElapsedMs(begin);
+		bvhVisible += visible.size();
+
+		begin = std::chrono::steady_clock::now();
+		size_t count = 0;
+		for (const Aabb& box : boxes)
+		{
+			count += frustum.Classify(box) != FrustumSimd::Outside ? 1 : 0;
+		}
+		bruteMs += ElapsedMs(begin);
+		bruteVisible += count;
+	}
+
+	std::printf("objects=%zu nodes=%zu views=%d\n", ObjectCount, bvh.Nodes().size(), ViewCount);
+	std::printf("bvh build   %.3f ms\n", buildMs);
+	std::printf("bvh query   %.3f ms/view (visible %zu)\n", bvhMs / ViewCount, bvhVisible / ViewCount);
+	std::printf("brute force %.3f ms/view (visible %zu)\n", bruteMs / ViewCount, bruteVisible / ViewCount);
+
+	// スキンメッシュ: 頂点全部から球を作る場合と、ボーン位置と影響半径から作る場合
+	std::vector<Float3> bones(BoneCount);
+	for (Float3& bone : bones)
+	{
+		bone = { position(random) * 0.001F, position(random) * 0.002F, position(random) * 0.001F };
+	}
+
+	std::uniform_int_distribution<uint32_t> boneOf(0, BoneCount - 1);
+	std::uniform_real_distribution<float> jitter(-0.2F, 0.2F);
+
+	std::vector<Float3> vertices(SkinVertexCount);
+	std::vector<uint16_t> indices(SkinVertexCount * SkinnedBounds::InfluenceCount, 0);
+	std::vector<float> weights(SkinVertexCount * SkinnedBounds::InfluenceCount, 0.0F);
+	for (size_t vtx = 0; vtx < SkinVertexCount; ++vtx)
+	{
+		uint32_t bone = boneOf(random);
+		vertices[vtx] = { bones[bone].x + jitter(random), bones[bone].y + jitter(random), bones[bone].z + jitter(random) };
+		indices[vtx * SkinnedBounds::InfluenceCount] = static_cast<uint16_t>(bone);
+		weights[vtx * SkinnedBounds::InfluenceCount] = 1.0F;
+	}
+
+	SkinnedBounds skinned;
+	skinned.Init(bones, vertices.data(), indices.data(), weights.data(), SkinVertexCount);
+
+	double fromVerticesMs = 0.0;
+	double fromBonesMs = 0.0;
+	float radiusSum = 0.0F;
+
+	for (int i = 0; i < SkinIterations; ++i)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		BoundingSphere exact = BoundingSphere::FromPoints(vertices.data(), vertices.size(), 0.0F);
+		fromVerticesMs += ElapsedMs(begin);
+
+		begin = std::chrono::steady_clock::now();
+		BoundingSphere fromBones = skinned.Update(bones.data(), bones.size());
+		fromBonesMs += ElapsedMs(begin);
+
+		radiusSum += fromBones.radius - exact.radius;
+	}
+
+	std::printf("skinned bounds bones=%zu vertices=%zu\n", BoneCount, SkinVertexCount);
+	std::printf("  from vertices %.4f ms\n", fromVerticesMs / SkinIterations);
+	std::printf("  from bones    %.4f ms (radius +%.3f)\n", fromBonesMs / SkinIterations, radiusSum / SkinIterations);
+
+	return 0;
+}
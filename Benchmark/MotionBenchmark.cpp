@@ -0,0 +1,209 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../Source/Motion/BakedMotionReader.h"
+#include "../Source/Motion/MotionBaker.h"
+#include "../Source/Motion/MotionBinding.h"
+#include "../Source/Motion/MotionSampler.h"
+#include "../Source/Motion/Skeleton.h"
+#include "../Source/Motion/VmdMotion.h"
+
+// VMDをベイクした時の大きさと誤差、1フレーム分の姿勢を作る時間を、VMDを直接評価する場合と比べる
+// 引数にVMDを渡せばそれを使う。無ければ3分のダンス程度(81ボーン、20表情、5396フレーム)の合成データを使う
+namespace
+{
+	const uint32_t BoneCount = 81;
+	const uint32_t MorphCount = 20;
+	const uint32_t FrameCount = 5396;
+
+	// センターと足IK等、移動するボーンの数
+	const uint32_t MovingBoneCount = 5;
+
+	const int Repeat = 5;
+
+	void AppendBytes(std::vector<uint8_t>& out, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		out.insert(out.end(), bytes, bytes + size);
+	}
+
+	void AppendName(std::vector<uint8_t>& out, const std::string& name, size_t length)
+	{
+		for (size_t i = 0; i < length; ++i)
+		{
+			out.push_back(i < name.size() ? static_cast<uint8_t>(name[i]) : 0);
+		}
+	}
+
+	// キーの間隔と補間曲線が手付けのダンスに近くなるように作る
+	std::vector<uint8_t> MakeDanceVmd()
+	{
+		std::mt19937 random(20240607);
+		std::uniform_int_distribution<uint32_t> boneGap(2, 8);
+		std::uniform_int_distribution<uint32_t> morphGap(4, 30);
+		std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+		std::uniform_real_distribution<float> weight(0.0F, 1.0F);
+		std::uniform_int_distribution<int> curve(0, 127);
+
+		std::vector<uint8_t> boneKeys;
+		uint32_t boneKeyCount = 0;
+
+		for (uint32_t b = 0; b < BoneCount; ++b)
+		{
+			char name[16] = {};
+			snprintf(name, sizeof(name), "bone%02u", b);
+
+			// 軸は固定して角度を揺らす(関節の動きに近い)
+			float ax = unit(random);
+			float ay = unit(random);
+			float az = unit(random);
+			float axisLength = std::sqrt(ax * ax + ay * ay + az * az);
+
+			for (uint32_t frame = 0; frame < FrameCount; frame += boneGap(random))
+			{
+				float angle = 0.6F * unit(random);
+				float s = std::sin(angle * 0.5F) / axisLength;
+				float rotation[4] = { ax * s, ay * s, az * s, std::cos(angle * 0.5F) };
+
+				float position[3] = {};
+				if (b < MovingBoneCount)
+				{
+					position[0] = 3.0F * unit(random);
+					position[1] = 0.5F * unit(random);
+					position[2] = 3.0F * unit(random);
+				}
+
+				// 半分は既定の直線、残りは緩急を付ける
+				uint8_t interpolation[64] = {};
+				bool linear = unit(random) < 0.0F;
+				for (int channel = 0; channel < 4; ++channel)
+				{
+					interpolation[channel] = linear ? 20 : static_cast<uint8_t>(curve(random));
+					interpolation[channel + 4] = linear ? 20 : static_cast<uint8_t>(curve(random));
+					interpolation[channel + 8] = linear ? 107 : static_cast<uint8_t>(curve(random));
+					interpolation[channel + 12] = linear ? 107 : static_cast<uint8_t>(curve(random));
+				}
+
+				AppendName(boneKeys, name, VmdMotion::BoneNameLength);
+				AppendBytes(boneKeys, &frame, sizeof(frame));
+				AppendBytes(boneKeys, position, sizeof(position));
+				AppendBytes(boneKeys, rotation, sizeof(rotation));
+				AppendBytes(boneKeys, interpolation, sizeof(interpolation));
+				++boneKeyCount;
+			}
+		}
+
+		std::vector<uint8_t> morphKeys;
+		uint32_t morphKeyCount = 0;
+
+		for (uint32_t m = 0; m < MorphCount; ++m)
+		{
+			char name[16] = {};
+			snprintf(name, sizeof(name), "morph%02u", m);
+
+			for (uint32_t frame = 0; frame < FrameCount; frame += morphGap(random))
+			{
+				float value = weight(random);
+
+				AppendName(morphKeys, name, VmdMotion::BoneNameLength);
+				AppendBytes(morphKeys, &frame, sizeof(frame));
+				AppendBytes(morphKeys, &value, sizeof(value));
+				++morphKeyCount;
+			}
+		}
+
+		std::vector<uint8_t> vmd;
+		AppendName(vmd, "Vocaloid Motion Data 0002", 30);
+		AppendName(vmd, "benchmark", VmdMotion::ModelNameLength);
+		AppendBytes(vmd, &boneKeyCount, sizeof(boneKeyCount));
+		vmd.insert(vmd.end(), boneKeys.begin(), boneKeys.end());
+		AppendBytes(vmd, &morphKeyCount, sizeof(morphKeyCount));
+		vmd.insert(vmd.end(), morphKeys.begin(), morphKeys.end());
+
+		return vmd;
+	}
+
+	// 全フレームを順に再生した時の1フレームあたりの時間(us)。一番速かった回
+	template<typename SampleFrame>
+	double PlaybackUs(uint32_t frameCount, SampleFrame sampleFrame)
+	{
+		double best = 1.0e30;
+
+		for (int r = 0; r < Repeat; ++r)
+		{
+			auto begin = std::chrono::steady_clock::now();
+
+			for (uint32_t f = 0; f < frameCount; ++f)
+			{
+				sampleFrame(static_cast<float>(f));
+			}
+
+			double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+			best = std::min(best, us / frameCount);
+		}
+
+		return best;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	VmdMotion motion;
+
+	if (argc > 1)
+	{
+		if (!motion.Load(argv[1]))
+		{
+			printf("failed to load %s\n", argv[1]);
+			return 1;
+		}
+	}
+	else
+	{
+		std::vector<uint8_t> vmd = MakeDanceVmd();
+		motion.LoadFromMemory(vmd.data(), vmd.size());
+	}
+
+	Skeleton skeleton = Skeleton::FromMotion(motion);
+	MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+
+	printf("motion: %zu bones, %zu morphs, %u frames\n", skeleton.BoneCount(), skeleton.MorphCount(), motion.LastFrame() + 1);
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "MotionBenchmark.bmot";
+
+	MotionBakeReport report;
+	if (!MotionBaker::BakeToFile(motion, skeleton, binding, MotionBakeSettings(), path.string(), &report))
+	{
+		printf("bake failed\n");
+		return 1;
+	}
+
+	printf("bake: %s\n", report.Summary().c_str());
+
+	BakedMotionReader reader;
+	if (!reader.Open(path.string()))
+	{
+		printf("failed to open %s\n", path.string().c_str());
+		return 1;
+	}
+
+	Skeleton pose = skeleton;
+	const uint32_t frameCount = reader.FrameCount();
+
+	double vmdUs = PlaybackUs(frameCount, [&](float frame) { MotionSampler::Sample(motion, binding, frame, pose); });
+	double bakedUs = PlaybackUs(frameCount, [&](float frame) { reader.Sample(frame, pose); });
+
+	printf("playback: vmd %.2f us/frame, baked %.2f us/frame (%.1fx)\n", vmdUs, bakedUs, bakedUs > 0.0 ? vmdUs / bakedUs : 0.0);
+
+	reader.Close();
+	std::filesystem::remove(path);
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "../Source/Profiler/CpuProfiler.h"
+#include "../Source/Profiler/TraceExporter.h"
+
+// PROFILE_SCOPE 1回あたりのコスト(1スレッドと複数スレッド同時)と、書き出しにかかる時間を測る
+namespace
+{
+	const int ScopesPerThread = 2000000;
+	const int ThreadCount = 4;
+
+	volatile uint64_t gSink = 0;
+
+	// 計測なしのループと比べて差をスコープのコストとする
+	double LoopNs(bool profiled)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		for (int i = 0; i < ScopesPerThread; ++i)
+		{
+			if (profiled)
+			{
+				PROFILE_SCOPE("Bench");
+				gSink = gSink + 1;
+			}
+			else
+			{
+				gSink = gSink + 1;
+			}
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+	}
+}
+
+int main()
+{
+	// リングの登録を計測から外す
+	CpuProfiler::Instance().SetThreadName("Main");
+
+	double baseNs = LoopNs(false);
+	double profiledNs = LoopNs(true);
+	std::printf("single thread: %.1f ns/scope\n", (profiledNs - baseNs) / ScopesPerThread);
+
+	std::vector<double> perThread(ThreadCount, 0.0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < ThreadCount; ++t)
+	{
+		threads.emplace_back([t, &perThread]()
+		{
+			CpuProfiler::Instance().SetThreadName("Worker");
+			double base = LoopNs(false);
+			perThread[t] = (LoopNs(true) - base) / ScopesPerThread;
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	double worst = 0.0;
+	for (double ns : perThread)
+	{
+		worst = ns > worst ? ns : worst;
+	}
+	std::printf("%d threads: worst %.1f ns/scope\n", ThreadCount, worst);
+
+	auto begin = std::chrono::steady_clock::now();
+	std::vector<ProfileEvent> events;
+	CpuProfiler::Instance().Collect(events);
+	auto collected = std::chrono::steady_clock::now();
+	std::string json = TraceExporter::ToChromeTrace(events, CpuProfiler::Instance().ThreadNames(), {});
+	auto exported = std::chrono::steady_clock::now();
+
+	std::printf("collect %zu events: %.3f ms\n", events.size(), std::chrono::duration<double, std::milli>(collected - begin).count());
+	std::printf("export %zu bytes: %.3f ms\n", json.size(), std::chrono::duration<double, std::milli>(exported - collected).count());
+
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Source/FramePacket/SpscQueue.h"
+#include "../Source/Profiler/CpuProfiler.h"
+
+// ゲームスレッドからレンダースレッドへの受け渡しの遅延(作ってから取り出されるまで)を、
+// SpscQueueと、ミューテックスと条件変数のキューで比べる
+namespace
+{
+	const int PacketCount = 200000;
+
+	// FramePacketと同じくらいの大きさ
+	struct Packet
+	{
+		int64_t createdNs;
+		uint64_t frameIndex;
+		float world[16];
+	};
+
+	class LockedQueue
+	{
+	public:
+
+		void Push(const Packet& packet)
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mNotFull.wait(lock, [this]() { return mPackets.size() < 2; });
+			mPackets.push_back(packet);
+			mNotEmpty.notify_one();
+		}
+
+		Packet Pop()
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mNotEmpty.wait(lock, [this]() { return !mPackets.empty(); });
+			Packet packet = mPackets.front();
+			mPackets.pop_front();
+			mNotFull.notify_one();
+			return packet;
+		}
+
+	private:
+
+		std::mutex mMutex;
+		std::condition_variable mNotEmpty;
+		std::condition_variable mNotFull;
+		std::deque<Packet> mPackets;
+	};
+
+	void Report(const char* name, std::vector<int64_t>& latencies, double totalMs)
+	{
+		std::sort(latencies.begin(), latencies.end());
+		auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+
+		std::printf("%-8s p50=%lld ns p99=%lld ns max=%lld ns, %.1f ns/packet\n", name,
+			static_cast<long long>(percentile(0.5)), static_cast<long long>(percentile(0.99)),
+			static_cast<long long>(latencies.back()), totalMs * 1.0e6 / PacketCount);
+	}
+}
+
+int main()
+{
+	{
+		SpscQueue<Packet, 2> queue;
+		std::vector<int64_t> latencies;
+		latencies.reserve(PacketCount);
+
+		auto begin = std::chrono::steady_clock::now();
+
+		std::thread consumer([&]()
+		{
+			Packet packet;
+			for (int i = 0; i < PacketCount;)
+			{
+				if (queue.TryPop(packet))
+				{
+					latencies.push_back(CpuProfiler::NowNs() - packet.createdNs);
+					++i;
+				}
+				else
+				{
+					// コアが少ない環境でも相手に時間を譲る
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		for (int i = 0; i < PacketCount; ++i)
+		{
+			Packet packet = {};
+			packet.frameIndex = i;
+			packet.createdNs = CpuProfiler::NowNs();
+			while (!queue.TryPush(packet))
+			{
+				std::this_thread::yield();
+				packet.createdNs = CpuProfiler::NowNs();
+			}
+		}
+
+		consumer.join();
+		Report("spsc", latencies, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+	}
+
+	{
+		LockedQueue queue;
+		std::vector<int64_t> latencies;
+		latencies.reserve(PacketCount);
+
+		auto begin = std::chrono::steady_clock::now();
+
+		std::thread consumer([&]()
+		{
+			for (int i = 0; i < PacketCount; ++i)
+			{
+				Packet packet = queue.Pop();
+				latencies.push_back(CpuProfiler::NowNs() - packet.createdNs);
+			}
+		});
+
+		for (int i = 0; i < PacketCount; ++i)
+		{
+			Packet packet = {};
+			packet.frameIndex = i;
+			packet.createdNs = CpuProfiler::NowNs();
+			queue.Push(packet);
+		}
+
+		consumer.join();
+		Report("mutex", latencies, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+	}
+
+	return 0;
+}
@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "../Source/GpuMemory/TlsfAllocator.h"
+
+// GPUメモリのページ(64MB)上でテクスチャやバッファの確保と解放を繰り返し、
+// TLSFと素朴なファーストフィットの1操作あたりの時間と断片化率を比べる
+namespace
+{
+	const uint64_t Capacity = 64ULL << 20;
+	const uint64_t Granularity = 256;
+	const int Operations = 2000000;
+
+	// 空き範囲をオフセット順のmapで持ち、先頭から順に探すだけのもの
+	class FirstFitAllocator
+	{
+	public:
+
+		explicit FirstFitAllocator(uint64_t capacity) { mFree[0] = capacity; }
+
+		bool Allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+		{
+			size = (size + Granularity - 1) & ~(Granularity - 1);
+
+			for (auto it = mFree.begin(); it != mFree.end(); ++it)
+			{
+				uint64_t aligned = (it->first + alignment - 1) & ~(alignment - 1);
+				if (aligned + size > it->first + it->second)
+				{
+					continue;
+				}
+
+				uint64_t begin = it->first;
+				uint64_t end = it->first + it->second;
+				mFree.erase(it);
+				if (aligned > begin)
+				{
+					mFree[begin] = aligned - begin;
+				}
+				if (aligned + size < end)
+				{
+					mFree[aligned + size] = end - (aligned + size);
+				}
+				offset = aligned;
+				return true;
+			}
+			return false;
+		}
+
+		void Free(uint64_t offset, uint64_t size)
+		{
+			size = (size + Granularity - 1) & ~(Granularity - 1);
+
+			auto it = mFree.emplace(offset, size).first;
+
+			auto next = std::next(it);
+			if (next != mFree.end() && it->first + it->second == next->first)
+			{
+				it->second += next->second;
+				mFree.erase(next);
+			}
+			if (it != mFree.begin())
+			{
+				auto prev = std::prev(it);
+				if (prev->first + prev->second == it->first)
+				{
+					prev->second += it->second;
+					mFree.erase(it);
+				}
+			}
+		}
+
+		double Fragmentation() const
+		{
+			uint64_t total = 0;
+			uint64_t largest = 0;
+			for (const auto& range : mFree)
+			{
+				total += range.second;
+				largest = range.second > largest ? range.second : largest;
+			}
+			return total == 0 ? 0.0 : 1.0 - static_cast<double>(largest) / static_cast<double>(total);
+		}
+
+	private:
+
+		std::map<uint64_t, uint64_t> mFree;
+	};
+
+	struct Request
+	{
+		bool free;
+		uint64_t size;
+		uint64_t alignment;
+		uint32_t victim;
+	};
+
+	// 小さいバッファが大半で、時々大きなテクスチャ(64KB境界)が混ざる
+	std::vector<Request> MakeRequests()
+	{
+		std::mt19937 random(99);
+		std::uniform_int_distribution<uint64_t> smallSize(256, 64 * 1024);
+		std::uniform_int_distribution<uint64_t> largeSize(256 * 1024, 4 * 1024 * 1024);
+
+		std::vector<Request> requests(Operations);
+		for (Request& request : requests)
+		{
+			request.free = random() % 2 == 0;
+			bool large = random() % 16 == 0;
+			request.size = large ? largeSize(random) : smallSize(random);
+			request.alignment = large ? 64 * 1024 : 256;
+			request.victim = static_cast<uint32_t>(random());
+		}
+		return requests;
+	}
+
+	double ElapsedNs(std::chrono::steady_clock::time_point begin)
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+	}
+}
+
+int main()
+{
+	std::vector<Request> requests = MakeRequests();
+
+	uint32_t tlsfFailures = 0;
+	double tlsfFragmentation = 0.0;
+	double tlsfNs = 0.0;
+	{
+		TlsfAllocator tlsf;
+		tlsf.Init(Capacity, Granularity);
+		std::vector<TlsfAllocator::Allocation> live;
+		live.reserve(Operations);
+
+		auto begin = std::chrono::steady_clock::now();
+		for (const Request& request : requests)
+		{
+			if (request.free && !live.empty())
+			{
+				size_t index = request.victim % live.size();
+				tlsf.Free(live[index]);
+				live[index] = live.back();
+				live.pop_back();
+				continue;
+			}
+
+			TlsfAllocator::Allocation allocation;
+			if (tlsf.Allocate(request.size, request.alignment, allocation))
+			{
+				live.push_back(allocation);
+			}
+			else
+			{
+				++tlsfFailures;
+			}
+		}
+		tlsfNs = ElapsedNs(begin) / Operations;
+
+		TlsfAllocator::Stats stats = tlsf.GetStats();
+		tlsfFragmentation = stats.Fragmentation();
+		std::printf("tlsf:      %.1f ns/op, failures=%u, used=%.1f MB, free blocks=%u, fragmentation=%.3f\n",
+			tlsfNs, tlsfFailures, stats.usedBytes / (1024.0 * 1024.0), stats.freeBlockCount, tlsfFragmentation);
+	}
+
+	{
+		FirstFitAllocator firstFit(Capacity);
+		struct Live { uint64_t offset; uint64_t size; };
+		std::vector<Live> live;
+		live.reserve(Operations);
+		uint32_t failures = 0;
+		uint64_t used = 0;
+
+		auto begin = std::chrono::steady_clock::now();
+		for (const Request& request : requests)
+		{
+			if (request.free && !live.empty())
+			{
+				size_t index = request.victim % live.size();
+				firstFit.Free(live[index].offset, live[index].size);
+				used -= live[index].size;
+				live[index] = live.back();
+				live.pop_back();
+				continue;
+			}
+
+			uint64_t offset = 0;
+			if (firstFit.Allocate(request.size, request.alignment, offset))
+			{
+				uint64_t size = (request.size + Granularity - 1) & ~(Granularity - 1);
+				live.push_back({ offset, size });
+				used += size;
+			}
+			else
+			{
+				++failures;
+			}
+		}
+		double ns = ElapsedNs(begin) / Operations;
+
+		std::printf("first fit: %.1f ns/op, failures=%u, used=%.1f MB, fragmentation=%.3f\n",
+			ns, failures, used / (1024.0 * 1024.0), firstFit.Fragmentation());
+	}
+
+	return 0;
+}
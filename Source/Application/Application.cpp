@@ -4,39 +4,209 @@
 
 #include <wrl/client.h>
 
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
 #include "../Render/Render.h"
 #include "../Dx12Wrapper/Dx12Wrapper.h"
+#include "../Motion/MotionBaker.h"
+#include "../Motion/MotionBinding.h"
+#include "../Motion/Skeleton.h"
+#include "../Motion/VmdMotion.h"
+#include "../Profiler/CpuProfiler.h"
+#include "../Profiler/TraceExporter.h"
+#include "../Startup/StartupGraph.h"
 
 LRESULT WindowProcedure(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 {
+	// 描画スレッドがまだPresentしているかもしれないので、ここではウィンドウを壊さない
+	// 描画スレッドを止めてからTerminateで破棄する
+	if (msg == WM_CLOSE)
+	{
+		PostQuitMessage(0);
+		return 0;
+	}
+
 	if (msg == WM_DESTROY)
 	{
 		PostQuitMessage(0);
 		return 0;
 	}
 
+	// 最小化中は0x0になるので無視する
+	if (msg == WM_SIZE && wparam != SIZE_MINIMIZED && LOWORD(lparam) > 0 && HIWORD(lparam) > 0)
+	{
+		Application::Instance().OnResize(LOWORD(lparam), HIWORD(lparam));
+		return 0;
+	}
+
 	return DefWindowProc(hwnd, msg, wparam, lparam);
 }
 
-int main()
+namespace
+{
+	struct MotionArgs
+	{
+		// --bake <vmd> <out>
+		std::string bakeSource;
+		std::string bakeOutput;
+
+		// --motion <vmd> <baked>
+		std::string motion;
+		std::string bakedMotion;
+	};
+
+	// --offline <path> [--frames N] [--fps F] [--size WxH] [--raw]
+	// --bake <vmd> <out> | --motion <vmd> <baked>
+	// --offlineが無ければfalse
+	bool ParseOfflineArgs(int argc, char** argv, OfflineRenderSettings& settings, SIZE& size, MotionArgs& motion)
+	{
+		bool offline = false;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			const char* arg = argv[i];
+			const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+			const char* second = i + 2 < argc ? argv[i + 2] : nullptr;
+
+			if (strcmp(arg, "--raw") == 0)
+			{
+				settings.format = VideoFormat::Raw;
+				continue;
+			}
+
+			if (value == nullptr)
+			{
+				continue;
+			}
+
+			if (strcmp(arg, "--offline") == 0)
+			{
+				settings.path = value;
+				offline = true;
+				++i;
+			}
+			else if (strcmp(arg, "--bake") == 0 && second != nullptr)
+			{
+				motion.bakeSource = value;
+				motion.bakeOutput = second;
+				i += 2;
+			}
+			else if (strcmp(arg, "--motion") == 0 && second != nullptr)
+			{
+				motion.motion = value;
+				motion.bakedMotion = second;
+				i += 2;
+			}
+			else if (strcmp(arg, "--frames") == 0)
+			{
+				settings.frameCount = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+				++i;
+			}
+			else if (strcmp(arg, "--fps") == 0)
+			{
+				settings.framesPerSecond = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+				++i;
+			}
+			else if (strcmp(arg, "--size") == 0)
+			{
+				long width = 0;
+				long height = 0;
+				if (sscanf_s(value, "%ldx%ld", &width, &height) == 2 && width > 0 && height > 0)
+				{
+					size.cx = width;
+					size.cy = height;
+				}
+				++i;
+			}
+		}
+
+		if (settings.framesPerSecond == 0)
+		{
+			settings.framesPerSecond = 30;
+		}
+
+		return offline;
+	}
+
+	// ウィンドウもデバイスも作らずにベイクだけして終わる
+	// モデルの読み込みがまだ無いので、VMDのトラックから作ったスケルトンでベイクする
+	bool BakeMotion(const std::string& vmdPath, const std::string& outPath)
+	{
+		VmdMotion motion;
+		if (!motion.Load(vmdPath))
+		{
+			printf("bake: failed to load %s\n", vmdPath.c_str());
+			return false;
+		}
+
+		Skeleton skeleton = Skeleton::FromMotion(motion);
+		MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+
+		MotionBakeReport report;
+		if (!MotionBaker::BakeToFile(motion, skeleton, binding, MotionBakeSettings(), outPath, &report))
+		{
+			printf("bake: failed to write %s\n", outPath.c_str());
+			return false;
+		}
+
+		printf("bake: %s -> %s %s\n", vmdPath.c_str(), outPath.c_str(), report.Summary().c_str());
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
 {
 	auto& app = Application::Instance();
+
+	OfflineRenderSettings offlineSettings;
+	SIZE offlineSize = app.GetWindowSize();
+	MotionArgs motionArgs;
+
+	bool offline = ParseOfflineArgs(argc, argv, offlineSettings, offlineSize, motionArgs);
+
+	if (!motionArgs.bakeSource.empty())
+	{
+		return BakeMotion(motionArgs.bakeSource, motionArgs.bakeOutput) ? 0 : -1;
+	}
+
+	if (offline)
+	{
+		app.EnableOfflineRender(offlineSettings, offlineSize);
+	}
+
+	if (!motionArgs.motion.empty())
+	{
+		app.SetMotion(motionArgs.motion, motionArgs.bakedMotion);
+	}
+
 	if (!app.Init())
 	{
 		return -1;
 	}
 
-	app.Run();
+	if (app.IsOfflineRender())
+	{
+		app.RunOffline();
+	}
+	else
+	{
+		app.Run();
+	}
+
 	app.Terminate();
 	return 0;
 }
 
 bool Application::Init()
 {
-	// [Nm点
+	// メモリリークを知らせる
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 
-	// COM
+	// COM初期化
 	if (FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED)))
 	{
 		CoUninitialize();
@@ -44,61 +214,389 @@ bool Application::Init()
 		return false;
 	}
 
-	if (!CreateGameWindow())
+	// デバイスを使わない読み込みは、ウィンドウとデバイスを作っている間に別スレッドで進める
+	StartupGraph startup;
+	RenderAssets assets;
+
+	using TaskThread = StartupGraph::TaskThread;
+
+	// オフラインではウィンドウを作らず、Dx12Wrapperはスワップチェーン無しで動く
+	auto window = startup.Add("CreateGameWindow", [this]
+		{
+			return mOffline || CreateGameWindow();
+		}, {}, TaskThread::Main);
+
+	// スワップチェーンの作成中にウィンドウへメッセージが送られることがあるので、ウィンドウと同じスレッドで作る
+	auto device = startup.Add("Dx12Wrapper", [this]
+		{
+			if (!mDX12Wrapper)
+			{
+				mDX12Wrapper = std::make_shared<Dx12Wrapper>(mHwnd);
+			}
+			return true;
+		}, { window }, TaskThread::Main);
+
+	auto texture = startup.Add("Render::LoadTexture", [&assets] { return Render::LoadTexture(assets); });
+	auto basicShaders = startup.Add("Render::CompileBasicShaders", [&assets] { return Render::CompileBasicShaders(assets); });
+	auto upscaleShaders = startup.Add("Render::CompileUpscaleShaders", [&assets] { return Render::CompileUpscaleShaders(assets); });
+
+	auto render = startup.Add("Render", [this, &assets]
+		{
+			if (!mRender)
+			{
+				mRender = std::make_shared<Render>(mDX12Wrapper, assets);
+			}
+			return true;
+		}, { device, texture, basicShaders, upscaleShaders });
+
+	// VMDの読み込みはデバイスと並行に進め、Renderができてからベイク済みの方を開く
+	Skeleton skeleton;
+
+	if (!mBakedMotionPath.empty())
 	{
-		return false;
+		auto motion = startup.Add("LoadMotion", [this, &skeleton]
+			{
+				VmdMotion vmd;
+				if (!vmd.Load(mMotionPath))
+				{
+					return false;
+				}
+
+				skeleton = Skeleton::FromMotion(vmd);
+				return true;
+			});
+
+		startup.Add("Render::SetBakedMotion", [this, &skeleton]
+			{
+				return mRender && mRender->SetBakedMotion(mBakedMotionPath, skeleton);
+			}, { render, motion });
 	}
 
-	if (!mDX12Wrapper)
+	if (mOffline)
 	{
-		mDX12Wrapper = std::make_shared<Dx12Wrapper>(mHwnd);
+		startup.Add("OfflineRenderer", [this]
+			{
+				if (!mOfflineRenderer)
+				{
+					mOfflineRenderer = std::make_shared<OfflineRenderer>();
+				}
+				return mOfflineRenderer->Init(mDX12Wrapper.get(), mOfflineSettings, mRenderSize.cx, mRenderSize.cy);
+			}, { device });
 	}
 
-	if (!mRender)
+	bool started = startup.Run(StartupWorkerCount);
+
+	// どのタスクが起動時間を決めているか
+	OutputDebugStringA(startup.Report().c_str());
+
+	if (!started)
 	{
-		mRender = std::make_shared<Render>();
+		return false;
 	}
 
+	// 起動直後のGPUメモリ使用量
+	OutputDebugStringA(mDX12Wrapper->GetMemoryAllocator().Report().c_str());
+
 	return true;
 }
 
 void Application::Run()
 {
-	MSG msg = {};
+	CpuProfiler::Instance().SetThreadName("Game");
+
+	mPacketReadyEvent = CreateEvent(nullptr, false, false, nullptr);
+	mPacketConsumedEvent = CreateEvent(nullptr, false, false, nullptr);
+
+	if (mPacketReadyEvent == nullptr || mPacketConsumedEvent == nullptr)
+	{
+		assert(false && "イベント作成失敗");
+		return;
+	}
+
+	mQuit = false;
+	mStartNs = CpuProfiler::NowNs();
+	mRenderThread = std::thread(&Application::RenderThreadMain, this);
 
 	while (true)
 	{
-		if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		// 1フレームに1つではなく、溜まっている入力は全て処理する
+		if (!PumpMessages())
 		{
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
+			break;
+		}
+
+		// 描画が追いつくまで待つ。待っている間もメッセージが来たら起きて処理する
+		if (mFramePackets.Full())
+		{
+			MsgWaitForMultipleObjects(1, &mPacketConsumedEvent, false, INFINITE, QS_ALLINPUT);
+			continue;
 		}
 
+		// 入力を処理し終えた直後の状態でパケットを作る
+		FramePacket packet;
+		BuildFramePacket(packet);
+
+		// 書き込むのはこのスレッドだけなので、Fullでなければ必ず積める
+		mFramePackets.TryPush(packet);
+		SetEvent(mPacketReadyEvent);
+	}
+
+	JoinRenderThread();
+
+	CloseHandle(mPacketReadyEvent);
+	CloseHandle(mPacketConsumedEvent);
+	mPacketReadyEvent = nullptr;
+	mPacketConsumedEvent = nullptr;
+}
+
+void Application::EnableOfflineRender(const OfflineRenderSettings& settings, SIZE size)
+{
+	mOffline = true;
+	mOfflineSettings = settings;
+
+	// 途中で大きさは変えない
+	mWindowSize = size;
+	mRenderSize = size;
+}
+
+void Application::RunOffline()
+{
+	CpuProfiler::Instance().SetThreadName("Render");
+
+	int64_t beginNs = CpuProfiler::NowNs();
+
+	mStartNs = beginNs;
+
+	// 描画スレッドは使わず、このスレッドでパケットを作って描く
+	for (uint32_t i = 0; i < mOfflineSettings.frameCount; ++i)
+	{
+		FramePacket packet;
+		BuildFramePacket(packet);
+
+		// 描くのにかかった時間に関係なく、フレーム番号から時刻を決める
+		packet.time = static_cast<double>(i) / mOfflineSettings.framesPerSecond;
+
+		RenderFrame(packet);
+	}
+
+	mOfflineRenderer->Finish();
+
+	double totalMs = (CpuProfiler::NowNs() - beginNs) / 1.0e6;
+	uint32_t frames = mOfflineRenderer->CapturedFrames();
+
+	char buf[256] = {};
+	snprintf(buf, sizeof(buf), "offline: %u frames -> %s, %.1f ms (%.2f ms/frame), readback stall %.1f ms\n",
+		frames, mOfflineSettings.path.c_str(), totalMs, frames > 0 ? totalMs / frames : 0.0, mOfflineRenderer->StallMs());
+
+	OutputDebugStringA(buf);
+	printf("%s", buf);
+}
+
+void Application::SetMotion(const std::string& vmdPath, const std::string& bakedPath)
+{
+	mMotionPath = vmdPath;
+	mBakedMotionPath = bakedPath;
+}
+
+bool Application::PumpMessages()
+{
+	PROFILE_SCOPE("Application::PumpMessages");
+
+	MSG msg = {};
+
+	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+	{
 		if (msg.message == WM_QUIT)
 		{
-			break;
+			return false;
+		}
+
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+
+		if (msg.message == WM_KEYDOWN)
+		{
+			OnKeyDown(msg.wParam);
+		}
+	}
+
+	return true;
+}
+
+void Application::OnKeyDown(WPARAM key)
+{
+	// F2で深度プリパスを切り替える
+	if (key == VK_F2)
+	{
+		mDepthPrepass = !mDepthPrepass;
+	}
+
+	// F3で動的解像度を切り替える
+	if (key == VK_F3)
+	{
+		mDynamicResolution = !mDynamicResolution;
+	}
+
+	// F4でGPUカリング+ExecuteIndirectの描画を切り替える
+	if (key == VK_F4)
+	{
+		mIndirectDraw = !mIndirectDraw;
+	}
+}
+
+void Application::BuildFramePacket(FramePacket& packet)
+{
+	PROFILE_SCOPE("Application::BuildFramePacket");
+
+	packet.frameIndex = mFrameIndex++;
+	packet.windowSize = mWindowSize;
+	packet.depthPrepass = mDepthPrepass;
+	packet.dynamicResolution = mDynamicResolution;
+	packet.indirectDraw = mIndirectDraw;
+
+	DirectX::XMStoreFloat4x4(&packet.world, DirectX::XMMatrixIdentity());
+
+	packet.createdNs = CpuProfiler::NowNs();
+	packet.time = (packet.createdNs - mStartNs) / 1.0e9;
+}
+
+void Application::RenderThreadMain()
+{
+	CpuProfiler::Instance().SetThreadName("Render");
+
+	while (true)
+	{
+		FramePacket packet;
+
+		if (!mFramePackets.TryPop(packet))
+		{
+			// 積まれた分を描き終えてから止まる
+			if (mQuit)
+			{
+				return;
+			}
+
+			WaitForSingleObject(mPacketReadyEvent, INFINITE);
+			continue;
+		}
+
+		SetEvent(mPacketConsumedEvent);
+
+		RenderFrame(packet);
+	}
+}
+
+void Application::RenderFrame(const FramePacket& packet)
+{
+	// 前のフレームのEndDrawでGPUを待っているので、ここではGPUは何も使っていない
+	if (packet.windowSize.cx != mRenderSize.cx || packet.windowSize.cy != mRenderSize.cy)
+	{
+		mRenderSize = packet.windowSize;
+
+		mDX12Wrapper->Resize();
+		mRender->OnResize();
+	}
+
+	int64_t frameBeginNs = CpuProfiler::NowNs();
+
+	mPacketLatency.AddFrame((frameBeginNs - packet.createdNs) / 1.0e6);
+
+	{
+		PROFILE_SCOPE("Frame");
+
+		{
+			PROFILE_SCOPE("Dx12Wrapper::Clear");
+			mDX12Wrapper->Clear();
 		}
 
-		mDX12Wrapper->Clear();
-		mDX12Wrapper->Update();
-		mDX12Wrapper->EndDraw();
+		{
+			PROFILE_SCOPE("Dx12Wrapper::Update");
+			mDX12Wrapper->Update();
+		}
 
-		mRender->Frame(); // t[ƂɌĂ
+		{
+			PROFILE_SCOPE("Render::Frame");
+			mRender->Frame(packet); // 毎フレームごとに呼ぶ
+		}
+
+		// EndDrawでPRESENTへ移る前に、描き終えたバックバッファを読み戻しバッファへコピーする
+		if (mOfflineRenderer)
+		{
+			mOfflineRenderer->Capture(mDX12Wrapper->CommandList().Get(), mDX12Wrapper->GetCurrentBackBuffer(), mDX12Wrapper->GetCurrentFenceValue());
+		}
+
+		{
+			PROFILE_SCOPE("Dx12Wrapper::EndDraw");
+			mDX12Wrapper->EndDraw();
+		}
+	}
+
+	mFrameStats.AddFrame((CpuProfiler::NowNs() - frameBeginNs) / 1.0e6);
+
+	// 一定フレーム毎にフレーム時間とパケット遅延の統計を出す
+	if ((packet.frameIndex + 1) % StatsReportInterval == 0)
+	{
+		OutputDebugStringA(("frame " + mFrameStats.Summary() + "\n").c_str());
+		OutputDebugStringA(("packet latency " + mPacketLatency.Summary() + "\n").c_str());
 	}
 }
 
+void Application::JoinRenderThread()
+{
+	if (!mRenderThread.joinable())
+	{
+		return;
+	}
+
+	mQuit = true;
+	SetEvent(mPacketReadyEvent);
+
+	// Present等がこのスレッドのウィンドウへメッセージを送ってくることがあるので、
+	// 止まって待つとデッドロックし得る
+	HANDLE thread = mRenderThread.native_handle();
+
+	while (MsgWaitForMultipleObjects(1, &thread, false, INFINITE, QS_ALLINPUT) != WAIT_OBJECT_0)
+	{
+		MSG msg = {};
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		{
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+
+	mRenderThread.join();
+}
+
 void Application::Terminate()
 {
-	UnregisterClass(mWindowClass.lpszClassName, mWindowClass.hInstance);
+	// 計測結果をchrome://tracing形式で書き出す
+	std::vector<ProfileEvent> cpuEvents;
+	CpuProfiler::Instance().Collect(cpuEvents);
+
+	TraceExporter::WriteChromeTrace("ProfileTrace.json", cpuEvents, CpuProfiler::Instance().ThreadNames(), mDX12Wrapper->GetGpuProfiler().History());
+
+	// WM_CLOSEでは壊さずにここまで残している
+	if (mHwnd != nullptr)
+	{
+		DestroyWindow(mHwnd);
+
+		UnregisterClass(mWindowClass.lpszClassName, mWindowClass.hInstance);
+	}
 
-	// COM
+	// COM解放
 	CoUninitialize();
 }
 
 SIZE Application::GetWindowSize() const
 {
-	SIZE size = {window_width, window_height};
-	return size;
+	return mRenderSize;
+}
+
+void Application::OnResize(int width, int height)
+{
+	mWindowSize.cx = width;
+	mWindowSize.cy = height;
 }
 
 bool Application::CreateGameWindow()
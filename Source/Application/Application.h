@@ -1,6 +1,13 @@
 #pragma once
 #include "Windows.h"
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
+
+#include "../FramePacket/FramePacket.h"
+#include "../OfflineRender/OfflineRenderer.h"
+#include "../Profiler/FrameStats.h"
 
 class Render;
 class Dx12Wrapper;
@@ -15,8 +22,24 @@ public:
 	bool Init();
 	void Run();
 	void Terminate();
+
+	// Initの前に呼ぶと、ウィンドウを作らずに固定の時間刻みで描き、動画ファイルへ書き出す
+	void EnableOfflineRender(const OfflineRenderSettings& settings, SIZE size);
+	bool IsOfflineRender() const { return mOffline; }
+
+	// Runの代わりに呼ぶ。指定フレーム数を描き終えたら戻る
+	void RunOffline();
+
+	// Initの前に呼ぶと、vmdPathのトラックから作ったスケルトンでbakedPathを繰り返し再生する
+	// bakedPathは同じvmdを--bakeでベイクしたもの
+	void SetMotion(const std::string& vmdPath, const std::string& bakedPath);
+
+	// 描画スレッドが今使っている大きさ(スワップチェーンの大きさ)
 	SIZE GetWindowSize() const;
 
+	// WM_SIZEから呼ばれる。次に作るフレームパケットで描画スレッドに伝わる
+	void OnResize(int width, int height);
+
 	static Application& Instance()
 	{
 		static Application instance = {};
@@ -28,15 +51,67 @@ private:
 	static const int window_width = 1600;
 	static const int window_height = 800;
 
+	// フレーム時間の統計を出力する間隔
+	static const unsigned int StatsReportInterval = 240;
+
+	// 起動時の並列タスクに使うスレッド数(メインスレッド以外)
+	static const unsigned int StartupWorkerCount = 3;
+
 	std::shared_ptr<Dx12Wrapper> mDX12Wrapper = nullptr;
 	std::shared_ptr<Render> mRender = nullptr;
+	std::shared_ptr<OfflineRenderer> mOfflineRenderer = nullptr;
+
+	bool mOffline = false;
+	OfflineRenderSettings mOfflineSettings;
+
+	// 空なら再生しない
+	std::string mMotionPath;
+	std::string mBakedMotionPath;
+
+	FrameStats mFrameStats;
 
-	WNDCLASSEX mWindowClass;
-	HWND mHwnd;
-	HINSTANCE mhInstance;
+	// パケットを作ってから描画スレッドが描き始めるまでの時間
+	FrameStats mPacketLatency;
+
+	// クライアント領域の大きさ(メインスレッド)
+	SIZE mWindowSize = { window_width, window_height };
+
+	// 描画スレッドだけが書く
+	SIZE mRenderSize = { window_width, window_height };
+
+	// ゲーム側の状態(メインスレッド)
+	uint64_t mFrameIndex = 0;
+	int64_t mStartNs = 0;
+	bool mDepthPrepass = false;
+	bool mDynamicResolution = false;
+	bool mIndirectDraw = false;
+
+	FramePacketQueue mFramePackets;
+	std::thread mRenderThread;
+	std::atomic<bool> mQuit = { false };
+
+	// パケットが積まれた / 取り出された時に立つ自動リセットイベント
+	HANDLE mPacketReadyEvent = nullptr;
+	HANDLE mPacketConsumedEvent = nullptr;
+
+	WNDCLASSEX mWindowClass = {};
+	HWND mHwnd = nullptr;
+	HINSTANCE mhInstance = nullptr;
 
 	bool CreateGameWindow();
 
+	// 溜まっているメッセージを全て処理する。WM_QUITが来たらfalse
+	bool PumpMessages();
+	void OnKeyDown(WPARAM key);
+
+	void BuildFramePacket(FramePacket& packet);
+
+	void RenderThreadMain();
+	void RenderFrame(const FramePacket& packet);
+
+	// 描画スレッドの終了をメッセージを処理しながら待つ
+	void JoinRenderThread();
+
 	Application(const Application&) = delete;
 	void operator=(const Application&) = delete;
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "ConstantBuffer.h"
+
+#include <cassert>
+#include <cstring>
+
+void ConstantBlock::Write(uint32_t offset, const void* data, uint32_t size)
+{
+	assert(offset + size <= mSize && "定数ブロックの範囲外");
+
+	if (std::memcmp(mShadow.data() + offset, data, size) == 0)
+	{
+		return;
+	}
+
+	std::memcpy(mShadow.data() + offset, data, size);
+	mDirty = true;
+}
+
+ConstantBufferSystem::~ConstantBufferSystem()
+{
+	if (!mFree)
+	{
+		return;
+	}
+
+	for (auto& block : mBlocks)
+	{
+		if (block->mBinding != ConstantBinding::RootCbv)
+		{
+			continue;
+		}
+
+		for (auto& version : block->mVersions)
+		{
+			mFree(version);
+		}
+	}
+}
+
+void ConstantBufferSystem::Init(AllocateFunction allocate, FreeFunction release)
+{
+	mAllocate = std::move(allocate);
+	mFree = std::move(release);
+}
+
+ConstantBlock* ConstantBufferSystem::CreateBlock(const char* name, ConstantFrequency frequency, uint32_t size, uint32_t rootIndex)
+{
+	ConstantBinding binding = (size <= RootConstantsMaxBytes) ? ConstantBinding::RootConstants : ConstantBinding::RootCbv;
+
+	return CreateBlock(name, frequency, size, rootIndex, binding);
+}
+
+ConstantBlock* ConstantBufferSystem::CreateBlock(const char* name, ConstantFrequency frequency, uint32_t size, uint32_t rootIndex, ConstantBinding binding)
+{
+	assert(size % 4 == 0 && "定数ブロックのサイズは4の倍数");
+
+	std::unique_ptr<ConstantBlock> block(new ConstantBlock());
+	block->mName = name;
+	block->mFrequency = frequency;
+	block->mBinding = binding;
+	block->mRootIndex = rootIndex;
+	block->mSize = size;
+	block->mShadow.resize(size, 0);
+
+	if (binding == ConstantBinding::RootCbv)
+	{
+		// CBVは256バイト単位
+		uint32_t alignedSize = (size + 0xff) & ~0xff;
+
+		for (uint32_t idx = 0; idx < ConstantBlock::VersionCount; ++idx)
+		{
+			if (!mAllocate || !mAllocate(alignedSize, block->mVersions[idx]))
+			{
+				// 途中まで確保した版は返す
+				for (uint32_t done = 0; done < idx && mFree; ++done)
+				{
+					mFree(block->mVersions[done]);
+				}
+				assert(false && "定数ブロックのバッファ作成失敗");
+				return nullptr;
+			}
+		}
+	}
+
+	mBlocks.push_back(std::move(block));
+
+	return mBlocks.back().get();
+}
+
+void ConstantBufferSystem::Flush()
+{
+	mStats = {};
+
+	for (auto& block : mBlocks)
+	{
+		if (block->mBinding == ConstantBinding::RootConstants)
+		{
+			// ルート定数はバインド時にコマンドリストへ直接積まれる
+			block->mDirty = false;
+			mStats.rootConstantBytes += block->mSize;
+			continue;
+		}
+
+		if (!block->mDirty)
+		{
+			++mStats.blocksSkipped;
+			continue;
+		}
+
+		block->mCurrent = (block->mCurrent + 1) % ConstantBlock::VersionCount;
+		std::memcpy(block->mVersions[block->mCurrent].cpuAddress, block->mShadow.data(), block->mSize);
+		block->mDirty = false;
+
+		mStats.bytesUploaded += block->mSize;
+		++mStats.blocksUploaded;
+	}
+}
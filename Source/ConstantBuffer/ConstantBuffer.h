@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ダーティ判定、版の切り替え、統計はd3d12.hに依存させない(ConstantBuffer.cpp)
+// アップロードヒープの確保とコマンドリストへのバインドはConstantBufferGpu.cppで行う
+struct ID3D12GraphicsCommandList;
+class GpuMemoryAllocator;
+
+// 更新頻度
+enum class ConstantFrequency : uint8_t
+{
+	PerFrame,
+	PerPass,
+	PerMaterial,
+	PerDraw,
+};
+
+// ルートシグネチャでの渡し方
+enum class ConstantBinding : uint8_t
+{
+	RootCbv,		// ルートCBV(GPUアドレスだけを積む)
+	RootConstants,	// 32bitルート定数(値を直接コマンドリストに積む)
+};
+
+// 1フレームでアップロードした量
+struct ConstantUploadStats
+{
+	uint64_t bytesUploaded = 0;
+	uint32_t blocksUploaded = 0;
+	uint32_t blocksSkipped = 0;
+	uint64_t rootConstantBytes = 0;
+};
+
+// 定数ブロックの1版分の置き場所
+struct ConstantVersion
+{
+	void* cpuAddress = nullptr;
+	uint64_t gpuAddress = 0;	// D3D12_GPU_VIRTUAL_ADDRESS
+};
+
+// 一度宣言して使い回す定数ブロック
+// 値が変わった時だけ次の版に書き込むので、GPUが読んでいる版は上書きしない
+class ConstantBlock
+{
+public:
+
+	// フレームの多重化数+1あれば、書き込む版は必ずGPUが使い終わっている
+	static const uint32_t VersionCount = 3;
+
+	template<typename T>
+	void Set(const T& value)
+	{
+		Write(0, &value, sizeof(T));
+	}
+
+	// 内容が変わった場合のみダーティにする
+	void Write(uint32_t offset, const void* data, uint32_t size);
+
+	void MarkDirty() { mDirty = true; }
+	bool IsDirty() const { return mDirty; }
+
+	const std::string& Name() const { return mName; }
+	ConstantFrequency Frequency() const { return mFrequency; }
+	ConstantBinding Binding() const { return mBinding; }
+	uint32_t RootIndex() const { return mRootIndex; }
+	uint32_t Size() const { return mSize; }
+
+	const void* Data() const { return mShadow.data(); }
+	uint32_t Num32BitValues() const { return mSize / 4; }
+
+	// RootCbvのみ、最後にアップロードした版
+	uint32_t CurrentVersion() const { return mCurrent; }
+	uint64_t GpuAddress() const { return mVersions[mCurrent].gpuAddress; }
+
+	void Bind(ID3D12GraphicsCommandList* cmdList) const;
+
+private:
+
+	friend class ConstantBufferSystem;
+
+	ConstantBlock() = default;
+
+	std::string mName;
+	ConstantFrequency mFrequency = ConstantFrequency::PerFrame;
+	ConstantBinding mBinding = ConstantBinding::RootCbv;
+	uint32_t mRootIndex = 0;
+	uint32_t mSize = 0;
+
+	std::vector<uint8_t> mShadow;
+	bool mDirty = true;
+
+	ConstantVersion mVersions[VersionCount];
+	uint32_t mCurrent = VersionCount - 1;
+};
+
+// 定数ブロックをまとめて管理し、ダーティなものだけ書き込む
+class ConstantBufferSystem
+{
+public:
+
+	// これ以下のブロックはルート定数にする(ルートシグネチャは全体で64DWORDまで)
+	static const uint32_t RootConstantsMaxBytes = 64;
+
+	// 版の置き場所の確保と解放。sizeはCBVの256バイト単位に揃えてある
+	using AllocateFunction = std::function<bool(uint32_t size, ConstantVersion& version)>;
+	using FreeFunction = std::function<void(ConstantVersion& version)>;
+
+	ConstantBufferSystem() = default;
+	~ConstantBufferSystem();
+
+	// アップロードヒープに置く(ConstantBufferGpu.cpp)
+	void Init(GpuMemoryAllocator* allocator);
+
+	// 置き場所を呼び出し側が用意する(テストではCPUのメモリを渡す)
+	void Init(AllocateFunction allocate, FreeFunction release);
+
+	// sizeは4の倍数
+	ConstantBlock* CreateBlock(const char* name, ConstantFrequency frequency, uint32_t size, uint32_t rootIndex);
+	ConstantBlock* CreateBlock(const char* name, ConstantFrequency frequency, uint32_t size, uint32_t rootIndex, ConstantBinding binding);
+
+	// ドローを積む前に1フレーム1回呼ぶ
+	void Flush();
+
+	// 指定した頻度のブロックを全てバインドする
+	void Bind(ID3D12GraphicsCommandList* cmdList, ConstantFrequency frequency);
+
+	const ConstantUploadStats& Stats() const { return mStats; }
+
+private:
+
+	AllocateFunction mAllocate;
+	FreeFunction mFree;
+
+	std::vector<std::unique_ptr<ConstantBlock>> mBlocks;
+
+	ConstantUploadStats mStats;
+};
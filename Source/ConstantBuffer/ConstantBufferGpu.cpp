@@ -0,0 +1,64 @@
+#include "ConstantBuffer.h"
+
+#include <d3d12.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "../GpuMemory/GpuMemoryAllocator.h"
+
+void ConstantBlock::Bind(ID3D12GraphicsCommandList* cmdList) const
+{
+	if (mBinding == ConstantBinding::RootConstants)
+	{
+		cmdList->SetGraphicsRoot32BitConstants(mRootIndex, Num32BitValues(), mShadow.data(), 0);
+	}
+	else
+	{
+		cmdList->SetGraphicsRootConstantBufferView(mRootIndex, GpuAddress());
+	}
+}
+
+void ConstantBufferSystem::Init(GpuMemoryAllocator* allocator)
+{
+	// 解放にはGpuAllocationが要るので、版のCPUアドレスから引けるように持っておく
+	auto allocations = std::make_shared<std::vector<GpuAllocation>>();
+
+	Init(
+		[allocator, allocations](uint32_t size, ConstantVersion& version)
+		{
+			GpuAllocation allocation;
+			if (!allocator->CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, size, D3D12_RESOURCE_STATE_GENERIC_READ, allocation))
+			{
+				return false;
+			}
+
+			version.cpuAddress = allocation.cpuAddress;
+			version.gpuAddress = allocation.gpuAddress;
+			allocations->push_back(allocation);
+			return true;
+		},
+		[allocator, allocations](ConstantVersion& version)
+		{
+			auto found = std::find_if(allocations->begin(), allocations->end(), [&version](const GpuAllocation& allocation) { return allocation.cpuAddress == version.cpuAddress; });
+			if (found == allocations->end())
+			{
+				return;
+			}
+
+			allocator->Free(*found);
+			allocations->erase(found);
+			version = {};
+		});
+}
+
+void ConstantBufferSystem::Bind(ID3D12GraphicsCommandList* cmdList, ConstantFrequency frequency)
+{
+	for (auto& block : mBlocks)
+	{
+		if (block->mFrequency == frequency)
+		{
+			block->Bind(cmdList);
+		}
+	}
+}
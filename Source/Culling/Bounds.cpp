@@ -0,0 +1,95 @@
+#include "Bounds.h"
+
+#include <algorithm>
+
+BoundingSphere BoundingSphere::FromPoints(const Float3* points, size_t count, float margin)
+{
+	BoundingSphere sphere = {};
+
+	if (count == 0)
+	{
+		sphere.radius = margin;
+		return sphere;
+	}
+
+	// 最初の点から最も遠い点a、aから最も遠い点bを直径の初期値にする
+	auto farthest = [&](const Float3& from)
+	{
+		size_t found = 0;
+		float maxDistSq = -1.0F;
+
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			float distSq = Math::LengthSq(Math::Subtract(points[idx], from));
+			if (distSq > maxDistSq)
+			{
+				maxDistSq = distSq;
+				found = idx;
+			}
+		}
+
+		return points[found];
+	};
+
+	Float3 a = farthest(points[0]);
+	Float3 b = farthest(a);
+
+	Float3 center = Math::Scale(Math::Add(a, b), 0.5F);
+	float radius = Math::Length(Math::Subtract(b, a)) * 0.5F;
+
+	// はみ出した点を含むように球を広げる
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		Float3 offset = Math::Subtract(points[idx], center);
+		float dist = Math::Length(offset);
+
+		if (dist > radius)
+		{
+			float newRadius = (radius + dist) * 0.5F;
+			center = Math::Add(center, Math::Scale(offset, (newRadius - radius) / dist));
+			radius = newRadius;
+		}
+	}
+
+	sphere.center = center;
+	sphere.radius = radius + margin;
+
+	return sphere;
+}
+
+void Aabb::Expand(const Float3& point)
+{
+	min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+	max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+}
+
+void Aabb::Expand(const Aabb& other)
+{
+	// 空の箱(min > max)を足すと±FLT_MAXまで広がってしまう
+	if (other.min.x > other.max.x)
+	{
+		return;
+	}
+
+	Expand(other.min);
+	Expand(other.max);
+}
+
+Float3 Aabb::Center() const
+{
+	return { (min.x + max.x) * 0.5F, (min.y + max.y) * 0.5F, (min.z + max.z) * 0.5F };
+}
+
+float Aabb::SurfaceArea() const
+{
+	float dx = max.x - min.x;
+	float dy = max.y - min.y;
+	float dz = max.z - min.z;
+
+	if (dx < 0.0F || dy < 0.0F || dz < 0.0F)
+	{
+		return 0.0F;
+	}
+
+	return 2.0F * (dx * dy + dy * dz + dz * dx);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cfloat>
+#include <cstddef>
+
+#include "../Math/MathTypes.h"
+
+// バウンディングスフィア
+struct BoundingSphere
+{
+	Float3 center = {};
+	float radius = 0.0F;
+
+	// 点群を囲む球(Ritter法)。marginは半径に足す余白
+	static BoundingSphere FromPoints(const Float3* points, size_t count, float margin);
+};
+
+// 軸並行バウンディングボックス
+struct Aabb
+{
+	Float3 min = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+	Float3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	void Expand(const Float3& point);
+	void Expand(const Aabb& other);
+
+	Float3 Center() const;
+	float SurfaceArea() const;
+};
@@ -0,0 +1,266 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	constexpr int BinCount = 12;
+	constexpr uint32_t MinLeafSize = 2;
+	constexpr uint32_t MaxLeafSize = 8;
+
+	// Queryの走査スタックの大きさ。木の深さはこれより浅く作る
+	constexpr uint32_t MaxQueryDepth = 64;
+
+	// 葉のプリミティブ判定1回に対するノード巡回のコスト比
+	constexpr float TraversalCost = 1.0F;
+
+	uint32_t CeilLog2(uint32_t value)
+	{
+		uint32_t log = 0;
+		while ((1ULL << log) < value)
+		{
+			++log;
+		}
+		return log;
+	}
+
+	float Axis(const Float3& v, int axis)
+	{
+		return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+	}
+}
+
+void Bvh::Build(const std::vector<Aabb>& bounds)
+{
+	mNodes.clear();
+	mPrimIndices.clear();
+	mPrimBounds.clear();
+
+	if (bounds.empty())
+	{
+		return;
+	}
+
+	std::vector<BuildPrim> prims(bounds.size());
+	for (size_t idx = 0; idx < bounds.size(); ++idx)
+	{
+		prims[idx].bounds = bounds[idx];
+		prims[idx].centroid = bounds[idx].Center();
+		prims[idx].index = static_cast<uint32_t>(idx);
+	}
+
+	mNodes.reserve(bounds.size() * 2);
+	mPrimIndices.reserve(bounds.size());
+	mPrimBounds.reserve(bounds.size());
+
+	BuildNode(prims, 0, static_cast<uint32_t>(prims.size()), 0);
+}
+
+uint32_t Bvh::BuildNode(std::vector<BuildPrim>& prims, uint32_t begin, uint32_t end, uint32_t depth)
+{
+	uint32_t nodeIdx = static_cast<uint32_t>(mNodes.size());
+	mNodes.push_back({});
+
+	Aabb nodeBounds = {};
+	Aabb centroidBounds = {};
+	for (uint32_t idx = begin; idx < end; ++idx)
+	{
+		nodeBounds.Expand(prims[idx].bounds);
+		centroidBounds.Expand(prims[idx].centroid);
+	}
+
+	mNodes[nodeIdx].min = nodeBounds.min;
+	mNodes[nodeIdx].max = nodeBounds.max;
+
+	uint32_t count = end - begin;
+
+	if (count <= MinLeafSize)
+	{
+		MakeLeaf(mNodes[nodeIdx], prims, begin, end);
+		return nodeIdx;
+	}
+
+	// 重心の広がりが最大の軸でビン分割する
+	float ext[3] =
+	{
+		centroidBounds.max.x - centroidBounds.min.x,
+		centroidBounds.max.y - centroidBounds.min.y,
+		centroidBounds.max.z - centroidBounds.min.z,
+	};
+	int axis = static_cast<int>(std::max_element(std::begin(ext), std::end(ext)) - std::begin(ext));
+
+	uint32_t mid = begin;
+
+	if (ext[axis] <= 0.0F)
+	{
+		// 重心が全て重なっているので個数で半分に分ける
+		if (count <= MaxLeafSize)
+		{
+			MakeLeaf(mNodes[nodeIdx], prims, begin, end);
+			return nodeIdx;
+		}
+
+		mid = begin + count / 2;
+	}
+	else if (depth + CeilLog2(count) + 1 >= MaxQueryDepth)
+	{
+		// 偏った分割が続いて深くなったので、残りは重心の中央で半分に分けて深さを抑える
+		auto first = prims.begin() + begin;
+		mid = begin + count / 2;
+		std::nth_element(first, prims.begin() + mid, prims.begin() + end, [axis](const BuildPrim& a, const BuildPrim& b) { return Axis(a.centroid, axis) < Axis(b.centroid, axis); });
+	}
+	else
+	{
+		struct Bin
+		{
+			Aabb bounds;
+			uint32_t count = 0;
+		};
+
+		Bin bins[BinCount] = {};
+		float axisMin = Axis(centroidBounds.min, axis);
+		float scale = BinCount / ext[axis];
+
+		auto binOf = [&](const BuildPrim& prim)
+		{
+			int bin = static_cast<int>((Axis(prim.centroid, axis) - axisMin) * scale);
+			return std::min(bin, BinCount - 1);
+		};
+
+		for (uint32_t idx = begin; idx < end; ++idx)
+		{
+			Bin& bin = bins[binOf(prims[idx])];
+			bin.bounds.Expand(prims[idx].bounds);
+			++bin.count;
+		}
+
+		// 左右から累積してBinCount-1通りの分割のSAHコストを求める
+		float leftArea[BinCount - 1] = {};
+		uint32_t leftCount[BinCount - 1] = {};
+		Aabb accum = {};
+		uint32_t accumCount = 0;
+		for (int idx = 0; idx < BinCount - 1; ++idx)
+		{
+			accum.Expand(bins[idx].bounds);
+			accumCount += bins[idx].count;
+			leftArea[idx] = accum.SurfaceArea();
+			leftCount[idx] = accumCount;
+		}
+
+		float bestCost = FLT_MAX;
+		int bestSplit = -1;
+		accum = {};
+		accumCount = 0;
+		for (int idx = BinCount - 1; idx > 0; --idx)
+		{
+			accum.Expand(bins[idx].bounds);
+			accumCount += bins[idx].count;
+
+			if (leftCount[idx - 1] == 0 || accumCount == 0)
+			{
+				continue;
+			}
+
+			float cost = leftArea[idx - 1] * leftCount[idx - 1] + accum.SurfaceArea() * accumCount;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = idx;
+			}
+		}
+
+		float parentArea = nodeBounds.SurfaceArea();
+		float splitCost = TraversalCost + (parentArea > 0.0F ? bestCost / parentArea : 0.0F);
+
+		// 分割しても得にならなければ葉にする
+		if (bestSplit < 0 || (splitCost >= static_cast<float>(count) && count <= MaxLeafSize))
+		{
+			MakeLeaf(mNodes[nodeIdx], prims, begin, end);
+			return nodeIdx;
+		}
+
+		auto first = prims.begin() + begin;
+		auto last = prims.begin() + end;
+		mid = begin + static_cast<uint32_t>(std::partition(first, last, [&](const BuildPrim& prim) { return binOf(prim) < bestSplit; }) - first);
+	}
+
+	BuildNode(prims, begin, mid, depth + 1);
+	uint32_t right = BuildNode(prims, mid, end, depth + 1);
+
+	mNodes[nodeIdx].offset = right;
+	mNodes[nodeIdx].count = 0;
+
+	return nodeIdx;
+}
+
+void Bvh::MakeLeaf(BvhNode& node, const std::vector<BuildPrim>& prims, uint32_t begin, uint32_t end)
+{
+	node.offset = static_cast<uint32_t>(mPrimIndices.size());
+	node.count = end - begin;
+
+	for (uint32_t idx = begin; idx < end; ++idx)
+	{
+		mPrimIndices.push_back(prims[idx].index);
+		mPrimBounds.push_back(prims[idx].bounds);
+	}
+}
+
+void Bvh::Query(const FrustumSimd& frustum, std::vector<uint32_t>& visible) const
+{
+	if (mNodes.empty())
+	{
+		return;
+	}
+
+	struct StackEntry
+	{
+		uint32_t node;
+		bool inside; // 親が完全に内側なら判定を省略する
+	};
+
+	// 毎フレーム呼ぶのでヒープは使わない
+	// 左から辿るので、積まれるのは深さ1段につき高々1つ(右の子)
+	StackEntry stack[MaxQueryDepth];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = { 0, false };
+
+	while (stackSize > 0)
+	{
+		StackEntry entry = stack[--stackSize];
+		const BvhNode& node = mNodes[entry.node];
+
+		bool inside = entry.inside;
+		if (!inside)
+		{
+			Aabb box = {};
+			box.min = node.min;
+			box.max = node.max;
+
+			FrustumSimd::Result result = frustum.Classify(box);
+			if (result == FrustumSimd::Outside)
+			{
+				continue;
+			}
+
+			inside = result == FrustumSimd::Inside;
+		}
+
+		if (node.count > 0)
+		{
+			for (uint32_t idx = node.offset; idx < node.offset + node.count; ++idx)
+			{
+				if (inside || frustum.Classify(mPrimBounds[idx]) != FrustumSimd::Outside)
+				{
+					visible.push_back(mPrimIndices[idx]);
+				}
+			}
+			continue;
+		}
+
+		// 右を先に積んで左(直後のノード)から辿る
+		assert(stackSize + 2 <= MaxQueryDepth && "BVHが深すぎる");
+		stack[stackSize++] = { node.offset, inside };
+		stack[stackSize++] = { entry.node + 1, inside };
+	}
+}
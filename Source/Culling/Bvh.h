@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.h"
+
+// 深さ優先で並べたノード。左の子は常に直後に置く
+struct BvhNode
+{
+	Float3 min;
+	uint32_t offset; // 葉: 先頭プリミティブ / 内部: 右の子のノード番号
+	Float3 max;
+	uint32_t count;  // 葉: プリミティブ数 / 内部: 0
+};
+
+static_assert(sizeof(BvhNode) == 32, "BvhNodeは32バイトに収める");
+
+// 静的なステージメッシュ用のBVH(SAHで構築)
+class Bvh
+{
+public:
+
+	Bvh() = default;
+	~Bvh() = default;
+
+	// boundsの添字がそのままプリミティブ番号になる
+	void Build(const std::vector<Aabb>& bounds);
+
+	// 視錐台に掛かるプリミティブ番号をvisibleに追加する
+	void Query(const FrustumSimd& frustum, std::vector<uint32_t>& visible) const;
+
+	const std::vector<BvhNode>& Nodes() const { return mNodes; }
+	size_t PrimitiveCount() const { return mPrimIndices.size(); }
+
+private:
+
+	struct BuildPrim
+	{
+		Aabb bounds;
+		Float3 centroid;
+		uint32_t index;
+	};
+
+	uint32_t BuildNode(std::vector<BuildPrim>& prims, uint32_t begin, uint32_t end, uint32_t depth);
+	void MakeLeaf(BvhNode& node, const std::vector<BuildPrim>& prims, uint32_t begin, uint32_t end);
+
+	std::vector<BvhNode> mNodes;
+
+	// 葉から参照する順に並べ替えたプリミティブ
+	std::vector<uint32_t> mPrimIndices;
+	std::vector<Aabb> mPrimBounds;
+};
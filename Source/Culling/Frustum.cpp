@@ -0,0 +1,147 @@
+#include "Frustum.h"
+
+namespace
+{
+	// 行ベクトル規約なので平面は列から取り出す
+	Float4 Column(const Float4x4& m, int col)
+	{
+		return { m.m[0][col], m.m[1][col], m.m[2][col], m.m[3][col] };
+	}
+
+	Float4 Combine(const Float4& a, const Float4& b, float sign)
+	{
+		return { a.x + b.x * sign, a.y + b.y * sign, a.z + b.z * sign, a.w + b.w * sign };
+	}
+
+	Float4 NormalizePlane(const Float4& plane)
+	{
+		float length = Math::Length({ plane.x, plane.y, plane.z });
+		if (length <= 0.0F)
+		{
+			return plane;
+		}
+
+		float inv = 1.0F / length;
+		return { plane.x * inv, plane.y * inv, plane.z * inv, plane.w * inv };
+	}
+}
+
+Frustum Frustum::FromViewProjection(const Float4x4& viewProj)
+{
+	Float4 c0 = Column(viewProj, 0);
+	Float4 c1 = Column(viewProj, 1);
+	Float4 c2 = Column(viewProj, 2);
+	Float4 c3 = Column(viewProj, 3);
+
+	Float4 planes[PlaneCount] =
+	{
+		Combine(c3, c0, 1.0F),
+		Combine(c3, c0, -1.0F),
+		Combine(c3, c1, 1.0F),
+		Combine(c3, c1, -1.0F),
+		c2,							// PlaneZ0 (D3DはZが0～1)
+		Combine(c3, c2, -1.0F),		// PlaneZW
+	};
+
+	Frustum frustum = {};
+	for (int idx = 0; idx < PlaneCount; ++idx)
+	{
+		frustum.planes[idx] = NormalizePlane(planes[idx]);
+	}
+
+	return frustum;
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+	for (const Float4& plane : planes)
+	{
+		float distance = plane.x * sphere.center.x + plane.y * sphere.center.y + plane.z * sphere.center.z + plane.w;
+		if (distance < -sphere.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+FrustumSimd::FrustumSimd(const Frustum& frustum)
+{
+	for (int group = 0; group < GroupCount; ++group)
+	{
+		const Float4* p[4] = {};
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			int planeIdx = group * 4 + lane;
+			p[lane] = &frustum.planes[planeIdx < Frustum::PlaneCount ? planeIdx : 0];
+		}
+
+		mNormalX[group] = Simd::Set(p[0]->x, p[1]->x, p[2]->x, p[3]->x);
+		mNormalY[group] = Simd::Set(p[0]->y, p[1]->y, p[2]->y, p[3]->y);
+		mNormalZ[group] = Simd::Set(p[0]->z, p[1]->z, p[2]->z, p[3]->z);
+		mDistance[group] = Simd::Set(p[0]->w, p[1]->w, p[2]->w, p[3]->w);
+
+		mAbsNormalX[group] = Simd::Abs(mNormalX[group]);
+		mAbsNormalY[group] = Simd::Abs(mNormalY[group]);
+		mAbsNormalZ[group] = Simd::Abs(mNormalZ[group]);
+	}
+}
+
+FrustumSimd::Result FrustumSimd::Classify(const Aabb& box) const
+{
+	Simd4 cx = Simd::Splat((box.min.x + box.max.x) * 0.5F);
+	Simd4 cy = Simd::Splat((box.min.y + box.max.y) * 0.5F);
+	Simd4 cz = Simd::Splat((box.min.z + box.max.z) * 0.5F);
+	Simd4 ex = Simd::Splat((box.max.x - box.min.x) * 0.5F);
+	Simd4 ey = Simd::Splat((box.max.y - box.min.y) * 0.5F);
+	Simd4 ez = Simd::Splat((box.max.z - box.min.z) * 0.5F);
+
+	bool inside = true;
+
+	for (int group = 0; group < GroupCount; ++group)
+	{
+		// 中心の符号付き距離と、平面法線方向への箱の半径
+		Simd4 dist = Simd::MultiplyAdd(cx, mNormalX[group], mDistance[group]);
+		dist = Simd::MultiplyAdd(cy, mNormalY[group], dist);
+		dist = Simd::MultiplyAdd(cz, mNormalZ[group], dist);
+
+		Simd4 radius = Simd::Multiply(ex, mAbsNormalX[group]);
+		radius = Simd::MultiplyAdd(ey, mAbsNormalY[group], radius);
+		radius = Simd::MultiplyAdd(ez, mAbsNormalZ[group], radius);
+
+		if (Simd::AnyLess(dist, Simd::Negate(radius)))
+		{
+			return Outside;
+		}
+
+		if (!Simd::AllGreaterEqual(dist, radius))
+		{
+			inside = false;
+		}
+	}
+
+	return inside ? Inside : Intersect;
+}
+
+bool FrustumSimd::Intersects(const BoundingSphere& sphere) const
+{
+	Simd4 cx = Simd::Splat(sphere.center.x);
+	Simd4 cy = Simd::Splat(sphere.center.y);
+	Simd4 cz = Simd::Splat(sphere.center.z);
+	Simd4 negRadius = Simd::Splat(-sphere.radius);
+
+	for (int group = 0; group < GroupCount; ++group)
+	{
+		Simd4 dist = Simd::MultiplyAdd(cx, mNormalX[group], mDistance[group]);
+		dist = Simd::MultiplyAdd(cy, mNormalY[group], dist);
+		dist = Simd::MultiplyAdd(cz, mNormalZ[group], dist);
+
+		if (Simd::AnyLess(dist, negRadius))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
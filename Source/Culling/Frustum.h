@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Math/MathTypes.h"
+#include "../Math/Simd4.h"
+#include "Bounds.h"
+
+// 視錐台(法線は内側向き、正規化済み)
+struct Frustum
+{
+	enum PlaneIndex
+	{
+		PlaneLeft,
+		PlaneRight,
+		PlaneBottom,
+		PlaneTop,
+		// 射影後のzで分ける。逆Z(Dx12Wrapper::IsReverseZ)ではz=0がファー、z=wがニアになる
+		PlaneZ0,	// z >= 0
+		PlaneZW,	// z <= w
+		PlaneCount,
+	};
+
+	Float4 planes[PlaneCount] = {};
+
+	// ビュー×プロジェクション行列から6平面を取り出す
+	// ワールド×ビュー×プロジェクションを渡せばオブジェクト空間の視錐台になる
+	static Frustum FromViewProjection(const Float4x4& viewProj);
+
+	bool Intersects(const BoundingSphere& sphere) const;
+};
+
+// 平面を4枚ずつSoAに並べ、1命令で4平面を判定する視錐台
+class FrustumSimd
+{
+public:
+
+	enum Result
+	{
+		Outside,
+		Intersect,
+		Inside,
+	};
+
+	explicit FrustumSimd(const Frustum& frustum);
+
+	Result Classify(const Aabb& box) const;
+	bool Intersects(const BoundingSphere& sphere) const;
+
+private:
+
+	// 6平面を4平面×2組に詰める(余った2枠は先頭の平面を複製)
+	static const int GroupCount = 2;
+
+	Simd4 mNormalX[GroupCount];
+	Simd4 mNormalY[GroupCount];
+	Simd4 mNormalZ[GroupCount];
+	Simd4 mDistance[GroupCount];
+
+	Simd4 mAbsNormalX[GroupCount];
+	Simd4 mAbsNormalY[GroupCount];
+	Simd4 mAbsNormalZ[GroupCount];
+};
@@ -0,0 +1,64 @@
+#include "SkinnedBounds.h"
+
+#include <algorithm>
+#include <cassert>
+
+void SkinnedBounds::Init(const std::vector<Float3>& bindBonePositions, const Float3* positions, const uint16_t* boneIndices, const float* boneWeights, size_t vertexCount)
+{
+	mBoneRadii.assign(bindBonePositions.size(), -1.0F);
+
+	for (size_t vtx = 0; vtx < vertexCount; ++vtx)
+	{
+		for (int inf = 0; inf < InfluenceCount; ++inf)
+		{
+			size_t slot = vtx * InfluenceCount + inf;
+			if (boneWeights[slot] <= 0.0F)
+			{
+				continue;
+			}
+
+			uint16_t bone = boneIndices[slot];
+			if (bone >= bindBonePositions.size())
+			{
+				assert(false && "ボーン番号が範囲外");
+				continue;
+			}
+
+			float dist = Math::Length(Math::Subtract(positions[vtx], bindBonePositions[bone]));
+			mBoneRadii[bone] = std::max(mBoneRadii[bone], dist);
+		}
+	}
+
+	mActivePositions.reserve(bindBonePositions.size());
+}
+
+BoundingSphere SkinnedBounds::Update(const Float3* bonePositions, size_t boneCount) const
+{
+	assert(boneCount >= mBoneRadii.size() && "ボーン数が足りない");
+
+	mActivePositions.clear();
+	for (size_t bone = 0; bone < mBoneRadii.size(); ++bone)
+	{
+		if (mBoneRadii[bone] >= 0.0F)
+		{
+			mActivePositions.push_back(bonePositions[bone]);
+		}
+	}
+
+	// ボーン位置を囲む球を作り、各ボーンの影響半径の分だけ広げる
+	BoundingSphere sphere = BoundingSphere::FromPoints(mActivePositions.data(), mActivePositions.size(), 0.0F);
+
+	float radius = 0.0F;
+	for (size_t bone = 0; bone < mBoneRadii.size(); ++bone)
+	{
+		if (mBoneRadii[bone] >= 0.0F)
+		{
+			float dist = Math::Length(Math::Subtract(bonePositions[bone], sphere.center));
+			radius = std::max(radius, dist + mBoneRadii[bone]);
+		}
+	}
+
+	sphere.radius = radius;
+
+	return sphere;
+}
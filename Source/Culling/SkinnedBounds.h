@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Bounds.h"
+
+// スキンメッシュのバウンディングスフィアを、毎フレームのボーン位置から作り直す
+// 読み込み時にボーン毎の影響半径(そのボーンが動かす頂点までの最大距離)を求めておき、
+// 頂点をスキニングせずにボーン位置と半径だけから全頂点を囲む球を得る
+// ボーンの変換が剛体(回転と平行移動)なら、ブレンドした頂点も必ずこの球に入る
+class SkinnedBounds
+{
+public:
+
+	static const int InfluenceCount = 4;
+
+	SkinnedBounds() = default;
+	~SkinnedBounds() = default;
+
+	// bindBonePositions: バインドポーズでのボーン位置(モデル空間)
+	// boneIndices/boneWeights: 頂点毎にInfluenceCount個ずつ並べたもの。ウェイト0は無視する
+	void Init(const std::vector<Float3>& bindBonePositions, const Float3* positions, const uint16_t* boneIndices, const float* boneWeights, size_t vertexCount);
+
+	// 現在のポーズのボーン位置(モデル空間)から球を作る
+	BoundingSphere Update(const Float3* bonePositions, size_t boneCount) const;
+
+	const std::vector<float>& BoneRadii() const { return mBoneRadii; }
+
+private:
+
+	// 影響する頂点が無いボーンは負の値
+	std::vector<float> mBoneRadii;
+
+	// Update用の作業領域(影響のあるボーンの位置だけを集める)
+	mutable std::vector<Float3> mActivePositions;
+};
@@ -0,0 +1,108 @@
+#include "DrawPacket.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+void DrawPacket::SetRootConstants(const void* values, uint32_t count)
+{
+	if (count > MaxRootConstants)
+	{
+		assert(false && "ルート定数がパケットに収まらない");
+		count = MaxRootConstants;
+	}
+
+	std::memcpy(rootConstants, values, count * sizeof(uint32_t));
+	rootConstantCount = count;
+}
+
+uint32_t DrawPacketStats::TotalSet() const
+{
+	return pipelineStateSet + rootSignatureSet + descriptorHeapSet + descriptorTableSet + samplerTableSet +
+		materialTableSet + materialIndexSet + rootCbvSet + rootConstantsSet + vertexBufferSet + indexBufferSet;
+}
+
+uint32_t DrawPacketStats::TotalSkipped() const
+{
+	return pipelineStateSkipped + rootSignatureSkipped + descriptorHeapSkipped + descriptorTableSkipped + samplerTableSkipped +
+		materialTableSkipped + materialIndexSkipped + rootCbvSkipped + rootConstantsSkipped + vertexBufferSkipped + indexBufferSkipped;
+}
+
+uint64_t DrawPacketQueue::MakeSortKey(uint8_t pass, uint16_t pipelineId, uint16_t textureId, float depth01)
+{
+	depth01 = std::clamp(depth01, 0.0F, 1.0F);
+
+	// 半透明は奥から手前に描くので深度を反転する
+	if (pass == PassTransparent)
+	{
+		depth01 = 1.0F - depth01;
+	}
+
+	uint64_t depthBits = static_cast<uint64_t>(depth01 * static_cast<float>(0xFFFFFF));
+
+	return (static_cast<uint64_t>(pass) << 56) |
+		(static_cast<uint64_t>(pipelineId) << 40) |
+		(static_cast<uint64_t>(textureId) << 24) |
+		(depthBits & 0xFFFFFF);
+}
+
+void DrawPacketQueue::Add(const DrawPacket& packet)
+{
+	mEntries.push_back({ packet.sortKey, static_cast<uint32_t>(mPackets.size()) });
+	mPackets.push_back(packet);
+}
+
+void DrawPacketQueue::Clear()
+{
+	mPackets.clear();
+	mEntries.clear();
+}
+
+void DrawPacketQueue::Sort()
+{
+	// 統計はフレーム単位(プリパスと本描画の合計)
+	mStats = {};
+
+	mScratch.resize(mEntries.size());
+
+	SortEntry* src = mEntries.data();
+	SortEntry* dst = mScratch.data();
+	const size_t count = mEntries.size();
+
+	// 8ビットずつ8パスのLSD基数ソート
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t histogram[256] = {};
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			++histogram[(src[i].key >> shift) & 0xFF];
+		}
+
+		// 全要素が同じバケットならこの桁は並べ替え不要
+		if (count == 0 || histogram[(src[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (size_t& bucket : histogram)
+		{
+			size_t num = bucket;
+			bucket = offset;
+			offset += num;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	if (src != mEntries.data())
+	{
+		std::copy_n(src, count, mEntries.data());
+	}
+}
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// D3D12のオブジェクトはポインタでしか持たないので前方宣言で足りる
+// ソートと再設定の省略はd3d12.hに依存させず、コマンドリストへの記録はDrawPacketCommandList.cppで行う
+struct ID3D12PipelineState;
+struct ID3D12RootSignature;
+struct ID3D12DescriptorHeap;
+struct ID3D12GraphicsCommandList;
+struct D3D12_VERTEX_BUFFER_VIEW;
+struct D3D12_INDEX_BUFFER_VIEW;
+
+// 1ドローコール分の情報
+struct DrawPacket
+{
+	uint64_t sortKey = 0;
+
+	ID3D12PipelineState* pipelineState = nullptr;
+
+	// 深度プリパス用(ピクセルシェーダーなし)。nullptrならプリパスで描かない
+	ID3D12PipelineState* depthOnlyPipelineState = nullptr;
+
+	ID3D12RootSignature* rootSignature = nullptr;
+	ID3D12DescriptorHeap* descriptorHeap = nullptr;
+
+	// サンプラーのヒープ。nullptrならサンプラーテーブルを使わない
+	ID3D12DescriptorHeap* samplerHeap = nullptr;
+
+	// ルートパラメータ0(テクスチャのテーブル)。D3D12_GPU_DESCRIPTOR_HANDLE::ptr
+	uint64_t textureTable = 0;
+
+	// ルートパラメータ1(ルートCBV)。D3D12_GPU_VIRTUAL_ADDRESS
+	uint64_t constantBuffer = 0;
+
+	// ルートパラメータ2(32bitルート定数)、ドロー毎の小さな値
+	// 積むまでの間に元の値が書き換わってもよいように、パケットに値ごとコピーして持つ
+	static constexpr uint32_t MaxRootConstants = 16;
+	uint32_t rootConstants[MaxRootConstants] = {};
+	uint32_t rootConstantCount = 0;
+
+	// countは32bit単位。MaxRootConstantsを超える分は捨てる
+	void SetRootConstants(const void* values, uint32_t count);
+
+	// ルートパラメータ3(マテリアルのサンプラーのテーブル)
+	uint64_t samplerTable = 0;
+
+	// ルートパラメータ4(マテリアル番号のルート定数)と5(トゥーン・スフィア・マテリアルのテーブル)
+	// テーブルはモデルの全マテリアルで共有し、ドロー毎には番号だけを変える。0なら使わない
+	uint32_t materialIndex = 0;
+	uint64_t materialTable = 0;
+
+	const D3D12_VERTEX_BUFFER_VIEW* vbView = nullptr;
+	const D3D12_INDEX_BUFFER_VIEW* ibView = nullptr;
+
+	uint32_t indexCount = 0;
+	uint32_t startIndex = 0;
+	int32_t baseVertex = 0;
+};
+
+// ステート変更の回数(発行した回数と省略した回数)
+struct DrawPacketStats
+{
+	uint32_t drawCount = 0;
+	uint32_t depthOnlyDrawCount = 0;
+
+	uint32_t pipelineStateSet = 0;
+	uint32_t pipelineStateSkipped = 0;
+	uint32_t rootSignatureSet = 0;
+	uint32_t rootSignatureSkipped = 0;
+	uint32_t descriptorHeapSet = 0;
+	uint32_t descriptorHeapSkipped = 0;
+	uint32_t descriptorTableSet = 0;
+	uint32_t descriptorTableSkipped = 0;
+	uint32_t samplerTableSet = 0;
+	uint32_t samplerTableSkipped = 0;
+	uint32_t materialTableSet = 0;
+	uint32_t materialTableSkipped = 0;
+	uint32_t materialIndexSet = 0;
+	uint32_t materialIndexSkipped = 0;
+	uint32_t rootCbvSet = 0;
+	uint32_t rootCbvSkipped = 0;
+	uint32_t rootConstantsSet = 0;
+	uint32_t rootConstantsSkipped = 0;
+	uint32_t vertexBufferSet = 0;
+	uint32_t vertexBufferSkipped = 0;
+	uint32_t indexBufferSet = 0;
+	uint32_t indexBufferSkipped = 0;
+
+	// 発行したステート変更の合計と省略した合計
+	uint32_t TotalSet() const;
+	uint32_t TotalSkipped() const;
+};
+
+// ルートパラメータの番号(Renderのルートシグネチャと一致させる)
+enum DrawRootParam : uint32_t
+{
+	DrawRootParamTexture = 0,
+	DrawRootParamFrame = 1,
+	DrawRootParamDraw = 2,
+	DrawRootParamSampler = 3,
+	DrawRootParamMaterialIndex = 4,
+	DrawRootParamMaterialTable = 5,
+};
+
+class DrawPacketQueue
+{
+public:
+
+	// ソートキーのビット配置
+	// [63:56] パス [55:40] PSO [39:24] テクスチャ [23:0] 深度
+	enum Pass : uint8_t
+	{
+		PassOpaque = 0,
+		PassTransparent = 1,
+	};
+
+	DrawPacketQueue() = default;
+	~DrawPacketQueue() = default;
+
+	static uint64_t MakeSortKey(uint8_t pass, uint16_t pipelineId, uint16_t textureId, float depth01);
+
+	void Add(const DrawPacket& packet);
+	void Clear();
+
+	// キーの昇順にソート(基数ソート)
+	void Sort();
+
+	// ソート済みの順に積み、同じステートの再設定を省略する
+	void Submit(ID3D12GraphicsCommandList* cmdList);
+
+	// 不透明のパケットを深度専用PSOで積む(Submitの前に呼ぶ)
+	void SubmitDepthOnly(ID3D12GraphicsCommandList* cmdList);
+
+	// Submitの中身。recorderは下のSet～/DrawIndexedを持つ型なら何でもよい
+	// (D3D12のコマンドリストの代わりに、呼ばれた順を記録する物を渡して検証できる)
+	template<typename Recorder>
+	void Record(Recorder& recorder, bool depthOnly);
+
+	size_t Size() const { return mPackets.size(); }
+	const DrawPacketStats& Stats() const { return mStats; }
+
+	// ソート後の順(Sortの前は追加順)
+	const DrawPacket& Packet(size_t order) const { return mPackets[mEntries[order].index]; }
+
+private:
+
+	struct SortEntry
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	std::vector<DrawPacket> mPackets;
+	std::vector<SortEntry> mEntries;
+	std::vector<SortEntry> mScratch;
+
+	DrawPacketStats mStats;
+};
+
+template<typename Recorder>
+void DrawPacketQueue::Record(Recorder& recorder, bool depthOnly)
+{
+	ID3D12PipelineState* curPipelineState = nullptr;
+	ID3D12RootSignature* curRootSignature = nullptr;
+	ID3D12DescriptorHeap* curDescriptorHeap = nullptr;
+	ID3D12DescriptorHeap* curSamplerHeap = nullptr;
+	uint64_t curTextureTable = 0;
+	uint64_t curSamplerTable = 0;
+	uint64_t curMaterialTable = 0;
+	uint32_t curMaterialIndex = 0;
+	bool materialIndexBound = false;
+	uint64_t curConstantBuffer = 0;
+	const DrawPacket* curRootConstants = nullptr;
+	const D3D12_VERTEX_BUFFER_VIEW* curVbView = nullptr;
+	const D3D12_INDEX_BUFFER_VIEW* curIbView = nullptr;
+
+	recorder.SetTriangleList();
+
+	for (const SortEntry& entry : mEntries)
+	{
+		const DrawPacket& packet = mPackets[entry.index];
+
+		// 深度プリパスは不透明で深度専用PSOを持つものだけ
+		if (depthOnly && ((entry.key >> 56) != PassOpaque || packet.depthOnlyPipelineState == nullptr))
+		{
+			continue;
+		}
+
+		ID3D12PipelineState* pipelineState = depthOnly ? packet.depthOnlyPipelineState : packet.pipelineState;
+
+		if (pipelineState != curPipelineState)
+		{
+			recorder.SetPipelineState(pipelineState);
+			curPipelineState = pipelineState;
+			++mStats.pipelineStateSet;
+		}
+		else
+		{
+			++mStats.pipelineStateSkipped;
+		}
+
+		// ルートシグネチャが変わるとルート引数は全て無効になる
+		if (packet.rootSignature != curRootSignature)
+		{
+			recorder.SetRootSignature(packet.rootSignature);
+			curRootSignature = packet.rootSignature;
+			curTextureTable = 0;
+			curSamplerTable = 0;
+			curMaterialTable = 0;
+			materialIndexBound = false;
+			curConstantBuffer = 0;
+			curRootConstants = nullptr;
+			++mStats.rootSignatureSet;
+		}
+		else
+		{
+			++mStats.rootSignatureSkipped;
+		}
+
+		// CBV/SRV/UAVとサンプラーのヒープは1回でまとめて設定する
+		if (packet.descriptorHeap != curDescriptorHeap || packet.samplerHeap != curSamplerHeap)
+		{
+			recorder.SetDescriptorHeaps(packet.descriptorHeap, packet.samplerHeap);
+			curDescriptorHeap = packet.descriptorHeap;
+			curSamplerHeap = packet.samplerHeap;
+			curTextureTable = 0;
+			curSamplerTable = 0;
+			curMaterialTable = 0;
+			++mStats.descriptorHeapSet;
+		}
+		else
+		{
+			++mStats.descriptorHeapSkipped;
+		}
+
+		// 深度だけならピクセルシェーダーのテクスチャは要らない
+		if (depthOnly)
+		{
+			++mStats.descriptorTableSkipped;
+		}
+		else if (packet.textureTable != curTextureTable)
+		{
+			recorder.SetDescriptorTable(DrawRootParamTexture, packet.textureTable);
+			curTextureTable = packet.textureTable;
+			++mStats.descriptorTableSet;
+		}
+		else
+		{
+			++mStats.descriptorTableSkipped;
+		}
+
+		if (depthOnly || packet.samplerTable == 0)
+		{
+			++mStats.samplerTableSkipped;
+		}
+		else if (packet.samplerTable != curSamplerTable)
+		{
+			recorder.SetDescriptorTable(DrawRootParamSampler, packet.samplerTable);
+			curSamplerTable = packet.samplerTable;
+			++mStats.samplerTableSet;
+		}
+		else
+		{
+			++mStats.samplerTableSkipped;
+		}
+
+		// マテリアルが変わっても、同じモデルならテーブルはそのままで番号だけを積み直す
+		if (depthOnly || packet.materialTable == 0)
+		{
+			++mStats.materialTableSkipped;
+			++mStats.materialIndexSkipped;
+		}
+		else
+		{
+			if (packet.materialTable != curMaterialTable)
+			{
+				recorder.SetDescriptorTable(DrawRootParamMaterialTable, packet.materialTable);
+				curMaterialTable = packet.materialTable;
+				++mStats.materialTableSet;
+			}
+			else
+			{
+				++mStats.materialTableSkipped;
+			}
+
+			if (!materialIndexBound || packet.materialIndex != curMaterialIndex)
+			{
+				recorder.SetConstants(DrawRootParamMaterialIndex, 1, &packet.materialIndex);
+				curMaterialIndex = packet.materialIndex;
+				materialIndexBound = true;
+				++mStats.materialIndexSet;
+			}
+			else
+			{
+				++mStats.materialIndexSkipped;
+			}
+		}
+
+		if (packet.constantBuffer != curConstantBuffer)
+		{
+			recorder.SetConstantBuffer(DrawRootParamFrame, packet.constantBuffer);
+			curConstantBuffer = packet.constantBuffer;
+			++mStats.rootCbvSet;
+		}
+		else
+		{
+			++mStats.rootCbvSkipped;
+		}
+
+		// 直前に積んだ値と中身が同じなら積み直さない
+		bool sameRootConstants = curRootConstants != nullptr &&
+			curRootConstants->rootConstantCount == packet.rootConstantCount &&
+			std::memcmp(curRootConstants->rootConstants, packet.rootConstants, packet.rootConstantCount * sizeof(uint32_t)) == 0;
+
+		if (packet.rootConstantCount != 0 && !sameRootConstants)
+		{
+			recorder.SetConstants(DrawRootParamDraw, packet.rootConstantCount, packet.rootConstants);
+			curRootConstants = &packet;
+			++mStats.rootConstantsSet;
+		}
+		else
+		{
+			++mStats.rootConstantsSkipped;
+		}
+
+		if (packet.vbView != curVbView)
+		{
+			recorder.SetVertexBuffer(packet.vbView);
+			curVbView = packet.vbView;
+			++mStats.vertexBufferSet;
+		}
+		else
+		{
+			++mStats.vertexBufferSkipped;
+		}
+
+		if (packet.ibView != curIbView)
+		{
+			recorder.SetIndexBuffer(packet.ibView);
+			curIbView = packet.ibView;
+			++mStats.indexBufferSet;
+		}
+		else
+		{
+			++mStats.indexBufferSkipped;
+		}
+
+		recorder.DrawIndexed(packet.indexCount, packet.startIndex, packet.baseVertex);
+
+		if (depthOnly)
+		{
+			++mStats.depthOnlyDrawCount;
+		}
+		else
+		{
+			++mStats.drawCount;
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#include "DrawPacket.h"
+
+#include <d3d12.h>
+
+namespace
+{
+	// DrawPacketQueue::Recordの呼び出しをD3D12のコマンドリストへ積む
+	class CommandListRecorder
+	{
+	public:
+
+		explicit CommandListRecorder(ID3D12GraphicsCommandList* cmdList)
+			: mCmdList(cmdList)
+		{
+		}
+
+		void SetTriangleList()
+		{
+			mCmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		}
+
+		void SetPipelineState(ID3D12PipelineState* pipelineState)
+		{
+			mCmdList->SetPipelineState(pipelineState);
+		}
+
+		void SetRootSignature(ID3D12RootSignature* rootSignature)
+		{
+			mCmdList->SetGraphicsRootSignature(rootSignature);
+		}
+
+		void SetDescriptorHeaps(ID3D12DescriptorHeap* descriptorHeap, ID3D12DescriptorHeap* samplerHeap)
+		{
+			ID3D12DescriptorHeap* heaps[] = { descriptorHeap, samplerHeap };
+			mCmdList->SetDescriptorHeaps(samplerHeap != nullptr ? 2 : 1, heaps);
+		}
+
+		void SetDescriptorTable(uint32_t rootIndex, uint64_t table)
+		{
+			D3D12_GPU_DESCRIPTOR_HANDLE handle = {};
+			handle.ptr = table;
+			mCmdList->SetGraphicsRootDescriptorTable(rootIndex, handle);
+		}
+
+		void SetConstantBuffer(uint32_t rootIndex, uint64_t address)
+		{
+			mCmdList->SetGraphicsRootConstantBufferView(rootIndex, address);
+		}
+
+		void SetConstants(uint32_t rootIndex, uint32_t count, const void* values)
+		{
+			mCmdList->SetGraphicsRoot32BitConstants(rootIndex, count, values, 0);
+		}
+
+		void SetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW* view)
+		{
+			mCmdList->IASetVertexBuffers(0, 1, view);
+		}
+
+		void SetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+		{
+			mCmdList->IASetIndexBuffer(view);
+		}
+
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+		{
+			mCmdList->DrawIndexedInstanced(indexCount, 1, startIndex, baseVertex, 0);
+		}
+
+	private:
+
+		ID3D12GraphicsCommandList* mCmdList = nullptr;
+	};
+}
+
+void DrawPacketQueue::Submit(ID3D12GraphicsCommandList* cmdList)
+{
+	CommandListRecorder recorder(cmdList);
+	Record(recorder, false);
+}
+
+void DrawPacketQueue::SubmitDepthOnly(ID3D12GraphicsCommandList* cmdList)
+{
+	CommandListRecorder recorder(cmdList);
+	Record(recorder, true);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+// GPUが使い終わるまで解放を遅らせるキュー
+// 最後に使われたフレームのフェンス値と一緒に積み、フェンスがそこを越えたら破棄する
+template<typename T>
+class DeferredReleaseQueue
+{
+public:
+
+	DeferredReleaseQueue() = default;
+	~DeferredReleaseQueue() = default;
+
+	DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+	DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+	// フェンス値は単調増加で積むこと
+	void Push(T&& item, uint64_t fenceValue)
+	{
+		assert((mEntries.empty() || mEntries.back().fenceValue <= fenceValue) && "フェンス値が逆行しています");
+
+		mEntries.push_back({ fenceValue, std::move(item) });
+	}
+
+	// completedValue以下のフェンス値を持つものを破棄し、破棄した数を返す
+	size_t Collect(uint64_t completedValue)
+	{
+		size_t released = 0;
+
+		while (!mEntries.empty() && mEntries.front().fenceValue <= completedValue)
+		{
+			mEntries.pop_front();
+			++released;
+		}
+
+		return released;
+	}
+
+	// GPUがアイドルになった後(終了時など)に全て破棄する
+	void Flush()
+	{
+		mEntries.clear();
+	}
+
+	size_t Size() const { return mEntries.size(); }
+	bool Empty() const { return mEntries.empty(); }
+
+private:
+
+	struct Entry
+	{
+		uint64_t fenceValue;
+		T item;
+	};
+
+	std::deque<Entry> mEntries;
+};
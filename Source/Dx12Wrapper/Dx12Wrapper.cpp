@@ -12,7 +12,7 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 	debugLayer->Release();
 #endif 
 
-	// foCX̏
+	// デバイスの初期化
 	D3D_FEATURE_LEVEL levels[] =
 	{
 		D3D_FEATURE_LEVEL_12_2,
@@ -33,7 +33,7 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 		}
 	}
 
-	// t@Ng[̏
+	// ファクトリーの初期化
 #ifdef _DEBUG
 	result = CreateDXGIFactory2(DXGI_CREATE_FACTORY_DEBUG, IID_PPV_ARGS(mDXGIFactory.ReleaseAndGetAddressOf()));
 #else 
@@ -42,49 +42,109 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 
 	if (FAILED(result))
 	{
-		assert(false && "t@Ng[쐬s");
+		assert(false && "ファクトリー作成失敗");
 		return;
 	}
 
-	// R}hAP[^̍쐬
-	result = mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(mCmdAllocator.ReleaseAndGetAddressOf()));
-
-	if (FAILED(result))
+	// コマンドアロケータの作成
+	// GPUが前のフレームを実行している間に次のフレームを記録するので、フレーム毎に持つ
+	for (auto& allocator : mCmdAllocators)
 	{
-		assert(false && "R}hAP[^[쐬s");
-		return;
+		result = mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(allocator.ReleaseAndGetAddressOf()));
+
+		if (FAILED(result))
+		{
+			assert(false && "コマンドアロケーター作成失敗");
+			return;
+		}
 	}
 
-	// R}hXg쐻
-	result = mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCmdAllocator.Get(), nullptr, IID_PPV_ARGS(mCmdList.ReleaseAndGetAddressOf()));
+	// コマンドリストを作製
+	result = mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, mCmdAllocators[mFrameIndex].Get(), nullptr, IID_PPV_ARGS(mCmdList.ReleaseAndGetAddressOf()));
 
 	if (FAILED(result))
 	{
-		assert(false && "R}hXg쐬s");
+		assert(false && "コマンドリスト作成失敗");
 		return;
 	}
 
 	D3D12_COMMAND_QUEUE_DESC cmdQueueDesc = {};
 
-	// ^CAEgȂ
+	// タイムアウトなし
 	cmdQueueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
 
-	// A_v^[g0őv
+	// アダプターを一つ使うと0で大丈夫
 	cmdQueueDesc.NodeMask = 0;
 
-	// vCIeB͎w肵Ȃ
+	// プライオリティは指定しない
 	cmdQueueDesc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
 
-	// R}hXgɍ킹
+	// コマンドリストに合わせる
 	cmdQueueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
 
 	result = mDevice->CreateCommandQueue(&cmdQueueDesc, IID_PPV_ARGS(mCmdQueue.ReleaseAndGetAddressOf()));
 	if (FAILED(result))
 	{
-		assert(false && "R}hL[쐬s");
+		assert(false && "コマンドキュー作成失敗");
 		return;
 	}
 
+	// ヘッドレスではスワップチェーンを作らない
+	if (hwnd != nullptr)
+	{
+		result = CreateSwapChain(hwnd);
+
+		if (FAILED(result))
+		{
+			assert(false && "スワップチェイン作成失敗");
+			return;
+		}
+	}
+
+	// デスクリプタヒープの作成(レンダーターゲット用)
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+	heapDesc.NodeMask = 0;
+	heapDesc.NumDescriptors = 2;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+	result = mDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(mRtvHeaps.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "ディスクリプタヒープ作成失敗");
+		return;
+	}
+
+	result = mDevice->CreateFence(mFenceVal, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(mFence.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "フェンス作成失敗");
+		return;
+	}
+	// 1フレームで計測するGPU区間の上限
+	mGpuProfiler.Init(mDevice.Get(), mCmdQueue.Get(), 64, FrameCount);
+
+	// オフスクリーンのターゲットもここから確保するので、ビューより先に初期化する
+	mMemoryAllocator.Init(mDevice.Get());
+
+	if (!CreateBackBufferViews())
+	{
+		return;
+	}
+
+	UpdateViewport();
+
+	if (!CreateDepthBuffer())
+	{
+		return;
+	}
+}
+
+HRESULT Dx12Wrapper::CreateSwapChain(const HWND& hwnd)
+{
 	DXGI_SWAP_CHAIN_DESC1 swapchainDesc = {};
 
 	swapchainDesc.Width = Application::Instance().GetWindowSize().cx;
@@ -94,54 +154,111 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 	swapchainDesc.SampleDesc.Count = 1;
 	swapchainDesc.SampleDesc.Quality = 0;
 	swapchainDesc.BufferUsage = DXGI_USAGE_BACK_BUFFER;
-	swapchainDesc.BufferCount = 2; // _uobt@OȂ̂2
+	swapchainDesc.BufferCount = 2; // ダブルバッファリングなので2
 
-	// obNobt@͐Lяk݉\
+	// バックバッファは伸び縮み可能
 	swapchainDesc.Scaling = DXGI_SCALING_STRETCH;
 
 	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	swapchainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
 
-	// EBhE[hƃtXN[[hؑ։\
+	// ウィンドウモードとフルスクリーンモード切替可能
 	swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 
-	result = mDXGIFactory->CreateSwapChainForHwnd(mCmdQueue.Get(), hwnd, &swapchainDesc, nullptr, nullptr, (IDXGISwapChain1**)mSwapChain.ReleaseAndGetAddressOf());
+	return mDXGIFactory->CreateSwapChainForHwnd(mCmdQueue.Get(), hwnd, &swapchainDesc, nullptr, nullptr, (IDXGISwapChain1**)mSwapChain.ReleaseAndGetAddressOf());
+}
 
-	if (FAILED(result))
+Dx12Wrapper::~Dx12Wrapper()
+{
+	// 実行中のフレームが使っているリソースを解放しないよう、先に全て待つ
+	if (mCmdQueue && mFence)
 	{
-		assert(false && "Xbv`FC쐬s");
-		return;
+		WaitForGpu();
 	}
 
-	// fXNv^q[v̍쐬(_[^[Qbgp)
-	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+	mMemoryAllocator.Free(mDepthBuffer);
 
-	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-	heapDesc.NodeMask = 0;
-	heapDesc.NumDescriptors = 2;
-	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	mBackBuffers.clear();
+	mMemoryAllocator.Free(mOffscreenTarget);
 
-	result = mDevice->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(mRtvHeaps.ReleaseAndGetAddressOf()));
+	// GPUはアイドルなので、フェンス値に関係なく全て解放してよい
+	mReleaseQueue.Flush();
+}
 
-	if (FAILED(result))
+void Dx12Wrapper::DeferredRelease(ComPtr<IUnknown> resource)
+{
+	DeferredRelease(std::move(resource), GetCurrentFenceValue());
+}
+
+void Dx12Wrapper::DeferredRelease(ComPtr<IUnknown> resource, UINT64 lastUsedFenceValue)
+{
+	if (resource == nullptr)
+	{
+		return;
+	}
+
+	mReleaseQueue.Push(std::move(resource), lastUsedFenceValue);
+}
+
+void Dx12Wrapper::ShowErrorMessage(HRESULT result, ID3DBlob* errorBlob)
+{
+	if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
 	{
-		assert(false && "fBXNv^q[v쐬s");
+		OutputDebugStringA("ファイルが見つかりません");
 		return;
 	}
+	else
+	{
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+
+		std::copy_n((char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+
+		OutputDebugStringA(errstr.c_str());
+	}
+}
+
+DirectX::XMMATRIX Dx12Wrapper::GetViewMatrix() const
+{
+	return DirectX::XMMatrixLookAtLH(DirectX::XMLoadFloat3(&mEye), DirectX::XMLoadFloat3(&mTarget), DirectX::XMLoadFloat3(&mUp));
+}
+
+DirectX::XMMATRIX Dx12Wrapper::GetProjectionMatrix() const
+{
+	SIZE windowSize = Application::Instance().GetWindowSize();
+
+	float aspect = static_cast<float>(windowSize.cx) / static_cast<float>(windowSize.cy);
+
+	// ニアとファーを入れ替えると深度が反転し、浮動小数点の精度が奥まで均等に近くなる
+	if (mReverseZ)
+	{
+		return DirectX::XMMatrixPerspectiveFovLH(mFovAngleY, aspect, mFarZ, mNearZ);
+	}
+
+	return DirectX::XMMatrixPerspectiveFovLH(mFovAngleY, aspect, mNearZ, mFarZ);
+}
+
+bool Dx12Wrapper::CreateBackBufferViews()
+{
+	if (IsHeadless())
+	{
+		return CreateOffscreenTarget();
+	}
 
 	DXGI_SWAP_CHAIN_DESC swcDesc = {};
-	result = mSwapChain->GetDesc(&swcDesc);
+	auto result = mSwapChain->GetDesc(&swcDesc);
 
 	if (FAILED(result))
 	{
-		assert(false && "Xbv`F[p[^擾s");
-		return;
+		assert(false && "スワップチェーンパラメータ取得失敗");
+		return false;
 	}
 
 	mBackBuffers.resize(swcDesc.BufferCount);
 
 	D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = {};
-	rtvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	rtvDesc.Format = BackBufferFormat;
 	rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
 
 	D3D12_CPU_DESCRIPTOR_HANDLE handle = mRtvHeaps->GetCPUDescriptorHandleForHeapStart();
@@ -152,21 +269,64 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 
 		if (FAILED(result))
 		{
-			assert(false && "_[^[QbgƃXbv`F[̕RÂs");
-			return;
+			assert(false && "レンダーターゲットとスワップチェーンの紐づけ失敗");
+			return false;
 		}
 
 		mDevice->CreateRenderTargetView(mBackBuffers[idx].Get(), &rtvDesc, handle);
 		handle.ptr += mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
 	}
 
+	return true;
+}
+
+bool Dx12Wrapper::CreateOffscreenTarget()
+{
+	SIZE windowSize = Application::Instance().GetWindowSize();
+
+	D3D12_RESOURCE_DESC resDesc = {};
+	resDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	resDesc.Width = windowSize.cx;
+	resDesc.Height = windowSize.cy;
+	resDesc.DepthOrArraySize = 1;
+	resDesc.Format = BackBufferFormat;
+	resDesc.SampleDesc.Count = 1;
+	resDesc.SampleDesc.Quality = 0;
+	resDesc.MipLevels = 1;
+	resDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	resDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+	D3D12_CLEAR_VALUE clearValue = {};
+	clearValue.Format = BackBufferFormat;
+	clearValue.Color[3] = 1.0F;
+
+	// スワップチェーンのバッファと同じく、描いていない間はPRESENT(COMMON)にしておく
+	if (!mMemoryAllocator.CreateTexture(resDesc, D3D12_RESOURCE_STATE_PRESENT, &clearValue, mOffscreenTarget))
+	{
+		assert(false && "オフスクリーンターゲット作成失敗");
+		return false;
+	}
+
+	mBackBuffers = { mOffscreenTarget.resource };
+
+	mDevice->CreateRenderTargetView(mOffscreenTarget.resource.Get(), nullptr, mRtvHeaps->GetCPUDescriptorHandleForHeapStart());
 
+	return true;
+}
+
+UINT Dx12Wrapper::CurrentBackBufferIndex() const
+{
+	return IsHeadless() ? 0 : mSwapChain->GetCurrentBackBufferIndex();
+}
+
+void Dx12Wrapper::UpdateViewport()
+{
 	if (!mViewport)
 	{
 		mViewport = std::make_unique<D3D12_VIEWPORT>();
 	}
 
-	// r[|[gƃVU[`
+	// ビューポートとシザー矩形
 	*mViewport = {};
 	mViewport->Width = Application::Instance().GetWindowSize().cx;
 	mViewport->Height = Application::Instance().GetWindowSize().cy;
@@ -184,45 +344,72 @@ Dx12Wrapper::Dx12Wrapper(HWND hwnd)
 	mScissorRect->left = 0;
 	mScissorRect->right = mScissorRect->left + Application::Instance().GetWindowSize().cx;
 	mScissorRect->bottom = mScissorRect->top + Application::Instance().GetWindowSize().cy;
-
-	result = mDevice->CreateFence(mFenceVal, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(mFence.ReleaseAndGetAddressOf()));
-
-	if (FAILED(result))
-	{
-		assert(false && "tFX쐬s");
-		return;
-	}
 }
 
-Dx12Wrapper::~Dx12Wrapper()
+D3D12_CPU_DESCRIPTOR_HANDLE Dx12Wrapper::GetDepthStencilView() const
 {
+	return mDsvHeap->GetCPUDescriptorHandleForHeapStart();
 }
 
-void Dx12Wrapper::ShowErrorMessage(HRESULT result, ID3DBlob* errorBlob)
+bool Dx12Wrapper::CreateDepthBuffer()
 {
-	if (result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
+	SIZE windowSize = Application::Instance().GetWindowSize();
+
+	D3D12_RESOURCE_DESC depthResDesc = {};
+	depthResDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	depthResDesc.Width = windowSize.cx;
+	depthResDesc.Height = windowSize.cy;
+	depthResDesc.DepthOrArraySize = 1;
+	depthResDesc.Format = DepthFormat;
+	depthResDesc.SampleDesc.Count = 1;
+	depthResDesc.SampleDesc.Quality = 0;
+	depthResDesc.MipLevels = 1;
+	depthResDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	depthResDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+	D3D12_CLEAR_VALUE depthClearValue = {};
+	depthClearValue.Format = DepthFormat;
+	depthClearValue.DepthStencil.Depth = GetDepthClearValue();
+	depthClearValue.DepthStencil.Stencil = 0;
+
+	if (!mMemoryAllocator.CreateTexture(depthResDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &depthClearValue, mDepthBuffer))
 	{
-		OutputDebugStringA("t@C܂");
-		return;
+		assert(false && "深度バッファ作成失敗");
+		return false;
 	}
-	else
+
+	if (!mDsvHeap)
 	{
-		std::string errstr;
-		errstr.resize(errorBlob->GetBufferSize());
+		D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
+		dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+		dsvHeapDesc.NodeMask = 0;
+		dsvHeapDesc.NumDescriptors = 1;
+		dsvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
-		std::copy_n((char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
-		errstr += "\n";
+		auto result = mDevice->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(mDsvHeap.ReleaseAndGetAddressOf()));
 
-		OutputDebugStringA(errstr.c_str());
+		if (FAILED(result))
+		{
+			assert(false && "深度用ディスクリプタヒープ作成失敗");
+			return false;
+		}
 	}
+
+	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+	dsvDesc.Format = DepthFormat;
+	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+	dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+
+	mDevice->CreateDepthStencilView(mDepthBuffer.resource.Get(), &dsvDesc, mDsvHeap->GetCPUDescriptorHandleForHeapStart());
+
+	return true;
 }
 
 void Dx12Wrapper::Clear()
 {
-	int bbIdx = mSwapChain->GetCurrentBackBufferIndex();
+	int bbIdx = CurrentBackBufferIndex();
 
-	D3D12_CPU_DESCRIPTOR_HANDLE rtvH = mRtvHeaps->GetCPUDescriptorHandleForHeapStart();
-	rtvH.ptr += bbIdx * mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvH = GetCurrentBackBufferView();
 
 	D3D12_RESOURCE_BARRIER BarrierDesc = {};
 	BarrierDesc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -234,54 +421,141 @@ void Dx12Wrapper::Clear()
 
 	mCmdList->ResourceBarrier(1, &BarrierDesc);
 
-	mCmdList->OMSetRenderTargets(1, &rtvH, true, nullptr);
+	D3D12_CPU_DESCRIPTOR_HANDLE dsvH = GetDepthStencilView();
+
+	mCmdList->OMSetRenderTargets(1, &rtvH, true, &dsvH);
 
 	float clearColor[] = { 0.0F, 0.0F, 0.0F, 1.0F };
 	mCmdList->ClearRenderTargetView(rtvH, clearColor, 0, nullptr);
+	mCmdList->ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, GetDepthClearValue(), 0, 0, nullptr);
 }
 
 void Dx12Wrapper::Update()
 {
-	int bbIdx = mSwapChain->GetCurrentBackBufferIndex();
-
 	mCmdList->RSSetViewports(1, mViewport.get());
 	mCmdList->RSSetScissorRects(1, mScissorRect.get());
 }
 
 void Dx12Wrapper::EndDraw()
 {
-	int bbIdx = mSwapChain->GetCurrentBackBufferIndex();
+	int bbIdx = CurrentBackBufferIndex();
 
 	D3D12_RESOURCE_BARRIER BarrierDesc = {};
 	BarrierDesc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
 	BarrierDesc.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
 	BarrierDesc.Transition.pResource = mBackBuffers[bbIdx].Get();
 
-	BarrierDesc.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	BarrierDesc.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
 	BarrierDesc.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
 
+	mCmdList->ResourceBarrier(1, &BarrierDesc);
+
+	mGpuProfiler.Resolve(mCmdList.Get(), mFrameIndex);
+
 	mCmdList->Close();
 
 	ID3D12CommandList* cmdlists[] = { mCmdList.Get() };
 	mCmdQueue->ExecuteCommandLists(1, cmdlists);
 
-	mCmdList->ResourceBarrier(1, &BarrierDesc);
+	if (!IsHeadless())
+	{
+		mSwapChain->Present(1, 0);
+	}
 
+	// このフレームの完了を知らせるフェンス値を積む(ここでは待たない)
 	mCmdQueue->Signal(mFence.Get(), ++mFenceVal);
+	mFrameFenceValues[mFrameIndex] = mFenceVal;
+
+	// 次のフレームで使うアロケータは、FrameCountフレーム前に同じ番号で記録したコマンドが使っている
+	// そのフレームの完了だけを待つので、直前のフレームはGPUで実行されたまま次の記録に進める
+	mFrameIndex = (mFrameIndex + 1) % FrameCount;
+	WaitForFence(mFrameFenceValues[mFrameIndex]);
+
+	mGpuProfiler.Collect(mFrameIndex);
+
+	// GPUが通過したフェンスまでのリソースを解放する
+	mReleaseQueue.Collect(mFence->GetCompletedValue());
+
+	mCmdAllocators[mFrameIndex]->Reset();
+	mCmdList->Reset(mCmdAllocators[mFrameIndex].Get(), nullptr);
+}
+
+bool Dx12Wrapper::Resize()
+{
+	SIZE windowSize = Application::Instance().GetWindowSize();
+
+	// スワップチェーンのバッファを参照しているものが残っているとResizeBuffersが失敗する
+	WaitForGpu();
+
+	// アイドルになったので、実行中のフレームが参照していた遅延解放待ちのリソースも今解放できる
+	mReleaseQueue.Collect(mFence->GetCompletedValue());
+
+	mBackBuffers.clear();
+
+	if (IsHeadless())
+	{
+		mMemoryAllocator.Free(mOffscreenTarget);
+	}
+	else
+	{
+		DXGI_SWAP_CHAIN_DESC1 swapchainDesc = {};
+		auto result = mSwapChain->GetDesc1(&swapchainDesc);
+
+		if (FAILED(result))
+		{
+			assert(false && "スワップチェーンパラメータ取得失敗");
+			return false;
+		}
+
+		result = mSwapChain->ResizeBuffers(swapchainDesc.BufferCount, windowSize.cx, windowSize.cy, swapchainDesc.Format, swapchainDesc.Flags);
 
-	if (mFence->GetCompletedValue() != mFenceVal)
+		if (FAILED(result))
+		{
+			assert(false && "スワップチェーンのリサイズ失敗");
+			return false;
+		}
+	}
+
+	if (!CreateBackBufferViews())
 	{
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
+		return false;
+	}
 
-		mFence->SetEventOnCompletion(mFenceVal, event);
+	UpdateViewport();
+
+	// デバイスはそのままで、深度バッファだけ作り直す
+	mMemoryAllocator.Free(mDepthBuffer);
+
+	return CreateDepthBuffer();
+}
+
+void Dx12Wrapper::WaitForGpu()
+{
+	mCmdQueue->Signal(mFence.Get(), ++mFenceVal);
 
-		WaitForSingleObject(event, INFINITE);
+	WaitForFence(mFenceVal);
+}
 
-		CloseHandle(event);
+void Dx12Wrapper::WaitForFence(UINT64 value)
+{
+	if (mFence->GetCompletedValue() >= value)
+	{
+		return;
 	}
 
-	mCmdAllocator->Reset();
-	mCmdList->Reset(mCmdAllocator.Get(), nullptr);
+	HANDLE event = CreateEvent(nullptr, false, false, nullptr);
+
+	mFence->SetEventOnCompletion(value, event);
+
+	WaitForSingleObject(event, INFINITE);
 
-	mSwapChain->Present(1, 0);
-}
\ No newline at end of file
+	CloseHandle(event);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE Dx12Wrapper::GetCurrentBackBufferView() const
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvH = mRtvHeaps->GetCPUDescriptorHandleForHeapStart();
+	rtvH.ptr += CurrentBackBufferIndex() * mDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+
+	return rtvH;
+}
@@ -12,6 +12,10 @@
 
 #include <memory>
 
+#include "DeferredReleaseQueue.h"
+#include "../GpuMemory/GpuMemoryAllocator.h"
+#include "../Profiler/GpuProfiler.h"
+
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
 
@@ -24,40 +28,114 @@ private:
 
 public:
 
+	// CPUがGPUより先行して記録できるフレーム数(コマンドアロケータとフェンス値をこの数だけ持つ)
+	static const UINT FrameCount = 2;
+
+	// hwndがnullptrならスワップチェーンを作らず、オフスクリーンのターゲットに描く(ヘッドレス)
 	Dx12Wrapper(HWND hwnd);
 	~Dx12Wrapper();
 
-	void ShowErrorMessage(HRESULT result, ID3DBlob* errorBlob);
+	static void ShowErrorMessage(HRESULT result, ID3DBlob* errorBlob);
 
 	void Clear();
 	void Update();
 	void EndDraw();
 
+	// ウィンドウサイズが変わった時、フレームの間に呼ぶ
+	bool Resize();
+
 	ComPtr<ID3D12Device> Device() const { return mDevice; }
 	ComPtr<ID3D12GraphicsCommandList> CommandList() const { return mCmdList; }
 	ComPtr<IDXGISwapChain4> SwapChain() const { return mSwapChain; }
+	GpuProfiler& GetGpuProfiler() { return mGpuProfiler; }
+	GpuMemoryAllocator& GetMemoryAllocator() { return mMemoryAllocator; }
+	ID3D12Fence* GetFence() const { return mFence.Get(); }
+	bool IsHeadless() const { return mSwapChain == nullptr; }
+
+	// 現在記録中のコマンドリストが完了した時に通過するフェンス値
+	UINT64 GetCurrentFenceValue() const { return mFenceVal + 1; }
+
+	// 記録中のフレームの番号(0～FrameCount-1)。CPUが毎フレーム書き換えるバッファはこれで使い分ける
+	UINT GetFrameIndex() const { return mFrameIndex; }
+
+	// 今フレームまで使われるリソースをGPUの完了後に解放する
+	void DeferredRelease(ComPtr<IUnknown> resource);
+	void DeferredRelease(ComPtr<IUnknown> resource, UINT64 lastUsedFenceValue);
 
 	DirectX::XMMATRIX GetViewMatrix() const;
 	DirectX::XMMATRIX GetProjectionMatrix() const;
 
+	DXGI_FORMAT GetBackBufferFormat() const { return BackBufferFormat; }
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCurrentBackBufferView() const;
+
+	// Clear～EndDrawの間はRENDER_TARGETの状態
+	ID3D12Resource* GetCurrentBackBuffer() const { return mBackBuffers[CurrentBackBufferIndex()].Get(); }
+	const D3D12_VIEWPORT& GetViewport() const { return *mViewport; }
+	const D3D12_RECT& GetScissorRect() const { return *mScissorRect; }
+
+	// 深度バッファ
+	// リバースZ(手前が1、奥が0)なので、クリアは0、比較はGREATER_EQUAL
+	DXGI_FORMAT GetDepthFormat() const { return DepthFormat; }
+	bool IsReverseZ() const { return mReverseZ; }
+	float GetDepthClearValue() const { return mReverseZ ? 0.0F : 1.0F; }
+	D3D12_COMPARISON_FUNC GetDepthComparison() const { return mReverseZ ? D3D12_COMPARISON_FUNC_GREATER_EQUAL : D3D12_COMPARISON_FUNC_LESS_EQUAL; }
+	D3D12_CPU_DESCRIPTOR_HANDLE GetDepthStencilView() const;
+
 private:
 
 	HRESULT InitializeDXGIDevice();
 	HRESULT InitializeCommand();
 	HRESULT CreateSwapChain(const HWND& hwnd);
+	bool CreateBackBufferViews();
+	bool CreateOffscreenTarget();
+	UINT CurrentBackBufferIndex() const;
+	void UpdateViewport();
+	bool CreateDepthBuffer();
+
+	// 実行中のコマンドを全て待つ
+	void WaitForGpu();
+
+	// フェンスがvalueを通過するまで待つ
+	void WaitForFence(UINT64 value);
+
+	static const DXGI_FORMAT BackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	static const DXGI_FORMAT DepthFormat = DXGI_FORMAT_D32_FLOAT;
 
 	SIZE mWindowSize;
 
 	ComPtr<IDXGIFactory6> mDXGIFactory = nullptr;
 	ComPtr<ID3D12Device> mDevice = nullptr;
-	ComPtr<ID3D12CommandAllocator> mCmdAllocator = nullptr;
+	ComPtr<ID3D12CommandAllocator> mCmdAllocators[FrameCount];
 	ComPtr<ID3D12GraphicsCommandList> mCmdList = nullptr;
 	ComPtr<ID3D12CommandQueue> mCmdQueue = nullptr;
 	ComPtr<IDXGISwapChain4> mSwapChain = nullptr;
 	ComPtr<ID3D12DescriptorHeap> mRtvHeaps = nullptr;
 	std::vector<ComPtr<ID3D12Resource>> mBackBuffers;
+
+	// ヘッドレスの時にバックバッファの代わりにするテクスチャ
+	GpuAllocation mOffscreenTarget;
+	ComPtr<ID3D12DescriptorHeap> mDsvHeap = nullptr;
+	GpuAllocation mDepthBuffer;
+	bool mReverseZ = true;
 	std::unique_ptr<D3D12_VIEWPORT> mViewport;
 	std::unique_ptr<D3D12_RECT> mScissorRect;
 	ComPtr<ID3D12Fence> mFence = nullptr;
 	UINT64 mFenceVal = 0;
+
+	// フレーム毎の、そのフレームのコマンドが完了した時に通過するフェンス値
+	UINT64 mFrameFenceValues[FrameCount] = {};
+	UINT mFrameIndex = 0;
+
+	DeferredReleaseQueue<ComPtr<IUnknown>> mReleaseQueue;
+
+	GpuProfiler mGpuProfiler;
+	GpuMemoryAllocator mMemoryAllocator;
+
+	// カメラ
+	DirectX::XMFLOAT3 mEye = { 0.0F, 0.0F, -5.0F };
+	DirectX::XMFLOAT3 mTarget = { 0.0F, 0.0F, 0.0F };
+	DirectX::XMFLOAT3 mUp = { 0.0F, 1.0F, 0.0F };
+	float mFovAngleY = DirectX::XM_PIDIV2;
+	float mNearZ = 1.0F;
+	float mFarZ = 10.0F;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// 積分の暴走を防ぐ上限
+	constexpr double IntegralLimit = 4.0;
+
+	// 1フレームで変える面積の上限(±)
+	constexpr double MaxAreaChange = 0.25;
+}
+
+DynamicResolution::DynamicResolution(const Settings& settings)
+	: mSettings(settings)
+{
+	Reset();
+}
+
+float DynamicResolution::Update(double gpuMs)
+{
+	if (gpuMs <= 0.0 || mSettings.targetMs <= 0.0)
+	{
+		return mScale;
+	}
+
+	// 1フレームのばらつきで倍率が揺れないよう平均を取る
+	mSmoothedMs = (mSmoothedMs <= 0.0) ? gpuMs : mSmoothedMs + (gpuMs - mSmoothedMs) * mSettings.smoothing;
+
+	// 正なら余裕がある、負なら間に合っていない
+	double error = (mSettings.targetMs - mSmoothedMs) / mSettings.targetMs;
+	double derivative = mHasPrevError ? error - mPrevError : 0.0;
+	mPrevError = error;
+	mHasPrevError = true;
+
+	if (std::abs(error) < mSettings.deadband)
+	{
+		return mScale;
+	}
+
+	double integral = std::clamp(mIntegral + error, -IntegralLimit, IntegralLimit);
+
+	double output = mSettings.kp * error + mSettings.ki * integral + mSettings.kd * derivative;
+	output = std::clamp(output, -MaxAreaChange, MaxAreaChange);
+
+	double area = mContinuousScale * mContinuousScale * (1.0 + output);
+	double scale = std::sqrt(std::max(area, 0.0));
+	double clamped = std::clamp(scale, static_cast<double>(mSettings.minScale), static_cast<double>(mSettings.maxScale));
+
+	// 上限・下限に張り付いている間は積分しない(アンチワインドアップ)
+	if (clamped == scale)
+	{
+		mIntegral = integral;
+	}
+
+	mContinuousScale = clamped;
+
+	// 刻みに丸め、1刻み以上離れた時だけ倍率を変える(境目でのばたつき防止)
+	double step = static_cast<double>(mSettings.step);
+	double quantized = std::round(mContinuousScale / step) * step;
+	quantized = std::clamp(quantized, static_cast<double>(mSettings.minScale), static_cast<double>(mSettings.maxScale));
+
+	bool atLimit = (clamped != scale);
+
+	if (std::abs(mContinuousScale - static_cast<double>(mScale)) >= step || (atLimit && quantized != static_cast<double>(mScale)))
+	{
+		mScale = static_cast<float>(quantized);
+	}
+
+	return mScale;
+}
+
+void DynamicResolution::Reset()
+{
+	mScale = mSettings.maxScale;
+	mContinuousScale = mSettings.maxScale;
+	mSmoothedMs = 0.0;
+	mIntegral = 0.0;
+	mPrevError = 0.0;
+	mHasPrevError = false;
+}
+
+unsigned int DynamicResolution::ScaledSize(unsigned int fullSize) const
+{
+	unsigned int size = static_cast<unsigned int>(std::lround(static_cast<double>(fullSize) * mScale));
+
+	return std::clamp(size, 1U, std::max(fullSize, 1U));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// GPU時間が目標に収まるよう、描画解像度の倍率を決める
+// 負荷はおおよそピクセル数(倍率の2乗)に比例するとみなし、面積に対してPID制御する
+class DynamicResolution
+{
+public:
+
+	struct Settings
+	{
+		double targetMs = 14.0;		// 60fpsから少し余裕を持たせる
+		float minScale = 0.5F;
+		float maxScale = 1.0F;
+
+		double kp = 0.5;
+		double ki = 0.05;
+		double kd = 0.1;
+
+		// GPU時間の指数移動平均の係数(1なら平均しない)
+		double smoothing = 0.25;
+
+		// 目標との差がこの割合以内なら倍率を動かさない
+		double deadband = 0.05;
+
+		// 倍率はこの刻みでしか変えない(毎フレームの揺れでターゲットが変わらないように)
+		float step = 1.0F / 32.0F;
+	};
+
+	DynamicResolution() = default;
+	explicit DynamicResolution(const Settings& settings);
+
+	// 前のフレームのGPU時間を渡し、次のフレームの倍率を返す
+	float Update(double gpuMs);
+
+	void Reset();
+
+	float Scale() const { return mScale; }
+	const Settings& GetSettings() const { return mSettings; }
+
+	// 縦横それぞれに倍率を掛けた大きさ(最低1)
+	unsigned int ScaledSize(unsigned int fullSize) const;
+
+private:
+
+	Settings mSettings;
+
+	float mScale = 1.0F;
+
+	// 量子化前の連続値
+	double mContinuousScale = 1.0;
+
+	double mSmoothedMs = 0.0;
+	double mIntegral = 0.0;
+	double mPrevError = 0.0;
+	bool mHasPrevError = false;
+};
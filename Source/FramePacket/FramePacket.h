@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Windows.h"
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+#include "SpscQueue.h"
+
+// ゲームスレッドが1フレーム分の状態をまとめ、描画スレッドへ渡す
+// 描画スレッドはこれ以外にゲーム側の状態を読まない
+struct FramePacket
+{
+	uint64_t frameIndex = 0;
+
+	// 作った時刻(受け渡しの遅延の計測用)
+	int64_t createdNs = 0;
+
+	// Runを始めてからの秒数。モーションの再生位置に使う
+	double time = 0.0;
+
+	// このフレームで使うクライアント領域の大きさ。変わっていれば描画スレッドでリサイズする
+	SIZE windowSize = {};
+
+	bool depthPrepass = false;
+	bool dynamicResolution = false;
+	bool indirectDraw = false;
+
+	DirectX::XMFLOAT4X4 world = {};
+};
+
+// ダブルバッファ。ゲームスレッドは描画スレッドより最大1フレーム先行する
+using FramePacketQueue = SpscQueue<FramePacket, 2>;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// 書き込み1スレッド・読み込み1スレッド専用のロックフリーなリングバッファ
+// 容量2ならダブルバッファとして使え、書き込み側は最大1つ先までしか進めない
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity > 0, "容量は1以上");
+
+public:
+
+	SpscQueue() = default;
+	~SpscQueue() = default;
+
+	// 書き込みスレッドから呼ぶ。満杯ならfalse
+	bool TryPush(const T& value)
+	{
+		size_t head = mHead.load(std::memory_order_relaxed);
+
+		if (head - mTailCache == Capacity)
+		{
+			// 読み込み側の位置を取り直してから満杯か判断する
+			mTailCache = mTail.load(std::memory_order_acquire);
+			if (head - mTailCache == Capacity)
+			{
+				return false;
+			}
+		}
+
+		mSlots[head % Capacity] = value;
+
+		// スロットへの書き込みを読み込み側に見せてから位置を進める
+		mHead.store(head + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// 読み込みスレッドから呼ぶ。空ならfalse
+	bool TryPop(T& value)
+	{
+		size_t tail = mTail.load(std::memory_order_relaxed);
+
+		if (tail == mHeadCache)
+		{
+			mHeadCache = mHead.load(std::memory_order_acquire);
+			if (tail == mHeadCache)
+			{
+				return false;
+			}
+		}
+
+		value = std::move(mSlots[tail % Capacity]);
+
+		mTail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	// どちらのスレッドからも呼べるが、戻った時点で変わっているかもしれない
+	size_t Size() const
+	{
+		return mHead.load(std::memory_order_acquire) - mTail.load(std::memory_order_acquire);
+	}
+
+	bool Empty() const { return Size() == 0; }
+	bool Full() const { return Size() >= Capacity; }
+
+private:
+
+	// 書き込み側と読み込み側の変数が同じキャッシュラインに乗らないようにする
+	static const size_t CacheLineSize = 64;
+
+	std::array<T, Capacity> mSlots = {};
+
+	// 書き込み側だけが書く
+	alignas(CacheLineSize) std::atomic<size_t> mHead = { 0 };
+	size_t mTailCache = 0;
+
+	// 読み込み側だけが書く
+	alignas(CacheLineSize) std::atomic<size_t> mTail = { 0 };
+	size_t mHeadCache = 0;
+};
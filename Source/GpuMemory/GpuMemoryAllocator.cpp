@@ -0,0 +1,362 @@
+#include "GpuMemoryAllocator.h"
+
+#include <d3dx12.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+struct GpuMemoryPage
+{
+	Microsoft::WRL::ComPtr<ID3D12Heap> heap = nullptr;
+
+	// 小さいバッファ用のページは、ページ全体を1つのバッファとして持つ
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer = nullptr;
+	UINT8* mapped = nullptr;
+
+	TlsfAllocator tlsf;
+};
+
+struct GpuMemoryPool
+{
+	const char* name;
+	D3D12_HEAP_TYPE heapType;
+	D3D12_HEAP_FLAGS heapFlags;
+	bool smallBuffer;
+	UINT64 heapAlignment;
+	UINT64 granularity;
+
+	std::vector<std::unique_ptr<GpuMemoryPage>> pages;
+	UINT64 requestedBytes = 0;
+};
+
+namespace
+{
+	UINT64 AlignUp(UINT64 value, UINT64 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// UPLOADとREADBACKは作成時のステートが決まっている
+	D3D12_RESOURCE_STATES RequiredState(D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_STATES initialState)
+	{
+		switch (heapType)
+		{
+		case D3D12_HEAP_TYPE_UPLOAD:
+			return D3D12_RESOURCE_STATE_GENERIC_READ;
+		case D3D12_HEAP_TYPE_READBACK:
+			return D3D12_RESOURCE_STATE_COPY_DEST;
+		default:
+			return initialState;
+		}
+	}
+}
+
+GpuMemoryAllocator::~GpuMemoryAllocator()
+{
+}
+
+bool GpuMemoryAllocator::Init(ID3D12Device* device)
+{
+	mDevice = device;
+
+	const UINT64 placement = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	const UINT64 msaaPlacement = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+	const UINT64 cbPlacement = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+	// リソースヒープTier1でも動くよう、バッファとテクスチャでヒープを分ける
+	GpuMemoryPool pools[] =
+	{
+		{ "Upload/Buffer",       D3D12_HEAP_TYPE_UPLOAD,   D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,            false, placement,     placement },
+		{ "Upload/Small",        D3D12_HEAP_TYPE_UPLOAD,   D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,            true,  placement,     cbPlacement },
+		{ "Default/Buffer",      D3D12_HEAP_TYPE_DEFAULT,  D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,            false, placement,     placement },
+		{ "Default/Texture",     D3D12_HEAP_TYPE_DEFAULT,  D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, false, placement,     placement },
+		{ "Default/RtDsTexture", D3D12_HEAP_TYPE_DEFAULT,  D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,     false, msaaPlacement, placement },
+		{ "Readback/Buffer",     D3D12_HEAP_TYPE_READBACK, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,            false, placement,     placement },
+		{ "Readback/Small",      D3D12_HEAP_TYPE_READBACK, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,            true,  placement,     cbPlacement },
+	};
+
+	mPools.clear();
+	for (auto& pool : pools)
+	{
+		mPools.push_back(std::make_unique<GpuMemoryPool>(std::move(pool)));
+	}
+
+	return true;
+}
+
+bool GpuMemoryAllocator::CreateBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, GpuAllocation& out, D3D12_RESOURCE_FLAGS flags, UINT64 alignment)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	out = {};
+
+	// 境界は2の累乗で、定数バッファの境界より細かくはしない
+	assert((alignment & (alignment - 1)) == 0);
+	alignment = std::max<UINT64>(alignment, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	bool smallBuffer = heapType != D3D12_HEAP_TYPE_DEFAULT && flags == D3D12_RESOURCE_FLAG_NONE && size <= SmallBufferThreshold;
+
+	GpuMemoryPool* pool = FindPool(heapType, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, smallBuffer);
+	if (pool == nullptr)
+	{
+		assert(false && "対応していないヒープタイプ");
+		return false;
+	}
+
+	if (smallBuffer)
+	{
+		// 共有バッファから切り出すので、リソースは作らない
+		if (!AllocateRange(*pool, size, alignment, out))
+		{
+			return false;
+		}
+
+		out.resource = out.page->buffer;
+		out.offset = out.range.offset;
+		out.size = size;
+		out.gpuAddress = out.page->buffer->GetGPUVirtualAddress() + out.offset;
+		out.cpuAddress = out.page->mapped + out.offset;
+
+		pool->requestedBytes += size;
+
+		return true;
+	}
+
+	auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(size, flags);
+	D3D12_RESOURCE_ALLOCATION_INFO info = mDevice->GetResourceAllocationInfo(0, 1, &resDesc);
+
+	if (!AllocateRange(*pool, info.SizeInBytes, std::max(info.Alignment, alignment), out))
+	{
+		return false;
+	}
+
+	auto result = mDevice->CreatePlacedResource(out.page->heap.Get(), out.range.offset, &resDesc, RequiredState(heapType, initialState), nullptr, IID_PPV_ARGS(out.resource.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "プレースドバッファ作成失敗");
+		ReleaseRange(*pool, out.page, out.range);
+		out = {};
+		return false;
+	}
+
+	if (heapType != D3D12_HEAP_TYPE_DEFAULT)
+	{
+		result = out.resource->Map(0, nullptr, &out.cpuAddress);
+		if (FAILED(result))
+		{
+			assert(false && "プレースドバッファのマップ失敗");
+			out.resource.Reset();
+			ReleaseRange(*pool, out.page, out.range);
+			out = {};
+			return false;
+		}
+	}
+
+	out.size = size;
+	out.gpuAddress = out.resource->GetGPUVirtualAddress();
+
+	pool->requestedBytes += size;
+
+	return true;
+}
+
+bool GpuMemoryAllocator::CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, GpuAllocation& out)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	out = {};
+
+	bool renderTarget = (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+	D3D12_HEAP_FLAGS heapFlags = renderTarget ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+	GpuMemoryPool* pool = FindPool(D3D12_HEAP_TYPE_DEFAULT, heapFlags, false);
+
+	D3D12_RESOURCE_ALLOCATION_INFO info = mDevice->GetResourceAllocationInfo(0, 1, &desc);
+
+	if (!AllocateRange(*pool, info.SizeInBytes, info.Alignment, out))
+	{
+		return false;
+	}
+
+	auto result = mDevice->CreatePlacedResource(out.page->heap.Get(), out.range.offset, &desc, initialState, clearValue, IID_PPV_ARGS(out.resource.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "プレースドテクスチャ作成失敗");
+		ReleaseRange(*pool, out.page, out.range);
+		out = {};
+		return false;
+	}
+
+	out.size = info.SizeInBytes;
+
+	pool->requestedBytes += out.size;
+
+	return true;
+}
+
+void GpuMemoryAllocator::Free(GpuAllocation& allocation)
+{
+	if (allocation.pool == nullptr)
+	{
+		allocation = {};
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	GpuMemoryPool* pool = allocation.pool;
+	GpuMemoryPage* page = allocation.page;
+
+	pool->requestedBytes -= allocation.size;
+
+	// プレースドリソースはヒープより先に解放する
+	allocation.resource.Reset();
+	ReleaseRange(*pool, page, allocation.range);
+
+	allocation = {};
+}
+
+void GpuMemoryAllocator::ReleaseRange(GpuMemoryPool& pool, GpuMemoryPage* page, TlsfAllocator::Allocation& range)
+{
+	page->tlsf.Free(range);
+
+	// 空になったページは1枚だけ残して返す
+	if (page->tlsf.IsEmpty() && pool.pages.size() > 1)
+	{
+		auto it = std::find_if(pool.pages.begin(), pool.pages.end(), [page](const std::unique_ptr<GpuMemoryPage>& p) { return p.get() == page; });
+		if (it != pool.pages.end())
+		{
+			pool.pages.erase(it);
+		}
+	}
+}
+
+std::string GpuMemoryAllocator::Report() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	std::string report = "GpuMemoryAllocator\n";
+	char buf[256] = {};
+
+	for (const auto& pool : mPools)
+	{
+		TlsfAllocator::Stats total = {};
+		UINT64 largestFree = 0;
+
+		for (const auto& page : pool->pages)
+		{
+			TlsfAllocator::Stats stats = page->tlsf.GetStats();
+			total.capacity += stats.capacity;
+			total.usedBytes += stats.usedBytes;
+			total.freeBytes += stats.freeBytes;
+			total.allocationCount += stats.allocationCount;
+			total.freeBlockCount += stats.freeBlockCount;
+			largestFree = std::max(largestFree, stats.largestFreeBlock);
+		}
+		total.largestFreeBlock = largestFree;
+
+		snprintf(buf, sizeof(buf), "  %-20s pages=%zu capacity=%lluKB used=%lluKB requested=%lluKB allocs=%u freeBlocks=%u frag=%.1f%%\n",
+			pool->name,
+			pool->pages.size(),
+			static_cast<unsigned long long>(total.capacity / 1024),
+			static_cast<unsigned long long>(total.usedBytes / 1024),
+			static_cast<unsigned long long>(pool->requestedBytes / 1024),
+			total.allocationCount,
+			total.freeBlockCount,
+			total.Fragmentation() * 100.0);
+
+		report += buf;
+	}
+
+	return report;
+}
+
+GpuMemoryPool* GpuMemoryAllocator::FindPool(D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, bool smallBuffer)
+{
+	for (auto& pool : mPools)
+	{
+		if (pool->heapType == heapType && pool->heapFlags == heapFlags && pool->smallBuffer == smallBuffer)
+		{
+			return pool.get();
+		}
+	}
+
+	return nullptr;
+}
+
+bool GpuMemoryAllocator::AllocateRange(GpuMemoryPool& pool, UINT64 size, UINT64 alignment, GpuAllocation& out)
+{
+	for (auto& page : pool.pages)
+	{
+		if (page->tlsf.Allocate(size, alignment, out.range))
+		{
+			out.pool = &pool;
+			out.page = page.get();
+			return true;
+		}
+	}
+
+	// 既存のページに入らなければ新しいヒープを作る
+	GpuMemoryPage* page = CreatePage(pool, size + alignment);
+	if (page == nullptr || !page->tlsf.Allocate(size, alignment, out.range))
+	{
+		return false;
+	}
+
+	out.pool = &pool;
+	out.page = page;
+	return true;
+}
+
+GpuMemoryPage* GpuMemoryAllocator::CreatePage(GpuMemoryPool& pool, UINT64 minSize)
+{
+	auto page = std::make_unique<GpuMemoryPage>();
+
+	UINT64 pageSize = pool.smallBuffer ? SmallBufferPageSize : DefaultPageSize;
+	pageSize = std::max(pageSize, AlignUp(minSize, pool.heapAlignment));
+
+	auto heapProp = CD3DX12_HEAP_PROPERTIES(pool.heapType);
+
+	if (pool.smallBuffer)
+	{
+		auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(pageSize);
+
+		auto result = mDevice->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &resDesc, RequiredState(pool.heapType, D3D12_RESOURCE_STATE_COMMON), nullptr, IID_PPV_ARGS(page->buffer.ReleaseAndGetAddressOf()));
+		if (FAILED(result))
+		{
+			assert(false && "小バッファ用ページ作成失敗");
+			return nullptr;
+		}
+
+		result = page->buffer->Map(0, nullptr, (void**)&page->mapped);
+		if (FAILED(result))
+		{
+			assert(false && "小バッファ用ページのマップ失敗");
+			return nullptr;
+		}
+	}
+	else
+	{
+		D3D12_HEAP_DESC heapDesc = {};
+		heapDesc.SizeInBytes = pageSize;
+		heapDesc.Properties = heapProp;
+		heapDesc.Alignment = pool.heapAlignment;
+		heapDesc.Flags = pool.heapFlags;
+
+		auto result = mDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(page->heap.ReleaseAndGetAddressOf()));
+		if (FAILED(result))
+		{
+			assert(false && "ヒープ作成失敗");
+			return nullptr;
+		}
+	}
+
+	page->tlsf.Init(pageSize, pool.granularity);
+
+	pool.pages.push_back(std::move(page));
+
+	return pool.pages.back().get();
+}
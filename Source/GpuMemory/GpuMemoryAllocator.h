@@ -0,0 +1,82 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TlsfAllocator.h"
+
+struct GpuMemoryPage;
+struct GpuMemoryPool;
+
+// GpuMemoryAllocatorから割り当てたバッファ・テクスチャ
+// 小さいバッファは共有バッファの一部なので、resourceとoffsetの組で扱う
+struct GpuAllocation
+{
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource = nullptr;
+	UINT64 offset = 0;
+	UINT64 size = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+
+	// UPLOAD/READBACKのみ、常にマップされている
+	void* cpuAddress = nullptr;
+
+	GpuMemoryPool* pool = nullptr;
+	GpuMemoryPage* page = nullptr;
+	TlsfAllocator::Allocation range;
+
+	bool IsValid() const { return resource != nullptr; }
+};
+
+// ヒープ種類毎に大きなID3D12Heapを確保し、プレースドリソースとして切り分ける
+class GpuMemoryAllocator
+{
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public:
+
+	// プレースドリソース用ヒープ1枚の大きさ
+	static const UINT64 DefaultPageSize = 64ULL * 1024 * 1024;
+
+	// これ以下のUPLOAD/READBACKバッファは共有バッファから256バイト(以上の指定された)境界で切り出す
+	static const UINT64 SmallBufferThreshold = 64ULL * 1024;
+	static const UINT64 SmallBufferPageSize = 4ULL * 1024 * 1024;
+
+	GpuMemoryAllocator() = default;
+	~GpuMemoryAllocator();
+
+	bool Init(ID3D12Device* device);
+
+	// alignmentは切り出したバッファの先頭(offset)の境界。テクスチャのコピー先なら512にする
+	bool CreateBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, GpuAllocation& out, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	bool CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue, GpuAllocation& out);
+
+	// GPUが使い終わった後に呼ぶこと
+	void Free(GpuAllocation& allocation);
+
+	// プール毎の使用量と断片化率
+	std::string Report() const;
+
+private:
+
+	GpuMemoryPool* FindPool(D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, bool smallBuffer);
+
+	bool AllocateRange(GpuMemoryPool& pool, UINT64 size, UINT64 alignment, GpuAllocation& out);
+
+	// 範囲を返し、空になったページは1枚だけ残して解放する。mMutexを取ってから呼ぶ
+	void ReleaseRange(GpuMemoryPool& pool, GpuMemoryPage* page, TlsfAllocator::Allocation& range);
+	GpuMemoryPage* CreatePage(GpuMemoryPool& pool, UINT64 minSize);
+
+	ComPtr<ID3D12Device> mDevice = nullptr;
+
+	std::vector<std::unique_ptr<GpuMemoryPool>> mPools;
+
+	mutable std::mutex mMutex;
+};
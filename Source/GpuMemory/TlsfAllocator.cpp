@@ -0,0 +1,344 @@
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	uint32_t FloorLog2(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanReverse64(&index, value);
+		return static_cast<uint32_t>(index);
+#else
+		return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+	}
+
+	uint32_t LowestBit(uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index = 0;
+		_BitScanForward64(&index, value);
+		return static_cast<uint32_t>(index);
+#else
+		return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+	}
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+void TlsfAllocator::Init(uint64_t capacity, uint64_t granularity)
+{
+	assert(granularity > 0 && (granularity & (granularity - 1)) == 0 && "粒度は2の累乗");
+
+	mBlocks.clear();
+	mUnusedBlocks.clear();
+
+	mFirstLevelBitmap = 0;
+	std::fill(std::begin(mSecondLevelBitmap), std::end(mSecondLevelBitmap), 0);
+	for (auto& heads : mFreeHeads)
+	{
+		std::fill(std::begin(heads), std::end(heads), InvalidBlock);
+	}
+
+	mGranularity = granularity;
+	mCapacity = capacity & ~(granularity - 1);
+	mUsedBytes = 0;
+	mAllocationCount = 0;
+
+	if (mCapacity == 0)
+	{
+		return;
+	}
+
+	uint32_t block = NewBlock();
+	mBlocks[block].offset = 0;
+	mBlocks[block].size = mCapacity;
+	InsertFree(block);
+}
+
+bool TlsfAllocator::Allocate(uint64_t size, uint64_t alignment, Allocation& out)
+{
+	out = {};
+
+	if (size == 0 || mCapacity == 0)
+	{
+		return false;
+	}
+
+	assert((alignment & (alignment - 1)) == 0 && "アライメントは2の累乗");
+
+	size = AlignUp(size, mGranularity);
+	alignment = std::max(alignment, mGranularity);
+
+	// オフセットは常に粒度の倍数なので、ずれは最大でalignment - granularity
+	uint64_t searchSize = size + (alignment - mGranularity);
+
+	uint32_t block = FindFree(searchSize);
+	if (block == InvalidBlock)
+	{
+		return false;
+	}
+
+	RemoveFree(block);
+
+	uint64_t padding = AlignUp(mBlocks[block].offset, alignment) - mBlocks[block].offset;
+	if (padding > 0)
+	{
+		// 前の物理ブロックは使用中なので、先頭の余りは単独の空きブロックにする
+		Split(block, padding);
+		uint32_t aligned = mBlocks[block].nextPhys;
+		InsertFree(block);
+		block = aligned;
+	}
+
+	if (mBlocks[block].size > size)
+	{
+		Split(block, size);
+		InsertFree(mBlocks[block].nextPhys);
+	}
+
+	mBlocks[block].free = false;
+	mUsedBytes += mBlocks[block].size;
+	++mAllocationCount;
+
+	out.offset = mBlocks[block].offset;
+	out.size = mBlocks[block].size;
+	out.block = block;
+
+	return true;
+}
+
+void TlsfAllocator::Free(Allocation& allocation)
+{
+	if (!allocation.IsValid())
+	{
+		return;
+	}
+
+	uint32_t block = allocation.block;
+	assert(!mBlocks[block].free && "二重解放");
+
+	mUsedBytes -= mBlocks[block].size;
+	--mAllocationCount;
+	mBlocks[block].free = true;
+
+	// 前後の空きブロックと結合する
+	uint32_t prev = mBlocks[block].prevPhys;
+	if (prev != InvalidBlock && mBlocks[prev].free)
+	{
+		RemoveFree(prev);
+		mBlocks[prev].size += mBlocks[block].size;
+		mBlocks[prev].nextPhys = mBlocks[block].nextPhys;
+		if (mBlocks[block].nextPhys != InvalidBlock)
+		{
+			mBlocks[mBlocks[block].nextPhys].prevPhys = prev;
+		}
+		DeleteBlock(block);
+		block = prev;
+	}
+
+	uint32_t next = mBlocks[block].nextPhys;
+	if (next != InvalidBlock && mBlocks[next].free)
+	{
+		RemoveFree(next);
+		mBlocks[block].size += mBlocks[next].size;
+		mBlocks[block].nextPhys = mBlocks[next].nextPhys;
+		if (mBlocks[next].nextPhys != InvalidBlock)
+		{
+			mBlocks[mBlocks[next].nextPhys].prevPhys = block;
+		}
+		DeleteBlock(next);
+	}
+
+	InsertFree(block);
+
+	allocation = {};
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const
+{
+	Stats stats = {};
+	stats.capacity = mCapacity;
+	stats.usedBytes = mUsedBytes;
+	stats.freeBytes = mCapacity - mUsedBytes;
+	stats.allocationCount = mAllocationCount;
+
+	for (uint32_t fl = 0; fl < FirstLevelCount; ++fl)
+	{
+		for (uint32_t sl = 0; sl < SecondLevelCount; ++sl)
+		{
+			for (uint32_t block = mFreeHeads[fl][sl]; block != InvalidBlock; block = mBlocks[block].nextFree)
+			{
+				stats.largestFreeBlock = std::max(stats.largestFreeBlock, mBlocks[block].size);
+				++stats.freeBlockCount;
+			}
+		}
+	}
+
+	return stats;
+}
+
+void TlsfAllocator::Mapping(uint64_t size, uint32_t& fl, uint32_t& sl)
+{
+	uint32_t log2 = FloorLog2(size);
+
+	if (log2 < SecondLevelLog2)
+	{
+		// 小さいサイズはそのまま1バイト刻み
+		fl = 0;
+		sl = static_cast<uint32_t>(size);
+	}
+	else
+	{
+		fl = log2 - SecondLevelLog2 + 1;
+		sl = static_cast<uint32_t>(size >> (log2 - SecondLevelLog2)) ^ SecondLevelCount;
+	}
+}
+
+uint32_t TlsfAllocator::NewBlock()
+{
+	uint32_t block = 0;
+
+	if (!mUnusedBlocks.empty())
+	{
+		block = mUnusedBlocks.back();
+		mUnusedBlocks.pop_back();
+	}
+	else
+	{
+		block = static_cast<uint32_t>(mBlocks.size());
+		mBlocks.emplace_back();
+	}
+
+	mBlocks[block] = { 0, 0, InvalidBlock, InvalidBlock, InvalidBlock, InvalidBlock, false };
+	return block;
+}
+
+void TlsfAllocator::DeleteBlock(uint32_t block)
+{
+	mUnusedBlocks.push_back(block);
+}
+
+void TlsfAllocator::InsertFree(uint32_t block)
+{
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	Mapping(mBlocks[block].size, fl, sl);
+
+	uint32_t head = mFreeHeads[fl][sl];
+
+	mBlocks[block].free = true;
+	mBlocks[block].prevFree = InvalidBlock;
+	mBlocks[block].nextFree = head;
+
+	if (head != InvalidBlock)
+	{
+		mBlocks[head].prevFree = block;
+	}
+
+	mFreeHeads[fl][sl] = block;
+	mFirstLevelBitmap |= 1ULL << fl;
+	mSecondLevelBitmap[fl] |= 1U << sl;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t block)
+{
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	Mapping(mBlocks[block].size, fl, sl);
+
+	uint32_t prev = mBlocks[block].prevFree;
+	uint32_t next = mBlocks[block].nextFree;
+
+	if (prev != InvalidBlock)
+	{
+		mBlocks[prev].nextFree = next;
+	}
+	else
+	{
+		mFreeHeads[fl][sl] = next;
+	}
+
+	if (next != InvalidBlock)
+	{
+		mBlocks[next].prevFree = prev;
+	}
+
+	if (mFreeHeads[fl][sl] == InvalidBlock)
+	{
+		mSecondLevelBitmap[fl] &= ~(1U << sl);
+		if (mSecondLevelBitmap[fl] == 0)
+		{
+			mFirstLevelBitmap &= ~(1ULL << fl);
+		}
+	}
+
+	mBlocks[block].free = false;
+	mBlocks[block].prevFree = InvalidBlock;
+	mBlocks[block].nextFree = InvalidBlock;
+}
+
+uint32_t TlsfAllocator::FindFree(uint64_t size) const
+{
+	// 次の区分まで切り上げ、見つかったリストの先頭が必ず収まるようにする
+	uint32_t log2 = FloorLog2(size);
+	if (log2 >= SecondLevelLog2)
+	{
+		size += (1ULL << (log2 - SecondLevelLog2)) - 1;
+	}
+
+	uint32_t fl = 0;
+	uint32_t sl = 0;
+	Mapping(size, fl, sl);
+
+	uint32_t slMap = mSecondLevelBitmap[fl] & (~0U << sl);
+
+	if (slMap == 0)
+	{
+		uint64_t flMap = (fl + 1 < FirstLevelCount) ? (mFirstLevelBitmap & (~0ULL << (fl + 1))) : 0;
+		if (flMap == 0)
+		{
+			return InvalidBlock;
+		}
+
+		fl = LowestBit(flMap);
+		slMap = mSecondLevelBitmap[fl];
+	}
+
+	sl = LowestBit(slMap);
+
+	return mFreeHeads[fl][sl];
+}
+
+void TlsfAllocator::Split(uint32_t block, uint64_t size)
+{
+	uint32_t tail = NewBlock();
+
+	// NewBlockでmBlocksが伸びる可能性があるので、参照はその後に取る
+	Block& head = mBlocks[block];
+	Block& rest = mBlocks[tail];
+
+	rest.offset = head.offset + size;
+	rest.size = head.size - size;
+	rest.prevPhys = block;
+	rest.nextPhys = head.nextPhys;
+
+	if (head.nextPhys != InvalidBlock)
+	{
+		mBlocks[head.nextPhys].prevPhys = tail;
+	}
+
+	head.size = size;
+	head.nextPhys = tail;
+}
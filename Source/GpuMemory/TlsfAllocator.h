@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// TLSF(Two-Level Segregated Fit)によるオフセット割り当て
+// 実際のメモリは持たず、[0, capacity)の範囲を切り分けるだけなのでD3D12に依存しない
+class TlsfAllocator
+{
+public:
+
+	static const uint32_t InvalidBlock = 0xFFFFFFFF;
+
+	// 第2レベルの分割数(2^SecondLevelLog2)
+	static const uint32_t SecondLevelLog2 = 4;
+	static const uint32_t SecondLevelCount = 1 << SecondLevelLog2;
+	static const uint32_t FirstLevelCount = 64;
+
+	struct Allocation
+	{
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint32_t block = InvalidBlock;
+
+		bool IsValid() const { return block != InvalidBlock; }
+	};
+
+	struct Stats
+	{
+		uint64_t capacity = 0;
+		uint64_t usedBytes = 0;
+		uint64_t freeBytes = 0;
+		uint64_t largestFreeBlock = 0;
+		uint32_t allocationCount = 0;
+		uint32_t freeBlockCount = 0;
+
+		// 0なら空きが1塊、1に近いほど細切れ
+		double Fragmentation() const
+		{
+			return freeBytes == 0 ? 0.0 : 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeBytes);
+		}
+	};
+
+	TlsfAllocator() = default;
+	~TlsfAllocator() = default;
+
+	// granularityは全ての割り当てサイズとオフセットの最小単位
+	void Init(uint64_t capacity, uint64_t granularity);
+
+	bool Allocate(uint64_t size, uint64_t alignment, Allocation& out);
+	void Free(Allocation& allocation);
+
+	bool IsEmpty() const { return mAllocationCount == 0; }
+	uint64_t Capacity() const { return mCapacity; }
+
+	Stats GetStats() const;
+
+private:
+
+	struct Block
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t prevPhys;
+		uint32_t nextPhys;
+		uint32_t prevFree;
+		uint32_t nextFree;
+		bool free;
+	};
+
+	static void Mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+
+	uint32_t NewBlock();
+	void DeleteBlock(uint32_t block);
+
+	void InsertFree(uint32_t block);
+	void RemoveFree(uint32_t block);
+
+	uint32_t FindFree(uint64_t size) const;
+
+	// blockの先頭sizeバイトを残し、残りを空きブロックとして切り出す
+	void Split(uint32_t block, uint64_t size);
+
+	std::vector<Block> mBlocks;
+	std::vector<uint32_t> mUnusedBlocks;
+
+	uint64_t mFirstLevelBitmap = 0;
+	uint32_t mSecondLevelBitmap[FirstLevelCount] = {};
+	uint32_t mFreeHeads[FirstLevelCount][SecondLevelCount] = {};
+
+	uint64_t mCapacity = 0;
+	uint64_t mGranularity = 1;
+	uint64_t mUsedBytes = 0;
+	uint32_t mAllocationCount = 0;
+};
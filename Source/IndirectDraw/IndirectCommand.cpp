@@ -0,0 +1,26 @@
+#include "IndirectCommand.h"
+
+uint32_t CullIndirectCommands(const Frustum& frustum, const std::vector<IndirectObject>& objects, std::vector<IndirectCommand>& commands)
+{
+	commands.clear();
+
+	for (const IndirectObject& object : objects)
+	{
+		if (!frustum.Intersects(object.bounds))
+		{
+			continue;
+		}
+
+		IndirectCommand command = {};
+		command.objectId = object.objectId;
+		command.args.indexCountPerInstance = object.indexCount;
+		command.args.instanceCount = 1;
+		command.args.startIndexLocation = object.startIndex;
+		command.args.baseVertexLocation = object.baseVertex;
+		command.args.startInstanceLocation = 0;
+
+		commands.push_back(command);
+	}
+
+	return static_cast<uint32_t>(commands.size());
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Culling/Frustum.h"
+
+// GPUカリングとExecuteIndirectで共有するデータの並び
+// d3d12.hに依存させず、CPU版のカリングと並びの検証をLinuxでもビルドできるようにする
+
+// GPUに置くオブジェクト1つ分の情報(FrustumCullCS.hlslのObjectDataと一致させる)
+struct IndirectObject
+{
+	BoundingSphere bounds;
+	uint32_t indexCount = 0;
+	uint32_t startIndex = 0;
+	int32_t baseVertex = 0;
+	uint32_t objectId = 0;
+};
+
+// D3D12_DRAW_INDEXED_ARGUMENTSと同じ並び(IndirectDraw.cppで一致を確認する)
+struct DrawIndexedArguments
+{
+	uint32_t indexCountPerInstance;
+	uint32_t instanceCount;
+	uint32_t startIndexLocation;
+	int32_t baseVertexLocation;
+	uint32_t startInstanceLocation;
+};
+
+// 引数バッファ1要素分(コマンドシグネチャと一致させる)
+// objectIdは1個のルート定数として、続くドローの前に設定される
+struct IndirectCommand
+{
+	uint32_t objectId;
+	DrawIndexedArguments args;
+};
+
+// カリングの定数バッファ(FrustumCullCS.hlslのCullParamsと一致させる)
+struct IndirectCullParams
+{
+	Float4 planes[Frustum::PlaneCount];
+	uint32_t objectCount;
+	uint32_t pad[3];
+};
+
+static_assert(sizeof(IndirectObject) == 32, "FrustumCullCS.hlslのObjectDataとサイズが違う");
+static_assert(sizeof(DrawIndexedArguments) == 20, "D3D12_DRAW_INDEXED_ARGUMENTSとサイズが違う");
+static_assert(sizeof(IndirectCommand) == 24, "FrustumCullCS.hlslのIndirectCommandとサイズが違う");
+static_assert(sizeof(IndirectCullParams) == 112, "FrustumCullCS.hlslのCullParamsとサイズが違う");
+
+// GPU版(FrustumCullCS.hlsl)と同じ入力から同じ引数バッファを作るCPU実装
+// 順番はGPU版と違い入力順になる(GPU版はアトミックで詰めるので不定)
+uint32_t CullIndirectCommands(const Frustum& frustum, const std::vector<IndirectObject>& objects, std::vector<IndirectCommand>& commands);
@@ -0,0 +1,277 @@
+#include "IndirectDraw.h"
+
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include "../Dx12Wrapper/Dx12Wrapper.h"
+#include "../Math/XMConvert.h"
+
+// IndirectCommand.hの並びがD3D12のものと一致しているか
+static_assert(sizeof(DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), "D3D12_DRAW_INDEXED_ARGUMENTSとサイズが違う");
+static_assert(offsetof(DrawIndexedArguments, indexCountPerInstance) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, IndexCountPerInstance), "並びが違う");
+static_assert(offsetof(DrawIndexedArguments, instanceCount) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, InstanceCount), "並びが違う");
+static_assert(offsetof(DrawIndexedArguments, startIndexLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartIndexLocation), "並びが違う");
+static_assert(offsetof(DrawIndexedArguments, baseVertexLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, BaseVertexLocation), "並びが違う");
+static_assert(offsetof(DrawIndexedArguments, startInstanceLocation) == offsetof(D3D12_DRAW_INDEXED_ARGUMENTS, StartInstanceLocation), "並びが違う");
+
+namespace
+{
+	// FrustumCullCS.hlslのnumthreadsと一致させる
+	constexpr UINT CullThreadGroupSize = 64;
+
+	// カリング定数はフレーム毎に256バイト境界で並べる
+	constexpr UINT CullParamStride = (sizeof(IndirectCullParams) + 0xff) & ~0xff;
+
+	enum CullRootParam
+	{
+		CullRootParamParams,
+		CullRootParamObjects,
+		CullRootParamCommands,
+		CullRootParamCount,
+		CullRootParamNum,
+	};
+}
+
+bool IndirectDraw::Init(std::shared_ptr<Dx12Wrapper>& dx, UINT maxObjects, ID3D12RootSignature* graphicsRootSignature, UINT objectIdRootIndex)
+{
+	mDX12Wrapper = dx;
+	mMaxObjects = maxObjects;
+
+	if (!CreateBuffers())
+	{
+		return false;
+	}
+
+	if (!CreateCullPipeline())
+	{
+		return false;
+	}
+
+	return CreateCommandSignature(graphicsRootSignature, objectIdRootIndex);
+}
+
+void IndirectDraw::SetObjects(const std::vector<IndirectObject>& objects)
+{
+	assert(objects.size() <= mMaxObjects && "オブジェクト数が上限を超えている");
+
+	mObjectCount = static_cast<UINT>(std::min<size_t>(objects.size(), mMaxObjects));
+	std::copy_n(objects.begin(), mObjectCount, mMapObjects);
+}
+
+void IndirectDraw::Cull(ID3D12GraphicsCommandList* cmdList, DirectX::FXMMATRIX viewProj)
+{
+	Frustum frustum = Frustum::FromViewProjection(XMConvert::ToFloat4x4(viewProj));
+
+	// 前のフレームがまだGPUで読んでいるかもしれないので、記録中のフレームの領域に書く
+	UINT frameIndex = mDX12Wrapper->GetFrameIndex();
+	IndirectCullParams* params = reinterpret_cast<IndirectCullParams*>(mMapCullParams + CullParamStride * frameIndex);
+
+	std::copy(std::begin(frustum.planes), std::end(frustum.planes), params->planes);
+	params->objectCount = mObjectCount;
+
+	// 前フレームの引数バッファを書き込み可能に戻してカウンタを0にする
+	D3D12_RESOURCE_BARRIER barriers[] =
+	{
+		CD3DX12_RESOURCE_BARRIER::Transition(mCommandBuff.Get(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+		CD3DX12_RESOURCE_BARRIER::Transition(mCountBuff.Get(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_RESOURCE_STATE_COPY_DEST),
+	};
+	cmdList->ResourceBarrier(_countof(barriers), barriers);
+
+	cmdList->CopyBufferRegion(mCountBuff.Get(), 0, mCountResetBuff.Get(), 0, sizeof(UINT));
+
+	auto countToUav = CD3DX12_RESOURCE_BARRIER::Transition(mCountBuff.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+	cmdList->ResourceBarrier(1, &countToUav);
+
+	cmdList->SetPipelineState(mCullPipelineState.Get());
+	cmdList->SetComputeRootSignature(mCullRootSignature.Get());
+	cmdList->SetComputeRootConstantBufferView(CullRootParamParams, mCullParamBuff->GetGPUVirtualAddress() + CullParamStride * frameIndex);
+	cmdList->SetComputeRootShaderResourceView(CullRootParamObjects, mObjectBuff->GetGPUVirtualAddress());
+	cmdList->SetComputeRootUnorderedAccessView(CullRootParamCommands, mCommandBuff->GetGPUVirtualAddress());
+	cmdList->SetComputeRootUnorderedAccessView(CullRootParamCount, mCountBuff->GetGPUVirtualAddress());
+
+	cmdList->Dispatch((mObjectCount + CullThreadGroupSize - 1) / CullThreadGroupSize, 1, 1);
+
+	barriers[0] = CD3DX12_RESOURCE_BARRIER::Transition(mCommandBuff.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+	barriers[1] = CD3DX12_RESOURCE_BARRIER::Transition(mCountBuff.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+	cmdList->ResourceBarrier(_countof(barriers), barriers);
+}
+
+void IndirectDraw::Draw(ID3D12GraphicsCommandList* cmdList)
+{
+	cmdList->ExecuteIndirect(mCommandSignature.Get(), mMaxObjects, mCommandBuff.Get(), 0, mCountBuff.Get(), 0);
+}
+
+bool IndirectDraw::CreateBuffers()
+{
+	auto dev = mDX12Wrapper->Device();
+
+	auto uploadHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	auto defaultHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+
+	// オブジェクト情報(CPUから毎フレーム書き込む)
+	auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(IndirectObject) * mMaxObjects);
+	auto result = dev->CreateCommittedResource(&uploadHeapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(mObjectBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "オブジェクトバッファ作成失敗");
+		return false;
+	}
+
+	mObjectBuff->Map(0, nullptr, (void**)&mMapObjects);
+
+	resDesc = CD3DX12_RESOURCE_DESC::Buffer(CullParamStride * Dx12Wrapper::FrameCount);
+	result = dev->CreateCommittedResource(&uploadHeapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(mCullParamBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "カリング定数バッファ作成失敗");
+		return false;
+	}
+
+	mCullParamBuff->Map(0, nullptr, (void**)&mMapCullParams);
+
+	// 引数バッファとカウンタ
+	resDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(IndirectCommand) * mMaxObjects, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+	result = dev->CreateCommittedResource(&defaultHeapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, nullptr, IID_PPV_ARGS(mCommandBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "引数バッファ作成失敗");
+		return false;
+	}
+
+	resDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(UINT), D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+	result = dev->CreateCommittedResource(&defaultHeapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, nullptr, IID_PPV_ARGS(mCountBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "カウンタバッファ作成失敗");
+		return false;
+	}
+
+	resDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(UINT));
+	result = dev->CreateCommittedResource(&uploadHeapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(mCountResetBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "カウンタリセット用バッファ作成失敗");
+		return false;
+	}
+
+	UINT* mapCount = nullptr;
+	mCountResetBuff->Map(0, nullptr, (void**)&mapCount);
+	*mapCount = 0;
+	mCountResetBuff->Unmap(0, nullptr);
+
+	return true;
+}
+
+bool IndirectDraw::CreateCullPipeline()
+{
+	auto dev = mDX12Wrapper->Device();
+
+	ComPtr<ID3DBlob> csBlob = nullptr;
+	ComPtr<ID3DBlob> errorBlob = nullptr;
+
+	auto result = D3DCompileFromFile(L"Asset/Shader/Culling/FrustumCullCS.hlsl",
+		nullptr,
+		D3D_COMPILE_STANDARD_FILE_INCLUDE,
+		"FrustumCullCS",
+		"cs_5_0",
+		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
+		0,
+		csBlob.ReleaseAndGetAddressOf(),
+		errorBlob.ReleaseAndGetAddressOf());
+
+	if (FAILED(result))
+	{
+		mDX12Wrapper->ShowErrorMessage(result, errorBlob.Get());
+		return false;
+	}
+
+	// ディスクリプタテーブルを使わずルートディスクリプタで直接渡す
+	D3D12_ROOT_PARAMETER rootparam[CullRootParamNum] = {};
+	rootparam[CullRootParamParams].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootparam[CullRootParamParams].Descriptor.ShaderRegister = 0;
+	rootparam[CullRootParamObjects].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootparam[CullRootParamObjects].Descriptor.ShaderRegister = 0;
+	rootparam[CullRootParamCommands].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+	rootparam[CullRootParamCommands].Descriptor.ShaderRegister = 0;
+	rootparam[CullRootParamCount].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+	rootparam[CullRootParamCount].Descriptor.ShaderRegister = 1;
+
+	for (auto& param : rootparam)
+	{
+		param.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	}
+
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+	rootSignatureDesc.pParameters = rootparam;
+	rootSignatureDesc.NumParameters = _countof(rootparam);
+
+	ComPtr<ID3DBlob> rootSigBlob = nullptr;
+
+	result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, rootSigBlob.ReleaseAndGetAddressOf(), errorBlob.ReleaseAndGetAddressOf());
+	if (FAILED(result))
+	{
+		mDX12Wrapper->ShowErrorMessage(result, errorBlob.Get());
+		return false;
+	}
+
+	result = dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(mCullRootSignature.ReleaseAndGetAddressOf()));
+	if (FAILED(result))
+	{
+		assert(false && "カリング用ルートシグネチャ作成失敗");
+		return false;
+	}
+
+	D3D12_COMPUTE_PIPELINE_STATE_DESC cpipeline = {};
+	cpipeline.pRootSignature = mCullRootSignature.Get();
+	cpipeline.CS.pShaderBytecode = csBlob->GetBufferPointer();
+	cpipeline.CS.BytecodeLength = csBlob->GetBufferSize();
+
+	result = dev->CreateComputePipelineState(&cpipeline, IID_PPV_ARGS(mCullPipelineState.ReleaseAndGetAddressOf()));
+	if (FAILED(result))
+	{
+		assert(false && "カリング用パイプラインステート作成失敗");
+		return false;
+	}
+
+	return true;
+}
+
+bool IndirectDraw::CreateCommandSignature(ID3D12RootSignature* graphicsRootSignature, UINT objectIdRootIndex)
+{
+	// ルート定数を書き換えるのでルートシグネチャが必須
+	if (!graphicsRootSignature)
+	{
+		assert(false && "コマンドシグネチャにはルートシグネチャが必要");
+		return false;
+	}
+
+	D3D12_INDIRECT_ARGUMENT_DESC argDescs[2] = {};
+	argDescs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+	argDescs[0].Constant.RootParameterIndex = objectIdRootIndex;
+	argDescs[0].Constant.DestOffsetIn32BitValues = 0;
+	argDescs[0].Constant.Num32BitValuesToSet = 1;
+	argDescs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+	D3D12_COMMAND_SIGNATURE_DESC sigDesc = {};
+	sigDesc.ByteStride = sizeof(IndirectCommand);
+	sigDesc.NumArgumentDescs = _countof(argDescs);
+	sigDesc.pArgumentDescs = argDescs;
+
+	auto result = mDX12Wrapper->Device()->CreateCommandSignature(&sigDesc, graphicsRootSignature, IID_PPV_ARGS(mCommandSignature.ReleaseAndGetAddressOf()));
+	if (FAILED(result))
+	{
+		assert(false && "コマンドシグネチャ作成失敗");
+		return false;
+	}
+
+	return true;
+}
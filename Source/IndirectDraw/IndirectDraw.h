@@ -0,0 +1,64 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <DirectXMath.h>
+
+#include <memory>
+#include <vector>
+
+#include "IndirectCommand.h"
+
+class Dx12Wrapper;
+
+// コンピュートシェーダーで視錐台カリングを行い、ExecuteIndirectで描画する
+class IndirectDraw
+{
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public:
+
+	IndirectDraw() = default;
+	~IndirectDraw() = default;
+
+	// objectIdはgraphicsRootSignatureのobjectIdRootIndex番のルート定数に設定される
+	bool Init(std::shared_ptr<Dx12Wrapper>& dx, UINT maxObjects, ID3D12RootSignature* graphicsRootSignature, UINT objectIdRootIndex);
+
+	void SetObjects(const std::vector<IndirectObject>& objects);
+
+	// カリングを積み、引数バッファをINDIRECT_ARGUMENTにする
+	void Cull(ID3D12GraphicsCommandList* cmdList, DirectX::FXMMATRIX viewProj);
+
+	// Cullの後、パイプラインとIAを設定した状態で呼ぶ
+	void Draw(ID3D12GraphicsCommandList* cmdList);
+
+private:
+
+	bool CreateBuffers();
+	bool CreateCullPipeline();
+	bool CreateCommandSignature(ID3D12RootSignature* graphicsRootSignature, UINT objectIdRootIndex);
+
+	std::shared_ptr<Dx12Wrapper> mDX12Wrapper = nullptr;
+
+	UINT mMaxObjects = 0;
+	UINT mObjectCount = 0;
+
+	ComPtr<ID3D12Resource> mObjectBuff = nullptr;
+	IndirectObject* mMapObjects = nullptr;
+
+	ComPtr<ID3D12Resource> mCullParamBuff = nullptr;
+	// フレーム毎(Dx12Wrapper::FrameCount個)の定数
+	uint8_t* mMapCullParams = nullptr;
+
+	ComPtr<ID3D12Resource> mCommandBuff = nullptr;
+	ComPtr<ID3D12Resource> mCountBuff = nullptr;
+	ComPtr<ID3D12Resource> mCountResetBuff = nullptr;
+
+	ComPtr<ID3D12RootSignature> mCullRootSignature = nullptr;
+	ComPtr<ID3D12PipelineState> mCullPipelineState = nullptr;
+	ComPtr<ID3D12CommandSignature> mCommandSignature = nullptr;
+};
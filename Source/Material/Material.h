@@ -0,0 +1,34 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+// スフィアマップの合成方法(PMD/PMXと同じ番号)
+enum class SphereMode : uint32_t
+{
+	None = 0,
+	Multiply = 1,
+	Add = 2,
+};
+
+// マテリアルのストラクチャードバッファの1要素
+// BasicShaderHeader.hlsliのMaterialと同じ並び
+struct MaterialConstants
+{
+	DirectX::XMFLOAT4 diffuse = { 1.0F, 1.0F, 1.0F, 1.0F };
+	DirectX::XMFLOAT3 specular = { 0.0F, 0.0F, 0.0F };
+	float specularPower = 1.0F;
+	DirectX::XMFLOAT3 ambient = { 0.0F, 0.0F, 0.0F };
+
+	// ToonRampAtlasの行
+	uint32_t toonIndex = 0;
+
+	// SphereMapArrayの層
+	uint32_t sphereIndex = 0;
+	uint32_t sphereMode = static_cast<uint32_t>(SphereMode::None);
+
+	uint32_t padding[2] = {};
+};
+
+static_assert(sizeof(MaterialConstants) == 64, "シェーダー側のMaterialと合わせる");
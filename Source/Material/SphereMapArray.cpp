@@ -0,0 +1,89 @@
+#include "SphereMapArray.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../Texture/MipGenerator.h"
+
+SphereMapArray::SphereMapArray(uint32_t size)
+	: mSize(std::max(size, 1u))
+{
+	Clear();
+}
+
+uint32_t SphereMapArray::Add(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height)
+{
+	if (pixels == nullptr || width == 0 || height == 0)
+	{
+		return DefaultLayer;
+	}
+
+	// 大きい画像は先に箱フィルタで縮め、最後のバイリニアで折り返しが出ないようにする
+	std::vector<MipLevel> levels;
+	MipGenerator::Generate(pixels, rowPitch, width, height, MipColorSpace::Srgb, levels, 1);
+
+	while (levels.back().width >= mSize * 2 && levels.back().height >= mSize * 2)
+	{
+		MipLevel smaller;
+		MipGenerator::Downsample(levels.back(), MipColorSpace::Srgb, smaller);
+		levels.back() = std::move(smaller);
+	}
+
+	const MipLevel& source = levels.back();
+
+	std::vector<uint8_t> layer(static_cast<size_t>(mSize) * mSize * 4);
+
+	for (uint32_t y = 0; y < mSize; ++y)
+	{
+		float sy = std::clamp((y + 0.5F) * source.height / mSize - 0.5F, 0.0F, static_cast<float>(source.height - 1));
+		uint32_t y0 = static_cast<uint32_t>(sy);
+		uint32_t y1 = std::min(y0 + 1, source.height - 1);
+		float ty = sy - y0;
+
+		for (uint32_t x = 0; x < mSize; ++x)
+		{
+			float sx = std::clamp((x + 0.5F) * source.width / mSize - 0.5F, 0.0F, static_cast<float>(source.width - 1));
+			uint32_t x0 = static_cast<uint32_t>(sx);
+			uint32_t x1 = std::min(x0 + 1, source.width - 1);
+			float tx = sx - x0;
+
+			const uint8_t* p00 = &source.pixels[(static_cast<size_t>(y0) * source.width + x0) * 4];
+			const uint8_t* p01 = &source.pixels[(static_cast<size_t>(y0) * source.width + x1) * 4];
+			const uint8_t* p10 = &source.pixels[(static_cast<size_t>(y1) * source.width + x0) * 4];
+			const uint8_t* p11 = &source.pixels[(static_cast<size_t>(y1) * source.width + x1) * 4];
+
+			uint8_t* dst = &layer[(static_cast<size_t>(y) * mSize + x) * 4];
+
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				bool color = c < 3;
+				auto load = [color](uint8_t value) { return color ? MipGenerator::SrgbToLinear(value) : value / 255.0F; };
+
+				float top = load(p00[c]) + (load(p01[c]) - load(p00[c])) * tx;
+				float bottom = load(p10[c]) + (load(p11[c]) - load(p10[c])) * tx;
+				float value = top + (bottom - top) * ty;
+
+				dst[c] = color ? MipGenerator::LinearToSrgb(value) : static_cast<uint8_t>(std::clamp(value, 0.0F, 1.0F) * 255.0F + 0.5F);
+			}
+		}
+	}
+
+	// 同じ画像を複数のマテリアルが使うことが多いので、同じ層にまとめる
+	for (uint32_t i = 0; i < LayerCount(); ++i)
+	{
+		if (mLayers[i] == layer)
+		{
+			return i;
+		}
+	}
+
+	mLayers.push_back(std::move(layer));
+
+	return LayerCount() - 1;
+}
+
+void SphereMapArray::Clear()
+{
+	mLayers.clear();
+	mLayers.emplace_back(static_cast<size_t>(mSize) * mSize * 4, static_cast<uint8_t>(255));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// スフィアマップを同じ大きさにそろえ、テクスチャ配列の層として並べる
+// マテリアルは層の番号で参照するので、全マテリアルで1つのSRVを共有できる
+class SphereMapArray
+{
+public:
+
+	static const uint32_t DefaultSize = 256;
+
+	// 0層目は白(乗算のスフィアが無いのと同じ)
+	static const uint32_t DefaultLayer = 0;
+
+	explicit SphereMapArray(uint32_t size = DefaultSize);
+	~SphereMapArray() = default;
+
+	// RGBA8(sRGB)の画像をsize x sizeにして加え、層の番号を返す
+	uint32_t Add(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height);
+
+	void Clear();
+
+	uint32_t Size() const { return mSize; }
+	uint32_t LayerCount() const { return static_cast<uint32_t>(mLayers.size()); }
+
+	// size x sizeのRGBA8
+	const std::vector<uint8_t>& Layer(uint32_t index) const { return mLayers[index]; }
+
+private:
+
+	uint32_t mSize = DefaultSize;
+	std::vector<std::vector<uint8_t>> mLayers;
+};
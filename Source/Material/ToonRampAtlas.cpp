@@ -0,0 +1,94 @@
+#include "ToonRampAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../Texture/MipGenerator.h"
+
+ToonRampAtlas::ToonRampAtlas()
+{
+	Clear();
+}
+
+uint32_t ToonRampAtlas::Add(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height)
+{
+	if (pixels == nullptr || width == 0 || height == 0)
+	{
+		return DefaultRamp;
+	}
+
+	uint8_t ramp[RowBytes] = {};
+	ExtractRamp(pixels, rowPitch, width, height, ramp);
+
+	// モデル1体のトゥーンは多くても十数本なので、全行と比べれば足りる
+	const uint32_t count = Count();
+	for (uint32_t row = 0; row < count; ++row)
+	{
+		if (std::memcmp(mPixels.data() + RowBytes * row, ramp, RowBytes) == 0)
+		{
+			return row;
+		}
+	}
+
+	mPixels.insert(mPixels.end(), ramp, ramp + RowBytes);
+
+	return count;
+}
+
+void ToonRampAtlas::Clear()
+{
+	mPixels.assign(RowBytes, 255);
+}
+
+void ToonRampAtlas::ExtractRamp(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height, uint8_t* out)
+{
+	// 画像の各行を1色にする(横に変化しないトゥーンならそのままの色になる)
+	std::vector<float> column(static_cast<size_t>(height) * 4);
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint8_t* row = pixels + rowPitch * y;
+		float sum[4] = {};
+
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				sum[c] += MipGenerator::SrgbToLinear(row[x * 4 + c]);
+			}
+
+			sum[3] += row[x * 4 + 3] / 255.0F;
+		}
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			column[y * 4 + c] = sum[c] / width;
+		}
+	}
+
+	// GPUが元のトゥーンをクランプ・バイリニアで引いた時と同じ値になるよう、画素中心で線形補間する
+	for (uint32_t i = 0; i < RampWidth; ++i)
+	{
+		float v = (i + 0.5F) / RampWidth;
+		float position = std::clamp(v * height - 0.5F, 0.0F, static_cast<float>(height - 1));
+
+		uint32_t y0 = static_cast<uint32_t>(position);
+		uint32_t y1 = std::min(y0 + 1, height - 1);
+		float t = position - y0;
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			float value = column[y0 * 4 + c] + (column[y1 * 4 + c] - column[y0 * 4 + c]) * t;
+
+			if (c < 3)
+			{
+				out[i * 4 + c] = MipGenerator::LinearToSrgb(value);
+			}
+			else
+			{
+				out[i * 4 + c] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0F, 1.0F) * 255.0F));
+			}
+		}
+	}
+}
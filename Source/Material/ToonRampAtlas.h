@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// トゥーンテクスチャを横RampWidth画素の1本の階調にし、1行ずつ積んだアトラスを作る
+// MMDはトゥーンをv = 0.5 - N・L * 0.5で引くので、意味があるのは縦方向の変化だけ
+// 全マテリアルのトゥーンが1枚に収まり、マテリアル毎にテクスチャを差し替えずに済む
+class ToonRampAtlas
+{
+public:
+
+	// 階調の画素数
+	static const uint32_t RampWidth = 128;
+
+	// 0行目は白(トゥーン無しのマテリアル用)
+	static const uint32_t DefaultRamp = 0;
+
+	ToonRampAtlas();
+	~ToonRampAtlas() = default;
+
+	// RGBA8(sRGB)の画像から階調を作って加え、行番号を返す
+	// 同じ階調になる画像は同じ行を返す
+	uint32_t Add(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height);
+
+	// 白の行だけに戻す
+	void Clear();
+
+	uint32_t Count() const { return static_cast<uint32_t>(mPixels.size() / RowBytes); }
+
+	// RampWidth x Count()のRGBA8
+	const std::vector<uint8_t>& Pixels() const { return mPixels; }
+
+	// 縦の階調を横RampWidth画素に並べ直す。各行の色はリニアで平均する
+	// outはRampWidth * 4バイト
+	static void ExtractRamp(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height, uint8_t* out);
+
+private:
+
+	static const size_t RowBytes = RampWidth * 4;
+
+	std::vector<uint8_t> mPixels;
+};
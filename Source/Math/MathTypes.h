@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cmath>
+
+// DirectXMathを使わないモジュール(D3Dに依存せずLinuxでもビルドする物)の最小限のベクトル型
+// メモリ上の並びはXMFLOAT2/XMFLOAT3/XMFLOAT4/XMFLOAT4X4と同じなので、D3D側はXMConvert.hで読み替える
+struct Float2
+{
+	float x;
+	float y;
+};
+
+struct Float3
+{
+	float x;
+	float y;
+	float z;
+};
+
+struct Float4
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+// DirectXMathと同じ行ベクトル規約(v * M)。m[行][列]
+struct Float4x4
+{
+	float m[4][4];
+};
+
+namespace Math
+{
+	inline Float3 Add(const Float3& a, const Float3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+	inline Float3 Subtract(const Float3& a, const Float3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+	inline Float3 Scale(const Float3& a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+	inline float Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline Float3 Cross(const Float3& a, const Float3& b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+	inline float LengthSq(const Float3& a) { return Dot(a, a); }
+	inline float Length(const Float3& a) { return std::sqrt(Dot(a, a)); }
+
+	// 長さ0ならそのまま返す
+	inline Float3 Normalize(const Float3& a)
+	{
+		float length = Length(a);
+		return length > 0.0F ? Scale(a, 1.0F / length) : a;
+	}
+
+	inline float Dot(const Float4& a, const Float4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+	// クォータニオンの球面線形補間。XMQuaternionSlerpと同じく短い方の弧を通る
+	inline Float4 Slerp(const Float4& a, const Float4& b, float t)
+	{
+		float cosine = Dot(a, b);
+		float sign = cosine < 0.0F ? -1.0F : 1.0F;
+		cosine *= sign;
+
+		float s0 = 1.0F - t;
+		float s1 = t;
+
+		// ほぼ同じ向きならsinで割ると誤差が大きいので線形補間し、長さを1に戻す
+		bool linear = cosine >= 1.0F - 1.0e-5F;
+		if (!linear)
+		{
+			float sine = std::sqrt(1.0F - cosine * cosine);
+			float angle = std::atan2(sine, cosine);
+			s0 = std::sin(s0 * angle) / sine;
+			s1 = std::sin(s1 * angle) / sine;
+		}
+
+		s1 *= sign;
+
+		Float4 out = { a.x * s0 + b.x * s1, a.y * s0 + b.y * s1, a.z * s0 + b.z * s1, a.w * s0 + b.w * s1 };
+
+		if (linear)
+		{
+			float length = std::sqrt(Dot(out, out));
+			if (length > 0.0F)
+			{
+				out = { out.x / length, out.y / length, out.z / length, out.w / length };
+			}
+		}
+
+		return out;
+	}
+
+	inline Float4x4 Identity()
+	{
+		return { { { 1.0F, 0.0F, 0.0F, 0.0F }, { 0.0F, 1.0F, 0.0F, 0.0F }, { 0.0F, 0.0F, 1.0F, 0.0F }, { 0.0F, 0.0F, 0.0F, 1.0F } } };
+	}
+
+	inline Float4x4 Multiply(const Float4x4& a, const Float4x4& b)
+	{
+		Float4x4 out = {};
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int col = 0; col < 4; ++col)
+			{
+				out.m[row][col] = a.m[row][0] * b.m[0][col] + a.m[row][1] * b.m[1][col] + a.m[row][2] * b.m[2][col] + a.m[row][3] * b.m[3][col];
+			}
+		}
+		return out;
+	}
+
+	// 点(w=1)を変換する。射影はしない
+	inline Float3 TransformPoint(const Float3& p, const Float4x4& m)
+	{
+		return
+		{
+			p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0],
+			p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1],
+			p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2],
+		};
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// 4レーンのfloat演算。x86ではSSE、それ以外は同じ計算をスカラーで行う
+// FrustumSimd等、4平面をまとめて判定する所で使う
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SIMD4_SSE 1
+#include <xmmintrin.h>
+#endif
+
+struct Simd4
+{
+#if SIMD4_SSE
+	__m128 v;
+#else
+	float v[4];
+#endif
+};
+
+namespace Simd
+{
+#if SIMD4_SSE
+	inline Simd4 Set(float x, float y, float z, float w) { return { _mm_setr_ps(x, y, z, w) }; }
+	inline Simd4 Splat(float s) { return { _mm_set1_ps(s) }; }
+	inline Simd4 Add(Simd4 a, Simd4 b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline Simd4 Multiply(Simd4 a, Simd4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline Simd4 MultiplyAdd(Simd4 a, Simd4 b, Simd4 c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+	inline Simd4 Negate(Simd4 a) { return { _mm_sub_ps(_mm_setzero_ps(), a.v) }; }
+	inline Simd4 Abs(Simd4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0F), a.v) }; }
+
+	// どれか1レーンでもa < b
+	inline bool AnyLess(Simd4 a, Simd4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)) != 0; }
+
+	// 全レーンでa >= b
+	inline bool AllGreaterEqual(Simd4 a, Simd4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a.v, b.v)) == 0xF; }
+#else
+	inline Simd4 Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+	inline Simd4 Splat(float s) { return { { s, s, s, s } }; }
+
+	template<typename Op>
+	inline Simd4 Map(Simd4 a, Simd4 b, Op op)
+	{
+		return { { op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3]) } };
+	}
+
+	inline Simd4 Add(Simd4 a, Simd4 b) { return Map(a, b, [](float x, float y) { return x + y; }); }
+	inline Simd4 Multiply(Simd4 a, Simd4 b) { return Map(a, b, [](float x, float y) { return x * y; }); }
+	inline Simd4 MultiplyAdd(Simd4 a, Simd4 b, Simd4 c) { return Add(Multiply(a, b), c); }
+	inline Simd4 Negate(Simd4 a) { return Map(a, a, [](float x, float) { return -x; }); }
+	inline Simd4 Abs(Simd4 a) { return Map(a, a, [](float x, float) { return x < 0.0F ? -x : x; }); }
+
+	inline bool AnyLess(Simd4 a, Simd4 b)
+	{
+		return a.v[0] < b.v[0] || a.v[1] < b.v[1] || a.v[2] < b.v[2] || a.v[3] < b.v[3];
+	}
+
+	inline bool AllGreaterEqual(Simd4 a, Simd4 b)
+	{
+		return a.v[0] >= b.v[0] && a.v[1] >= b.v[1] && a.v[2] >= b.v[2] && a.v[3] >= b.v[3];
+	}
+#endif
+}
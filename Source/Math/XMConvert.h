@@ -0,0 +1,36 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstring>
+
+#include "MathTypes.h"
+
+// D3D側でDirectXMathの型とMathTypes.hの型を読み替える(並びは同じ)
+namespace XMConvert
+{
+	static_assert(sizeof(Float2) == sizeof(DirectX::XMFLOAT2), "XMFLOAT2と並びを合わせる");
+	static_assert(sizeof(Float3) == sizeof(DirectX::XMFLOAT3), "XMFLOAT3と並びを合わせる");
+	static_assert(sizeof(Float4) == sizeof(DirectX::XMFLOAT4), "XMFLOAT4と並びを合わせる");
+	static_assert(sizeof(Float4x4) == sizeof(DirectX::XMFLOAT4X4), "XMFLOAT4X4と並びを合わせる");
+
+	inline Float4x4 ToFloat4x4(DirectX::FXMMATRIX matrix)
+	{
+		DirectX::XMFLOAT4X4 stored;
+		DirectX::XMStoreFloat4x4(&stored, matrix);
+
+		Float4x4 out;
+		std::memcpy(&out, &stored, sizeof(out));
+		return out;
+	}
+
+	inline DirectX::XMMATRIX ToMatrix(const Float4x4& matrix)
+	{
+		DirectX::XMFLOAT4X4 stored;
+		std::memcpy(&stored, &matrix, sizeof(stored));
+		return DirectX::XMLoadFloat4x4(&stored);
+	}
+
+	inline DirectX::XMFLOAT3 ToXMFLOAT3(const Float3& v) { return DirectX::XMFLOAT3(v.x, v.y, v.z); }
+	inline DirectX::XMFLOAT4 ToXMFLOAT4(const Float4& v) { return DirectX::XMFLOAT4(v.x, v.y, v.z, v.w); }
+}
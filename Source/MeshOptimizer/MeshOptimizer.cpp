@@ -0,0 +1,307 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Forsyth法のパラメータ(LRUキャッシュを想定)
+	constexpr int ForsythCacheSize = 32;
+	constexpr float CacheDecayPower = 1.5F;
+	constexpr float LastTriScore = 0.75F;
+	constexpr float ValenceBoostScale = 2.0F;
+	constexpr float ValenceBoostPower = 0.5F;
+
+	constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	float VertexScore(int cachePos, uint32_t remaining)
+	{
+		// もう使われない頂点
+		if (remaining == 0)
+		{
+			return -1.0F;
+		}
+
+		float score = 0.0F;
+
+		if (cachePos >= 0)
+		{
+			// 直前の三角形の頂点は次の三角形でも同じ位置にいるので少し下げる
+			if (cachePos < 3)
+			{
+				score = LastTriScore;
+			}
+			else
+			{
+				float scaler = 1.0F - static_cast<float>(cachePos - 3) / static_cast<float>(ForsythCacheSize - 3);
+				score = std::pow(scaler, CacheDecayPower);
+			}
+		}
+
+		// 残りの三角形が少ない頂点を優先して使い切る
+		score += ValenceBoostScale * std::pow(static_cast<float>(remaining), -ValenceBoostPower);
+
+		return score;
+	}
+}
+
+MeshOptimizeStats MeshOptimizer::Optimize(std::vector<uint8_t>& vertices, size_t vertexStride, std::vector<uint32_t>& indices, std::vector<MeshSubset>& subsets)
+{
+	MeshOptimizeStats stats = {};
+
+	size_t vertexCount = vertices.size() / vertexStride;
+
+	stats.acmrBefore = ComputeAcmr(indices.data(), indices.size(), vertexCount);
+
+	// マテリアルを跨いで三角形を入れ替えないようにサブセット毎に行う
+	for (const MeshSubset& subset : subsets)
+	{
+		OptimizeVertexCache(indices.data() + subset.indexOffset, subset.indexCount, vertexCount);
+	}
+
+	OptimizeVertexFetch(vertices, vertexStride, indices);
+
+	stats.acmrAfter = ComputeAcmr(indices.data(), indices.size(), vertexCount);
+
+	for (MeshSubset& subset : subsets)
+	{
+		uint32_t minIndex = InvalidIndex;
+		uint32_t maxIndex = 0;
+
+		for (uint32_t idx = subset.indexOffset; idx < subset.indexOffset + subset.indexCount; ++idx)
+		{
+			minIndex = std::min(minIndex, indices[idx]);
+			maxIndex = std::max(maxIndex, indices[idx]);
+		}
+
+		if (subset.indexCount == 0)
+		{
+			minIndex = 0;
+		}
+
+		subset.baseVertex = minIndex;
+		subset.index32 = maxIndex - minIndex > 0xFFFF;
+
+		++stats.subsetCount;
+		if (!subset.index32)
+		{
+			++stats.index16SubsetCount;
+		}
+	}
+
+	return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount)
+{
+	size_t triCount = indexCount / 3;
+	if (triCount == 0)
+	{
+		return;
+	}
+
+	// 頂点→三角形の隣接リスト。各頂点の先頭remaining個が未出力の三角形
+	std::vector<uint32_t> remaining(vertexCount, 0);
+	for (size_t idx = 0; idx < triCount * 3; ++idx)
+	{
+		++remaining[indices[idx]];
+	}
+
+	std::vector<uint32_t> triOffset(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		triOffset[v + 1] = triOffset[v] + remaining[v];
+	}
+
+	std::vector<uint32_t> vertTris(triCount * 3);
+	{
+		std::vector<uint32_t> cursor(triOffset.begin(), triOffset.end() - 1);
+		for (size_t tri = 0; tri < triCount; ++tri)
+		{
+			for (int corner = 0; corner < 3; ++corner)
+			{
+				vertTris[cursor[indices[tri * 3 + corner]]++] = static_cast<uint32_t>(tri);
+			}
+		}
+	}
+
+	std::vector<int> cachePos(vertexCount, -1);
+	std::vector<float> vertScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		vertScore[v] = VertexScore(-1, remaining[v]);
+	}
+
+	std::vector<float> triScore(triCount);
+	std::vector<bool> emitted(triCount, false);
+	for (size_t tri = 0; tri < triCount; ++tri)
+	{
+		triScore[tri] = vertScore[indices[tri * 3]] + vertScore[indices[tri * 3 + 1]] + vertScore[indices[tri * 3 + 2]];
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(triCount * 3);
+
+	std::vector<uint32_t> cache;
+	std::vector<uint32_t> newCache;
+	cache.reserve(ForsythCacheSize + 3);
+	newCache.reserve(ForsythCacheSize + 3);
+
+	uint32_t bestTri = static_cast<uint32_t>(std::max_element(triScore.begin(), triScore.end()) - triScore.begin());
+	size_t scanCursor = 0;
+
+	for (size_t emitCount = 0; emitCount < triCount; ++emitCount)
+	{
+		// キャッシュ内に候補が無ければ未出力の三角形を先頭から探す
+		if (bestTri == InvalidIndex)
+		{
+			while (emitted[scanCursor])
+			{
+				++scanCursor;
+			}
+			bestTri = static_cast<uint32_t>(scanCursor);
+		}
+
+		const uint32_t* tri = &indices[bestTri * 3];
+		emitted[bestTri] = true;
+
+		for (int corner = 0; corner < 3; ++corner)
+		{
+			uint32_t v = tri[corner];
+			output.push_back(v);
+
+			// 隣接リストの未出力部分から外す
+			uint32_t* begin = &vertTris[triOffset[v]];
+			uint32_t* end = begin + remaining[v];
+			uint32_t* found = std::find(begin, end, bestTri);
+			std::swap(*found, *(end - 1));
+			--remaining[v];
+		}
+
+		// 出力した三角形の頂点をLRUの先頭に置く
+		newCache.assign(tri, tri + 3);
+		for (uint32_t v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				newCache.push_back(v);
+			}
+		}
+
+		for (size_t pos = 0; pos < newCache.size(); ++pos)
+		{
+			cachePos[newCache[pos]] = pos < static_cast<size_t>(ForsythCacheSize) ? static_cast<int>(pos) : -1;
+		}
+
+		// スコアが変わった頂点の三角形スコアを差分更新する
+		for (uint32_t v : newCache)
+		{
+			float score = VertexScore(cachePos[v], remaining[v]);
+			float delta = score - vertScore[v];
+			vertScore[v] = score;
+
+			for (uint32_t t = triOffset[v]; t < triOffset[v] + remaining[v]; ++t)
+			{
+				triScore[vertTris[t]] += delta;
+			}
+		}
+
+		if (newCache.size() > static_cast<size_t>(ForsythCacheSize))
+		{
+			newCache.resize(ForsythCacheSize);
+		}
+		cache.swap(newCache);
+
+		bestTri = InvalidIndex;
+		float bestScore = -1.0F;
+		for (uint32_t v : cache)
+		{
+			for (uint32_t t = triOffset[v]; t < triOffset[v] + remaining[v]; ++t)
+			{
+				if (triScore[vertTris[t]] > bestScore)
+				{
+					bestScore = triScore[vertTris[t]];
+					bestTri = vertTris[t];
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::vector<uint8_t>& vertices, size_t vertexStride, std::vector<uint32_t>& indices)
+{
+	size_t vertexCount = vertices.size() / vertexStride;
+
+	std::vector<uint32_t> remap(vertexCount, InvalidIndex);
+	uint32_t next = 0;
+
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == InvalidIndex)
+		{
+			remap[index] = next++;
+		}
+		index = remap[index];
+	}
+
+	// 参照されない頂点はモーフ等から使われる可能性があるので末尾に残す
+	for (uint32_t& dst : remap)
+	{
+		if (dst == InvalidIndex)
+		{
+			dst = next++;
+		}
+	}
+
+	std::vector<uint8_t> reordered(vertices.size());
+	for (size_t v = 0; v < vertexCount; ++v)
+	{
+		std::memcpy(&reordered[remap[v] * vertexStride], &vertices[v * vertexStride], vertexStride);
+	}
+	vertices.swap(reordered);
+
+	return remap;
+}
+
+float MeshOptimizer::ComputeAcmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	size_t triCount = indexCount / 3;
+	if (triCount == 0)
+	{
+		return 0.0F;
+	}
+
+	// 頂点がキャッシュに入った時刻。時刻の差がキャッシュサイズ未満ならヒット
+	std::vector<uint32_t> insertTime(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	uint32_t misses = 0;
+
+	for (size_t idx = 0; idx < triCount * 3; ++idx)
+	{
+		uint32_t v = indices[idx];
+		if (time - insertTime[v] > cacheSize)
+		{
+			insertTime[v] = time++;
+			++misses;
+		}
+	}
+
+	return static_cast<float>(misses) / static_cast<float>(triCount);
+}
+
+std::vector<uint16_t> MeshOptimizer::ToIndex16(const std::vector<uint32_t>& indices, const MeshSubset& subset)
+{
+	assert(!subset.index32 && "16ビットに収まらないサブセット");
+
+	std::vector<uint16_t> result(subset.indexCount);
+	for (uint32_t idx = 0; idx < subset.indexCount; ++idx)
+	{
+		result[idx] = static_cast<uint16_t>(indices[subset.indexOffset + idx] - subset.baseVertex);
+	}
+
+	return result;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// マテリアル単位のインデックス範囲
+struct MeshSubset
+{
+	uint32_t indexOffset = 0;
+	uint32_t indexCount = 0;
+
+	// 最適化後に決まる値
+	uint32_t baseVertex = 0; // インデックスはこの頂点からの相対値にできる
+	bool index32 = false;    // 相対値が16ビットに収まらない
+};
+
+struct MeshOptimizeStats
+{
+	float acmrBefore = 0.0F;
+	float acmrAfter = 0.0F;
+	uint32_t subsetCount = 0;
+	uint32_t index16SubsetCount = 0;
+};
+
+// インポート時にインデックス・頂点を並べ替えるメッシュ最適化
+class MeshOptimizer
+{
+public:
+
+	// ACMRの計測に使うFIFOキャッシュのサイズ
+	static const uint32_t FifoCacheSize = 16;
+
+	// 頂点キャッシュ最適化 → 頂点フェッチ最適化 → インデックス形式決定をまとめて行う
+	static MeshOptimizeStats Optimize(std::vector<uint8_t>& vertices, size_t vertexStride, std::vector<uint32_t>& indices, std::vector<MeshSubset>& subsets);
+
+	// Forsyth法で三角形の順番を並べ替える
+	static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// 最初に参照された順に頂点を並べ替え、インデックスを書き換える
+	// 戻り値は旧頂点番号→新頂点番号の対応(モーフ等の頂点参照の書き換えに使う)
+	static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint8_t>& vertices, size_t vertexStride, std::vector<uint32_t>& indices);
+
+	// 三角形1つあたりの頂点シェーダー実行回数(FIFOキャッシュで計測)
+	static float ComputeAcmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = FifoCacheSize);
+
+	// baseVertexからの相対インデックスに変換した16ビットインデックスを作る
+	static std::vector<uint16_t> ToIndex16(const std::vector<uint32_t>& indices, const MeshSubset& subset);
+};
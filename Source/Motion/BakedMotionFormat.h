@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../Math/MathTypes.h"
+
+// ベイク済みモーションのファイル形式
+// [ヘッダ][回転トラック x ボーン数][移動トラック x ボーン数][移動の範囲 x ボーン数][表情トラック x 表情数]
+// [回転キー...][移動キー...][表情キー...]
+// 全て先頭からの位置が決まっているので、メモリマップしてそのまま参照できる
+namespace BakedMotionFormat
+{
+	const char Magic[4] = { 'B', 'M', 'O', 'T' };
+	const uint32_t Version = 1;
+
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t frameCount;
+		uint32_t boneCount;
+		uint32_t morphCount;
+		float framesPerSecond;
+
+		// どのモデルとモーションから作ったか
+		uint64_t skeletonHash;
+		uint64_t motionHash;
+
+		uint32_t rotationKeyCount;
+		uint32_t translationKeyCount;
+		uint32_t morphKeyCount;
+		uint32_t reserved;
+	};
+
+	// キー配列の中の範囲
+	struct Track
+	{
+		uint32_t firstKey;
+		uint32_t keyCount;
+	};
+
+	// 移動はトラック毎の範囲で16ビットに量子化する
+	struct TranslationRange
+	{
+		float minimum[3];
+		float scale[3];
+	};
+
+	// 最大成分を除いた3成分を15ビットずつ持つ(smallest three)
+	// 除いた成分の番号はvalue[0]とvalue[1]の最上位ビットに入れる
+	struct RotationKey
+	{
+		uint16_t frame;
+		uint16_t value[3];
+	};
+
+	struct TranslationKey
+	{
+		uint16_t frame;
+		uint16_t value[3];
+	};
+
+	struct MorphKey
+	{
+		uint16_t frame;
+		uint16_t weight;	// UNORM16
+	};
+
+	const float MorphWeightScale = 1.0F / 65535.0F;
+
+	static_assert(sizeof(Header) == 56, "ファイル形式が変わる");
+	static_assert(sizeof(RotationKey) == 8, "ファイル形式が変わる");
+	static_assert(sizeof(TranslationKey) == 8, "ファイル形式が変わる");
+	static_assert(sizeof(MorphKey) == 4, "ファイル形式が変わる");
+
+	// フレーム番号を16ビットで持つので、30fpsで約36分まで
+	const uint32_t MaxFrameCount = 65535;
+
+	// 最大成分以外は±1/√2に収まる
+	const float RotationRange = 0.70710678F;
+	const float RotationSteps = 32767.0F;
+
+	inline void PackRotation(const Float4& rotation, uint16_t value[3])
+	{
+		float q[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+		int largest = 0;
+		for (int i = 1; i < 4; ++i)
+		{
+			if (std::abs(q[i]) > std::abs(q[largest]))
+			{
+				largest = i;
+			}
+		}
+
+		// qと-qは同じ回転なので、最大成分が正になる方を使う
+		float sign = q[largest] < 0.0F ? -1.0F : 1.0F;
+
+		int slot = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+
+			float normalized = std::clamp(q[i] * sign / RotationRange * 0.5F + 0.5F, 0.0F, 1.0F);
+			value[slot++] = static_cast<uint16_t>(std::lround(normalized * RotationSteps));
+		}
+
+		value[0] |= static_cast<uint16_t>((largest & 1) << 15);
+		value[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+	}
+
+	inline Float4 UnpackRotation(const uint16_t value[3])
+	{
+		int largest = (value[0] >> 15) | ((value[1] >> 15) << 1);
+
+		float q[4] = {};
+		float sum = 0.0F;
+		int slot = 0;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i == largest)
+			{
+				continue;
+			}
+
+			float normalized = (value[slot++] & 0x7FFF) / RotationSteps;
+			q[i] = (normalized - 0.5F) * 2.0F * RotationRange;
+			sum += q[i] * q[i];
+		}
+
+		q[largest] = std::sqrt(std::max(1.0F - sum, 0.0F));
+
+		return { q[0], q[1], q[2], q[3] };
+	}
+
+	// 正規化線形補間。slerpより軽く、キーの間隔が短ければ差は小さい
+	inline Float4 NlerpRotation(const Float4& a, const Float4& b, float t)
+	{
+		float dot = Math::Dot(a, b);
+		float sign = dot < 0.0F ? -1.0F : 1.0F;
+
+		float x = a.x + (b.x * sign - a.x) * t;
+		float y = a.y + (b.y * sign - a.y) * t;
+		float z = a.z + (b.z * sign - a.z) * t;
+		float w = a.w + (b.w * sign - a.w) * t;
+
+		float length = std::sqrt(x * x + y * y + z * z + w * w);
+		if (length <= 0.0F)
+		{
+			return a;
+		}
+
+		return { x / length, y / length, z / length, w / length };
+	}
+
+	// 2つの回転の間の角度(ラジアン)
+	inline float RotationAngle(const Float4& a, const Float4& b)
+	{
+		float dot = std::abs(Math::Dot(a, b));
+
+		return 2.0F * std::acos(std::min(dot, 1.0F));
+	}
+
+	inline uint16_t PackUnorm16(float value, float minimum, float scale)
+	{
+		if (scale <= 0.0F)
+		{
+			return 0;
+		}
+
+		return static_cast<uint16_t>(std::clamp(std::lround((value - minimum) / scale), 0L, 65535L));
+	}
+
+	inline float UnpackUnorm16(uint16_t value, float minimum, float scale)
+	{
+		return minimum + value * scale;
+	}
+}
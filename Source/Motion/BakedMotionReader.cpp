@@ -0,0 +1,203 @@
+#include "BakedMotionReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Skeleton.h"
+
+using namespace BakedMotionFormat;
+
+namespace
+{
+	// frameを挟むキーの前側を探す。cursorは前回の結果
+	template<typename Key>
+	uint32_t Seek(const Key* keys, uint32_t count, float frame, uint32_t& cursor)
+	{
+		if (cursor >= count || frame < keys[cursor].frame)
+		{
+			// 巻き戻った(ループした)時だけ二分探索する
+			const Key* it = std::upper_bound(keys, keys + count, frame, [](float f, const Key& key) { return f < key.frame; });
+			cursor = it == keys ? 0 : static_cast<uint32_t>(it - keys - 1);
+		}
+		else
+		{
+			while (cursor + 1 < count && keys[cursor + 1].frame <= frame)
+			{
+				++cursor;
+			}
+		}
+
+		return cursor;
+	}
+
+	template<typename Key>
+	float SegmentT(const Key* keys, uint32_t count, uint32_t index, float frame)
+	{
+		if (index + 1 >= count)
+		{
+			return 0.0F;
+		}
+
+		float t = (frame - keys[index].frame) / static_cast<float>(keys[index + 1].frame - keys[index].frame);
+
+		return std::clamp(t, 0.0F, 1.0F);
+	}
+
+	bool ValidTracks(const Track* tracks, uint32_t trackCount, uint32_t keyCount)
+	{
+		for (uint32_t i = 0; i < trackCount; ++i)
+		{
+			if (tracks[i].keyCount == 0 || tracks[i].firstKey > keyCount || tracks[i].keyCount > keyCount - tracks[i].firstKey)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+BakedMotionReader::~BakedMotionReader()
+{
+	Close();
+}
+
+bool BakedMotionReader::Open(const std::string& path)
+{
+	Close();
+
+	if (!mFile.Open(path) || mFile.Size() < sizeof(Header) || !SetView(mFile.Data(), mFile.Size()))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void BakedMotionReader::Close()
+{
+	mHeader = nullptr;
+	mCursors.clear();
+
+	mFile.Close();
+}
+
+bool BakedMotionReader::SetView(const uint8_t* data, size_t size)
+{
+	const Header* header = reinterpret_cast<const Header*>(data);
+
+	if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 || header->version != Version || header->frameCount == 0)
+	{
+		return false;
+	}
+
+	// 配列の並びはBakedMotionFormat.hの通り
+	size_t offset = sizeof(Header);
+	size_t rotationTracks = offset;
+	offset += sizeof(Track) * header->boneCount;
+	size_t translationTracks = offset;
+	offset += sizeof(Track) * header->boneCount;
+	size_t translationRanges = offset;
+	offset += sizeof(TranslationRange) * header->boneCount;
+	size_t morphTracks = offset;
+	offset += sizeof(Track) * header->morphCount;
+	size_t rotationKeys = offset;
+	offset += sizeof(RotationKey) * header->rotationKeyCount;
+	size_t translationKeys = offset;
+	offset += sizeof(TranslationKey) * header->translationKeyCount;
+	size_t morphKeys = offset;
+	offset += sizeof(MorphKey) * header->morphKeyCount;
+
+	if (offset > size)
+	{
+		return false;
+	}
+
+	mRotationTracks = reinterpret_cast<const Track*>(data + rotationTracks);
+	mTranslationTracks = reinterpret_cast<const Track*>(data + translationTracks);
+	mTranslationRanges = reinterpret_cast<const TranslationRange*>(data + translationRanges);
+	mMorphTracks = reinterpret_cast<const Track*>(data + morphTracks);
+	mRotationKeys = reinterpret_cast<const RotationKey*>(data + rotationKeys);
+	mTranslationKeys = reinterpret_cast<const TranslationKey*>(data + translationKeys);
+	mMorphKeys = reinterpret_cast<const MorphKey*>(data + morphKeys);
+
+	// 壊れたファイルで範囲外を読まないように、再生前に一度だけ確かめる
+	if (!ValidTracks(mRotationTracks, header->boneCount, header->rotationKeyCount) ||
+		!ValidTracks(mTranslationTracks, header->boneCount, header->translationKeyCount) ||
+		!ValidTracks(mMorphTracks, header->morphCount, header->morphKeyCount))
+	{
+		return false;
+	}
+
+	mHeader = header;
+	mCursors.assign(static_cast<size_t>(header->boneCount) * 2 + header->morphCount, 0);
+
+	return true;
+}
+
+bool BakedMotionReader::Sample(float frame, Skeleton& skeleton)
+{
+	if (!IsOpen() || skeleton.Hash() != mHeader->skeletonHash)
+	{
+		return false;
+	}
+
+	auto& rotations = skeleton.LocalRotations();
+	auto& translations = skeleton.LocalTranslations();
+	auto& weights = skeleton.MorphWeights();
+
+	const uint32_t boneCount = mHeader->boneCount;
+	uint32_t* rotationCursors = mCursors.data();
+	uint32_t* translationCursors = rotationCursors + boneCount;
+	uint32_t* morphCursors = translationCursors + boneCount;
+
+	for (uint32_t b = 0; b < boneCount; ++b)
+	{
+		const Track& rotationTrack = mRotationTracks[b];
+		const RotationKey* rotationKeys = mRotationKeys + rotationTrack.firstKey;
+
+		uint32_t index = Seek(rotationKeys, rotationTrack.keyCount, frame, rotationCursors[b]);
+		float t = SegmentT(rotationKeys, rotationTrack.keyCount, index, frame);
+
+		Float4 rotation = UnpackRotation(rotationKeys[index].value);
+		if (t > 0.0F)
+		{
+			rotation = NlerpRotation(rotation, UnpackRotation(rotationKeys[index + 1].value), t);
+		}
+		rotations[b] = rotation;
+
+		const Track& translationTrack = mTranslationTracks[b];
+		const TranslationKey* translationKeys = mTranslationKeys + translationTrack.firstKey;
+		const TranslationRange& range = mTranslationRanges[b];
+
+		index = Seek(translationKeys, translationTrack.keyCount, frame, translationCursors[b]);
+		t = SegmentT(translationKeys, translationTrack.keyCount, index, frame);
+
+		const TranslationKey& p0 = translationKeys[index];
+		const TranslationKey& p1 = translationKeys[t > 0.0F ? index + 1 : index];
+
+		float* translation = &translations[b].x;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float v0 = UnpackUnorm16(p0.value[axis], range.minimum[axis], range.scale[axis]);
+			float v1 = UnpackUnorm16(p1.value[axis], range.minimum[axis], range.scale[axis]);
+			translation[axis] = v0 + (v1 - v0) * t;
+		}
+	}
+
+	for (uint32_t m = 0; m < mHeader->morphCount; ++m)
+	{
+		const Track& track = mMorphTracks[m];
+		const MorphKey* keys = mMorphKeys + track.firstKey;
+
+		uint32_t index = Seek(keys, track.keyCount, frame, morphCursors[m]);
+		float t = SegmentT(keys, track.keyCount, index, frame);
+
+		float w0 = UnpackUnorm16(keys[index].weight, 0.0F, MorphWeightScale);
+		float w1 = UnpackUnorm16(keys[t > 0.0F ? index + 1 : index].weight, 0.0F, MorphWeightScale);
+		weights[m] = w0 + (w1 - w0) * t;
+	}
+
+	return true;
+}
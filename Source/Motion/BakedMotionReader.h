@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BakedMotionFormat.h"
+#include "MappedFile.h"
+
+class Skeleton;
+
+// ベイク済みモーションをメモリマップして再生する
+// ファイルは読み込まずに参照するだけなので、開くのは一瞬で、使ったページだけがメモリに載る
+class BakedMotionReader
+{
+public:
+
+	BakedMotionReader() = default;
+	~BakedMotionReader();
+
+	BakedMotionReader(const BakedMotionReader&) = delete;
+	BakedMotionReader& operator=(const BakedMotionReader&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return mHeader != nullptr; }
+
+	uint32_t FrameCount() const { return mHeader->frameCount; }
+	float FramesPerSecond() const { return mHeader->framesPerSecond; }
+	uint64_t SkeletonHash() const { return mHeader->skeletonHash; }
+	uint64_t MotionHash() const { return mHeader->motionHash; }
+
+	// frameの姿勢をスケルトンのローカル姿勢へ書き込む。ベイクした時のスケルトンと違えばfalse
+	// 前回の位置から探し始めるので、順に再生する時はキーの検索がほぼかからない
+	bool Sample(float frame, Skeleton& skeleton);
+
+private:
+
+	// 範囲外を指していないか確かめてから各配列の位置を決める
+	bool SetView(const uint8_t* data, size_t size);
+
+	MappedFile mFile;
+
+	const BakedMotionFormat::Header* mHeader = nullptr;
+	const BakedMotionFormat::Track* mRotationTracks = nullptr;
+	const BakedMotionFormat::Track* mTranslationTracks = nullptr;
+	const BakedMotionFormat::TranslationRange* mTranslationRanges = nullptr;
+	const BakedMotionFormat::Track* mMorphTracks = nullptr;
+	const BakedMotionFormat::RotationKey* mRotationKeys = nullptr;
+	const BakedMotionFormat::TranslationKey* mTranslationKeys = nullptr;
+	const BakedMotionFormat::MorphKey* mMorphKeys = nullptr;
+
+	// トラック毎の前回のキー(回転、移動、表情の順)
+	std::vector<uint32_t> mCursors;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ファイルを読み取り専用でメモリマップする
+// OSの呼び出しはMappedFileWin32.cpp(CreateFileMapping)とMappedFilePosix.cpp(mmap)にあり、
+// ここにはOSのヘッダーを出さない
+class MappedFile
+{
+public:
+
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// 空のファイルはマップできないのでfalse
+	bool Open(const std::string& path);
+	void Close();
+
+	bool IsOpen() const { return mData != nullptr; }
+
+	const uint8_t* Data() const { return mData; }
+	size_t Size() const { return mSize; }
+
+private:
+
+	// OS毎のハンドル
+	struct Impl;
+
+	std::unique_ptr<Impl> mImpl;
+
+	const uint8_t* mData = nullptr;
+	size_t mSize = 0;
+};
@@ -0,0 +1,68 @@
+#ifndef _WIN32
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MappedFile::Impl
+{
+	// マップした後はファイルを閉じてもよいので、ハンドルは持たない
+};
+
+MappedFile::MappedFile() : mImpl(new Impl())
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat status = {};
+	if (fstat(fd, &status) != 0 || status.st_size <= 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(status.st_size);
+	void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	mData = static_cast<const uint8_t*>(data);
+	mSize = size;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != nullptr)
+	{
+		munmap(const_cast<uint8_t*>(mData), mSize);
+		mData = nullptr;
+	}
+
+	mSize = 0;
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifdef _WIN32
+
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include <filesystem>
+
+struct MappedFile::Impl
+{
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+};
+
+MappedFile::MappedFile() : mImpl(new Impl())
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+	mImpl->file = CreateFileW(std::filesystem::path(path).wstring().c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (mImpl->file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(mImpl->file, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		Close();
+		return false;
+	}
+
+	mImpl->mapping = CreateFileMappingW(mImpl->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mImpl->mapping == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	mData = static_cast<const uint8_t*>(MapViewOfFile(mImpl->mapping, FILE_MAP_READ, 0, 0, 0));
+	if (mData == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	mSize = static_cast<size_t>(fileSize.QuadPart);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != nullptr)
+	{
+		UnmapViewOfFile(mData);
+		mData = nullptr;
+	}
+
+	mSize = 0;
+
+	if (mImpl->mapping != nullptr)
+	{
+		CloseHandle(mImpl->mapping);
+		mImpl->mapping = nullptr;
+	}
+
+	if (mImpl->file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mImpl->file);
+		mImpl->file = INVALID_HANDLE_VALUE;
+	}
+}
+
+#endif
@@ -0,0 +1,365 @@
+#include "MotionBaker.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "BakedMotionFormat.h"
+#include "MotionBinding.h"
+#include "MotionSampler.h"
+#include "Skeleton.h"
+#include "VmdMotion.h"
+
+using namespace BakedMotionFormat;
+
+namespace
+{
+	// 先頭から、誤差に収まる限り遠くまで直線で結べるキーを選んでいく
+	// fits(a, b)はキーaとbの間を補間した時に、間の全フレームが誤差内ならtrue
+	template<typename Fits>
+	std::vector<uint32_t> ReduceKeys(uint32_t frameCount, uint32_t maxKeyGap, Fits fits)
+	{
+		std::vector<uint32_t> keys = { 0 };
+
+		uint32_t start = 0;
+		while (start + 1 < frameCount)
+		{
+			uint32_t best = start + 1;
+			uint32_t last = std::min(start + maxKeyGap, frameCount - 1);
+
+			for (uint32_t end = start + 2; end <= last; ++end)
+			{
+				if (!fits(start, end))
+				{
+					break;
+				}
+				best = end;
+			}
+
+			keys.push_back(best);
+			start = best;
+		}
+
+		// 全く動かないトラックは1キーにする
+		if (keys.size() == 2 && fits(0, 0))
+		{
+			keys.pop_back();
+		}
+
+		return keys;
+	}
+
+	// キーaからbの間(両端を含む)を補間した時の誤差の最大を求める
+	// aとbが同じなら、全フレームをaの値のまま使った時の誤差
+	template<typename Error>
+	float SegmentError(uint32_t a, uint32_t b, uint32_t frameCount, Error error)
+	{
+		float maxError = 0.0F;
+
+		if (a == b)
+		{
+			for (uint32_t f = 0; f < frameCount; ++f)
+			{
+				maxError = std::max(maxError, error(a, a, f, 0.0F));
+			}
+			return maxError;
+		}
+
+		for (uint32_t f = a; f <= b; ++f)
+		{
+			maxError = std::max(maxError, error(a, b, f, static_cast<float>(f - a) / static_cast<float>(b - a)));
+		}
+
+		return maxError;
+	}
+
+	// 間引いた後のキーで全フレームを補間し、元の値との誤差の最大を求める
+	template<typename Error>
+	float TrackError(const std::vector<uint32_t>& keys, uint32_t frameCount, Error error)
+	{
+		float maxError = 0.0F;
+		size_t k = 0;
+
+		for (uint32_t f = 0; f < frameCount; ++f)
+		{
+			while (k + 1 < keys.size() && keys[k + 1] <= f)
+			{
+				++k;
+			}
+
+			if (k + 1 < keys.size())
+			{
+				float t = static_cast<float>(f - keys[k]) / static_cast<float>(keys[k + 1] - keys[k]);
+				maxError = std::max(maxError, error(keys[k], keys[k + 1], f, t));
+			}
+			else
+			{
+				maxError = std::max(maxError, error(keys[k], keys[k], f, 0.0F));
+			}
+		}
+
+		return maxError;
+	}
+
+	template<typename T>
+	void Append(std::vector<uint8_t>& out, const T* data, size_t count)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		out.insert(out.end(), bytes, bytes + sizeof(T) * count);
+	}
+}
+
+std::string MotionBakeReport::Summary() const
+{
+	char buf[256] = {};
+	snprintf(buf, sizeof(buf), "frames=%u raw=%zuKB baked=%zuKB (%.1f%%) keys rot=%u trans=%u morph=%u maxErr rot=%.4frad trans=%.4f morph=%.4f bake=%.1fms",
+		frameCount,
+		rawBytes / 1024,
+		bakedBytes / 1024,
+		rawBytes > 0 ? 100.0 * bakedBytes / rawBytes : 0.0,
+		rotationKeys,
+		translationKeys,
+		morphKeys,
+		maxRotationError,
+		maxTranslationError,
+		maxMorphError,
+		bakeMs);
+
+	return buf;
+}
+
+bool MotionBaker::Bake(const VmdMotion& motion, const Skeleton& skeleton, const MotionBinding& binding, const MotionBakeSettings& settings, std::vector<uint8_t>& out, MotionBakeReport* report)
+{
+	auto beginTime = std::chrono::steady_clock::now();
+
+	uint32_t frameCount = motion.LastFrame() + 1;
+	if (frameCount > MaxFrameCount || settings.maxKeyGap < 1)
+	{
+		return false;
+	}
+
+	const uint32_t boneCount = static_cast<uint32_t>(skeleton.BoneCount());
+	const uint32_t morphCount = static_cast<uint32_t>(skeleton.MorphCount());
+
+	// 全フレームの姿勢を取り出す([ボーン][フレーム]の順)
+	std::vector<Float4> rotations(static_cast<size_t>(boneCount) * frameCount);
+	std::vector<Float3> translations(static_cast<size_t>(boneCount) * frameCount);
+	std::vector<float> weights(static_cast<size_t>(morphCount) * frameCount);
+
+	Skeleton pose = skeleton;
+
+	for (uint32_t f = 0; f < frameCount; ++f)
+	{
+		pose.ResetPose();
+		MotionSampler::Sample(motion, binding, static_cast<float>(f), pose);
+
+		for (uint32_t b = 0; b < boneCount; ++b)
+		{
+			rotations[static_cast<size_t>(b) * frameCount + f] = pose.LocalRotations()[b];
+			translations[static_cast<size_t>(b) * frameCount + f] = pose.LocalTranslations()[b];
+		}
+
+		for (uint32_t m = 0; m < morphCount; ++m)
+		{
+			weights[static_cast<size_t>(m) * frameCount + f] = pose.MorphWeights()[m];
+		}
+	}
+
+	std::vector<Track> rotationTracks(boneCount);
+	std::vector<Track> translationTracks(boneCount);
+	std::vector<TranslationRange> translationRanges(boneCount);
+	std::vector<Track> morphTracks(morphCount);
+
+	std::vector<RotationKey> rotationKeys;
+	std::vector<TranslationKey> translationKeys;
+	std::vector<MorphKey> morphKeys;
+
+	MotionBakeReport result = {};
+	result.frameCount = frameCount;
+
+	// 量子化した後の値で誤差を測るので、誤差には量子化の分も含まれる
+	std::vector<RotationKey> packedRotations(frameCount);
+	std::vector<Float4> decodedRotations(frameCount);
+	std::vector<TranslationKey> packedTranslations(frameCount);
+	std::vector<Float3> decodedTranslations(frameCount);
+
+	for (uint32_t b = 0; b < boneCount; ++b)
+	{
+		const Float4* sourceRotations = &rotations[static_cast<size_t>(b) * frameCount];
+		const Float3* sourceTranslations = &translations[static_cast<size_t>(b) * frameCount];
+
+		// 回転
+		for (uint32_t f = 0; f < frameCount; ++f)
+		{
+			packedRotations[f].frame = static_cast<uint16_t>(f);
+			PackRotation(sourceRotations[f], packedRotations[f].value);
+			decodedRotations[f] = UnpackRotation(packedRotations[f].value);
+		}
+
+		auto rotationError = [&](uint32_t a, uint32_t c, uint32_t f, float t)
+		{
+			return RotationAngle(NlerpRotation(decodedRotations[a], decodedRotations[c], t), sourceRotations[f]);
+		};
+
+		std::vector<uint32_t> keys = ReduceKeys(frameCount, settings.maxKeyGap, [&](uint32_t a, uint32_t c)
+			{
+				return SegmentError(a, c, frameCount, rotationError) <= settings.rotationError;
+			});
+
+		rotationTracks[b] = { static_cast<uint32_t>(rotationKeys.size()), static_cast<uint32_t>(keys.size()) };
+		for (uint32_t key : keys)
+		{
+			rotationKeys.push_back(packedRotations[key]);
+		}
+
+		result.maxRotationError = std::max(result.maxRotationError, TrackError(keys, frameCount, rotationError));
+
+		// 移動はトラック毎の範囲で量子化する
+		TranslationRange& range = translationRanges[b];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float minimum = FLT_MAX;
+			float maximum = -FLT_MAX;
+
+			for (uint32_t f = 0; f < frameCount; ++f)
+			{
+				float value = (&sourceTranslations[f].x)[axis];
+				minimum = std::min(minimum, value);
+				maximum = std::max(maximum, value);
+			}
+
+			range.minimum[axis] = minimum;
+			range.scale[axis] = (maximum - minimum) / 65535.0F;
+		}
+
+		for (uint32_t f = 0; f < frameCount; ++f)
+		{
+			packedTranslations[f].frame = static_cast<uint16_t>(f);
+
+			float* decoded = &decodedTranslations[f].x;
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				packedTranslations[f].value[axis] = PackUnorm16((&sourceTranslations[f].x)[axis], range.minimum[axis], range.scale[axis]);
+				decoded[axis] = UnpackUnorm16(packedTranslations[f].value[axis], range.minimum[axis], range.scale[axis]);
+			}
+		}
+
+		auto translationError = [&](uint32_t a, uint32_t c, uint32_t f, float t)
+		{
+			const Float3& p0 = decodedTranslations[a];
+			const Float3& p1 = decodedTranslations[c];
+			const Float3& source = sourceTranslations[f];
+
+			float dx = p0.x + (p1.x - p0.x) * t - source.x;
+			float dy = p0.y + (p1.y - p0.y) * t - source.y;
+			float dz = p0.z + (p1.z - p0.z) * t - source.z;
+
+			return std::sqrt(dx * dx + dy * dy + dz * dz);
+		};
+
+		keys = ReduceKeys(frameCount, settings.maxKeyGap, [&](uint32_t a, uint32_t c)
+			{
+				return SegmentError(a, c, frameCount, translationError) <= settings.translationError;
+			});
+
+		translationTracks[b] = { static_cast<uint32_t>(translationKeys.size()), static_cast<uint32_t>(keys.size()) };
+		for (uint32_t key : keys)
+		{
+			translationKeys.push_back(packedTranslations[key]);
+		}
+
+		result.maxTranslationError = std::max(result.maxTranslationError, TrackError(keys, frameCount, translationError));
+	}
+
+	std::vector<MorphKey> packedWeights(frameCount);
+	std::vector<float> decodedWeights(frameCount);
+
+	for (uint32_t m = 0; m < morphCount; ++m)
+	{
+		const float* sourceWeights = &weights[static_cast<size_t>(m) * frameCount];
+
+		for (uint32_t f = 0; f < frameCount; ++f)
+		{
+			packedWeights[f].frame = static_cast<uint16_t>(f);
+			packedWeights[f].weight = PackUnorm16(sourceWeights[f], 0.0F, MorphWeightScale);
+			decodedWeights[f] = UnpackUnorm16(packedWeights[f].weight, 0.0F, MorphWeightScale);
+		}
+
+		auto morphError = [&](uint32_t a, uint32_t c, uint32_t f, float t)
+		{
+			return std::abs(decodedWeights[a] + (decodedWeights[c] - decodedWeights[a]) * t - sourceWeights[f]);
+		};
+
+		std::vector<uint32_t> keys = ReduceKeys(frameCount, settings.maxKeyGap, [&](uint32_t a, uint32_t c)
+			{
+				return SegmentError(a, c, frameCount, morphError) <= settings.morphError;
+			});
+
+		morphTracks[m] = { static_cast<uint32_t>(morphKeys.size()), static_cast<uint32_t>(keys.size()) };
+		for (uint32_t key : keys)
+		{
+			morphKeys.push_back(packedWeights[key]);
+		}
+
+		result.maxMorphError = std::max(result.maxMorphError, TrackError(keys, frameCount, morphError));
+	}
+
+	Header header = {};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.frameCount = frameCount;
+	header.boneCount = boneCount;
+	header.morphCount = morphCount;
+	header.framesPerSecond = settings.framesPerSecond;
+	header.skeletonHash = skeleton.Hash();
+	header.motionHash = motion.Hash();
+	header.rotationKeyCount = static_cast<uint32_t>(rotationKeys.size());
+	header.translationKeyCount = static_cast<uint32_t>(translationKeys.size());
+	header.morphKeyCount = static_cast<uint32_t>(morphKeys.size());
+
+	out.clear();
+	Append(out, &header, 1);
+	Append(out, rotationTracks.data(), rotationTracks.size());
+	Append(out, translationTracks.data(), translationTracks.size());
+	Append(out, translationRanges.data(), translationRanges.size());
+	Append(out, morphTracks.data(), morphTracks.size());
+	Append(out, rotationKeys.data(), rotationKeys.size());
+	Append(out, translationKeys.data(), translationKeys.size());
+	Append(out, morphKeys.data(), morphKeys.size());
+
+	if (report != nullptr)
+	{
+		result.rawBytes = static_cast<size_t>(frameCount) * (boneCount * (sizeof(Float4) + sizeof(Float3)) + morphCount * sizeof(float));
+		result.bakedBytes = out.size();
+		result.rotationKeys = header.rotationKeyCount;
+		result.translationKeys = header.translationKeyCount;
+		result.morphKeys = header.morphKeyCount;
+		result.bakeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beginTime).count();
+
+		*report = result;
+	}
+
+	return true;
+}
+
+bool MotionBaker::BakeToFile(const VmdMotion& motion, const Skeleton& skeleton, const MotionBinding& binding, const MotionBakeSettings& settings, const std::string& path, MotionBakeReport* report)
+{
+	std::vector<uint8_t> data;
+	if (!Bake(motion, skeleton, binding, settings, data, report))
+	{
+		return false;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+	return static_cast<bool>(file);
+}
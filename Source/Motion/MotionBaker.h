@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MotionBinding;
+class Skeleton;
+class VmdMotion;
+
+struct MotionBakeSettings
+{
+	// VMDのフレーム毎(30fps)に姿勢を取り出す
+	float framesPerSecond = 30.0F;
+
+	// キーを間引く時に許す誤差
+	float rotationError = 0.002F;		// ラジアン
+	float translationError = 0.001F;	// モデルの単位
+	float morphError = 1.0F / 512.0F;
+
+	// キーの間隔の上限。間引きの計算量を抑える
+	uint32_t maxKeyGap = 256;
+};
+
+// ベイクの結果。誤差は全フレームで元の姿勢と比べた最大値
+struct MotionBakeReport
+{
+	uint32_t frameCount = 0;
+
+	// 全フレームの姿勢をfloatのまま持った場合のバイト数
+	size_t rawBytes = 0;
+	size_t bakedBytes = 0;
+
+	uint32_t rotationKeys = 0;
+	uint32_t translationKeys = 0;
+	uint32_t morphKeys = 0;
+
+	float maxRotationError = 0.0F;
+	float maxTranslationError = 0.0F;
+	float maxMorphError = 0.0F;
+
+	double bakeMs = 0.0;
+
+	std::string Summary() const;
+};
+
+// VMDを毎フレーム評価した姿勢を、量子化とキーの間引きで圧縮する
+// 同じダンスを繰り返し再生する時に、ベジェの評価を毎フレームしなくて済む
+class MotionBaker
+{
+public:
+
+	static bool Bake(const VmdMotion& motion, const Skeleton& skeleton, const MotionBinding& binding, const MotionBakeSettings& settings, std::vector<uint8_t>& out, MotionBakeReport* report = nullptr);
+
+	static bool BakeToFile(const VmdMotion& motion, const Skeleton& skeleton, const MotionBinding& binding, const MotionBakeSettings& settings, const std::string& path, MotionBakeReport* report = nullptr);
+};
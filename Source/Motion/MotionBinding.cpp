@@ -0,0 +1,86 @@
+#include "MotionBinding.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "Skeleton.h"
+#include "VmdMotion.h"
+
+namespace
+{
+	// VMDの名前は15バイトで切られているので、モデル側も同じ長さに切って比べる
+	// 2バイト文字の途中で切れることもあるが、VMDを書き出す側も同じ切り方をしている
+	std::string TruncateName(const std::string& name)
+	{
+		return name.substr(0, VmdMotion::BoneNameLength);
+	}
+
+	// 同じ名前が複数あれば先のものを使う
+	template<typename NameOf>
+	std::unordered_map<std::string, int> MakeNameTable(size_t count, NameOf nameOf)
+	{
+		std::unordered_map<std::string, int> table;
+		table.reserve(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			table.emplace(TruncateName(nameOf(i)), static_cast<int>(i));
+		}
+
+		return table;
+	}
+
+	template<typename Track>
+	size_t Resolve(const std::vector<Track>& tracks, const std::unordered_map<std::string, int>& table, std::vector<int>& targets)
+	{
+		size_t unresolved = 0;
+
+		targets.resize(tracks.size());
+
+		for (size_t i = 0; i < tracks.size(); ++i)
+		{
+			auto it = table.find(tracks[i].name);
+
+			if (it == table.end())
+			{
+				targets[i] = -1;
+				++unresolved;
+			}
+			else
+			{
+				targets[i] = it->second;
+			}
+		}
+
+		return unresolved;
+	}
+}
+
+std::shared_ptr<const MotionBinding> MotionBindingCache::Get(const Skeleton& skeleton, const VmdMotion& motion)
+{
+	auto key = std::make_pair(skeleton.Hash(), motion.Hash());
+
+	auto it = mBindings.find(key);
+	if (it != mBindings.end())
+	{
+		return it->second;
+	}
+
+	auto binding = std::make_shared<const MotionBinding>(Bind(skeleton, motion));
+	mBindings.emplace(key, binding);
+
+	return binding;
+}
+
+MotionBinding MotionBindingCache::Bind(const Skeleton& skeleton, const VmdMotion& motion)
+{
+	MotionBinding binding;
+
+	auto bones = MakeNameTable(skeleton.BoneCount(), [&](size_t i) -> const std::string& { return skeleton.BoneName(i); });
+	binding.unresolvedBones = Resolve(motion.BoneTracks(), bones, binding.boneTargets);
+
+	auto morphs = MakeNameTable(skeleton.MorphCount(), [&](size_t i) -> const std::string& { return skeleton.MorphName(i); });
+	binding.unresolvedMorphs = Resolve(motion.MorphTracks(), morphs, binding.morphTargets);
+
+	return binding;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class Skeleton;
+class VmdMotion;
+
+// VMDのトラック番号 -> モデルのボーン(表情)番号。見つからなければ-1
+struct MotionBinding
+{
+	std::vector<int> boneTargets;
+	std::vector<int> morphTargets;
+
+	size_t unresolvedBones = 0;
+	size_t unresolvedMorphs = 0;
+};
+
+// 名前の照合はモデルとモーションの組につき1回だけ行い、結果を使い回す
+// メインスレッドからだけ使うこと
+class MotionBindingCache
+{
+public:
+
+	MotionBindingCache() = default;
+	~MotionBindingCache() = default;
+
+	// 同じ組のモデルとモーションなら、2回目以降は照合せずに前の結果を返す
+	std::shared_ptr<const MotionBinding> Get(const Skeleton& skeleton, const VmdMotion& motion);
+
+	void Clear() { mBindings.clear(); }
+	size_t Size() const { return mBindings.size(); }
+
+	// 名前をハッシュで引いて対応を作る
+	static MotionBinding Bind(const Skeleton& skeleton, const VmdMotion& motion);
+
+private:
+
+	// (モデルのハッシュ, モーションのハッシュ)
+	std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<const MotionBinding>> mBindings;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// モデルとモーションの組をキャッシュするためのFNV-1aハッシュ
+namespace MotionHash
+{
+	const uint64_t Seed = 14695981039346656037ULL;
+
+	// seedに前の結果を渡すと続けて計算できる
+	inline uint64_t Bytes(const void* data, size_t size, uint64_t seed = Seed)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		uint64_t hash = seed;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+
+		return hash;
+	}
+}
@@ -0,0 +1,158 @@
+#include "MotionSampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MotionBinding.h"
+#include "Skeleton.h"
+#include "VmdMotion.h"
+
+namespace
+{
+	// VMDの補間パラメータの並び(64バイトのうち先頭16バイト)
+	// X:[0,4,8,12] Y:[1,5,9,13] Z:[2,6,10,14] 回転:[3,7,11,15]
+	enum InterpolationChannel
+	{
+		ChannelX = 0,
+		ChannelY = 1,
+		ChannelZ = 2,
+		ChannelRotation = 3,
+	};
+
+	float Interpolate(const VmdBoneKey& next, InterpolationChannel channel, float t)
+	{
+		const uint8_t* ip = next.interpolation;
+
+		return MotionSampler::EvaluateBezier(t, ip[channel], ip[channel + 4], ip[channel + 8], ip[channel + 12]);
+	}
+
+	// frame以下で一番後ろのキーと、その次のキーを探す
+	template<typename Key>
+	void FindKeys(const std::vector<Key>& keys, float frame, const Key*& prev, const Key*& next, float& t)
+	{
+		auto it = std::upper_bound(keys.begin(), keys.end(), frame, [](float f, const Key& key) { return f < static_cast<float>(key.frame); });
+
+		if (it == keys.begin())
+		{
+			prev = next = &keys.front();
+			t = 0.0F;
+			return;
+		}
+
+		if (it == keys.end())
+		{
+			prev = next = &keys.back();
+			t = 0.0F;
+			return;
+		}
+
+		prev = &*(it - 1);
+		next = &*it;
+		t = (frame - static_cast<float>(prev->frame)) / static_cast<float>(next->frame - prev->frame);
+	}
+}
+
+void MotionSampler::Sample(const VmdMotion& motion, const MotionBinding& binding, float frame, Skeleton& skeleton)
+{
+	auto& translations = skeleton.LocalTranslations();
+	auto& rotations = skeleton.LocalRotations();
+	auto& weights = skeleton.MorphWeights();
+
+	const auto& boneTracks = motion.BoneTracks();
+
+	for (size_t i = 0; i < boneTracks.size(); ++i)
+	{
+		int bone = binding.boneTargets[i];
+		if (bone < 0 || boneTracks[i].keys.empty())
+		{
+			continue;
+		}
+
+		const VmdBoneKey* prev = nullptr;
+		const VmdBoneKey* next = nullptr;
+		float t = 0.0F;
+		FindKeys(boneTracks[i].keys, frame, prev, next, t);
+
+		if (prev == next)
+		{
+			translations[bone] = prev->position;
+			rotations[bone] = prev->rotation;
+			continue;
+		}
+
+		// 軸毎に別の補間曲線を持つ
+		Float3& position = translations[bone];
+		position.x = prev->position.x + (next->position.x - prev->position.x) * Interpolate(*next, ChannelX, t);
+		position.y = prev->position.y + (next->position.y - prev->position.y) * Interpolate(*next, ChannelY, t);
+		position.z = prev->position.z + (next->position.z - prev->position.z) * Interpolate(*next, ChannelZ, t);
+
+		rotations[bone] = Math::Slerp(prev->rotation, next->rotation, Interpolate(*next, ChannelRotation, t));
+	}
+
+	const auto& morphTracks = motion.MorphTracks();
+
+	for (size_t i = 0; i < morphTracks.size(); ++i)
+	{
+		int morph = binding.morphTargets[i];
+		if (morph < 0 || morphTracks[i].keys.empty())
+		{
+			continue;
+		}
+
+		const VmdMorphKey* prev = nullptr;
+		const VmdMorphKey* next = nullptr;
+		float t = 0.0F;
+		FindKeys(morphTracks[i].keys, frame, prev, next, t);
+
+		// 表情は線形補間
+		weights[morph] = prev->weight + (next->weight - prev->weight) * t;
+	}
+}
+
+float MotionSampler::EvaluateBezier(float x, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+	// 直線なら解く必要はない
+	if (x1 == y1 && x2 == y2)
+	{
+		return x;
+	}
+
+	const float px1 = x1 / 127.0F;
+	const float py1 = y1 / 127.0F;
+	const float px2 = x2 / 127.0F;
+	const float py2 = y2 / 127.0F;
+
+	auto bezier = [](float p1, float p2, float t)
+	{
+		float s = 1.0F - t;
+		return 3.0F * s * s * t * p1 + 3.0F * s * t * t * p2 + t * t * t;
+	};
+
+	// x(t)は単調増加なので二分法でtを求める
+	float lo = 0.0F;
+	float hi = 1.0F;
+	float t = x;
+
+	for (int i = 0; i < 24; ++i)
+	{
+		float bx = bezier(px1, px2, t);
+
+		if (std::abs(bx - x) < 1.0e-5F)
+		{
+			break;
+		}
+
+		if (bx < x)
+		{
+			lo = t;
+		}
+		else
+		{
+			hi = t;
+		}
+
+		t = (lo + hi) * 0.5F;
+	}
+
+	return bezier(py1, py2, t);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+struct MotionBinding;
+class Skeleton;
+class VmdMotion;
+
+// VMDを指定フレームで補間し、スケルトンのローカル姿勢の配列へ直接書き込む
+class MotionSampler
+{
+public:
+
+	// バインドされたボーンと表情だけを書き換える。それ以外はそのまま
+	static void Sample(const VmdMotion& motion, const MotionBinding& binding, float frame, Skeleton& skeleton);
+
+	// VMDの補間曲線(始点(0,0)、終点(1,1)の3次ベジェ)で、xに対するyを求める
+	// 制御点は0～127の整数をそのまま渡す
+	static float EvaluateBezier(float x, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2);
+};
@@ -0,0 +1,72 @@
+#include "Skeleton.h"
+
+#include <algorithm>
+
+#include "VmdMotion.h"
+
+namespace
+{
+	// ボーンと表情で同じ名前があっても別のハッシュになるように区切る
+	const uint8_t BoneTag = 'B';
+	const uint8_t MorphTag = 'M';
+}
+
+int Skeleton::AddBone(const std::string& name, int parent)
+{
+	int index = static_cast<int>(mBoneNames.size());
+
+	mBoneNames.push_back(name);
+	mParents.push_back(parent);
+	mLocalTranslations.push_back({ 0.0F, 0.0F, 0.0F });
+	mLocalRotations.push_back({ 0.0F, 0.0F, 0.0F, 1.0F });
+
+	uint64_t hash = MotionHash::Bytes(&BoneTag, sizeof(BoneTag), mHash);
+	hash = MotionHash::Bytes(name.data(), name.size() + 1, hash);
+	mHash = MotionHash::Bytes(&parent, sizeof(parent), hash);
+
+	return index;
+}
+
+int Skeleton::AddMorph(const std::string& name)
+{
+	int index = static_cast<int>(mMorphNames.size());
+
+	mMorphNames.push_back(name);
+	mMorphWeights.push_back(0.0F);
+
+	uint64_t hash = MotionHash::Bytes(&MorphTag, sizeof(MorphTag), mHash);
+	mHash = MotionHash::Bytes(name.data(), name.size() + 1, hash);
+
+	return index;
+}
+
+Skeleton Skeleton::FromMotion(const VmdMotion& motion)
+{
+	Skeleton skeleton;
+
+	for (const VmdBoneTrack& track : motion.BoneTracks())
+	{
+		skeleton.AddBone(track.name, -1);
+	}
+
+	for (const VmdMorphTrack& track : motion.MorphTracks())
+	{
+		skeleton.AddMorph(track.name);
+	}
+
+	return skeleton;
+}
+
+int Skeleton::FindBone(const std::string& name) const
+{
+	auto it = std::find(mBoneNames.begin(), mBoneNames.end(), name);
+
+	return it == mBoneNames.end() ? -1 : static_cast<int>(it - mBoneNames.begin());
+}
+
+void Skeleton::ResetPose()
+{
+	std::fill(mLocalTranslations.begin(), mLocalTranslations.end(), Float3{ 0.0F, 0.0F, 0.0F });
+	std::fill(mLocalRotations.begin(), mLocalRotations.end(), Float4{ 0.0F, 0.0F, 0.0F, 1.0F });
+	std::fill(mMorphWeights.begin(), mMorphWeights.end(), 0.0F);
+}
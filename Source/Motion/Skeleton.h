@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Math/MathTypes.h"
+#include "MotionHash.h"
+
+class VmdMotion;
+
+// ボーンの階層と、モーションが書き込むローカル姿勢
+// 姿勢はボーン毎の構造体ではなく要素毎の配列で持ち、サンプラーがそのまま書き込む
+class Skeleton
+{
+public:
+
+	Skeleton() = default;
+	~Skeleton() = default;
+
+	// 名前はShift-JIS。parentは既に追加したボーンの番号か-1
+	int AddBone(const std::string& name, int parent);
+	int AddMorph(const std::string& name);
+
+	// モデルの読み込みがまだ無いので、モーションのトラック名から親の無いボーンと表情を作る
+	// 同じモーションからは同じハッシュのスケルトンになる
+	static Skeleton FromMotion(const VmdMotion& motion);
+
+	// 見つからなければ-1
+	int FindBone(const std::string& name) const;
+
+	size_t BoneCount() const { return mBoneNames.size(); }
+	size_t MorphCount() const { return mMorphNames.size(); }
+
+	const std::string& BoneName(size_t index) const { return mBoneNames[index]; }
+	const std::string& MorphName(size_t index) const { return mMorphNames[index]; }
+	int Parent(size_t index) const { return mParents[index]; }
+
+	// ローカル姿勢を初期状態(移動0、回転なし、表情0)に戻す
+	void ResetPose();
+
+	std::vector<Float3>& LocalTranslations() { return mLocalTranslations; }
+	std::vector<Float4>& LocalRotations() { return mLocalRotations; }
+	std::vector<float>& MorphWeights() { return mMorphWeights; }
+
+	const std::vector<Float3>& LocalTranslations() const { return mLocalTranslations; }
+	const std::vector<Float4>& LocalRotations() const { return mLocalRotations; }
+	const std::vector<float>& MorphWeights() const { return mMorphWeights; }
+
+	// 名前と親子関係から求めたハッシュ。構成が同じモデルなら同じ値になる
+	uint64_t Hash() const { return mHash; }
+
+private:
+
+	std::vector<std::string> mBoneNames;
+	std::vector<int> mParents;
+	std::vector<std::string> mMorphNames;
+
+	std::vector<Float3> mLocalTranslations;
+	std::vector<Float4> mLocalRotations;
+	std::vector<float> mMorphWeights;
+
+	uint64_t mHash = MotionHash::Seed;
+};
@@ -0,0 +1,196 @@
+#include "VmdMotion.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include "MotionHash.h"
+
+namespace
+{
+	const char SignatureV2[] = "Vocaloid Motion Data 0002";
+	const char SignatureV1[] = "Vocaloid Motion Data file";
+	const size_t SignatureLength = 30;
+
+	// 古い形式はモデル名が10バイト
+	const size_t ModelNameLengthV1 = 10;
+
+	// ファイルの先頭から順に読む
+	class ByteReader
+	{
+	public:
+
+		ByteReader(const uint8_t* data, size_t size)
+			: mData(data), mRemain(size)
+		{
+		}
+
+		bool Read(void* out, size_t size)
+		{
+			if (size > mRemain)
+			{
+				return false;
+			}
+
+			std::memcpy(out, mData, size);
+			mData += size;
+			mRemain -= size;
+
+			return true;
+		}
+
+		template<typename T>
+		bool Read(T& out)
+		{
+			return Read(&out, sizeof(T));
+		}
+
+	private:
+
+		const uint8_t* mData;
+		size_t mRemain;
+	};
+
+	// 同じ名前のキーを1つのトラックにまとめ、フレーム順に並べる
+	template<typename Key>
+	void AddKey(std::vector<VmdTrack<Key>>& tracks, std::unordered_map<std::string, size_t>& indices, std::string&& name, const Key& key)
+	{
+		auto it = indices.find(name);
+
+		if (it == indices.end())
+		{
+			it = indices.emplace(name, tracks.size()).first;
+			tracks.push_back({ std::move(name), {} });
+		}
+
+		tracks[it->second].keys.push_back(key);
+	}
+
+	template<typename Key>
+	void SortKeys(std::vector<VmdTrack<Key>>& tracks)
+	{
+		for (auto& track : tracks)
+		{
+			std::stable_sort(track.keys.begin(), track.keys.end(), [](const Key& a, const Key& b) { return a.frame < b.frame; });
+		}
+	}
+}
+
+bool VmdMotion::Load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return LoadFromMemory(data.data(), data.size());
+}
+
+bool VmdMotion::LoadFromMemory(const uint8_t* data, size_t size)
+{
+	mModelName.clear();
+	mBoneTracks.clear();
+	mMorphTracks.clear();
+	mLastFrame = 0;
+	mHash = MotionHash::Bytes(data, size);
+
+	ByteReader reader(data, size);
+
+	char signature[SignatureLength] = {};
+	if (!reader.Read(signature, SignatureLength))
+	{
+		return false;
+	}
+
+	size_t modelNameLength = 0;
+
+	if (std::strncmp(signature, SignatureV2, sizeof(SignatureV2) - 1) == 0)
+	{
+		modelNameLength = ModelNameLength;
+	}
+	else if (std::strncmp(signature, SignatureV1, sizeof(SignatureV1) - 1) == 0)
+	{
+		modelNameLength = ModelNameLengthV1;
+	}
+	else
+	{
+		return false;
+	}
+
+	char modelName[ModelNameLength] = {};
+	if (!reader.Read(modelName, modelNameLength))
+	{
+		return false;
+	}
+
+	mModelName = ReadName(modelName, modelNameLength);
+
+	uint32_t boneKeyCount = 0;
+	if (!reader.Read(boneKeyCount))
+	{
+		return false;
+	}
+
+	std::unordered_map<std::string, size_t> boneIndices;
+
+	for (uint32_t i = 0; i < boneKeyCount; ++i)
+	{
+		char name[BoneNameLength] = {};
+		VmdBoneKey key = {};
+
+		// ファイル上は111バイトで詰まっているので1項目ずつ読む
+		if (!reader.Read(name, BoneNameLength) ||
+			!reader.Read(key.frame) ||
+			!reader.Read(key.position) ||
+			!reader.Read(key.rotation) ||
+			!reader.Read(key.interpolation, sizeof(key.interpolation)))
+		{
+			return false;
+		}
+
+		mLastFrame = std::max(mLastFrame, key.frame);
+		AddKey(mBoneTracks, boneIndices, ReadName(name, BoneNameLength), key);
+	}
+
+	// 表情が無い古いファイルもある
+	uint32_t morphKeyCount = 0;
+	if (reader.Read(morphKeyCount))
+	{
+		std::unordered_map<std::string, size_t> morphIndices;
+
+		for (uint32_t i = 0; i < morphKeyCount; ++i)
+		{
+			char name[BoneNameLength] = {};
+			VmdMorphKey key = {};
+
+			if (!reader.Read(name, BoneNameLength) ||
+				!reader.Read(key.frame) ||
+				!reader.Read(key.weight))
+			{
+				return false;
+			}
+
+			mLastFrame = std::max(mLastFrame, key.frame);
+			AddKey(mMorphTracks, morphIndices, ReadName(name, BoneNameLength), key);
+		}
+	}
+
+	// カメラ・照明・セルフ影は使わない
+
+	SortKeys(mBoneTracks);
+	SortKeys(mMorphTracks);
+
+	return true;
+}
+
+std::string VmdMotion::ReadName(const char* field, size_t length)
+{
+	const char* end = std::find(field, field + length, '\0');
+
+	return std::string(field, end);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Math/MathTypes.h"
+
+// VMDのボーンのキーフレーム
+struct VmdBoneKey
+{
+	uint32_t frame;
+	Float3 position;
+	Float4 rotation;		// クォータニオン
+
+	// X,Y,Z,回転それぞれのベジェ制御点(0～127)。前のキーからこのキーまでの補間に使う
+	uint8_t interpolation[64];
+};
+
+// VMDの表情のキーフレーム
+struct VmdMorphKey
+{
+	uint32_t frame;
+	float weight;
+};
+
+// 1つのボーン(表情)のキーフレーム列。フレーム順に並んでいる
+template<typename Key>
+struct VmdTrack
+{
+	// Shift-JISのまま(最大15バイト)
+	std::string name;
+	std::vector<Key> keys;
+};
+
+using VmdBoneTrack = VmdTrack<VmdBoneKey>;
+using VmdMorphTrack = VmdTrack<VmdMorphKey>;
+
+// VMDファイルを名前毎のトラックにまとめて読み込む
+class VmdMotion
+{
+public:
+
+	// VMDの名前欄のバイト数
+	static const size_t BoneNameLength = 15;
+	static const size_t ModelNameLength = 20;
+
+	VmdMotion() = default;
+	~VmdMotion() = default;
+
+	bool Load(const std::string& path);
+	bool LoadFromMemory(const uint8_t* data, size_t size);
+
+	const std::string& ModelName() const { return mModelName; }
+	const std::vector<VmdBoneTrack>& BoneTracks() const { return mBoneTracks; }
+	const std::vector<VmdMorphTrack>& MorphTracks() const { return mMorphTracks; }
+
+	uint32_t LastFrame() const { return mLastFrame; }
+
+	// ファイルの中身から求めたハッシュ。バインド結果のキャッシュに使う
+	uint64_t Hash() const { return mHash; }
+
+	// 固定長の名前欄を、最初の0までのShift-JISの文字列にする
+	// Shift-JISの2バイト目は0x40以上なので、0で切っても文字の途中で切れることはない
+	static std::string ReadName(const char* field, size_t length);
+
+private:
+
+	std::string mModelName;
+	std::vector<VmdBoneTrack> mBoneTracks;
+	std::vector<VmdMorphTrack> mMorphTracks;
+	uint32_t mLastFrame = 0;
+	uint64_t mHash = 0;
+};
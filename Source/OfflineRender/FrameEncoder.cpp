@@ -0,0 +1,203 @@
+#include "FrameEncoder.h"
+
+#include <cassert>
+#include <utility>
+
+#include "../Profiler/CpuProfiler.h"
+
+namespace
+{
+	// 変換済みで書き出しを待てるフレーム数。書き出しが遅い時にメモリを使い切らないようにする
+	const size_t MaxPendingFrames = 8;
+}
+
+FrameEncoder::~FrameEncoder()
+{
+	Finish();
+}
+
+bool FrameEncoder::Start(const OfflineRenderSettings& settings, uint32_t width, uint32_t height, size_t rowPitch, ReadbackFunction readback)
+{
+	mSettings = settings;
+	mWidth = width;
+	mHeight = height;
+	mRowPitch = rowPitch;
+	mReadback = std::move(readback);
+
+	if (mSettings.readbackSlots == 0 || mSettings.workerCount == 0)
+	{
+		assert(false && "読み戻しスロットと変換スレッドは1以上");
+		return false;
+	}
+
+	if (!mWriter.Open(mSettings.path, mSettings.format, width, height, mSettings.framesPerSecond))
+	{
+		assert(false && "動画ファイルを開けない");
+		return false;
+	}
+
+	mSlots.assign(mSettings.readbackSlots, Slot());
+	mFreeSlots.clear();
+	mSubmittedSlots.clear();
+	for (uint32_t i = 0; i < mSettings.readbackSlots; ++i)
+	{
+		mFreeSlots.push_back(i);
+	}
+
+	mQuit = false;
+	mNextFrame = 0;
+	mNextWriteFrame = 0;
+	mStallCount = 0;
+	mStallMs = 0.0;
+
+	for (uint32_t i = 0; i < mSettings.workerCount; ++i)
+	{
+		mWorkers.emplace_back(&FrameEncoder::WorkerMain, this);
+	}
+
+	mWriterThread = std::thread(&FrameEncoder::WriterMain, this);
+
+	return true;
+}
+
+uint32_t FrameEncoder::AcquireSlot()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	// 全スロットが変換待ちの時だけ止まる
+	if (mFreeSlots.empty())
+	{
+		int64_t stallBeginNs = CpuProfiler::NowNs();
+
+		mCondition.wait(lock, [this] { return !mFreeSlots.empty(); });
+
+		++mStallCount;
+		mStallMs += (CpuProfiler::NowNs() - stallBeginNs) / 1.0e6;
+	}
+
+	uint32_t slotIndex = mFreeSlots.back();
+	mFreeSlots.pop_back();
+
+	return slotIndex;
+}
+
+void FrameEncoder::Submit(uint32_t slot, uint64_t fenceValue)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mSlots[slot].frameIndex = mNextFrame++;
+		mSlots[slot].fenceValue = fenceValue;
+
+		mSubmittedSlots.push_back(slot);
+	}
+
+	mCondition.notify_all();
+}
+
+void FrameEncoder::Finish()
+{
+	if (mWriterThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+
+		mCondition.notify_all();
+
+		for (auto& worker : mWorkers)
+		{
+			worker.join();
+		}
+
+		mWriterThread.join();
+	}
+
+	mWorkers.clear();
+	mWriter.Close();
+}
+
+void FrameEncoder::WorkerMain()
+{
+	CpuProfiler::Instance().SetThreadName("OfflineConvert");
+
+	while (true)
+	{
+		uint32_t slotIndex = 0;
+		Slot slot;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			// 先に出したスロットから取るので、書き出し待ちの先頭のフレームは必ずどこかのスレッドが持っている
+			mCondition.wait(lock, [this] { return mQuit || (!mSubmittedSlots.empty() && mConvertedFrames.size() < MaxPendingFrames); });
+
+			if (mSubmittedSlots.empty())
+			{
+				break;
+			}
+
+			slotIndex = mSubmittedSlots.front();
+			mSubmittedSlots.erase(mSubmittedSlots.begin());
+			slot = mSlots[slotIndex];
+		}
+
+		// コピーが終わるまで待つ
+		const uint8_t* pixels = mReadback(slotIndex, slot.fenceValue);
+
+		std::vector<uint8_t> frame;
+
+		{
+			PROFILE_SCOPE("FrameEncoder::ConvertFrame");
+
+			VideoWriter::ConvertFrame(mSettings.format, pixels, mRowPitch, mWidth, mHeight, frame);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			mConvertedFrames[slot.frameIndex] = std::move(frame);
+			mFreeSlots.push_back(slotIndex);
+		}
+
+		mCondition.notify_all();
+	}
+}
+
+void FrameEncoder::WriterMain()
+{
+	CpuProfiler::Instance().SetThreadName("OfflineWrite");
+
+	while (true)
+	{
+		std::vector<uint8_t> frame;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			// 変換は順不同で終わるので、次に書く番号が揃うまで待つ
+			mCondition.wait(lock, [this] { return mConvertedFrames.count(mNextWriteFrame) > 0 || (mQuit && mNextWriteFrame == mNextFrame); });
+
+			auto it = mConvertedFrames.find(mNextWriteFrame);
+			if (it == mConvertedFrames.end())
+			{
+				break;
+			}
+
+			frame = std::move(it->second);
+			mConvertedFrames.erase(it);
+			++mNextWriteFrame;
+		}
+
+		// 書き出し待ちが減ったので変換スレッドを起こす
+		mCondition.notify_all();
+
+		PROFILE_SCOPE("FrameEncoder::WriteFrame");
+
+		if (!mWriter.WriteFrame(frame))
+		{
+			assert(false && "動画ファイルの書き込み失敗");
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VideoWriter.h"
+
+struct OfflineRenderSettings
+{
+	std::string path;
+	VideoFormat format = VideoFormat::Y4m;
+
+	uint32_t frameCount = 300;
+	uint32_t framesPerSecond = 30;
+
+	// 読み戻しバッファの数。GPUが書いている間に、前のフレームを変換できる
+	uint32_t readbackSlots = 3;
+
+	// 変換スレッドの数(書き出しは別に1スレッド)
+	uint32_t workerCount = 2;
+};
+
+// 読み戻しスロットのリングと、変換・書き出しのスレッド
+// スロットの中身(GPUからのコピー)はd3d12.hに依存させず、読み戻し元の関数から受け取る(OfflineRenderer.cpp)
+class FrameEncoder
+{
+public:
+
+	// スロットへのコピーがfenceValueで終わるまで待ち、その画素(行の間隔はrowPitch)を返す。変換スレッドから呼ぶ
+	using ReadbackFunction = std::function<const uint8_t*(uint32_t slot, uint64_t fenceValue)>;
+
+	FrameEncoder() = default;
+	~FrameEncoder();
+
+	FrameEncoder(const FrameEncoder&) = delete;
+	FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+	bool Start(const OfflineRenderSettings& settings, uint32_t width, uint32_t height, size_t rowPitch, ReadbackFunction readback);
+
+	// 空いているスロットを取る。全スロットが変換待ちの時だけ待つ
+	uint32_t AcquireSlot();
+
+	// AcquireSlotで取ったスロットへのコピーを積んだ。フレーム番号は呼んだ順
+	void Submit(uint32_t slot, uint64_t fenceValue);
+
+	// 残りのフレームを全て書き出してからスレッドを止める
+	void Finish();
+
+	uint32_t SubmittedFrames() const { return mNextFrame; }
+
+	// 空きスロットを待った回数と合計時間(長ければ変換・書き出しが間に合っていない)
+	uint32_t StallCount() const { return mStallCount; }
+	double StallMs() const { return mStallMs; }
+
+private:
+
+	struct Slot
+	{
+		uint64_t frameIndex = 0;
+		uint64_t fenceValue = 0;
+	};
+
+	void WorkerMain();
+	void WriterMain();
+
+	OfflineRenderSettings mSettings;
+	VideoWriter mWriter;
+	ReadbackFunction mReadback;
+
+	uint32_t mWidth = 0;
+	uint32_t mHeight = 0;
+	size_t mRowPitch = 0;
+
+	std::vector<Slot> mSlots;
+	uint32_t mNextFrame = 0;
+	uint32_t mStallCount = 0;
+	double mStallMs = 0.0;
+
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+
+	// 空いているスロット / コピー待ちのスロット
+	std::vector<uint32_t> mFreeSlots;
+	std::vector<uint32_t> mSubmittedSlots;
+
+	// 変換済みで書き出し待ちのフレーム(番号順に書き出す)
+	std::map<uint64_t, std::vector<uint8_t>> mConvertedFrames;
+	uint64_t mNextWriteFrame = 0;
+
+	std::vector<std::thread> mWorkers;
+	std::thread mWriterThread;
+	bool mQuit = false;
+};
@@ -0,0 +1,108 @@
+#include "OfflineRenderer.h"
+
+#include <cassert>
+#include <utility>
+
+#include "../Dx12Wrapper/Dx12Wrapper.h"
+#include "../Profiler/CpuProfiler.h"
+
+OfflineRenderer::~OfflineRenderer()
+{
+	Finish();
+}
+
+bool OfflineRenderer::Init(Dx12Wrapper* dx, const OfflineRenderSettings& settings, uint32_t width, uint32_t height)
+{
+	mDX12Wrapper = dx;
+	mSettings = settings;
+
+	// 読み戻し先の行の間隔は256バイト境界に揃える必要がある
+	D3D12_RESOURCE_DESC texDesc = {};
+	texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	texDesc.Width = width;
+	texDesc.Height = height;
+	texDesc.DepthOrArraySize = 1;
+	texDesc.MipLevels = 1;
+	texDesc.Format = dx->GetBackBufferFormat();
+	texDesc.SampleDesc.Count = 1;
+	texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+	UINT64 totalBytes = 0;
+	dx->Device()->GetCopyableFootprints(&texDesc, 0, 1, 0, &mFootprint, nullptr, nullptr, &totalBytes);
+
+	mReadbackBuffers.resize(mSettings.readbackSlots);
+	for (auto& buffer : mReadbackBuffers)
+	{
+		// 64KB以下だと共有バッファから切り出されるので、コピー先の先頭はテクスチャデータの境界(512)に揃える
+		if (!dx->GetMemoryAllocator().CreateBuffer(D3D12_HEAP_TYPE_READBACK, totalBytes, D3D12_RESOURCE_STATE_COPY_DEST, buffer, D3D12_RESOURCE_FLAG_NONE, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT))
+		{
+			assert(false && "読み戻しバッファ作成失敗");
+			return false;
+		}
+	}
+
+	return mEncoder.Start(mSettings, width, height, mFootprint.Footprint.RowPitch,
+		[this](uint32_t slot, uint64_t fenceValue) { return WaitReadback(slot, fenceValue); });
+}
+
+void OfflineRenderer::Capture(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* source, UINT64 fenceValue)
+{
+	PROFILE_SCOPE("OfflineRenderer::Capture");
+
+	uint32_t slot = mEncoder.AcquireSlot();
+
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Transition.pResource = source;
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+
+	cmdList->ResourceBarrier(1, &barrier);
+
+	D3D12_TEXTURE_COPY_LOCATION src = {};
+	src.pResource = source;
+	src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	src.SubresourceIndex = 0;
+
+	D3D12_TEXTURE_COPY_LOCATION dst = {};
+	dst.pResource = mReadbackBuffers[slot].resource.Get();
+	dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	dst.PlacedFootprint = mFootprint;
+	dst.PlacedFootprint.Offset = mReadbackBuffers[slot].offset;
+
+	cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+
+	std::swap(barrier.Transition.StateBefore, barrier.Transition.StateAfter);
+	cmdList->ResourceBarrier(1, &barrier);
+
+	mEncoder.Submit(slot, fenceValue);
+}
+
+void OfflineRenderer::Finish()
+{
+	mEncoder.Finish();
+
+	// Finishは最後のフレームのGPU完了後に呼ばれるので、すぐ解放してよい
+	if (mDX12Wrapper != nullptr)
+	{
+		for (auto& buffer : mReadbackBuffers)
+		{
+			mDX12Wrapper->GetMemoryAllocator().Free(buffer);
+		}
+	}
+
+	mReadbackBuffers.clear();
+}
+
+const uint8_t* OfflineRenderer::WaitReadback(uint32_t slot, uint64_t fenceValue)
+{
+	// イベントを渡さなければ、フェンスが通過するまで戻らない
+	ID3D12Fence* fence = mDX12Wrapper->GetFence();
+	if (fence->GetCompletedValue() < fenceValue)
+	{
+		fence->SetEventOnCompletion(fenceValue, nullptr);
+	}
+
+	return static_cast<const uint8_t*>(mReadbackBuffers[slot].cpuAddress);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "FrameEncoder.h"
+#include "../GpuMemory/GpuMemoryAllocator.h"
+
+class Dx12Wrapper;
+
+// 描いたフレームを読み戻しバッファのリングへコピーし、変換と書き出しを別スレッドで行う(FrameEncoder)
+// ここではCopyTextureRegionとフェンスの待ちだけを受け持つ
+// 描画スレッドはディスクを待たず、空きスロットが無い時だけ待つ
+class OfflineRenderer
+{
+public:
+
+	OfflineRenderer() = default;
+	~OfflineRenderer();
+
+	OfflineRenderer(const OfflineRenderer&) = delete;
+	OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+	bool Init(Dx12Wrapper* dx, const OfflineRenderSettings& settings, uint32_t width, uint32_t height);
+
+	// Clear～EndDrawの間に呼ぶ。sourceはRENDER_TARGETの状態で、戻った時も同じ
+	// コピーはfenceValueが通過した時に終わっている
+	void Capture(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* source, UINT64 fenceValue);
+
+	// 残りのフレームを全て書き出してからスレッドを止める
+	void Finish();
+
+	const OfflineRenderSettings& GetSettings() const { return mSettings; }
+	uint32_t CapturedFrames() const { return mEncoder.SubmittedFrames(); }
+	bool IsDone() const { return CapturedFrames() >= mSettings.frameCount; }
+
+	// 空きスロットを待った合計時間(長ければ変換・書き出しが間に合っていない)
+	double StallMs() const { return mEncoder.StallMs(); }
+
+private:
+
+	// FrameEncoderから呼ばれる。コピーが終わるまで待ってスロットの画素を返す
+	const uint8_t* WaitReadback(uint32_t slot, uint64_t fenceValue);
+
+	Dx12Wrapper* mDX12Wrapper = nullptr;
+	OfflineRenderSettings mSettings;
+	FrameEncoder mEncoder;
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT mFootprint = {};
+
+	// FrameEncoderのスロット番号と同じ並び
+	std::vector<GpuAllocation> mReadbackBuffers;
+};
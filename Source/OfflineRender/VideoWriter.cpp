@@ -0,0 +1,155 @@
+#include "VideoWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	// BT.601フルレンジ。8ビット固定小数点で計算する
+	inline uint8_t ToY(int r, int g, int b)
+	{
+		return static_cast<uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+	}
+
+	inline uint8_t ToU(int r, int g, int b)
+	{
+		return static_cast<uint8_t>(std::clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 0, 255));
+	}
+
+	inline uint8_t ToV(int r, int g, int b)
+	{
+		return static_cast<uint8_t>(std::clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 0, 255));
+	}
+
+	void ConvertToI420(const uint8_t* rgba, size_t rowPitch, uint32_t width, uint32_t height, uint8_t* out)
+	{
+		const uint32_t chromaWidth = (width + 1) / 2;
+		const uint32_t chromaHeight = (height + 1) / 2;
+
+		uint8_t* planeY = out;
+		uint8_t* planeU = planeY + static_cast<size_t>(width) * height;
+		uint8_t* planeV = planeU + static_cast<size_t>(chromaWidth) * chromaHeight;
+
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			const uint8_t* row = rgba + rowPitch * y;
+			uint8_t* dst = planeY + static_cast<size_t>(width) * y;
+
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				dst[x] = ToY(row[x * 4 + 0], row[x * 4 + 1], row[x * 4 + 2]);
+			}
+		}
+
+		// 色差は2x2の平均から作る(端は存在する画素だけ)
+		for (uint32_t cy = 0; cy < chromaHeight; ++cy)
+		{
+			const uint8_t* row0 = rgba + rowPitch * (cy * 2);
+			const uint8_t* row1 = rgba + rowPitch * std::min(cy * 2 + 1, height - 1);
+
+			for (uint32_t cx = 0; cx < chromaWidth; ++cx)
+			{
+				uint32_t x0 = cx * 2;
+				uint32_t x1 = std::min(x0 + 1, width - 1);
+
+				int r = row0[x0 * 4 + 0] + row0[x1 * 4 + 0] + row1[x0 * 4 + 0] + row1[x1 * 4 + 0];
+				int g = row0[x0 * 4 + 1] + row0[x1 * 4 + 1] + row1[x0 * 4 + 1] + row1[x1 * 4 + 1];
+				int b = row0[x0 * 4 + 2] + row0[x1 * 4 + 2] + row1[x0 * 4 + 2] + row1[x1 * 4 + 2];
+
+				r = (r + 2) / 4;
+				g = (g + 2) / 4;
+				b = (b + 2) / 4;
+
+				planeU[static_cast<size_t>(chromaWidth) * cy + cx] = ToU(r, g, b);
+				planeV[static_cast<size_t>(chromaWidth) * cy + cx] = ToV(r, g, b);
+			}
+		}
+	}
+}
+
+VideoWriter::~VideoWriter()
+{
+	Close();
+}
+
+bool VideoWriter::Open(const std::string& path, VideoFormat format, uint32_t width, uint32_t height, uint32_t framesPerSecond)
+{
+	Close();
+
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+	if (!mFile)
+	{
+		return false;
+	}
+
+	mFormat = format;
+	mWidth = width;
+	mHeight = height;
+
+	if (format == VideoFormat::Y4m)
+	{
+		char header[128] = {};
+		int length = snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, framesPerSecond);
+
+		mFile.write(header, length);
+	}
+
+	return static_cast<bool>(mFile);
+}
+
+void VideoWriter::Close()
+{
+	if (mFile.is_open())
+	{
+		mFile.close();
+	}
+}
+
+bool VideoWriter::WriteFrame(const std::vector<uint8_t>& frame)
+{
+	if (!mFile.is_open() || frame.size() != FrameSize(mFormat, mWidth, mHeight))
+	{
+		return false;
+	}
+
+	if (mFormat == VideoFormat::Y4m)
+	{
+		mFile.write("FRAME\n", 6);
+	}
+
+	mFile.write(reinterpret_cast<const char*>(frame.data()), static_cast<std::streamsize>(frame.size()));
+
+	return static_cast<bool>(mFile);
+}
+
+void VideoWriter::ConvertFrame(VideoFormat format, const uint8_t* rgba, size_t rowPitch, uint32_t width, uint32_t height, std::vector<uint8_t>& out)
+{
+	out.resize(FrameSize(format, width, height));
+
+	if (format == VideoFormat::Y4m)
+	{
+		ConvertToI420(rgba, rowPitch, width, height, out.data());
+		return;
+	}
+
+	// 読み戻しバッファは行が256バイト境界に揃っているので詰め直す
+	const size_t packedPitch = static_cast<size_t>(width) * 4;
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		std::memcpy(out.data() + packedPitch * y, rgba + rowPitch * y, packedPitch);
+	}
+}
+
+size_t VideoWriter::FrameSize(VideoFormat format, uint32_t width, uint32_t height)
+{
+	if (format == VideoFormat::Y4m)
+	{
+		size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+
+		return static_cast<size_t>(width) * height + chroma * 2;
+	}
+
+	return static_cast<size_t>(width) * height * 4;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+enum class VideoFormat
+{
+	Raw,	// RGBA8を詰めて並べただけ
+	Y4m,	// YUV4MPEG2(4:2:0、BT.601フルレンジ)。ffmpeg等でそのまま読める
+};
+
+// 変換済みのフレームを順にファイルへ書き出す
+class VideoWriter
+{
+public:
+
+	VideoWriter() = default;
+	~VideoWriter();
+
+	VideoWriter(const VideoWriter&) = delete;
+	VideoWriter& operator=(const VideoWriter&) = delete;
+
+	bool Open(const std::string& path, VideoFormat format, uint32_t width, uint32_t height, uint32_t framesPerSecond);
+	void Close();
+
+	// ConvertFrameで作ったデータを渡す
+	bool WriteFrame(const std::vector<uint8_t>& frame);
+
+	// 読み戻したRGBA8(行の間隔はrowPitch)を書き出す形式に変換する。どのスレッドから呼んでもよい
+	static void ConvertFrame(VideoFormat format, const uint8_t* rgba, size_t rowPitch, uint32_t width, uint32_t height, std::vector<uint8_t>& out);
+
+	// 1フレームのバイト数
+	static size_t FrameSize(VideoFormat format, uint32_t width, uint32_t height);
+
+private:
+
+	std::ofstream mFile;
+	VideoFormat mFormat = VideoFormat::Raw;
+	uint32_t mWidth = 0;
+	uint32_t mHeight = 0;
+};
@@ -0,0 +1,103 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	thread_local uint32_t tScopeDepth = 0;
+}
+
+int64_t CpuProfiler::NowNs()
+{
+	// MSVCのsteady_clockはQueryPerformanceCounterなのでGPUの較正値と揃えられる
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+	ThreadRing& ring = LocalRing();
+
+	std::lock_guard<std::mutex> lock(mRegisterMutex);
+	ring.name = name;
+}
+
+void CpuProfiler::Record(const char* name, int64_t beginNs, int64_t endNs, uint32_t depth)
+{
+	ThreadRing& ring = LocalRing();
+
+	uint64_t count = ring.writeCount.load(std::memory_order_relaxed);
+	ring.events[count & (RingSize - 1)] = { name, beginNs, endNs, ring.threadId, depth };
+
+	// 読み手はwriteCountを見てから中身を読む
+	ring.writeCount.store(count + 1, std::memory_order_release);
+}
+
+void CpuProfiler::Collect(std::vector<ProfileEvent>& events) const
+{
+	std::lock_guard<std::mutex> lock(mRegisterMutex);
+
+	for (const auto& ring : mRings)
+	{
+		uint64_t end = ring->writeCount.load(std::memory_order_acquire);
+		uint64_t begin = end > RingSize ? end - RingSize : 0;
+
+		size_t first = events.size();
+		for (uint64_t idx = begin; idx < end; ++idx)
+		{
+			events.push_back(ring->events[idx & (RingSize - 1)]);
+		}
+
+		// コピー中に書き手が追い越した分は壊れている可能性があるので捨てる
+		uint64_t after = ring->writeCount.load(std::memory_order_acquire);
+		uint64_t overwritten = after > RingSize ? after - RingSize : 0;
+		if (overwritten > begin)
+		{
+			size_t drop = static_cast<size_t>(std::min<uint64_t>(overwritten - begin, end - begin));
+			events.erase(events.begin() + first, events.begin() + first + drop);
+		}
+	}
+}
+
+std::vector<std::pair<uint32_t, std::string>> CpuProfiler::ThreadNames() const
+{
+	std::lock_guard<std::mutex> lock(mRegisterMutex);
+
+	std::vector<std::pair<uint32_t, std::string>> names;
+	for (const auto& ring : mRings)
+	{
+		names.emplace_back(ring->threadId, ring->name);
+	}
+
+	return names;
+}
+
+CpuProfiler::ThreadRing& CpuProfiler::LocalRing()
+{
+	thread_local ThreadRing* tRing = nullptr;
+
+	if (!tRing)
+	{
+		std::lock_guard<std::mutex> lock(mRegisterMutex);
+
+		mRings.push_back(std::make_unique<ThreadRing>());
+		tRing = mRings.back().get();
+		tRing->threadId = static_cast<uint32_t>(mRings.size() - 1);
+		tRing->name = "Thread" + std::to_string(tRing->threadId);
+	}
+
+	return *tRing;
+}
+
+CpuProfileScope::CpuProfileScope(const char* name)
+	: mName(name)
+	, mBeginNs(CpuProfiler::NowNs())
+	, mDepth(tScopeDepth++)
+{
+}
+
+CpuProfileScope::~CpuProfileScope()
+{
+	--tScopeDepth;
+	CpuProfiler::Instance().Record(mName, mBeginNs, CpuProfiler::NowNs(), mDepth);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 計測区間1つ分(時刻はsteady_clockのナノ秒)
+struct ProfileEvent
+{
+	const char* name;
+	int64_t beginNs;
+	int64_t endNs;
+	uint32_t threadId;
+	uint32_t depth;
+};
+
+// スレッド毎のリングバッファに計測区間を書き込むCPUプロファイラ
+// 書き込みはスレッド毎に1人なのでロックを取らない
+class CpuProfiler
+{
+public:
+
+	// スレッド毎に保持するイベント数(2の累乗)
+	static const uint32_t RingSize = 8192;
+
+	static CpuProfiler& Instance()
+	{
+		static CpuProfiler instance = {};
+		return instance;
+	}
+
+	static int64_t NowNs();
+
+	void SetThreadName(const char* name);
+	void Record(const char* name, int64_t beginNs, int64_t endNs, uint32_t depth);
+
+	// 全スレッドのリングから上書きされていないイベントを集める
+	void Collect(std::vector<ProfileEvent>& events) const;
+
+	// スレッド番号と名前の一覧
+	std::vector<std::pair<uint32_t, std::string>> ThreadNames() const;
+
+private:
+
+	CpuProfiler() = default;
+	~CpuProfiler() = default;
+
+	struct ThreadRing
+	{
+		std::atomic<uint64_t> writeCount = 0;
+		ProfileEvent events[RingSize];
+		uint32_t threadId = 0;
+		std::string name;
+	};
+
+	ThreadRing& LocalRing();
+
+	// リングの登録はスレッド毎に最初の1回だけ
+	mutable std::mutex mRegisterMutex;
+	std::vector<std::unique_ptr<ThreadRing>> mRings;
+
+	CpuProfiler(const CpuProfiler&) = delete;
+	void operator=(const CpuProfiler&) = delete;
+};
+
+// スコープを抜けた時に区間を記録する
+class CpuProfileScope
+{
+public:
+
+	explicit CpuProfileScope(const char* name);
+	~CpuProfileScope();
+
+private:
+
+	const char* mName;
+	int64_t mBeginNs;
+	uint32_t mDepth;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) CpuProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
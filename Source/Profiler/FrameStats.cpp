@@ -0,0 +1,54 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+FrameStats::FrameStats(size_t windowSize)
+	: mFrameMs(windowSize, 0.0)
+{
+}
+
+void FrameStats::AddFrame(double frameMs)
+{
+	mFrameMs[mNext] = frameMs;
+	mNext = (mNext + 1) % mFrameMs.size();
+	mCount = std::min(mCount + 1, mFrameMs.size());
+}
+
+double FrameStats::Percentile(double percentile) const
+{
+	if (mCount == 0)
+	{
+		return 0.0;
+	}
+
+	std::vector<double> sorted(mFrameMs.begin(), mFrameMs.begin() + mCount);
+
+	// 最近傍順位法
+	size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(mCount)));
+	rank = std::clamp<size_t>(rank, 1, mCount) - 1;
+
+	std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+	return sorted[rank];
+}
+
+double FrameStats::Average() const
+{
+	if (mCount == 0)
+	{
+		return 0.0;
+	}
+
+	return std::accumulate(mFrameMs.begin(), mFrameMs.begin() + mCount, 0.0) / static_cast<double>(mCount);
+}
+
+std::string FrameStats::Summary() const
+{
+	char buf[128] = {};
+	snprintf(buf, sizeof(buf), "frames=%zu avg=%.2fms p50=%.2fms p99=%.2fms max=%.2fms",
+		mCount, Average(), Percentile(50.0), Percentile(99.0), Percentile(100.0));
+
+	return buf;
+}
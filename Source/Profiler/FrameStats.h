@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// 直近Nフレームのフレーム時間からパーセンタイルを求める
+class FrameStats
+{
+public:
+
+	explicit FrameStats(size_t windowSize = 240);
+	~FrameStats() = default;
+
+	void AddFrame(double frameMs);
+
+	// percentileは0～100
+	double Percentile(double percentile) const;
+	double Average() const;
+
+	size_t FrameCount() const { return mCount; }
+
+	// "frames=240 avg=16.67ms p50=16.60ms p99=18.20ms max=19.00ms" の形式
+	std::string Summary() const;
+
+private:
+
+	std::vector<double> mFrameMs;
+	size_t mNext = 0;
+	size_t mCount = 0;
+};
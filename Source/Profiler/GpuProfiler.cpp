@@ -0,0 +1,181 @@
+#include "GpuProfiler.h"
+
+#include <d3dx12.h>
+
+#include <cassert>
+
+namespace
+{
+	constexpr UINT InvalidScope = 0xFFFFFFFF;
+}
+
+bool GpuProfiler::Init(ID3D12Device* device, ID3D12CommandQueue* queue, UINT maxScopesPerFrame, UINT frameCount)
+{
+	mQueue = queue;
+	mMaxScopes = maxScopesPerFrame;
+	mResolved.resize(frameCount);
+
+	D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+	queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	queryHeapDesc.Count = mMaxScopes * 2;
+	queryHeapDesc.NodeMask = 0;
+
+	auto result = device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(mQueryHeap.ReleaseAndGetAddressOf()));
+	if (FAILED(result))
+	{
+		assert(false && "タイムスタンプクエリヒープ作成失敗");
+		return false;
+	}
+
+	auto heapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
+	// クエリヒープはGPUが順に使うので1つでよいが、読み戻し先はCPUが読む前に次のフレームで上書きされないよう分ける
+	auto resDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(UINT64) * mMaxScopes * 2 * frameCount);
+
+	result = device->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &resDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(mReadbackBuff.ReleaseAndGetAddressOf()));
+	if (FAILED(result))
+	{
+		assert(false && "タイムスタンプ読み戻しバッファ作成失敗");
+		return false;
+	}
+
+	result = mQueue->GetTimestampFrequency(&mGpuFrequency);
+	if (FAILED(result))
+	{
+		assert(false && "タイムスタンプ周波数取得失敗");
+		return false;
+	}
+
+	mScopeNames.reserve(mMaxScopes);
+	mScopeDepths.reserve(mMaxScopes);
+	for (ResolvedFrame& frame : mResolved)
+	{
+		frame.names.reserve(mMaxScopes);
+		frame.depths.reserve(mMaxScopes);
+	}
+	mHistory.reserve(HistorySize);
+
+	return true;
+}
+
+UINT GpuProfiler::Begin(ID3D12GraphicsCommandList* cmdList, const char* name)
+{
+	if (!mQueryHeap || mScopeNames.size() >= mMaxScopes)
+	{
+		return InvalidScope;
+	}
+
+	UINT scope = static_cast<UINT>(mScopeNames.size());
+	mScopeNames.push_back(name);
+	mScopeDepths.push_back(mOpenDepth++);
+
+	cmdList->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, scope * 2);
+
+	return scope;
+}
+
+void GpuProfiler::End(ID3D12GraphicsCommandList* cmdList, UINT scope)
+{
+	if (scope == InvalidScope)
+	{
+		return;
+	}
+
+	--mOpenDepth;
+	cmdList->EndQuery(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, scope * 2 + 1);
+}
+
+void GpuProfiler::Resolve(ID3D12GraphicsCommandList* cmdList, UINT frameIndex)
+{
+	ResolvedFrame& frame = mResolved[frameIndex];
+	frame.names.swap(mScopeNames);
+	frame.depths.swap(mScopeDepths);
+
+	mScopeNames.clear();
+	mScopeDepths.clear();
+	mOpenDepth = 0;
+
+	UINT count = static_cast<UINT>(frame.names.size());
+
+	if (count > 0)
+	{
+		UINT64 offset = sizeof(UINT64) * mMaxScopes * 2 * frameIndex;
+		cmdList->ResolveQueryData(mQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0, count * 2, mReadbackBuff.Get(), offset);
+	}
+}
+
+void GpuProfiler::Collect(UINT frameIndex)
+{
+	mLastFrame.clear();
+
+	ResolvedFrame& frame = mResolved[frameIndex];
+	UINT count = static_cast<UINT>(frame.names.size());
+
+	if (count > 0)
+	{
+		SIZE_T offset = sizeof(UINT64) * mMaxScopes * 2 * frameIndex;
+		D3D12_RANGE readRange = { offset, offset + sizeof(UINT64) * count * 2 };
+		UINT64* mapped = nullptr;
+
+		if (SUCCEEDED(mReadbackBuff->Map(0, &readRange, (void**)&mapped)))
+		{
+			const UINT64* timestamps = mapped + mMaxScopes * 2 * frameIndex;
+
+			// GPUのタイムスタンプとQueryPerformanceCounterの対応を取る
+			UINT64 gpuCalib = 0;
+			UINT64 cpuCalib = 0;
+			mQueue->GetClockCalibration(&gpuCalib, &cpuCalib);
+
+			LARGE_INTEGER qpcFrequency = {};
+			QueryPerformanceFrequency(&qpcFrequency);
+
+			double cpuCalibNs = static_cast<double>(cpuCalib) * 1.0e9 / static_cast<double>(qpcFrequency.QuadPart);
+			double gpuTickNs = 1.0e9 / static_cast<double>(mGpuFrequency);
+
+			auto toNs = [&](UINT64 tick)
+			{
+				double deltaTick = static_cast<double>(static_cast<INT64>(tick - gpuCalib));
+				return static_cast<int64_t>(cpuCalibNs + deltaTick * gpuTickNs);
+			};
+
+			for (UINT scope = 0; scope < count; ++scope)
+			{
+				ProfileEvent event = {};
+				event.name = frame.names[scope];
+				event.beginNs = toNs(timestamps[scope * 2]);
+				event.endNs = toNs(timestamps[scope * 2 + 1]);
+				event.threadId = 0;
+				event.depth = frame.depths[scope];
+
+				mLastFrame.push_back(event);
+
+				if (mHistory.size() < HistorySize)
+				{
+					mHistory.push_back(event);
+				}
+				else
+				{
+					mHistory[mHistoryNext] = event;
+				}
+				mHistoryNext = (mHistoryNext + 1) % HistorySize;
+			}
+
+			D3D12_RANGE writeRange = { 0, 0 };
+			mReadbackBuff->Unmap(0, &writeRange);
+		}
+	}
+
+	frame.names.clear();
+	frame.depths.clear();
+}
+
+GpuProfileScope::GpuProfileScope(GpuProfiler& profiler, ID3D12GraphicsCommandList* cmdList, const char* name)
+	: mProfiler(profiler)
+	, mCmdList(cmdList)
+	, mScope(profiler.Begin(cmdList, name))
+{
+}
+
+GpuProfileScope::~GpuProfileScope()
+{
+	mProfiler.End(mCmdList, mScope);
+}
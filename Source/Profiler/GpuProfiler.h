@@ -0,0 +1,84 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <vector>
+
+#include "CpuProfiler.h"
+
+// タイムスタンプクエリでパス毎のGPU時間を計測する
+class GpuProfiler
+{
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public:
+
+	// 保持する過去のGPUイベント数
+	static const size_t HistorySize = 8192;
+
+	GpuProfiler() = default;
+	~GpuProfiler() = default;
+
+	// frameCountはGPUで同時に実行され得るフレーム数。読み戻し先をフレーム毎に分ける
+	bool Init(ID3D12Device* device, ID3D12CommandQueue* queue, UINT maxScopesPerFrame, UINT frameCount);
+
+	// 戻り値をEndに渡す
+	UINT Begin(ID3D12GraphicsCommandList* cmdList, const char* name);
+	void End(ID3D12GraphicsCommandList* cmdList, UINT scope);
+
+	// コマンドリストを閉じる直前に呼び、クエリをframeIndex用の読み戻し領域へ解決する
+	void Resolve(ID3D12GraphicsCommandList* cmdList, UINT frameIndex);
+
+	// frameIndexで解決したフレームのGPUの完了を待った後に呼び、CPUと同じ時間軸のイベントに変換する
+	void Collect(UINT frameIndex);
+
+	const std::vector<ProfileEvent>& LastFrame() const { return mLastFrame; }
+	const std::vector<ProfileEvent>& History() const { return mHistory; }
+
+private:
+
+	ComPtr<ID3D12QueryHeap> mQueryHeap = nullptr;
+	ComPtr<ID3D12Resource> mReadbackBuff = nullptr;
+	ComPtr<ID3D12CommandQueue> mQueue = nullptr;
+
+	UINT mMaxScopes = 0;
+	UINT64 mGpuFrequency = 0;
+
+	// 記録中のフレームの区間
+	std::vector<const char*> mScopeNames;
+	std::vector<UINT> mScopeDepths;
+	UINT mOpenDepth = 0;
+
+	// 解決済みでGPUの完了待ちのフレームの区間(フレーム番号毎)
+	struct ResolvedFrame
+	{
+		std::vector<const char*> names;
+		std::vector<UINT> depths;
+	};
+	std::vector<ResolvedFrame> mResolved;
+
+	std::vector<ProfileEvent> mLastFrame;
+	std::vector<ProfileEvent> mHistory;
+	size_t mHistoryNext = 0;
+};
+
+// スコープを抜けた時にGPU区間を閉じる
+class GpuProfileScope
+{
+public:
+
+	GpuProfileScope(GpuProfiler& profiler, ID3D12GraphicsCommandList* cmdList, const char* name);
+	~GpuProfileScope();
+
+private:
+
+	GpuProfiler& mProfiler;
+	ID3D12GraphicsCommandList* mCmdList;
+	UINT mScope;
+};
+
+#define GPU_PROFILE_SCOPE(profiler, cmdList, name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, cmdList, name)
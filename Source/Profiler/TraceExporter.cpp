@@ -0,0 +1,113 @@
+#include "TraceExporter.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	void AppendEscaped(std::string& out, const char* text)
+	{
+		for (const char* c = text; *c; ++c)
+		{
+			// 制御文字はそのままではJSONとして読めないので\u形式にする
+			if (static_cast<unsigned char>(*c) < 0x20)
+			{
+				char buf[8] = {};
+				snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(*c));
+				out += buf;
+				continue;
+			}
+
+			if (*c == '"' || *c == '\\')
+			{
+				out += '\\';
+			}
+			out += *c;
+		}
+	}
+
+	void AppendEvents(std::string& out, const std::vector<ProfileEvent>& events, int pid, int64_t originNs, bool& first)
+	{
+		char buf[128] = {};
+
+		for (const ProfileEvent& event : events)
+		{
+			out += first ? "\n" : ",\n";
+			first = false;
+
+			// tsとdurはマイクロ秒
+			out += "{\"name\":\"";
+			AppendEscaped(out, event.name);
+			snprintf(buf, sizeof(buf), "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f}",
+				pid, event.threadId,
+				(event.beginNs - originNs) / 1000.0,
+				(event.endNs - event.beginNs) / 1000.0);
+			out += buf;
+		}
+	}
+}
+
+bool TraceExporter::WriteChromeTrace(const std::string& path,
+	const std::vector<ProfileEvent>& cpuEvents,
+	const std::vector<std::pair<uint32_t, std::string>>& threadNames,
+	const std::vector<ProfileEvent>& gpuEvents)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		return false;
+	}
+
+	file << ToChromeTrace(cpuEvents, threadNames, gpuEvents);
+	return static_cast<bool>(file);
+}
+
+std::string TraceExporter::ToChromeTrace(
+	const std::vector<ProfileEvent>& cpuEvents,
+	const std::vector<std::pair<uint32_t, std::string>>& threadNames,
+	const std::vector<ProfileEvent>& gpuEvents)
+{
+	// 一番早いイベントを0にする
+	int64_t originNs = INT64_MAX;
+	for (const ProfileEvent& event : cpuEvents)
+	{
+		originNs = std::min(originNs, event.beginNs);
+	}
+	for (const ProfileEvent& event : gpuEvents)
+	{
+		originNs = std::min(originNs, event.beginNs);
+	}
+
+	std::string out = "{\"traceEvents\":[";
+	bool first = true;
+	char buf[64] = {};
+
+	for (const auto& thread : threadNames)
+	{
+		out += first ? "\n" : ",\n";
+		first = false;
+
+		snprintf(buf, sizeof(buf), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%" PRIu32, thread.first);
+		out += buf;
+		out += ",\"args\":{\"name\":\"";
+		AppendEscaped(out, thread.second.c_str());
+		out += "\"}}";
+	}
+
+	if (!gpuEvents.empty())
+	{
+		out += first ? "\n" : ",\n";
+		first = false;
+		out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+	}
+
+	AppendEvents(out, cpuEvents, 0, originNs, first);
+	AppendEvents(out, gpuEvents, 1, originNs, first);
+
+	out += "\n]}\n";
+
+	return out;
+}
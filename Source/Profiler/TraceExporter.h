@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CpuProfiler.h"
+
+// chrome://tracing / Perfetto で読めるJSONに書き出す
+class TraceExporter
+{
+public:
+
+	// CPUはpid 0(スレッド毎)、GPUはpid 1に並べる
+	static bool WriteChromeTrace(const std::string& path,
+		const std::vector<ProfileEvent>& cpuEvents,
+		const std::vector<std::pair<uint32_t, std::string>>& threadNames,
+		const std::vector<ProfileEvent>& gpuEvents);
+
+	static std::string ToChromeTrace(
+		const std::vector<ProfileEvent>& cpuEvents,
+		const std::vector<std::pair<uint32_t, std::string>>& threadNames,
+		const std::vector<ProfileEvent>& gpuEvents);
+};
@@ -1,23 +1,1282 @@
 #include "Render.h"
 
-Render::Render(std::shared_ptr<Dx12Wrapper>& dx)
+#include <d3dcompiler.h>
+
+#include <DirectXTex.h>
+#include <d3dx12.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "../Application/Application.h"
+#include "../Dx12Wrapper/Dx12Wrapper.h"
+#include "../Math/XMConvert.h"
+#include "../MeshOptimizer/MeshOptimizer.h"
+#include "../Profiler/CpuProfiler.h"
+#include "../Texture/MipGenerator.h"
+
+#pragma comment(lib, "DirectXTex.lib")
+#pragma comment(lib, "d3dcompiler.lib")
+
+namespace
+{
+	const char* const BasicVsPath = "Asset/Shader/Basic/BasicVertexShader.hlsl";
+	const char* const BasicVsEntry = "BasicVS";
+	const char* const BasicPsPath = "Asset/Shader/Basic/BasicPixelShader.hlsl";
+	const char* const BasicPsEntry = "BasicPS";
+
+	const char* const UpscaleVsPath = "Asset/Shader/Upscale/UpscaleVertexShader.hlsl";
+	const char* const UpscaleVsEntry = "UpscaleVS";
+	const char* const UpscalePsPath = "Asset/Shader/Upscale/UpscalePixelShader.hlsl";
+	const char* const UpscalePsEntry = "UpscalePS";
+
+	// mBasicDescHeapの並び。2～4はマテリアルのテーブルとして続けて置く
+	const UINT ToonAtlasSlot = 2;
+	const UINT SphereArraySlot = 3;
+	const UINT MaterialBufferSlot = 4;
+	const UINT BasicDescriptorCount = 5;
+
+	// MMDの既定の照明(ワールド空間の光の向きと色)
+	const DirectX::XMFLOAT3 LightDirection = { -0.5F, -1.0F, 0.5F };
+	const DirectX::XMFLOAT4 LightColor = { 0.6F, 0.6F, 0.6F, 1.0F };
+
+	// モデル全体を動かすボーン
+	const char RootBoneName[] = "センター";
+}
+
+Render::Render(std::shared_ptr<Dx12Wrapper>& dx, const RenderAssets& assets)
+	: mDX12Wrapper(dx)
 {
+	if (!CreateBuffers())
+	{
+		return;
+	}
+
+	if (!CreateTexture(assets))
+	{
+		return;
+	}
+
+	if (!CreateConstants())
+	{
+		return;
+	}
+
+	if (!CreateMaterials())
+	{
+		return;
+	}
 
+	if (!CreatePipeline(assets))
+	{
+		return;
+	}
+
+	// 失敗してもパケットでの描画はできるので続ける
+	mIndirectDrawReady = CreateIndirectDraw();
+
+	if (!CreateSceneTarget())
+	{
+		return;
+	}
+
+	if (!CreateUpscalePipeline(assets))
+	{
+		return;
+	}
+
+	mShaderHotReload.Init(mDX12Wrapper.get(), "Asset/Shader");
 }
 
-void Render::Frame()
+Render::~Render()
 {
+	auto& allocator = mDX12Wrapper->GetMemoryAllocator();
 
+	allocator.Free(mVertBuff);
+	allocator.Free(mIdxBuff);
+	allocator.Free(mMaterialBuff);
+	allocator.Free(mSceneTarget);
 }
 
-void Render::Update() const
+void Render::SetDynamicResolution(bool enable)
 {
+	mDynamicResolutionEnabled = enable;
+
+	// 戻した時に前回の積分が残らないように
+	mDynamicResolution.Reset();
+}
+
+void Render::OnResize()
+{
+	// Dx12Wrapper::ResizeでGPUの完了を待っているので、すぐ解放してよい
+	mDX12Wrapper->GetMemoryAllocator().Free(mSceneTarget);
+
+	CreateSceneTarget();
+}
+
+void Render::Frame(const FramePacket& packet)
+{
+	// 作り直しが終わったPSOはフレームの境目で差し替える
+	mShaderHotReload.Update();
+
+	ApplyPacket(packet);
+	Update();
+	DrawFrame();
+	EndOfFrame();
+}
+
+void Render::ApplyPacket(const FramePacket& packet)
+{
+	mDepthPrepass = packet.depthPrepass;
+	mIndirectDrawEnabled = packet.indirectDraw && mIndirectDrawReady;
+
+	// 切り替えた時だけ制御をリセットする
+	if (packet.dynamicResolution != mDynamicResolutionEnabled)
+	{
+		SetDynamicResolution(packet.dynamicResolution);
+	}
+
+	mWorld = packet.world;
+	mTime = packet.time;
+}
+
+bool Render::SetBakedMotion(const std::string& path, const Skeleton& skeleton)
+{
+	if (!mBakedMotion.Open(path))
+	{
+		return false;
+	}
+
+	// 別のモデル用にベイクしたものは使えない
+	if (mBakedMotion.SkeletonHash() != skeleton.Hash())
+	{
+		mBakedMotion.Close();
+		return false;
+	}
+
+	mSkeleton = skeleton;
+	mRootBone = mSkeleton.FindBone(RootBoneName);
+
+	return true;
 }
 
-void Render::DrawFrame() const
+void Render::Update()
 {
+	PROFILE_SCOPE("Render::Update");
+
+	if (!mPipelineState)
+	{
+		return;
+	}
+
+	if (mBakedMotion.IsOpen())
+	{
+		PROFILE_SCOPE("BakedMotion::Sample");
+
+		// 最後まで再生したら頭に戻る
+		double frame = std::fmod(mTime * mBakedMotion.FramesPerSecond(), static_cast<double>(mBakedMotion.FrameCount()));
+		mBakedMotion.Sample(static_cast<float>(frame), mSkeleton);
+	}
+
+	// 値が変わらなければアップロードされない
+	DirectX::XMMATRIX view = mDX12Wrapper->GetViewMatrix();
+
+	FrameConstants frame = {};
+	frame.viewProj = view * mDX12Wrapper->GetProjectionMatrix();
+	frame.view = view;
+	frame.lightColor = LightColor;
+
+	// ライトはワールドで固定し、シェーダーではビュー空間で計算する
+	DirectX::XMVECTOR lightDirection = DirectX::XMVector3TransformNormal(DirectX::XMLoadFloat3(&LightDirection), view);
+	DirectX::XMStoreFloat4(&frame.lightDirection, DirectX::XMVector3Normalize(lightDirection));
+
+	mFrameConstants->Set(frame);
+
+	DirectX::XMMATRIX world = DirectX::XMLoadFloat4x4(&mWorld);
+
+	if (mBakedMotion.IsOpen() && mRootBone >= 0)
+	{
+		DirectX::XMFLOAT4 rotation = XMConvert::ToXMFLOAT4(mSkeleton.LocalRotations()[mRootBone]);
+		DirectX::XMFLOAT3 translation = XMConvert::ToXMFLOAT3(mSkeleton.LocalTranslations()[mRootBone]);
+
+		// カリングも同じ行列を使う
+		world = DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&rotation)) *
+			DirectX::XMMatrixTranslation(translation.x, translation.y, translation.z) * world;
+	}
+
+	mDrawConstants->Set(world);
+
+	mConstants.Flush();
+
+	if (mDynamicResolutionEnabled)
+	{
+		// 前のフレームのシーン描画にかかったGPU時間で次の倍率を決める
+		for (const ProfileEvent& event : mDX12Wrapper->GetGpuProfiler().LastFrame())
+		{
+			if (std::strcmp(event.name, "Scene") == 0)
+			{
+				mDynamicResolution.Update(static_cast<double>(event.endNs - event.beginNs) / 1000000.0);
+				break;
+			}
+		}
+	}
+
+	// カリングとドローの引数はGPUで作るので、パケットは積まない
+	if (mIndirectDrawEnabled)
+	{
+		DirectX::XMStoreFloat4x4(&mCullMatrix, world * frame.viewProj);
+		return;
+	}
+
+	// ステージは全オブジェクトが同じワールド行列なので、ワールド×ビュー×プロジェクションから
+	// 視錐台を作ればBVHをモデル空間のまま辿れる(ワールドが変わってもBVHを作り直さなくてよい)
+	{
+		PROFILE_SCOPE("Render::Visibility");
+
+		Frustum frustum = Frustum::FromViewProjection(XMConvert::ToFloat4x4(world * frame.viewProj));
+
+		mVisibleObjects.clear();
+		mStageBvh.Query(FrustumSimd(frustum), mVisibleObjects);
+	}
+
+	// マテリアルはまだ1つだけ。番号でソートすると同じマテリアルのドローが続き、番号の再設定が減る
+	const UINT materialIndex = 0;
+
+	DrawPacket packet = {};
+	packet.sortKey = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 0, static_cast<UINT16>(materialIndex), 0.0F);
+	packet.pipelineState = mDepthPrepass ? mPipelineStateAfterPrepass.Get() : mPipelineState.Get();
+	packet.depthOnlyPipelineState = mDepthOnlyPipelineState.Get();
+	packet.rootSignature = mRootSignature.Get();
+	packet.descriptorHeap = mBasicDescHeap.Get();
+
+	packet.textureTable = mBasicDescHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+	packet.constantBuffer = mFrameConstants->GpuAddress();
+	packet.SetRootConstants(mDrawConstants->Data(), mDrawConstants->Num32BitValues());
+	packet.samplerHeap = mSamplers.Heap();
+	packet.samplerTable = mMaterialSamplerTable.ptr;
+	packet.materialIndex = materialIndex;
+	packet.materialTable = mMaterialTable.ptr;
+
+	packet.vbView = &mVbView;
+	packet.ibView = &mIbView;
+
+	// 見えるオブジェクトだけをパケットにする
+	for (uint32_t objectIdx : mVisibleObjects)
+	{
+		const StageObject& object = mStageObjects[objectIdx];
+
+		packet.indexCount = object.indexCount;
+		packet.startIndex = object.startIndex;
+		packet.baseVertex = object.baseVertex;
+
+		mDrawPackets.Add(packet);
+	}
 }
 
-void Render::EndOfFrame() const
+void Render::DrawFrame()
 {
+	PROFILE_SCOPE("Render::DrawFrame");
+
+	auto cmdList = mDX12Wrapper->CommandList();
+	GPU_PROFILE_SCOPE(mDX12Wrapper->GetGpuProfiler(), cmdList.Get(), "DrawFrame");
+
+	mDrawPackets.Sort();
+
+	if (!mDynamicResolutionEnabled || !mSceneTarget.resource || !mUpscalePipelineState)
+	{
+		DrawScene(cmdList.Get());
+		return;
+	}
+
+	SIZE windowSize = Application::Instance().GetWindowSize();
+	UINT sceneWidth = mDynamicResolution.ScaledSize(static_cast<UINT>(windowSize.cx));
+	UINT sceneHeight = mDynamicResolution.ScaledSize(static_cast<UINT>(windowSize.cy));
+
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = mSceneTarget.resource.Get();
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+
+	cmdList->ResourceBarrier(1, &barrier);
+
+	D3D12_CPU_DESCRIPTOR_HANDLE sceneRtv = mSceneRtvHeap->GetCPUDescriptorHandleForHeapStart();
+	D3D12_CPU_DESCRIPTOR_HANDLE dsv = mDX12Wrapper->GetDepthStencilView();
+
+	cmdList->OMSetRenderTargets(1, &sceneRtv, true, &dsv);
+
+	float clearColor[] = { 0.0F, 0.0F, 0.0F, 1.0F };
+	cmdList->ClearRenderTargetView(sceneRtv, clearColor, 0, nullptr);
+	cmdList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, mDX12Wrapper->GetDepthClearValue(), 0, 0, nullptr);
+
+	// ターゲットはウィンドウサイズのまま、左上の一部にだけ描く
+	D3D12_VIEWPORT viewport = mDX12Wrapper->GetViewport();
+	viewport.Width = static_cast<float>(sceneWidth);
+	viewport.Height = static_cast<float>(sceneHeight);
+
+	D3D12_RECT scissorRect = { 0, 0, static_cast<LONG>(sceneWidth), static_cast<LONG>(sceneHeight) };
+
+	cmdList->RSSetViewports(1, &viewport);
+	cmdList->RSSetScissorRects(1, &scissorRect);
+
+	DrawScene(cmdList.Get());
+
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+
+	cmdList->ResourceBarrier(1, &barrier);
+
+	DrawUpscale(cmdList.Get(), sceneWidth, sceneHeight);
+}
+
+void Render::DrawScene(ID3D12GraphicsCommandList* cmdList)
+{
+	GPU_PROFILE_SCOPE(mDX12Wrapper->GetGpuProfiler(), cmdList, "Scene");
+
+	if (mIndirectDrawEnabled)
+	{
+		DrawSceneIndirect(cmdList);
+		return;
+	}
+
+	if (mDepthPrepass)
+	{
+		GPU_PROFILE_SCOPE(mDX12Wrapper->GetGpuProfiler(), cmdList, "DepthPrepass");
+		mDrawPackets.SubmitDepthOnly(cmdList);
+	}
+
+	mDrawPackets.Submit(cmdList);
+}
+
+void Render::DrawSceneIndirect(ID3D12GraphicsCommandList* cmdList)
+{
+	{
+		GPU_PROFILE_SCOPE(mDX12Wrapper->GetGpuProfiler(), cmdList, "IndirectCull");
+
+		// オブジェクトの球はモデル空間なので、ワールド込みの行列で視錐台を作る
+		mIndirectDraw.Cull(cmdList, DirectX::XMLoadFloat4x4(&mCullMatrix));
+	}
+
+	// パケットで積むのと同じステートを設定し、マテリアル番号とインデックスの範囲だけを引数バッファから取る
+	ID3D12DescriptorHeap* heaps[] = { mBasicDescHeap.Get(), mSamplers.Heap() };
+
+	cmdList->SetPipelineState(mPipelineState.Get());
+	cmdList->SetGraphicsRootSignature(mRootSignature.Get());
+	cmdList->SetDescriptorHeaps(_countof(heaps), heaps);
+	cmdList->SetGraphicsRootDescriptorTable(DrawRootParamTexture, mBasicDescHeap->GetGPUDescriptorHandleForHeapStart());
+	cmdList->SetGraphicsRootConstantBufferView(DrawRootParamFrame, mFrameConstants->GpuAddress());
+	cmdList->SetGraphicsRoot32BitConstants(DrawRootParamDraw, mDrawConstants->Num32BitValues(), mDrawConstants->Data(), 0);
+	cmdList->SetGraphicsRootDescriptorTable(DrawRootParamSampler, mMaterialSamplerTable);
+	cmdList->SetGraphicsRootDescriptorTable(DrawRootParamMaterialTable, mMaterialTable);
+
+	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	cmdList->IASetVertexBuffers(0, 1, &mVbView);
+	cmdList->IASetIndexBuffer(&mIbView);
+
+	mIndirectDraw.Draw(cmdList);
+}
+
+void Render::DrawUpscale(ID3D12GraphicsCommandList* cmdList, UINT sceneWidth, UINT sceneHeight)
+{
+	GPU_PROFILE_SCOPE(mDX12Wrapper->GetGpuProfiler(), cmdList, "Upscale");
+
+	D3D12_CPU_DESCRIPTOR_HANDLE rtv = mDX12Wrapper->GetCurrentBackBufferView();
+	cmdList->OMSetRenderTargets(1, &rtv, true, nullptr);
+
+	cmdList->RSSetViewports(1, &mDX12Wrapper->GetViewport());
+	cmdList->RSSetScissorRects(1, &mDX12Wrapper->GetScissorRect());
+
+	SIZE windowSize = Application::Instance().GetWindowSize();
+	float width = static_cast<float>(windowSize.cx);
+	float height = static_cast<float>(windowSize.cy);
+
+	// 描いた範囲のUVと、範囲外のテクセルを拾わないための上限(半テクセル内側)
+	float upscaleParam[] =
+	{
+		static_cast<float>(sceneWidth) / width,
+		static_cast<float>(sceneHeight) / height,
+		(static_cast<float>(sceneWidth) - 0.5F) / width,
+		(static_cast<float>(sceneHeight) - 0.5F) / height,
+	};
+
+	D3D12_GPU_DESCRIPTOR_HANDLE sceneSrv = mBasicDescHeap->GetGPUDescriptorHandleForHeapStart();
+	sceneSrv.ptr += mDX12Wrapper->Device()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	ID3D12DescriptorHeap* heaps[] = { mBasicDescHeap.Get() };
+
+	cmdList->SetGraphicsRootSignature(mUpscaleRootSignature.Get());
+	cmdList->SetPipelineState(mUpscalePipelineState.Get());
+	cmdList->SetDescriptorHeaps(1, heaps);
+	cmdList->SetGraphicsRootDescriptorTable(0, sceneSrv);
+	cmdList->SetGraphicsRoot32BitConstants(1, _countof(upscaleParam), upscaleParam, 0);
+
+	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	cmdList->DrawInstanced(3, 1, 0, 0);
+}
+
+void Render::EndOfFrame()
+{
+	mDrawPackets.Clear();
+}
+
+bool Render::CreateBuffers()
+{
+	auto dev = mDX12Wrapper->Device();
+
+	// 頂点作製
+	StaticVertex vertices[] =
+	{
+		{ {-1.0F, -1.0F, 0.0F }, { 0.0F, 0.0F, -1.0F }, { 0.0F, 1.0F } },
+		{ {-1.0F,  1.0F, 0.0F }, { 0.0F, 0.0F, -1.0F }, { 0.0F, 0.0F } },
+		{ { 1.0F, -1.0F, 0.0F }, { 0.0F, 0.0F, -1.0F }, { 1.0F, 1.0F } },
+		{ { 1.0F,  1.0F, 0.0F }, { 0.0F, 0.0F, -1.0F }, { 1.0F, 0.0F } },
+	};
+
+	unsigned short indices[] =
+	{
+		0, 1, 2,
+		2, 1, 3
+	};
+
+	// 読み込み時の最適化(頂点キャッシュ→頂点フェッチの順に並べ替え、16ビットインデックスにする)
+	// モデルを読むようになっても同じ経路を通す
+	// 法線は八面体SNORM16、UVは半精度にして1頂点20バイトにする(BasicVertexShader.hlslで戻す)
+	std::vector<CompactStaticVertex> compact = VertexFormat::Compress(vertices, _countof(vertices));
+
+	std::vector<uint8_t> vertexData(compact.size() * sizeof(CompactStaticVertex));
+	std::memcpy(vertexData.data(), compact.data(), vertexData.size());
+
+	std::vector<uint32_t> indexData(std::begin(indices), std::end(indices));
+
+	std::vector<MeshSubset> subsets(1);
+	subsets[0].indexCount = static_cast<uint32_t>(indexData.size());
+
+	MeshOptimizer::Optimize(vertexData, sizeof(CompactStaticVertex), indexData, subsets);
+
+	if (subsets[0].index32)
+	{
+		assert(false && "16ビットインデックスに収まらない");
+		return false;
+	}
+
+	std::vector<uint16_t> index16 = MeshOptimizer::ToIndex16(indexData, subsets[0]);
+
+	auto& allocator = mDX12Wrapper->GetMemoryAllocator();
+
+	// 小さいバッファなのでアップロードヒープの共有バッファから切り出される
+	if (!allocator.CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, vertexData.size(), D3D12_RESOURCE_STATE_GENERIC_READ, mVertBuff))
+	{
+		assert(false && "バーテックスバッファーの作成失敗");
+		return false;
+	}
+
+	std::memcpy(mVertBuff.cpuAddress, vertexData.data(), vertexData.size());
+
+	// 頂点バッファービュー
+	mVbView.BufferLocation = mVertBuff.gpuAddress; // 頂点バッファー仮想アドレス
+	mVbView.SizeInBytes = static_cast<UINT>(vertexData.size()); // 全バイト数
+	mVbView.StrideInBytes = sizeof(CompactStaticVertex); // 頂点一つのバイト数
+
+	// インデックスバッファー
+	const size_t indexBytes = index16.size() * sizeof(uint16_t);
+	if (!allocator.CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, indexBytes, D3D12_RESOURCE_STATE_GENERIC_READ, mIdxBuff))
+	{
+		assert(false && "インデックスバッファーの作製失敗");
+		return false;
+	}
+
+	std::memcpy(mIdxBuff.cpuAddress, index16.data(), indexBytes);
+
+	mIbView.BufferLocation = mIdxBuff.gpuAddress;
+	mIbView.Format = DXGI_FORMAT_R16_UINT;
+	mIbView.SizeInBytes = static_cast<UINT>(indexBytes);
+
+	mIndexCount = static_cast<UINT>(index16.size());
+
+	// 板ポリ1枚を1オブジェクトとしてBVHに入れる
+	Aabb bounds = {};
+	for (const StaticVertex& vertex : vertices)
+	{
+		bounds.Expand(vertex.pos);
+	}
+
+	mStageObjects = { { mIndexCount, 0, static_cast<INT>(subsets[0].baseVertex), bounds } };
+
+	std::vector<Aabb> objectBounds;
+	for (const StageObject& object : mStageObjects)
+	{
+		objectBounds.push_back(object.bounds);
+	}
+
+	mStageBvh.Build(objectBounds);
+
+	return true;
+}
+
+bool Render::LoadTexture(RenderAssets& assets)
+{
+	// WICはCOMを使うが、メインスレッドがMTAで初期化済みなので、どのスレッドから呼んでもよい
+	DirectX::TexMetadata metadata = {};
+	DirectX::ScratchImage scratchImg = {};
+
+	auto result = DirectX::LoadFromWICFile(L"Asset/Texture/Test.png", DirectX::WIC_FLAGS_NONE, &metadata, scratchImg);
+
+	if (FAILED(result))
+	{
+		assert(false && "テクスチャ読み込み失敗");
+		return false;
+	}
+
+	// ミップはRGBA8で作るので、それ以外(グレースケール等)は先に変換する
+	const DXGI_FORMAT sourceFormat = DirectX::MakeTypeless(metadata.format);
+	if (sourceFormat != DXGI_FORMAT_R8G8B8A8_TYPELESS && sourceFormat != DXGI_FORMAT_B8G8R8A8_TYPELESS)
+	{
+		DirectX::ScratchImage converted = {};
+		DXGI_FORMAT targetFormat = DirectX::IsSRGB(metadata.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+
+		result = DirectX::Convert(*scratchImg.GetImage(0, 0, 0), targetFormat, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+
+		if (FAILED(result))
+		{
+			assert(false && "テクスチャのフォーマット変換失敗");
+			return false;
+		}
+
+		scratchImg = std::move(converted);
+		metadata = scratchImg.GetMetadata();
+	}
+
+	// 縮小時のちらつきを抑えるため、読み込み時にミップを1x1まで作る
+	// マテリアルのテクスチャは色なので、リニアに戻してから平均する
+	const DirectX::Image* img = scratchImg.GetImage(0, 0, 0);
+
+	{
+		PROFILE_SCOPE("MipGenerator::Generate");
+
+		if (!MipGenerator::Generate(img->pixels, img->rowPitch, static_cast<uint32_t>(img->width), static_cast<uint32_t>(img->height), MipColorSpace::Srgb, assets.textureMips))
+		{
+			assert(false && "ミップ生成失敗");
+			return false;
+		}
+	}
+
+	assets.textureFormat = metadata.format;
+
+	return true;
+}
+
+bool Render::CompileBasicShaders(RenderAssets& assets)
+{
+	if (!ShaderHotReload::Compile(BasicVsPath, BasicVsEntry, "vs_5_0", assets.basicVs))
+	{
+		return false;
+	}
+
+	return ShaderHotReload::Compile(BasicPsPath, BasicPsEntry, "ps_5_0", assets.basicPs);
+}
+
+bool Render::CompileUpscaleShaders(RenderAssets& assets)
+{
+	if (!ShaderHotReload::Compile(UpscaleVsPath, UpscaleVsEntry, "vs_5_0", assets.upscaleVs))
+	{
+		return false;
+	}
+
+	return ShaderHotReload::Compile(UpscalePsPath, UpscalePsEntry, "ps_5_0", assets.upscalePs);
+}
+
+bool Render::CreateTexture(const RenderAssets& assets)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	const std::vector<MipLevel>& mipLevels = assets.textureMips;
+
+	if (mipLevels.empty())
+	{
+		assert(false && "テクスチャが読み込まれていない");
+		return false;
+	}
+
+	D3D12_HEAP_PROPERTIES textureHeapProp = {};
+	textureHeapProp.Type = D3D12_HEAP_TYPE_CUSTOM;
+	textureHeapProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
+	textureHeapProp.MemoryPoolPreference = D3D12_MEMORY_POOL_L0;
+	textureHeapProp.CreationNodeMask = 0;
+	textureHeapProp.VisibleNodeMask = 0;
+
+	D3D12_RESOURCE_DESC resDesc = {};
+	resDesc.Format = assets.textureFormat;
+	resDesc.Width = mipLevels[0].width;
+	resDesc.Height = mipLevels[0].height;
+	resDesc.DepthOrArraySize = 1;
+	resDesc.SampleDesc.Count = 1;
+	resDesc.SampleDesc.Quality = 0;
+	resDesc.MipLevels = static_cast<UINT16>(mipLevels.size());
+	resDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	resDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	resDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	auto result = dev->CreateCommittedResource(&textureHeapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resDesc,
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+		nullptr,
+		IID_PPV_ARGS(mTexBuff.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "テクスチャバッファ作成失敗");
+		return false;
+	}
+
+	for (size_t i = 0; i < mipLevels.size(); ++i)
+	{
+		const MipLevel& level = mipLevels[i];
+		UINT rowPitch = level.width * 4;
+
+		result = mTexBuff->WriteToSubresource(static_cast<UINT>(i),
+			nullptr,
+			level.pixels.data(),
+			rowPitch,
+			rowPitch * level.height);
+
+		if (FAILED(result))
+		{
+			assert(false && "テクスチャ転送失敗");
+			return false;
+		}
+	}
+
+	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	descHeapDesc.NodeMask = 0;
+	descHeapDesc.NumDescriptors = BasicDescriptorCount;
+	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+
+	result = dev->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(mBasicDescHeap.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "ディスクリプタヒープ作成失敗");
+		return false;
+	}
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+
+	srvDesc.Format = assets.textureFormat;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = static_cast<UINT>(mipLevels.size());
+
+	dev->CreateShaderResourceView(mTexBuff.Get(), &srvDesc, mBasicDescHeap->GetCPUDescriptorHandleForHeapStart());
+
+	if (!mSamplers.Init(dev.Get()))
+	{
+		return false;
+	}
+
+	SetMaterialSampler(mMaterialSampler);
+
+	return true;
+}
+
+void Render::SetMaterialSampler(const SamplerSettings& settings)
+{
+	mMaterialSampler = settings;
+	mMaterialSamplerTable = mSamplers.Get(settings);
+}
+
+bool Render::CreateConstants()
+{
+	mConstants.Init(&mDX12Wrapper->GetMemoryAllocator());
+
+	// ビュープロジェクションと照明はルートCBV、ワールド行列(16DWORD)はルート定数で渡す
+	mFrameConstants = mConstants.CreateBlock("Frame", ConstantFrequency::PerFrame, sizeof(FrameConstants), 1, ConstantBinding::RootCbv);
+	mDrawConstants = mConstants.CreateBlock("Draw", ConstantFrequency::PerDraw, sizeof(DirectX::XMMATRIX), 2);
+
+	if (mFrameConstants == nullptr || mDrawConstants == nullptr)
+	{
+		assert(false && "定数ブロック作成失敗");
+		return false;
+	}
+
+	return true;
+}
+
+bool Render::CreateMaterials()
+{
+	auto dev = mDX12Wrapper->Device();
+
+	// モデルの読み込みがまだ無いので、テクスチャをそのまま出す既定のマテリアルを1つ置く
+	// 読み込む時はマテリアル毎にトゥーンとスフィアをmToonRamps/mSphereMapsへ加え、返った番号を入れる
+	if (mMaterials.empty())
+	{
+		MaterialConstants material = {};
+		material.ambient = { 0.4F, 0.4F, 0.4F };
+		material.toonIndex = ToonRampAtlas::DefaultRamp;
+		material.sphereIndex = SphereMapArray::DefaultLayer;
+
+		mMaterials.push_back(material);
+	}
+
+	const uint8_t* toonRows = mToonRamps.Pixels().data();
+	if (!CreateMaterialTexture(&toonRows, ToonRampAtlas::RampWidth, mToonRamps.Count(), 1, mToonAtlasBuff))
+	{
+		return false;
+	}
+
+	std::vector<const uint8_t*> sphereLayers;
+	for (uint32_t i = 0; i < mSphereMaps.LayerCount(); ++i)
+	{
+		sphereLayers.push_back(mSphereMaps.Layer(i).data());
+	}
+
+	if (!CreateMaterialTexture(sphereLayers.data(), mSphereMaps.Size(), mSphereMaps.Size(), mSphereMaps.LayerCount(), mSphereArrayBuff))
+	{
+		return false;
+	}
+
+	// 毎フレームは書き換えないので、小さければアップロードヒープの共有バッファから切り出される
+	auto& allocator = mDX12Wrapper->GetMemoryAllocator();
+
+	if (!allocator.CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, sizeof(MaterialConstants) * mMaterials.size(), D3D12_RESOURCE_STATE_GENERIC_READ, mMaterialBuff))
+	{
+		assert(false && "マテリアルバッファの作成失敗");
+		return false;
+	}
+
+	std::copy(mMaterials.begin(), mMaterials.end(), static_cast<MaterialConstants*>(mMaterialBuff.cpuAddress));
+
+	const UINT increment = dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	const D3D12_CPU_DESCRIPTOR_HANDLE heapStart = mBasicDescHeap->GetCPUDescriptorHandleForHeapStart();
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE handle = { heapStart.ptr + increment * ToonAtlasSlot };
+	dev->CreateShaderResourceView(mToonAtlasBuff.Get(), &srvDesc, handle);
+
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+	srvDesc.Texture2DArray.MipLevels = 1;
+	srvDesc.Texture2DArray.FirstArraySlice = 0;
+	srvDesc.Texture2DArray.ArraySize = mSphereMaps.LayerCount();
+
+	handle.ptr = heapStart.ptr + increment * SphereArraySlot;
+	dev->CreateShaderResourceView(mSphereArrayBuff.Get(), &srvDesc, handle);
+
+	// 共有バッファの切り出し位置は256バイト境界なので、要素の位置で表せる
+	D3D12_SHADER_RESOURCE_VIEW_DESC bufferDesc = {};
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	bufferDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+	bufferDesc.Buffer.FirstElement = mMaterialBuff.offset / sizeof(MaterialConstants);
+	bufferDesc.Buffer.NumElements = static_cast<UINT>(mMaterials.size());
+	bufferDesc.Buffer.StructureByteStride = sizeof(MaterialConstants);
+	bufferDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
+
+	handle.ptr = heapStart.ptr + increment * MaterialBufferSlot;
+	dev->CreateShaderResourceView(mMaterialBuff.resource.Get(), &bufferDesc, handle);
+
+	mMaterialTable = mBasicDescHeap->GetGPUDescriptorHandleForHeapStart();
+	mMaterialTable.ptr += increment * ToonAtlasSlot;
+
+	return true;
+}
+
+bool Render::CreateMaterialTexture(const uint8_t* const* layers, UINT width, UINT height, UINT layerCount, ComPtr<ID3D12Resource>& texture)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	// マテリアルのテクスチャと同じく、CPUから直接書き込む
+	D3D12_HEAP_PROPERTIES textureHeapProp = {};
+	textureHeapProp.Type = D3D12_HEAP_TYPE_CUSTOM;
+	textureHeapProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
+	textureHeapProp.MemoryPoolPreference = D3D12_MEMORY_POOL_L0;
+	textureHeapProp.CreationNodeMask = 0;
+	textureHeapProp.VisibleNodeMask = 0;
+
+	// MMDと同じく、sRGBとして戻さずにそのままの値で使う
+	D3D12_RESOURCE_DESC resDesc = {};
+	resDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	resDesc.Width = width;
+	resDesc.Height = height;
+	resDesc.DepthOrArraySize = static_cast<UINT16>(layerCount);
+	resDesc.SampleDesc.Count = 1;
+	resDesc.SampleDesc.Quality = 0;
+	resDesc.MipLevels = 1;
+	resDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	resDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	resDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	auto result = dev->CreateCommittedResource(&textureHeapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resDesc,
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE,
+		nullptr,
+		IID_PPV_ARGS(texture.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "マテリアル用テクスチャ作成失敗");
+		return false;
+	}
+
+	UINT rowPitch = width * 4;
+
+	// ミップが1段なので、サブリソースの番号は層の番号と同じ
+	for (UINT i = 0; i < layerCount; ++i)
+	{
+		result = texture->WriteToSubresource(i, nullptr, layers[i], rowPitch, rowPitch * height);
+
+		if (FAILED(result))
+		{
+			assert(false && "マテリアル用テクスチャ転送失敗");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Render::CreatePipeline(const RenderAssets& assets)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	ComPtr<ID3DBlob> errorBlob = nullptr;
+
+	D3D12_DESCRIPTOR_RANGE textureDescriptorRange = {};
+	textureDescriptorRange.NumDescriptors = 1;
+	textureDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	textureDescriptorRange.BaseShaderRegister = 0;
+	textureDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	// マテリアル毎に切り替えられるよう、サンプラーも静的サンプラーではなくテーブルで渡す
+	D3D12_DESCRIPTOR_RANGE samplerDescriptorRange = {};
+	samplerDescriptorRange.NumDescriptors = 1;
+	samplerDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER;
+	samplerDescriptorRange.BaseShaderRegister = 0;
+	samplerDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	// トゥーン(t1)、スフィア(t2)、マテリアル(t3)
+	D3D12_DESCRIPTOR_RANGE materialDescriptorRange = {};
+	materialDescriptorRange.NumDescriptors = 3;
+	materialDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	materialDescriptorRange.BaseShaderRegister = 1;
+	materialDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	D3D12_ROOT_PARAMETER rootparam[6] = {};
+	rootparam[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootparam[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[0].DescriptorTable.pDescriptorRanges = &textureDescriptorRange;
+	rootparam[0].DescriptorTable.NumDescriptorRanges = 1;
+
+	// フレーム毎の定数(b0)はルートCBV。照明をピクセルシェーダーでも使う
+	rootparam[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootparam[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+	rootparam[1].Descriptor.ShaderRegister = 0;
+	rootparam[1].Descriptor.RegisterSpace = 0;
+
+	// ドロー毎の定数(b1)はルート定数
+	rootparam[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	rootparam[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootparam[2].Constants.ShaderRegister = 1;
+	rootparam[2].Constants.RegisterSpace = 0;
+	rootparam[2].Constants.Num32BitValues = mDrawConstants->Num32BitValues();
+
+	// マテリアルのサンプラー(s0)
+	rootparam[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootparam[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[3].DescriptorTable.pDescriptorRanges = &samplerDescriptorRange;
+	rootparam[3].DescriptorTable.NumDescriptorRanges = 1;
+
+	// マテリアル番号(b2)。ドロー毎に変わるのはこの1DWORDだけ
+	rootparam[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	rootparam[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[4].Constants.ShaderRegister = 2;
+	rootparam[4].Constants.RegisterSpace = 0;
+	rootparam[4].Constants.Num32BitValues = 1;
+
+	rootparam[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootparam[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[5].DescriptorTable.pDescriptorRanges = &materialDescriptorRange;
+	rootparam[5].DescriptorTable.NumDescriptorRanges = 1;
+
+	// トゥーンとスフィア(s1)。端の色を繰り返さないようクランプ
+	D3D12_STATIC_SAMPLER_DESC samplerDesc = {};
+	samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+	samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+	samplerDesc.MinLOD = 0.0f;
+	samplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	samplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	samplerDesc.ShaderRegister = 1;
+	samplerDesc.RegisterSpace = 0;
+
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+	rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+	rootSignatureDesc.pParameters = rootparam;
+	rootSignatureDesc.NumParameters = _countof(rootparam);
+	rootSignatureDesc.pStaticSamplers = &samplerDesc;
+	rootSignatureDesc.NumStaticSamplers = 1;
+
+	ComPtr<ID3DBlob> rootSigBlob = nullptr;
+
+	auto result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, rootSigBlob.ReleaseAndGetAddressOf(), errorBlob.ReleaseAndGetAddressOf());
+	if (FAILED(result) == true)
+	{
+		mDX12Wrapper->ShowErrorMessage(result, errorBlob.Get());
+		return false;
+	}
+
+	result = dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(mRootSignature.ReleaseAndGetAddressOf()));
+	if (FAILED(result) == true)
+	{
+		assert(false && "ルートシグネチャ作成失敗");
+		return false;
+	}
+
+	struct
+	{
+		PipelineVariant variant;
+		ComPtr<ID3D12PipelineState>* target;
+	} pipelines[] =
+	{
+		{ PipelineVariant::Shaded, &mPipelineState },
+		{ PipelineVariant::ShadedAfterPrepass, &mPipelineStateAfterPrepass },
+		{ PipelineVariant::DepthOnly, &mDepthOnlyPipelineState },
+	};
+
+	ShaderProgramDesc program = {};
+	program.vsPath = BasicVsPath;
+	program.vsEntry = BasicVsEntry;
+	program.psPath = BasicPsPath;
+	program.psEntry = BasicPsEntry;
+
+	for (const auto& pipeline : pipelines)
+	{
+		if (!CreatePipelineState(assets.basicVs.Get(), assets.basicPs.Get(), pipeline.variant, *pipeline.target))
+		{
+			return false;
+		}
+
+		// シェーダーの保存でPSOを作り直す
+		PipelineVariant variant = pipeline.variant;
+		mShaderHotReload.Register(pipeline.target, program, [this, variant](ID3DBlob* vs, ID3DBlob* ps, ComPtr<ID3D12PipelineState>& pipelineState)
+			{
+				return CreatePipelineState(vs, ps, variant, pipelineState);
+			});
+	}
+
+	return true;
+}
+
+bool Render::CreatePipelineState(ID3DBlob* vsBlob, ID3DBlob* psBlob, PipelineVariant variant, ComPtr<ID3D12PipelineState>& pipelineState)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	// 頂点レイアウトの作成
+	// CompactStaticVertex(BasicVertexShader.hlslの引数と対応)
+	std::vector<D3D12_INPUT_ELEMENT_DESC> inputLayout = VertexFormat::StaticInputLayout();
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline = {};
+
+	gpipeline.pRootSignature = mRootSignature.Get();
+	gpipeline.VS.pShaderBytecode = vsBlob->GetBufferPointer();
+	gpipeline.VS.BytecodeLength = vsBlob->GetBufferSize();
+
+	if (variant != PipelineVariant::DepthOnly)
+	{
+		gpipeline.PS.pShaderBytecode = psBlob->GetBufferPointer();
+		gpipeline.PS.BytecodeLength = psBlob->GetBufferSize();
+	}
+
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	gpipeline.RasterizerState.MultisampleEnable = false;
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	gpipeline.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+	gpipeline.RasterizerState.DepthClipEnable = true;
+
+	gpipeline.BlendState.AlphaToCoverageEnable = false;
+	gpipeline.BlendState.IndependentBlendEnable = false;
+
+	D3D12_RENDER_TARGET_BLEND_DESC renderTargetBlendDesc = {};
+	renderTargetBlendDesc.BlendEnable = false;
+	renderTargetBlendDesc.LogicOpEnable = false;
+	renderTargetBlendDesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	gpipeline.BlendState.RenderTarget[0] = renderTargetBlendDesc;
+
+	gpipeline.DepthStencilState.DepthEnable = true;
+	gpipeline.DepthStencilState.StencilEnable = false;
+	gpipeline.DSVFormat = mDX12Wrapper->GetDepthFormat();
+
+	if (variant == PipelineVariant::ShadedAfterPrepass)
+	{
+		// プリパスで書いた一番手前の面だけを塗る
+		gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+		gpipeline.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_EQUAL;
+	}
+	else
+	{
+		gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+		gpipeline.DepthStencilState.DepthFunc = mDX12Wrapper->GetDepthComparison();
+	}
+
+	gpipeline.InputLayout.pInputElementDescs = inputLayout.data();
+	gpipeline.InputLayout.NumElements = static_cast<UINT>(inputLayout.size());
+
+	gpipeline.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	if (variant == PipelineVariant::DepthOnly)
+	{
+		gpipeline.NumRenderTargets = 0;
+	}
+	else
+	{
+		gpipeline.NumRenderTargets = 1;
+		gpipeline.RTVFormats[0] = mDX12Wrapper->GetBackBufferFormat();
+	}
+	gpipeline.SampleDesc.Count = 1;
+	gpipeline.SampleDesc.Quality = 0;
+
+	auto result = dev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(pipelineState.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "パイプラインステート作成失敗");
+		return false;
+	}
+
+	return true;
+}
+
+bool Render::CreateIndirectDraw()
+{
+	// objectIdをマテリアル番号のルート定数に流し込む
+	if (!mIndirectDraw.Init(mDX12Wrapper, static_cast<UINT>(mStageObjects.size()), mRootSignature.Get(), DrawRootParamMaterialIndex))
+	{
+		return false;
+	}
+
+	// マテリアルはまだ1つだけ(Updateのパケットと同じ番号)
+	std::vector<IndirectObject> objects;
+	for (const StageObject& object : mStageObjects)
+	{
+		Float3 center = object.bounds.Center();
+
+		IndirectObject indirect = {};
+		indirect.bounds.center = center;
+		indirect.bounds.radius = Math::Length(Math::Subtract(object.bounds.max, center));
+		indirect.indexCount = object.indexCount;
+		indirect.startIndex = object.startIndex;
+		indirect.baseVertex = object.baseVertex;
+		indirect.objectId = 0;
+
+		objects.push_back(indirect);
+	}
+
+	mIndirectDraw.SetObjects(objects);
+
+	return true;
+}
+
+bool Render::CreateSceneTarget()
+{
+	auto dev = mDX12Wrapper->Device();
+
+	SIZE windowSize = Application::Instance().GetWindowSize();
+
+	// 倍率が変わる度に作り直さないよう、最大(ウィンドウサイズ)で確保しておく
+	D3D12_RESOURCE_DESC resDesc = {};
+	resDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	resDesc.Width = windowSize.cx;
+	resDesc.Height = windowSize.cy;
+	resDesc.DepthOrArraySize = 1;
+	resDesc.Format = mDX12Wrapper->GetBackBufferFormat();
+	resDesc.SampleDesc.Count = 1;
+	resDesc.SampleDesc.Quality = 0;
+	resDesc.MipLevels = 1;
+	resDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	resDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+	D3D12_CLEAR_VALUE clearValue = {};
+	clearValue.Format = resDesc.Format;
+	clearValue.Color[3] = 1.0F;
+
+	if (!mDX12Wrapper->GetMemoryAllocator().CreateTexture(resDesc, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, &clearValue, mSceneTarget))
+	{
+		assert(false && "シーンターゲット作成失敗");
+		return false;
+	}
+
+	if (!mSceneRtvHeap)
+	{
+		D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+		rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+		rtvHeapDesc.NodeMask = 0;
+		rtvHeapDesc.NumDescriptors = 1;
+		rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+		auto result = dev->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(mSceneRtvHeap.ReleaseAndGetAddressOf()));
+
+		if (FAILED(result))
+		{
+			assert(false && "シーンターゲット用ディスクリプタヒープ作成失敗");
+			return false;
+		}
+	}
+
+	dev->CreateRenderTargetView(mSceneTarget.resource.Get(), nullptr, mSceneRtvHeap->GetCPUDescriptorHandleForHeapStart());
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Format = resDesc.Format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+
+	// テクスチャの次(1番)に置く
+	D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = mBasicDescHeap->GetCPUDescriptorHandleForHeapStart();
+	srvHandle.ptr += dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	dev->CreateShaderResourceView(mSceneTarget.resource.Get(), &srvDesc, srvHandle);
+
+	return true;
+}
+
+bool Render::CreateUpscalePipeline(const RenderAssets& assets)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	ComPtr<ID3DBlob> errorBlob = nullptr;
+
+	ShaderProgramDesc program = {};
+	program.vsPath = UpscaleVsPath;
+	program.vsEntry = UpscaleVsEntry;
+	program.psPath = UpscalePsPath;
+	program.psEntry = UpscalePsEntry;
+
+	D3D12_DESCRIPTOR_RANGE sceneDescriptorRange = {};
+	sceneDescriptorRange.NumDescriptors = 1;
+	sceneDescriptorRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	sceneDescriptorRange.BaseShaderRegister = 0;
+	sceneDescriptorRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	D3D12_ROOT_PARAMETER rootparam[2] = {};
+	rootparam[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	rootparam[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[0].DescriptorTable.pDescriptorRanges = &sceneDescriptorRange;
+	rootparam[0].DescriptorTable.NumDescriptorRanges = 1;
+
+	// UVの倍率と上限(b0)
+	rootparam[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	rootparam[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	rootparam[1].Constants.ShaderRegister = 0;
+	rootparam[1].Constants.RegisterSpace = 0;
+	rootparam[1].Constants.Num32BitValues = 4;
+
+	// 拡大なのでバイリニア、端はクランプ
+	D3D12_STATIC_SAMPLER_DESC samplerDesc = {};
+	samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK;
+	samplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+	samplerDesc.MinLOD = 0.0f;
+	samplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	samplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	samplerDesc.RegisterSpace = 0;
+
+	// 頂点はSV_VertexIDから作るので入力レイアウトは使わない
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+	rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+	rootSignatureDesc.pParameters = rootparam;
+	rootSignatureDesc.NumParameters = _countof(rootparam);
+	rootSignatureDesc.pStaticSamplers = &samplerDesc;
+	rootSignatureDesc.NumStaticSamplers = 1;
+
+	ComPtr<ID3DBlob> rootSigBlob = nullptr;
+
+	auto result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, rootSigBlob.ReleaseAndGetAddressOf(), errorBlob.ReleaseAndGetAddressOf());
+	if (FAILED(result) == true)
+	{
+		mDX12Wrapper->ShowErrorMessage(result, errorBlob.Get());
+		return false;
+	}
+
+	result = dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(mUpscaleRootSignature.ReleaseAndGetAddressOf()));
+	if (FAILED(result) == true)
+	{
+		assert(false && "拡大用ルートシグネチャ作成失敗");
+		return false;
+	}
+
+	if (!CreateUpscalePipelineState(assets.upscaleVs.Get(), assets.upscalePs.Get(), mUpscalePipelineState))
+	{
+		return false;
+	}
+
+	mShaderHotReload.Register(&mUpscalePipelineState, program, [this](ID3DBlob* vs, ID3DBlob* ps, ComPtr<ID3D12PipelineState>& pipelineState)
+		{
+			return CreateUpscalePipelineState(vs, ps, pipelineState);
+		});
+
+	return true;
+}
+
+bool Render::CreateUpscalePipelineState(ID3DBlob* vsBlob, ID3DBlob* psBlob, ComPtr<ID3D12PipelineState>& pipelineState)
+{
+	auto dev = mDX12Wrapper->Device();
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline = {};
+
+	gpipeline.pRootSignature = mUpscaleRootSignature.Get();
+	gpipeline.VS.pShaderBytecode = vsBlob->GetBufferPointer();
+	gpipeline.VS.BytecodeLength = vsBlob->GetBufferSize();
+	gpipeline.PS.pShaderBytecode = psBlob->GetBufferPointer();
+	gpipeline.PS.BytecodeLength = psBlob->GetBufferSize();
+
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	gpipeline.RasterizerState.MultisampleEnable = false;
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	gpipeline.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+	gpipeline.RasterizerState.DepthClipEnable = true;
+
+	gpipeline.BlendState.AlphaToCoverageEnable = false;
+	gpipeline.BlendState.IndependentBlendEnable = false;
+	gpipeline.BlendState.RenderTarget[0].BlendEnable = false;
+	gpipeline.BlendState.RenderTarget[0].LogicOpEnable = false;
+	gpipeline.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	// 全画面を上書きするだけなので深度は使わない
+	gpipeline.DepthStencilState.DepthEnable = false;
+	gpipeline.DepthStencilState.StencilEnable = false;
+
+	gpipeline.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;
+	gpipeline.RTVFormats[0] = mDX12Wrapper->GetBackBufferFormat();
+	gpipeline.SampleDesc.Count = 1;
+	gpipeline.SampleDesc.Quality = 0;
+
+	auto result = dev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(pipelineState.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "拡大用パイプラインステート作成失敗");
+		return false;
+	}
+
+	return true;
 }
@@ -1,21 +1,210 @@
 #pragma once
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <DirectXMath.h>
+
 #include <memory>
+#include <string>
+#include <vector>
+
+#include "../ConstantBuffer/ConstantBuffer.h"
+#include "../Culling/Bvh.h"
+#include "../DrawPacket/DrawPacket.h"
+#include "../DynamicResolution/DynamicResolution.h"
+#include "../FramePacket/FramePacket.h"
+#include "../IndirectDraw/IndirectDraw.h"
+#include "../GpuMemory/GpuMemoryAllocator.h"
+#include "../Material/Material.h"
+#include "../Material/SphereMapArray.h"
+#include "../Material/ToonRampAtlas.h"
+#include "../Motion/BakedMotionReader.h"
+#include "../Motion/Skeleton.h"
+#include "../ShaderHotReload/ShaderHotReload.h"
+#include "../Texture/MipGenerator.h"
+#include "../Texture/SamplerCache.h"
+#include "../VertexFormat/VertexFormat.h"
 
 class Dx12Wrapper;
 
+// デバイスが無くても用意できる物(テクスチャのデコードとミップ、シェーダーのバイトコード)
+// 起動時にDx12Wrapperの初期化と並行して別スレッドで作り、Renderの構築に渡す
+struct RenderAssets
+{
+	std::vector<MipLevel> textureMips;
+	DXGI_FORMAT textureFormat = DXGI_FORMAT_UNKNOWN;
+
+	Microsoft::WRL::ComPtr<ID3DBlob> basicVs = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> basicPs = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> upscaleVs = nullptr;
+	Microsoft::WRL::ComPtr<ID3DBlob> upscalePs = nullptr;
+};
+
 class Render
 {
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
 public:
 
-	Render (std::shared_ptr<Dx12Wrapper>& dx);
-	Render() = default;
-	~Render() = default;
+	Render (std::shared_ptr<Dx12Wrapper>& dx, const RenderAssets& assets);
+	~Render();
 
-	void Frame();
+	// RenderAssetsを埋める。互いに独立していて、どのスレッドから呼んでもよい
+	static bool LoadTexture(RenderAssets& assets);
+	static bool CompileBasicShaders(RenderAssets& assets);
+	static bool CompileUpscaleShaders(RenderAssets& assets);
+
+	// 描画スレッドから呼ぶ。packetの設定を反映してから描く
+	void Frame(const FramePacket& packet);
+
+	const DrawPacketStats& GetDrawStats() const { return mDrawPackets.Stats(); }
+	const ConstantUploadStats& GetConstantStats() const { return mConstants.Stats(); }
+
+	// 不透明を先に深度だけ描き、本描画は深度EQUALで見える面だけを塗る
+	void SetDepthPrepass(bool enable) { mDepthPrepass = enable; }
+	bool IsDepthPrepass() const { return mDepthPrepass; }
+
+	// シーンを縮小したターゲットに描き、バックバッファへ拡大する
+	void SetDynamicResolution(bool enable);
+	bool IsDynamicResolution() const { return mDynamicResolutionEnabled; }
+	float GetResolutionScale() const { return mDynamicResolutionEnabled ? mDynamicResolution.Scale() : 1.0F; }
+
+	// 視錐台カリングをコンピュートシェーダーで行い、ExecuteIndirectで描く
+	// 深度プリパスとは併用しない
+	bool IsIndirectDraw() const { return mIndirectDrawEnabled; }
+
+	// ウィンドウサイズが変わった後に呼ぶ
+	void OnResize();
+
+	// ベイク済みモーションをskeletonに流して繰り返し再生する
+	// スキニングはまだ無いので、センターボーンの動きをモデル全体に掛ける
+	// 描画スレッドを動かす前に呼ぶこと
+	bool SetBakedMotion(const std::string& path, const Skeleton& skeleton);
+	const Skeleton& GetSkeleton() const { return mSkeleton; }
+
+	// マテリアルのテクスチャのサンプラー。既定は異方性x8、WRAP
+	void SetMaterialSampler(const SamplerSettings& settings);
+	const SamplerSettings& GetMaterialSampler() const { return mMaterialSampler; }
 
 private:
 
-	void Update() const;
-	void DrawFrame() const;
-	void EndOfFrame() const;
-};
\ No newline at end of file
+	enum class PipelineVariant
+	{
+		Shaded,				// 深度テストと書き込みあり
+		ShadedAfterPrepass,	// プリパス後、深度EQUALで書き込みなし
+		DepthOnly,			// ピクセルシェーダーなし
+	};
+
+	// ステージを構成する描画単位。添字がBVHのプリミティブ番号になる
+	struct StageObject
+	{
+		UINT indexCount;
+		UINT startIndex;
+		INT baseVertex;
+		Aabb bounds;
+	};
+
+	// ルートパラメータ1(b0)。BasicShaderHeader.hlsliのcbuff0と同じ並び
+	struct FrameConstants
+	{
+		DirectX::XMMATRIX viewProj;
+		DirectX::XMMATRIX view;
+		DirectX::XMFLOAT4 lightDirection;	// ビュー空間、光の進む向き
+		DirectX::XMFLOAT4 lightColor;
+	};
+
+	void ApplyPacket(const FramePacket& packet);
+	void Update();
+	void DrawFrame();
+	void DrawScene(ID3D12GraphicsCommandList* cmdList);
+	void DrawSceneIndirect(ID3D12GraphicsCommandList* cmdList);
+	void DrawUpscale(ID3D12GraphicsCommandList* cmdList, UINT sceneWidth, UINT sceneHeight);
+	void EndOfFrame();
+
+	bool CreateBuffers();
+	bool CreateTexture(const RenderAssets& assets);
+	bool CreateConstants();
+	bool CreateMaterials();
+	bool CreateMaterialTexture(const uint8_t* const* layers, UINT width, UINT height, UINT layerCount, ComPtr<ID3D12Resource>& texture);
+	bool CreatePipeline(const RenderAssets& assets);
+	bool CreateIndirectDraw();
+	bool CreatePipelineState(ID3DBlob* vsBlob, ID3DBlob* psBlob, PipelineVariant variant, ComPtr<ID3D12PipelineState>& pipelineState);
+	bool CreateSceneTarget();
+	bool CreateUpscalePipeline(const RenderAssets& assets);
+	bool CreateUpscalePipelineState(ID3DBlob* vsBlob, ID3DBlob* psBlob, ComPtr<ID3D12PipelineState>& pipelineState);
+
+	std::shared_ptr<Dx12Wrapper> mDX12Wrapper = nullptr;
+
+	GpuAllocation mVertBuff;
+	GpuAllocation mIdxBuff;
+	D3D12_VERTEX_BUFFER_VIEW mVbView = {};
+	D3D12_INDEX_BUFFER_VIEW mIbView = {};
+	UINT mIndexCount = 0;
+
+	// ステージの可視判定(モデル空間のBVH)
+	std::vector<StageObject> mStageObjects;
+	Bvh mStageBvh;
+	std::vector<uint32_t> mVisibleObjects;
+
+	// GPU駆動の描画。ステージのオブジェクトを起動時に渡しておく
+	IndirectDraw mIndirectDraw;
+	bool mIndirectDrawReady = false;
+	bool mIndirectDrawEnabled = false;
+	DirectX::XMFLOAT4X4 mCullMatrix = {};
+
+	ComPtr<ID3D12Resource> mTexBuff = nullptr;
+
+	// ルートパラメータ3(サンプラーのテーブル)
+	SamplerCache mSamplers;
+	SamplerSettings mMaterialSampler;
+	D3D12_GPU_DESCRIPTOR_HANDLE mMaterialSamplerTable = {};
+
+	// ルートパラメータ5(トゥーンのアトラス、スフィアの配列、マテリアルのバッファ)
+	// モデルの全マテリアルで同じテーブルを使い、ドロー毎にはルートパラメータ4の番号だけを変える
+	ToonRampAtlas mToonRamps;
+	SphereMapArray mSphereMaps;
+	std::vector<MaterialConstants> mMaterials;
+	ComPtr<ID3D12Resource> mToonAtlasBuff = nullptr;
+	ComPtr<ID3D12Resource> mSphereArrayBuff = nullptr;
+	GpuAllocation mMaterialBuff;
+	D3D12_GPU_DESCRIPTOR_HANDLE mMaterialTable = {};
+
+	// ルートパラメータ1(フレーム毎)と2(ドロー毎)の定数
+	ConstantBufferSystem mConstants;
+	ConstantBlock* mFrameConstants = nullptr;
+	ConstantBlock* mDrawConstants = nullptr;
+
+	// SRVのヒープ(0:テクスチャ 1:シーンターゲット 2:トゥーン 3:スフィア 4:マテリアル)
+	ComPtr<ID3D12DescriptorHeap> mBasicDescHeap = nullptr;
+
+	ComPtr<ID3D12RootSignature> mRootSignature = nullptr;
+	ComPtr<ID3D12PipelineState> mPipelineState = nullptr;
+	ComPtr<ID3D12PipelineState> mPipelineStateAfterPrepass = nullptr;
+	ComPtr<ID3D12PipelineState> mDepthOnlyPipelineState = nullptr;
+	bool mDepthPrepass = false;
+
+	// ゲームスレッドから受け取ったワールド行列と時刻
+	DirectX::XMFLOAT4X4 mWorld = {};
+	double mTime = 0.0;
+
+	// ベイク済みモーションの再生先
+	Skeleton mSkeleton;
+	BakedMotionReader mBakedMotion;
+	int mRootBone = -1;
+
+	// 動的解像度
+	DynamicResolution mDynamicResolution;
+	bool mDynamicResolutionEnabled = false;
+	GpuAllocation mSceneTarget;
+	ComPtr<ID3D12DescriptorHeap> mSceneRtvHeap = nullptr;
+	ComPtr<ID3D12RootSignature> mUpscaleRootSignature = nullptr;
+	ComPtr<ID3D12PipelineState> mUpscalePipelineState = nullptr;
+
+	DrawPacketQueue mDrawPackets;
+
+	// ワーカースレッドがthisを使うので最後に宣言し、最初に破棄されるようにする
+	ShaderHotReload mShaderHotReload;
+};
@@ -0,0 +1,26 @@
+#include "ChangeDebouncer.h"
+
+void ChangeDebouncer::Add(const std::string& path, Clock::time_point time)
+{
+	Clock::time_point& last = mLastChange[path];
+	if (last < time)
+	{
+		last = time;
+	}
+}
+
+void ChangeDebouncer::TakeSettled(Clock::time_point now, std::vector<std::string>& settled)
+{
+	for (auto it = mLastChange.begin(); it != mLastChange.end();)
+	{
+		if (now - it->second >= mDelay)
+		{
+			settled.push_back(it->first);
+			it = mLastChange.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
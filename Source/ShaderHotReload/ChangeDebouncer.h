@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// エディタの保存は複数回の書き込みになるので、最後の変更から少し待ってからまとめて返す
+class ChangeDebouncer
+{
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::chrono::milliseconds DefaultDelay = std::chrono::milliseconds(100);
+
+	explicit ChangeDebouncer(std::chrono::milliseconds delay = DefaultDelay) : mDelay(delay) {}
+	~ChangeDebouncer() = default;
+
+	void SetDelay(std::chrono::milliseconds delay) { mDelay = delay; }
+
+	// 同じファイルの変更が続く間は待ち時間を延長する
+	void Add(const std::string& path, Clock::time_point time);
+
+	// 最後の変更からdelay以上経ったファイルを1回ずつ取り出す
+	void TakeSettled(Clock::time_point now, std::vector<std::string>& settled);
+
+	bool Empty() const { return mLastChange.empty(); }
+
+private:
+
+	std::chrono::milliseconds mDelay;
+
+	// パス -> 最後に変更された時刻
+	std::map<std::string, Clock::time_point> mLastChange;
+};
@@ -0,0 +1,15 @@
+#include "FileWatcher.h"
+
+void FileWatcher::PollChanges(std::vector<std::string>& changes)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mDebouncer.TakeSettled(ChangeDebouncer::Clock::now(), changes);
+}
+
+void FileWatcher::OnChanged(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	mDebouncer.Add(mDirectory + "/" + name, ChangeDebouncer::Clock::now());
+}
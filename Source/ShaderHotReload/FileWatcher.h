@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChangeDebouncer.h"
+
+// フォルダ以下の書き込みを監視する
+// OSの監視はFileWatcherWin32.cpp(ReadDirectoryChangesW)とFileWatcherInotify.cpp(inotify)にあり、
+// ここにはOSのヘッダーを出さない
+class FileWatcher
+{
+public:
+
+	FileWatcher();
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// サブフォルダも含めて監視する
+	bool Start(const std::string& directory, std::chrono::milliseconds debounce = ChangeDebouncer::DefaultDelay);
+	void Stop();
+
+	// debounceの間変更がなかったファイル(directoryを含むパス)を取り出す
+	void PollChanges(std::vector<std::string>& changes);
+
+private:
+
+	// OS毎の監視ハンドル
+	struct Impl;
+
+	void ThreadMain();
+
+	// 監視スレッドから呼ぶ。nameはdirectoryからの相対パス
+	void OnChanged(const std::string& name);
+
+	std::string mDirectory;
+
+	std::unique_ptr<Impl> mImpl;
+
+	std::thread mThread;
+
+	std::mutex mMutex;
+	ChangeDebouncer mDebouncer;
+};
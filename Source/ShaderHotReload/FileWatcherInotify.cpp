@@ -0,0 +1,178 @@
+#ifdef __linux__
+
+#include "FileWatcher.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+
+#include "../Profiler/CpuProfiler.h"
+
+namespace
+{
+	constexpr uint32_t WatchMask = IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+}
+
+struct FileWatcher::Impl
+{
+	int inotifyFd = -1;
+	int stopFd = -1;
+
+	// inotifyはサブフォルダを辿らないので、フォルダ毎に登録する
+	// 監視番号 -> directoryからの相対パス(直下なら空)
+	std::map<int, std::string> watches;
+
+	void AddWatch(const std::string& root, const std::string& relative)
+	{
+		std::string path = relative.empty() ? root : root + "/" + relative;
+
+		int watch = inotify_add_watch(inotifyFd, path.c_str(), WatchMask);
+		if (watch >= 0)
+		{
+			watches[watch] = relative;
+		}
+	}
+};
+
+FileWatcher::FileWatcher() : mImpl(new Impl())
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+bool FileWatcher::Start(const std::string& directory, std::chrono::milliseconds debounce)
+{
+	Stop();
+
+	mDirectory = directory;
+	mDebouncer.SetDelay(debounce);
+
+	mImpl->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (mImpl->inotifyFd < 0)
+	{
+		assert(false && "inotifyを初期化できません");
+		return false;
+	}
+
+	mImpl->AddWatch(directory, "");
+	if (mImpl->watches.empty())
+	{
+		assert(false && "監視フォルダを開けません");
+		Stop();
+		return false;
+	}
+
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+	{
+		if (it->is_directory(error))
+		{
+			mImpl->AddWatch(directory, std::filesystem::relative(it->path(), directory, error).generic_string());
+		}
+	}
+
+	// 止める合図が作れなければ、スレッドを始めるとStopで止められなくなる
+	mImpl->stopFd = eventfd(0, EFD_CLOEXEC);
+	if (mImpl->stopFd < 0)
+	{
+		assert(false && "eventfdを作れません");
+		Stop();
+		return false;
+	}
+
+	mThread = std::thread(&FileWatcher::ThreadMain, this);
+
+	return true;
+}
+
+void FileWatcher::Stop()
+{
+	if (mThread.joinable())
+	{
+		uint64_t one = 1;
+		ssize_t written = write(mImpl->stopFd, &one, sizeof(one));
+		(void)written;
+		mThread.join();
+	}
+
+	if (mImpl->stopFd >= 0)
+	{
+		close(mImpl->stopFd);
+		mImpl->stopFd = -1;
+	}
+
+	if (mImpl->inotifyFd >= 0)
+	{
+		// 閉じれば監視も全て外れる
+		close(mImpl->inotifyFd);
+		mImpl->inotifyFd = -1;
+	}
+
+	mImpl->watches.clear();
+}
+
+void FileWatcher::ThreadMain()
+{
+	CpuProfiler::Instance().SetThreadName("FileWatcher");
+
+	// inotify_eventはこの境界に並ぶ
+	alignas(inotify_event) char buffer[16 * 1024];
+
+	pollfd fds[] =
+	{
+		{ mImpl->stopFd, POLLIN, 0 },
+		{ mImpl->inotifyFd, POLLIN, 0 },
+	};
+
+	while (true)
+	{
+		if (poll(fds, 2, -1) < 0 || (fds[0].revents & POLLIN) != 0)
+		{
+			// 停止要求
+			break;
+		}
+
+		ssize_t bytes = read(mImpl->inotifyFd, buffer, sizeof(buffer));
+		if (bytes <= 0)
+		{
+			continue;
+		}
+
+		for (ssize_t offset = 0; offset < bytes;)
+		{
+			auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+			offset += sizeof(inotify_event) + event->len;
+
+			auto watch = mImpl->watches.find(event->wd);
+			if (watch == mImpl->watches.end() || event->len == 0)
+			{
+				continue;
+			}
+
+			std::string name = watch->second.empty() ? event->name : watch->second + "/" + event->name;
+
+			if ((event->mask & IN_ISDIR) != 0)
+			{
+				// 後から作られたフォルダも監視する
+				if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+				{
+					mImpl->AddWatch(mDirectory, name);
+				}
+				continue;
+			}
+
+			OnChanged(name);
+		}
+	}
+}
+
+#endif
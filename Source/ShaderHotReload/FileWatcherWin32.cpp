@@ -0,0 +1,150 @@
+#ifdef _WIN32
+
+#include "FileWatcher.h"
+
+#include <Windows.h>
+
+#include <cassert>
+
+#include "../Profiler/CpuProfiler.h"
+
+struct FileWatcher::Impl
+{
+	HANDLE directoryHandle = INVALID_HANDLE_VALUE;
+	HANDLE stopEvent = nullptr;
+};
+
+FileWatcher::FileWatcher() : mImpl(new Impl())
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+	Stop();
+}
+
+bool FileWatcher::Start(const std::string& directory, std::chrono::milliseconds debounce)
+{
+	Stop();
+
+	mDirectory = directory;
+	mDebouncer.SetDelay(debounce);
+
+	mImpl->directoryHandle = CreateFileA(directory.c_str(),
+		FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		nullptr);
+
+	if (mImpl->directoryHandle == INVALID_HANDLE_VALUE)
+	{
+		assert(false && "監視フォルダを開けません");
+		return false;
+	}
+
+	mImpl->stopEvent = CreateEvent(nullptr, true, false, nullptr);
+
+	mThread = std::thread(&FileWatcher::ThreadMain, this);
+
+	return true;
+}
+
+void FileWatcher::Stop()
+{
+	if (mThread.joinable())
+	{
+		SetEvent(mImpl->stopEvent);
+		mThread.join();
+	}
+
+	if (mImpl->stopEvent != nullptr)
+	{
+		CloseHandle(mImpl->stopEvent);
+		mImpl->stopEvent = nullptr;
+	}
+
+	if (mImpl->directoryHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mImpl->directoryHandle);
+		mImpl->directoryHandle = INVALID_HANDLE_VALUE;
+	}
+}
+
+void FileWatcher::ThreadMain()
+{
+	CpuProfiler::Instance().SetThreadName("FileWatcher");
+
+	// FILE_NOTIFY_INFORMATIONはDWORD境界に並ぶ
+	alignas(DWORD) BYTE buffer[16 * 1024] = {};
+
+	OVERLAPPED overlapped = {};
+	overlapped.hEvent = CreateEvent(nullptr, true, false, nullptr);
+
+	HANDLE events[] = { mImpl->stopEvent, overlapped.hEvent };
+
+	while (true)
+	{
+		ResetEvent(overlapped.hEvent);
+
+		BOOL issued = ReadDirectoryChangesW(mImpl->directoryHandle,
+			buffer,
+			sizeof(buffer),
+			true,
+			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+			nullptr,
+			&overlapped,
+			nullptr);
+
+		if (!issued)
+		{
+			break;
+		}
+
+		DWORD signaled = WaitForMultipleObjects(_countof(events), events, false, INFINITE);
+
+		if (signaled != WAIT_OBJECT_0 + 1)
+		{
+			// 停止要求
+			DWORD cancelled = 0;
+			CancelIo(mImpl->directoryHandle);
+			GetOverlappedResult(mImpl->directoryHandle, &overlapped, &cancelled, true);
+			break;
+		}
+
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(mImpl->directoryHandle, &overlapped, &bytes, false) || bytes == 0)
+		{
+			// バッファが溢れた場合は取りこぼすが、次の保存で拾える
+			continue;
+		}
+
+		const BYTE* cursor = buffer;
+		while (true)
+		{
+			auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+
+			if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+			{
+				int length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+				int size = WideCharToMultiByte(CP_ACP, 0, info->FileName, length, nullptr, 0, nullptr, nullptr);
+
+				std::string name(size, '\0');
+				WideCharToMultiByte(CP_ACP, 0, info->FileName, length, &name[0], size, nullptr, nullptr);
+
+				OnChanged(name);
+			}
+
+			if (info->NextEntryOffset == 0)
+			{
+				break;
+			}
+			cursor += info->NextEntryOffset;
+		}
+	}
+
+	CloseHandle(overlapped.hEvent);
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include "ShaderHotReload.h"
+
+#include <d3dcompiler.h>
+
+#include <algorithm>
+#include <filesystem>
+
+#include "../Dx12Wrapper/Dx12Wrapper.h"
+#include "../Profiler/CpuProfiler.h"
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+ShaderHotReload::~ShaderHotReload()
+{
+	Terminate();
+}
+
+bool ShaderHotReload::Init(Dx12Wrapper* dx, const std::string& shaderDirectory)
+{
+	mDX12Wrapper = dx;
+
+	if (!mWatcher.Start(shaderDirectory))
+	{
+		return false;
+	}
+
+	mQuit = false;
+	mWorker = std::thread(&ShaderHotReload::WorkerMain, this);
+
+	return true;
+}
+
+void ShaderHotReload::Terminate()
+{
+	mWatcher.Stop();
+
+	if (mWorker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+		mCondition.notify_all();
+		mWorker.join();
+	}
+
+	mJobs.clear();
+	mResults.clear();
+}
+
+void ShaderHotReload::Register(ComPtr<ID3D12PipelineState>* target, const ShaderProgramDesc& desc, PipelineBuilder builder)
+{
+	mIncludeGraph.AddRoot(desc.vsPath);
+	mIncludeGraph.AddRoot(desc.psPath);
+
+	auto program = std::make_unique<Program>();
+	program->target = target;
+	program->desc = desc;
+	program->builder = std::move(builder);
+
+	mPrograms.push_back(std::move(program));
+}
+
+void ShaderHotReload::Update()
+{
+	std::vector<std::string> changes;
+	mWatcher.PollChanges(changes);
+
+	std::vector<Result> results;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		for (const std::string& change : changes)
+		{
+			std::vector<std::string> roots = mIncludeGraph.AffectedRoots(change);
+
+			for (auto& program : mPrograms)
+			{
+				bool affected = std::any_of(roots.begin(), roots.end(), [&](const std::string& root)
+					{
+						return root == ShaderIncludeGraph::Normalize(program->desc.vsPath) || root == ShaderIncludeGraph::Normalize(program->desc.psPath);
+					});
+
+				if (affected && std::find(mJobs.begin(), mJobs.end(), program.get()) == mJobs.end())
+				{
+					mJobs.push_back(program.get());
+				}
+			}
+		}
+
+		results.swap(mResults);
+	}
+
+	if (!changes.empty())
+	{
+		mCondition.notify_one();
+	}
+
+	// フレームの境目なので、ここで差し替えれば1フレーム内でPSOが混ざらない
+	for (Result& result : results)
+	{
+		ComPtr<ID3D12PipelineState>& target = *result.program->target;
+
+		// 前のフレームがまだ使っているかもしれないので解放は遅らせる
+		mDX12Wrapper->DeferredRelease(target);
+		target = result.pipelineState;
+
+		// インクルードが増減しているかもしれない
+		mIncludeGraph.Rescan(result.program->desc.vsPath);
+		mIncludeGraph.Rescan(result.program->desc.psPath);
+
+		OutputDebugStringA(("シェーダーを再読み込みしました: " + result.program->desc.psPath + "\n").c_str());
+	}
+}
+
+bool ShaderHotReload::Compile(const std::string& path, const std::string& entry, const char* target, ComPtr<ID3DBlob>& blob)
+{
+	ComPtr<ID3DBlob> errorBlob = nullptr;
+
+	auto result = D3DCompileFromFile(std::filesystem::path(path).wstring().c_str(),
+		nullptr,
+		D3D_COMPILE_STANDARD_FILE_INCLUDE,
+		entry.c_str(),
+		target,
+		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
+		0,
+		blob.ReleaseAndGetAddressOf(),
+		errorBlob.ReleaseAndGetAddressOf());
+
+	if (FAILED(result))
+	{
+		if (errorBlob != nullptr || result == HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND))
+		{
+			Dx12Wrapper::ShowErrorMessage(result, errorBlob.Get());
+		}
+		else
+		{
+			// 保存途中でファイルが開けなかった場合など
+			OutputDebugStringA(("シェーダーのコンパイル失敗: " + path + "\n").c_str());
+		}
+		return false;
+	}
+
+	return true;
+}
+
+void ShaderHotReload::WorkerMain()
+{
+	CpuProfiler::Instance().SetThreadName("ShaderHotReload");
+
+	while (true)
+	{
+		std::vector<Program*> jobs;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return mQuit || !mJobs.empty(); });
+
+			if (mQuit)
+			{
+				return;
+			}
+
+			jobs.swap(mJobs);
+		}
+
+		for (Program* program : jobs)
+		{
+			PROFILE_SCOPE("ShaderHotReload::Rebuild");
+
+			ComPtr<ID3DBlob> vsBlob = nullptr;
+			ComPtr<ID3DBlob> psBlob = nullptr;
+
+			// 失敗した場合は今のPSOを使い続ける
+			if (!Compile(program->desc.vsPath, program->desc.vsEntry, "vs_5_0", vsBlob))
+			{
+				continue;
+			}
+
+			if (!Compile(program->desc.psPath, program->desc.psEntry, "ps_5_0", psBlob))
+			{
+				continue;
+			}
+
+			ComPtr<ID3D12PipelineState> pipelineState = nullptr;
+			if (!program->builder(vsBlob.Get(), psBlob.Get(), pipelineState))
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mResults.push_back({ program, pipelineState });
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "ShaderIncludeGraph.h"
+
+class Dx12Wrapper;
+
+// パイプラインを作るシェーダーの組
+struct ShaderProgramDesc
+{
+	std::string vsPath;
+	std::string vsEntry;
+	std::string psPath;
+	std::string psEntry;
+};
+
+// シェーダーファイルの変更を監視し、別スレッドで作り直したPSOをフレームの境目で差し替える
+class ShaderHotReload
+{
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public:
+
+	// 作り直しに使う。ワーカースレッドから呼ばれる
+	using PipelineBuilder = std::function<bool(ID3DBlob* vsBlob, ID3DBlob* psBlob, ComPtr<ID3D12PipelineState>& pipelineState)>;
+
+	ShaderHotReload() = default;
+	~ShaderHotReload();
+
+	bool Init(Dx12Wrapper* dx, const std::string& shaderDirectory);
+	void Terminate();
+
+	// targetは差し替え先。ShaderHotReloadより長く生きていること
+	void Register(ComPtr<ID3D12PipelineState>* target, const ShaderProgramDesc& desc, PipelineBuilder builder);
+
+	// フレームの先頭(コマンドを積む前)に呼ぶ
+	void Update();
+
+	// デバイスを使わないので、Dx12Wrapperを作る前でもどのスレッドからでも呼べる
+	static bool Compile(const std::string& path, const std::string& entry, const char* target, ComPtr<ID3DBlob>& blob);
+
+private:
+
+	struct Program
+	{
+		ComPtr<ID3D12PipelineState>* target;
+		ShaderProgramDesc desc;
+		PipelineBuilder builder;
+	};
+
+	struct Result
+	{
+		Program* program;
+		ComPtr<ID3D12PipelineState> pipelineState;
+	};
+
+	void WorkerMain();
+
+	Dx12Wrapper* mDX12Wrapper = nullptr;
+
+	FileWatcher mWatcher;
+	ShaderIncludeGraph mIncludeGraph;
+
+	std::vector<std::unique_ptr<Program>> mPrograms;
+
+	std::thread mWorker;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::vector<Program*> mJobs;
+	std::vector<Result> mResults;
+	bool mQuit = false;
+};
@@ -0,0 +1,114 @@
+#include "ShaderIncludeGraph.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+std::string ShaderIncludeGraph::Normalize(const std::string& path)
+{
+	std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+
+	// Windowsのパスは大文字小文字を区別しない
+	std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	return normalized;
+}
+
+std::vector<std::string> ShaderIncludeGraph::ParseIncludes(const std::string& path)
+{
+	std::vector<std::string> includes;
+
+	std::ifstream file(path);
+	if (!file)
+	{
+		return includes;
+	}
+
+	std::filesystem::path directory = std::filesystem::path(path).parent_path();
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line[pos] != '#')
+		{
+			continue;
+		}
+
+		pos = line.find_first_not_of(" \t", pos + 1);
+		if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+		{
+			continue;
+		}
+
+		size_t open = line.find_first_of("\"<", pos + 7);
+		if (open == std::string::npos)
+		{
+			continue;
+		}
+
+		size_t close = line.find_first_of("\">", open + 1);
+		if (close == std::string::npos)
+		{
+			continue;
+		}
+
+		// D3D_COMPILE_STANDARD_FILE_INCLUDEと同じく、インクルード元のフォルダから探す
+		std::string name = line.substr(open + 1, close - open - 1);
+		includes.push_back((directory / name).generic_string());
+	}
+
+	return includes;
+}
+
+void ShaderIncludeGraph::AddRoot(const std::string& rootPath)
+{
+	Rescan(rootPath);
+}
+
+void ShaderIncludeGraph::Rescan(const std::string& rootPath)
+{
+	std::set<std::string>& dependencies = mDependencies[Normalize(rootPath)];
+	dependencies.clear();
+
+	// 循環インクルードは訪問済みで止まる
+	std::vector<std::string> pending = { rootPath };
+
+	while (!pending.empty())
+	{
+		std::string path = pending.back();
+		pending.pop_back();
+
+		if (!dependencies.insert(Normalize(path)).second)
+		{
+			continue;
+		}
+
+		for (const std::string& include : ParseIncludes(path))
+		{
+			pending.push_back(include);
+		}
+	}
+}
+
+std::vector<std::string> ShaderIncludeGraph::AffectedRoots(const std::string& changedPath) const
+{
+	std::vector<std::string> roots;
+	std::string changed = Normalize(changedPath);
+
+	for (const auto& entry : mDependencies)
+	{
+		if (entry.second.count(changed) > 0)
+		{
+			roots.push_back(entry.first);
+		}
+	}
+
+	return roots;
+}
+
+bool ShaderIncludeGraph::IsTracked(const std::string& path) const
+{
+	return !AffectedRoots(path).empty();
+}
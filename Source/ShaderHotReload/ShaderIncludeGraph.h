@@ -0,0 +1,37 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// シェーダーの#includeを辿り、どのファイルが変わったらどのシェーダーを作り直すかを引く
+class ShaderIncludeGraph
+{
+public:
+
+	ShaderIncludeGraph() = default;
+	~ShaderIncludeGraph() = default;
+
+	// 区切りを'/'に、大文字を小文字に揃えた比較用のパス
+	static std::string Normalize(const std::string& path);
+
+	// ファイル中の #include "..." を、そのファイルからの相対パスとして解決して返す
+	static std::vector<std::string> ParseIncludes(const std::string& path);
+
+	// エントリポイントを持つファイルを登録し、間接的なインクルードまで辿る
+	void AddRoot(const std::string& rootPath);
+
+	// インクルードが増減した可能性があるので、rootの依存を取り直す
+	void Rescan(const std::string& rootPath);
+
+	// changedPathに(間接的に)依存しているルートを返す
+	std::vector<std::string> AffectedRoots(const std::string& changedPath) const;
+
+	bool IsTracked(const std::string& path) const;
+
+private:
+
+	// ルート(正規化済み) -> ルート自身を含む依存ファイル全て
+	std::map<std::string, std::set<std::string>> mDependencies;
+};
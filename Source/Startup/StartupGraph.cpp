@@ -0,0 +1,344 @@
+#include "StartupGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <thread>
+
+#include "../Profiler/CpuProfiler.h"
+
+namespace
+{
+	// Reportの時間軸の幅(文字数)
+	const int TimelineWidth = 40;
+}
+
+StartupGraph::TaskId StartupGraph::Add(const char* name, TaskFunction function, std::initializer_list<TaskId> dependencies, TaskThread thread)
+{
+	TaskId id = static_cast<TaskId>(mTasks.size());
+
+	Task task;
+	task.name = name;
+	task.function = std::move(function);
+	task.thread = thread;
+
+	for (TaskId dependency : dependencies)
+	{
+		if (dependency >= id)
+		{
+			assert(false && "依存先は先に追加すること");
+			continue;
+		}
+
+		task.dependencies.push_back(dependency);
+		mTasks[dependency].dependents.push_back(id);
+	}
+
+	task.remaining = static_cast<uint32_t>(task.dependencies.size());
+
+	mTasks.push_back(std::move(task));
+
+	return id;
+}
+
+bool StartupGraph::Run(uint32_t workerCount)
+{
+	mReady.clear();
+	mRunning = 0;
+	mCompleted = 0;
+	mMainRemaining = 0;
+	mFailed = false;
+	mThreadCount = workerCount + 1;
+
+	for (TaskId id = 0; id < mTasks.size(); ++id)
+	{
+		Task& task = mTasks[id];
+		task.state = TaskState::Pending;
+		task.remaining = static_cast<uint32_t>(task.dependencies.size());
+
+		if (task.thread == TaskThread::Main)
+		{
+			++mMainRemaining;
+		}
+
+		if (task.remaining == 0)
+		{
+			mReady.push_back(id);
+		}
+	}
+
+	mBeginNs = CpuProfiler::NowNs();
+
+	std::vector<std::thread> workers;
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(&StartupGraph::WorkerLoop, this, i + 1);
+	}
+
+	WorkerLoop(0);
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	mEndNs = CpuProfiler::NowNs();
+
+	return !mFailed && mCompleted == mTasks.size();
+}
+
+void StartupGraph::WorkerLoop(uint32_t threadIndex)
+{
+	if (threadIndex > 0)
+	{
+		char name[32] = {};
+		snprintf(name, sizeof(name), "Startup %u", threadIndex);
+		CpuProfiler::Instance().SetThreadName(name);
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while (true)
+	{
+		TaskId id = 0;
+		bool taken = false;
+
+		mCondition.wait(lock, [&]
+			{
+				taken = TakeReady(threadIndex, id);
+				return taken || IsFinished();
+			});
+
+		if (!taken)
+		{
+			return;
+		}
+
+		Task& task = mTasks[id];
+		++mRunning;
+
+		lock.unlock();
+
+		task.threadIndex = threadIndex;
+		task.beginNs = CpuProfiler::NowNs();
+
+		bool succeeded = task.function ? task.function() : true;
+
+		task.endNs = CpuProfiler::NowNs();
+
+		// トレースにも起動時のタスクとして残す
+		CpuProfiler::Instance().Record(task.name, task.beginNs, task.endNs, 0);
+
+		lock.lock();
+
+		--mRunning;
+		++mCompleted;
+		task.state = succeeded ? TaskState::Done : TaskState::Failed;
+
+		if (task.thread == TaskThread::Main)
+		{
+			--mMainRemaining;
+		}
+
+		if (!succeeded)
+		{
+			mFailed = true;
+		}
+		else
+		{
+			for (TaskId dependent : task.dependents)
+			{
+				if (--mTasks[dependent].remaining == 0)
+				{
+					mReady.push_back(dependent);
+				}
+			}
+		}
+
+		mCondition.notify_all();
+	}
+}
+
+bool StartupGraph::TakeReady(uint32_t threadIndex, TaskId& id)
+{
+	if (mFailed)
+	{
+		return false;
+	}
+
+	auto it = mReady.end();
+
+	if (threadIndex == 0)
+	{
+		it = std::find_if(mReady.begin(), mReady.end(), [this](TaskId ready) { return mTasks[ready].thread == TaskThread::Main; });
+
+		// Mainのタスクがまだ残っている間は、長いAnyのタスクでそれを遅らせないよう
+		// ワーカーに任せる。ワーカーが居なければ全部ここで実行する
+		if (it == mReady.end() && mMainRemaining > 0 && mThreadCount > 1)
+		{
+			return false;
+		}
+	}
+
+	if (it == mReady.end())
+	{
+		it = std::find_if(mReady.begin(), mReady.end(), [this](TaskId ready) { return mTasks[ready].thread == TaskThread::Any; });
+	}
+
+	if (it == mReady.end())
+	{
+		return false;
+	}
+
+	id = *it;
+	mReady.erase(it);
+
+	return true;
+}
+
+bool StartupGraph::IsFinished() const
+{
+	// 失敗した時は実行中の物が終わるまで待つ
+	return mCompleted == mTasks.size() || (mFailed && mRunning == 0);
+}
+
+std::vector<StartupGraph::TaskId> StartupGraph::CriticalPath() const
+{
+	std::vector<TaskId> path;
+
+	auto lastEnd = [this](TaskId a, TaskId b) { return mTasks[a].endNs < mTasks[b].endNs; };
+
+	std::vector<TaskId> finished;
+	for (TaskId id = 0; id < mTasks.size(); ++id)
+	{
+		if (mTasks[id].state != TaskState::Pending)
+		{
+			finished.push_back(id);
+		}
+	}
+
+	if (finished.empty())
+	{
+		return path;
+	}
+
+	TaskId current = *std::max_element(finished.begin(), finished.end(), lastEnd);
+
+	while (true)
+	{
+		path.push_back(current);
+
+		const Task& task = mTasks[current];
+		if (task.dependencies.empty())
+		{
+			break;
+		}
+
+		// 最後に終わった依存先が、このタスクの開始を決めていた
+		current = *std::max_element(task.dependencies.begin(), task.dependencies.end(), lastEnd);
+	}
+
+	std::reverse(path.begin(), path.end());
+
+	return path;
+}
+
+double StartupGraph::TaskTotalMs() const
+{
+	int64_t totalNs = 0;
+
+	for (const Task& task : mTasks)
+	{
+		if (task.state != TaskState::Pending)
+		{
+			totalNs += task.endNs - task.beginNs;
+		}
+	}
+
+	return totalNs / 1.0e6;
+}
+
+std::string StartupGraph::Report() const
+{
+	std::string report;
+	char buf[256] = {};
+
+	double wallMs = WallMs();
+	double totalMs = TaskTotalMs();
+
+	snprintf(buf, sizeof(buf), "startup %.1f ms (tasks %.1f ms, %.2fx, %u threads)%s\n",
+		wallMs, totalMs, wallMs > 0.0 ? totalMs / wallMs : 0.0, mThreadCount, mFailed ? " FAILED" : "");
+	report += buf;
+
+	std::vector<TaskId> path = CriticalPath();
+
+	std::vector<TaskId> order;
+	for (TaskId id = 0; id < mTasks.size(); ++id)
+	{
+		order.push_back(id);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [this](TaskId a, TaskId b)
+		{
+			bool startedA = mTasks[a].state != TaskState::Pending;
+			bool startedB = mTasks[b].state != TaskState::Pending;
+			return startedA != startedB ? startedA : mTasks[a].beginNs < mTasks[b].beginNs;
+		});
+
+	report += "     begin     time  thread  task\n";
+
+	const int64_t wallNs = std::max<int64_t>(mEndNs - mBeginNs, 1);
+
+	for (TaskId id : order)
+	{
+		const Task& task = mTasks[id];
+
+		if (task.state == TaskState::Pending)
+		{
+			snprintf(buf, sizeof(buf), "         -        -  -       %s (not run)\n", task.name);
+			report += buf;
+			continue;
+		}
+
+		// 起動全体を横幅に縮めた中で、このタスクが動いていた範囲
+		char timeline[TimelineWidth + 1] = {};
+		int first = static_cast<int>((task.beginNs - mBeginNs) * TimelineWidth / wallNs);
+		int last = static_cast<int>((task.endNs - mBeginNs) * TimelineWidth / wallNs);
+		for (int i = 0; i < TimelineWidth; ++i)
+		{
+			timeline[i] = (i >= first && i <= std::max(first, last - 1)) ? '#' : ' ';
+		}
+
+		bool critical = std::find(path.begin(), path.end(), id) != path.end();
+
+		char thread[16] = {};
+		if (task.threadIndex == 0)
+		{
+			snprintf(thread, sizeof(thread), "main");
+		}
+		else
+		{
+			snprintf(thread, sizeof(thread), "%u", task.threadIndex);
+		}
+
+		snprintf(buf, sizeof(buf), "%s %8.1f %8.1f  %-6s  %-32s |%s|%s\n",
+			critical ? "*" : " ",
+			(task.beginNs - mBeginNs) / 1.0e6,
+			(task.endNs - task.beginNs) / 1.0e6,
+			thread,
+			task.name,
+			timeline,
+			task.state == TaskState::Failed ? " FAILED" : "");
+		report += buf;
+	}
+
+	report += "critical path:";
+	for (size_t i = 0; i < path.size(); ++i)
+	{
+		report += i == 0 ? " " : " -> ";
+		report += mTasks[path[i]].name;
+	}
+	report += "\n";
+
+	return report;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 起動時の処理を依存関係付きのタスクとして並列に実行し、各タスクの時間と
+// 起動全体を律速したタスクの列(クリティカルパス)を報告する
+class StartupGraph
+{
+public:
+
+	using TaskId = uint32_t;
+	using TaskFunction = std::function<bool()>;
+
+	enum class TaskThread
+	{
+		Any,	// どのスレッドで実行してもよい
+		Main,	// Runを呼んだスレッドで実行する(ウィンドウに関わる物等)
+	};
+
+	StartupGraph() = default;
+	~StartupGraph() = default;
+
+	StartupGraph(const StartupGraph&) = delete;
+	StartupGraph& operator=(const StartupGraph&) = delete;
+
+	// 依存先は先に追加したタスクに限るので、循環はできない
+	// nameはトレースにも残すので、PROFILE_SCOPEと同じく文字列リテラルを渡す
+	TaskId Add(const char* name, TaskFunction function, std::initializer_list<TaskId> dependencies = {}, TaskThread thread = TaskThread::Any);
+
+	// 呼び出し元とworkerCount個のスレッドで実行する。全て成功すればtrue
+	// 失敗したら新しいタスクは始めず、実行中の物が終わるのを待って戻る
+	bool Run(uint32_t workerCount);
+
+	// 最後に終わったタスクから、それを待たせていた依存先を辿った列(先頭が最初)
+	std::vector<TaskId> CriticalPath() const;
+
+	// タスク毎の開始・所要時間とクリティカルパスの一覧
+	std::string Report() const;
+
+	double WallMs() const { return (mEndNs - mBeginNs) / 1.0e6; }
+
+	// 全タスクの所要時間の合計(直列に実行した場合の目安)
+	double TaskTotalMs() const;
+
+private:
+
+	enum class TaskState
+	{
+		Pending,
+		Done,
+		Failed,
+	};
+
+	struct Task
+	{
+		const char* name = "";
+		TaskFunction function;
+		TaskThread thread = TaskThread::Any;
+
+		std::vector<TaskId> dependencies;
+		std::vector<TaskId> dependents;
+		uint32_t remaining = 0;
+
+		TaskState state = TaskState::Pending;
+		int64_t beginNs = 0;
+		int64_t endNs = 0;
+		uint32_t threadIndex = 0;
+	};
+
+	// threadIndexが0なら呼び出し元のスレッド
+	void WorkerLoop(uint32_t threadIndex);
+
+	// 実行できるタスクを取り出す。無ければfalse
+	// 呼び出し元のスレッドは、Mainのタスクが残っている間はそれだけを待つ
+	bool TakeReady(uint32_t threadIndex, TaskId& id);
+
+	bool IsFinished() const;
+
+	std::vector<Task> mTasks;
+
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<TaskId> mReady;
+	uint32_t mRunning = 0;
+	uint32_t mCompleted = 0;
+	uint32_t mMainRemaining = 0;
+	uint32_t mThreadCount = 0;
+	bool mFailed = false;
+
+	int64_t mBeginNs = 0;
+	int64_t mEndNs = 0;
+};
@@ -0,0 +1,269 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const uint32_t ChannelCount = 4;
+
+	// 1軸分の縮小の重み。出力の1画素が、元のどの画素からどれだけの重みで作られるか
+	struct FilterTaps
+	{
+		uint32_t first = 0;
+		uint32_t count = 0;
+		float weight[4] = {};
+	};
+
+	// 出力の画素xは元の[x * scale, (x + 1) * scale)を覆う箱フィルタ
+	// 偶数なら2画素の平均、奇数なら3画素に端を半端な重みで掛ける
+	void BuildTaps(uint32_t srcSize, uint32_t dstSize, std::vector<FilterTaps>& taps)
+	{
+		taps.assign(dstSize, FilterTaps());
+
+		const double scale = static_cast<double>(srcSize) / dstSize;
+
+		for (uint32_t x = 0; x < dstSize; ++x)
+		{
+			double begin = x * scale;
+			double end = (x + 1) * scale;
+
+			FilterTaps& tap = taps[x];
+			tap.first = static_cast<uint32_t>(begin);
+
+			uint32_t last = std::min(static_cast<uint32_t>(std::ceil(end)) - 1, srcSize - 1);
+
+			for (uint32_t i = tap.first; i <= last && tap.count < 4; ++i)
+			{
+				double overlap = std::min(end, i + 1.0) - std::max(begin, static_cast<double>(i));
+				tap.weight[tap.count++] = static_cast<float>(overlap / scale);
+			}
+		}
+	}
+
+	double DecodeSrgb(double value)
+	{
+		return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+	}
+
+	// 8ビットのsRGB値からリニア値への表
+	const std::array<float, 256>& SrgbDecodeTable()
+	{
+		static const std::array<float, 256> table = []
+		{
+			std::array<float, 256> t = {};
+			for (int i = 0; i < 256; ++i)
+			{
+				t[i] = static_cast<float>(DecodeSrgb(i / 255.0));
+			}
+			return t;
+		}();
+
+		return table;
+	}
+
+	// リニア値をsRGBに戻す時の境目。i番目はsRGBでi+0.5にあたるリニア値
+	// 二分探索すれば、powを使わずに最も近いsRGB値が求まる
+	const std::array<float, 255>& SrgbEncodeThresholds()
+	{
+		static const std::array<float, 255> table = []
+		{
+			std::array<float, 255> t = {};
+			for (int i = 0; i < 255; ++i)
+			{
+				t[i] = static_cast<float>(DecodeSrgb((i + 0.5) / 255.0));
+			}
+			return t;
+		}();
+
+		return table;
+	}
+
+	// 粗い表で当たりを付けてから境目を数個進める
+	const uint32_t EncodeBuckets = 4096;
+
+	const std::array<uint8_t, EncodeBuckets + 1>& SrgbEncodeStart()
+	{
+		static const std::array<uint8_t, EncodeBuckets + 1> table = []
+		{
+			const std::array<float, 255>& thresholds = SrgbEncodeThresholds();
+
+			std::array<uint8_t, EncodeBuckets + 1> t = {};
+			for (uint32_t i = 0; i <= EncodeBuckets; ++i)
+			{
+				float value = static_cast<float>(i) / EncodeBuckets;
+				t[i] = static_cast<uint8_t>(std::upper_bound(thresholds.begin(), thresholds.end(), value) - thresholds.begin());
+			}
+			return t;
+		}();
+
+		return table;
+	}
+
+	inline uint8_t EncodeSrgb(float value, const uint8_t* start, const float* thresholds)
+	{
+		float clamped = std::clamp(value, 0.0F, 1.0F);
+		uint32_t code = start[static_cast<uint32_t>(clamped * EncodeBuckets)];
+
+		while (code < 255 && clamped >= thresholds[code])
+		{
+			++code;
+		}
+
+		return static_cast<uint8_t>(code);
+	}
+
+	inline uint8_t ToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value * 255.0F + 0.5F, 0.0F, 255.0F));
+	}
+}
+
+uint32_t MipGenerator::MipCount(uint32_t width, uint32_t height)
+{
+	uint32_t count = 1;
+
+	while (width > 1 || height > 1)
+	{
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+		++count;
+	}
+
+	return count;
+}
+
+bool MipGenerator::Generate(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height, MipColorSpace colorSpace, std::vector<MipLevel>& levels, uint32_t maxLevels)
+{
+	levels.clear();
+
+	if (pixels == nullptr || width == 0 || height == 0 || rowPitch < static_cast<size_t>(width) * ChannelCount)
+	{
+		return false;
+	}
+
+	uint32_t count = MipCount(width, height);
+	if (maxLevels > 0)
+	{
+		count = std::min(count, maxLevels);
+	}
+
+	levels.resize(count);
+
+	MipLevel& top = levels[0];
+	top.width = width;
+	top.height = height;
+	top.pixels.resize(static_cast<size_t>(width) * height * ChannelCount);
+
+	const size_t packedPitch = static_cast<size_t>(width) * ChannelCount;
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		std::memcpy(top.pixels.data() + packedPitch * y, pixels + rowPitch * y, packedPitch);
+	}
+
+	for (uint32_t i = 1; i < count; ++i)
+	{
+		Downsample(levels[i - 1], colorSpace, levels[i]);
+	}
+
+	return true;
+}
+
+void MipGenerator::Downsample(const MipLevel& src, MipColorSpace colorSpace, MipLevel& dst)
+{
+	dst.width = std::max(src.width / 2, 1u);
+	dst.height = std::max(src.height / 2, 1u);
+	dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * ChannelCount);
+
+	std::vector<FilterTaps> tapsX;
+	std::vector<FilterTaps> tapsY;
+	BuildTaps(src.width, dst.width, tapsX);
+	BuildTaps(src.height, dst.height, tapsY);
+
+	const bool srgb = colorSpace == MipColorSpace::Srgb;
+	const float* srgbTable = SrgbDecodeTable().data();
+	const uint8_t* encodeStart = SrgbEncodeStart().data();
+	const float* encodeThresholds = SrgbEncodeThresholds().data();
+
+	const size_t srcFloats = static_cast<size_t>(src.width) * ChannelCount;
+	const size_t dstFloats = static_cast<size_t>(dst.width) * ChannelCount;
+
+	// 元の1行をリニアに戻した物、それを横に縮めた物、縦に足し合わせた物
+	// 出力1行に要る元の行(2～3行)だけを扱うので、作業領域は幅に比例する分で済む
+	std::vector<float> linearRow(srcFloats);
+	std::vector<float> filteredRow(dstFloats);
+	std::vector<float> column(dstFloats);
+
+	for (uint32_t y = 0; y < dst.height; ++y)
+	{
+		const FilterTaps& tapY = tapsY[y];
+
+		std::fill(column.begin(), column.end(), 0.0F);
+
+		for (uint32_t ty = 0; ty < tapY.count; ++ty)
+		{
+			const uint8_t* srcRow = src.pixels.data() + srcFloats * (tapY.first + ty);
+
+			// アルファは常にそのまま
+			for (size_t i = 0; i < srcFloats; i += ChannelCount)
+			{
+				for (uint32_t c = 0; c < 3; ++c)
+				{
+					linearRow[i + c] = srgb ? srgbTable[srcRow[i + c]] : srcRow[i + c] * (1.0F / 255.0F);
+				}
+
+				linearRow[i + 3] = srcRow[i + 3] * (1.0F / 255.0F);
+			}
+
+			for (uint32_t x = 0; x < dst.width; ++x)
+			{
+				const FilterTaps& tapX = tapsX[x];
+				const float* in = linearRow.data() + static_cast<size_t>(tapX.first) * ChannelCount;
+
+				float sum[ChannelCount] = {};
+				for (uint32_t tx = 0; tx < tapX.count; ++tx)
+				{
+					for (uint32_t c = 0; c < ChannelCount; ++c)
+					{
+						sum[c] += in[tx * ChannelCount + c] * tapX.weight[tx];
+					}
+				}
+
+				for (uint32_t c = 0; c < ChannelCount; ++c)
+				{
+					filteredRow[x * ChannelCount + c] = sum[c];
+				}
+			}
+
+			const float weight = tapY.weight[ty];
+			for (size_t i = 0; i < dstFloats; ++i)
+			{
+				column[i] += filteredRow[i] * weight;
+			}
+		}
+
+		uint8_t* dstRow = dst.pixels.data() + dstFloats * y;
+
+		for (size_t i = 0; i < dstFloats; i += ChannelCount)
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				dstRow[i + c] = srgb ? EncodeSrgb(column[i + c], encodeStart, encodeThresholds) : ToUnorm8(column[i + c]);
+			}
+
+			dstRow[i + 3] = ToUnorm8(column[i + 3]);
+		}
+	}
+}
+
+float MipGenerator::SrgbToLinear(uint8_t value)
+{
+	return SrgbDecodeTable()[value];
+}
+
+uint8_t MipGenerator::LinearToSrgb(float value)
+{
+	return EncodeSrgb(value, SrgbEncodeStart().data(), SrgbEncodeThresholds().data());
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 色の値をどの空間で平均するか
+enum class MipColorSpace
+{
+	Linear,		// 法線やマスク等、値をそのまま平均する
+	Srgb,		// カラーテクスチャ。リニアに戻してから平均し、sRGBに戻す
+};
+
+// RGBA8のミップ1段分(行は詰めてある)
+struct MipLevel
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+// 読み込み時にRGBA8(BGRA8)のミップチェーンをCPUで作る
+// 奇数の大きさでも、縮小前の範囲を覆う重みで平均するので半画素ずれない
+class MipGenerator
+{
+public:
+
+	// 1x1までの段数
+	static uint32_t MipCount(uint32_t width, uint32_t height);
+
+	// levels[0]に元画像の複製、以降に1/2ずつ縮小した画像を入れる
+	// maxLevelsが0なら1x1まで作る
+	static bool Generate(const uint8_t* pixels, size_t rowPitch, uint32_t width, uint32_t height, MipColorSpace colorSpace, std::vector<MipLevel>& levels, uint32_t maxLevels = 0);
+
+	// srcを縦横1/2(切り捨て、最小1)にする
+	static void Downsample(const MipLevel& src, MipColorSpace colorSpace, MipLevel& dst);
+
+	static float SrgbToLinear(uint8_t value);
+	static uint8_t LinearToSrgb(float value);
+};
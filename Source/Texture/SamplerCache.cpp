@@ -0,0 +1,94 @@
+#include "SamplerCache.h"
+
+#include <algorithm>
+#include <cassert>
+
+bool SamplerCache::Init(ID3D12Device* device, UINT capacity)
+{
+	mDevice = device;
+	mCapacity = capacity;
+	mSettings.clear();
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+	heapDesc.NumDescriptors = capacity;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	heapDesc.NodeMask = 0;
+
+	auto result = device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(mHeap.ReleaseAndGetAddressOf()));
+
+	if (FAILED(result))
+	{
+		assert(false && "サンプラーヒープ作成失敗");
+		return false;
+	}
+
+	mDescriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+
+	return true;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE SamplerCache::Get(const SamplerSettings& settings)
+{
+	D3D12_GPU_DESCRIPTOR_HANDLE handle = {};
+
+	if (mHeap == nullptr)
+	{
+		return handle;
+	}
+
+	// 設定の種類は少ないので線形探索で足りる
+	auto it = std::find(mSettings.begin(), mSettings.end(), settings);
+	UINT index = static_cast<UINT>(it - mSettings.begin());
+
+	if (it == mSettings.end())
+	{
+		if (index >= mCapacity)
+		{
+			assert(false && "サンプラーヒープが足りない");
+			return handle;
+		}
+
+		D3D12_SAMPLER_DESC desc = MakeDesc(settings);
+
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = mHeap->GetCPUDescriptorHandleForHeapStart();
+		cpuHandle.ptr += static_cast<SIZE_T>(mDescriptorSize) * index;
+
+		mDevice->CreateSampler(&desc, cpuHandle);
+		mSettings.push_back(settings);
+	}
+
+	handle = mHeap->GetGPUDescriptorHandleForHeapStart();
+	handle.ptr += static_cast<UINT64>(mDescriptorSize) * index;
+
+	return handle;
+}
+
+D3D12_SAMPLER_DESC SamplerCache::MakeDesc(const SamplerSettings& settings)
+{
+	D3D12_SAMPLER_DESC desc = {};
+
+	switch (settings.filter)
+	{
+	case TextureFilter::Point:
+		desc.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+		break;
+	case TextureFilter::Linear:
+		desc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+		break;
+	case TextureFilter::Anisotropic:
+		desc.Filter = D3D12_FILTER_ANISOTROPIC;
+		break;
+	}
+
+	desc.AddressU = settings.addressU;
+	desc.AddressV = settings.addressV;
+	desc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	desc.MipLODBias = settings.mipLodBias;
+	desc.MaxAnisotropy = settings.filter == TextureFilter::Anisotropic ? std::clamp(settings.maxAnisotropy, 1u, static_cast<UINT>(D3D12_MAX_MAXANISOTROPY)) : 1;
+	desc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	desc.MinLOD = 0.0F;
+	desc.MaxLOD = settings.maxLod;
+
+	return desc;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <vector>
+
+enum class TextureFilter
+{
+	Point,
+	Linear,
+	Anisotropic,
+};
+
+// マテリアル毎のサンプラー設定
+struct SamplerSettings
+{
+	TextureFilter filter = TextureFilter::Anisotropic;
+	UINT maxAnisotropy = 8;
+
+	D3D12_TEXTURE_ADDRESS_MODE addressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	D3D12_TEXTURE_ADDRESS_MODE addressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+
+	float mipLodBias = 0.0F;
+	float maxLod = D3D12_FLOAT32_MAX;
+
+	bool operator==(const SamplerSettings& other) const
+	{
+		return filter == other.filter && maxAnisotropy == other.maxAnisotropy && addressU == other.addressU && addressV == other.addressV && mipLodBias == other.mipLodBias && maxLod == other.maxLod;
+	}
+};
+
+// シェーダーから見えるサンプラーヒープに、設定毎のサンプラーを1つずつ作って使い回す
+// 同じ設定のマテリアルは同じディスクリプタを指すので、ドロー間でテーブルの再設定が省ける
+class SamplerCache
+{
+private:
+
+	template<typename T>
+	using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+public:
+
+	SamplerCache() = default;
+	~SamplerCache() = default;
+
+	bool Init(ID3D12Device* device, UINT capacity = 64);
+
+	// settingsのサンプラー1つだけのテーブル。作れなければptrが0
+	D3D12_GPU_DESCRIPTOR_HANDLE Get(const SamplerSettings& settings);
+
+	ID3D12DescriptorHeap* Heap() const { return mHeap.Get(); }
+	UINT Size() const { return static_cast<UINT>(mSettings.size()); }
+
+	static D3D12_SAMPLER_DESC MakeDesc(const SamplerSettings& settings);
+
+private:
+
+	ComPtr<ID3D12Device> mDevice = nullptr;
+	ComPtr<ID3D12DescriptorHeap> mHeap = nullptr;
+	UINT mDescriptorSize = 0;
+	UINT mCapacity = 0;
+
+	// ヒープ内の並びと同じ
+	std::vector<SamplerSettings> mSettings;
+};
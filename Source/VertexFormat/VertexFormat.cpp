@@ -0,0 +1,346 @@
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+	const float RadiansToDegrees = 57.2957795F;
+
+	float SignNotZero(float v)
+	{
+		return v >= 0.0F ? 1.0F : -1.0F;
+	}
+
+	int16_t ToSnorm16(float v)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(v, -1.0F, 1.0F) * 32767.0F));
+	}
+
+	template<typename Attrib>
+	Attrib MakeAttrib(const SkinVertex& vertex)
+	{
+		Attrib attrib = {};
+
+		VertexFormat::EncodeOct(vertex.normal, attrib.normalOct);
+		attrib.uvHalf[0] = VertexFormat::FloatToHalf(vertex.uv.x);
+		attrib.uvHalf[1] = VertexFormat::FloatToHalf(vertex.uv.y);
+		VertexFormat::EncodeWeights(vertex.boneWeight, attrib.boneWeight);
+
+		using BoneIndexType = std::remove_extent_t<decltype(Attrib::boneIndex)>;
+
+		for (int idx = 0; idx < 4; ++idx)
+		{
+			// PMXは未使用ボーンを-1にするので、ウェイト0のまま0番を指す
+			int32_t bone = std::max(vertex.boneIndex[idx], 0);
+			attrib.boneIndex[idx] = static_cast<BoneIndexType>(bone);
+		}
+
+		return attrib;
+	}
+
+	template<typename Attrib>
+	void WriteStreams(const std::vector<SkinVertex>& vertices, CompactSkinMesh& mesh)
+	{
+		const uint32_t posSize = sizeof(Float3);
+
+		if (mesh.splitStreams)
+		{
+			mesh.stride0 = posSize;
+			mesh.stride1 = sizeof(Attrib);
+		}
+		else
+		{
+			mesh.stride0 = posSize + sizeof(Attrib);
+			mesh.stride1 = 0;
+		}
+
+		mesh.stream0.resize(vertices.size() * mesh.stride0);
+		mesh.stream1.resize(vertices.size() * mesh.stride1);
+
+		for (size_t idx = 0; idx < vertices.size(); ++idx)
+		{
+			Attrib attrib = MakeAttrib<Attrib>(vertices[idx]);
+
+			uint8_t* pos = &mesh.stream0[idx * mesh.stride0];
+			std::memcpy(pos, &vertices[idx].pos, posSize);
+
+			uint8_t* dst = mesh.splitStreams ? &mesh.stream1[idx * mesh.stride1] : pos + posSize;
+			std::memcpy(dst, &attrib, sizeof(Attrib));
+		}
+	}
+
+	void MeasurePosition(const Float3& pos, const uint8_t* stored, VertexQuantizeReport& report)
+	{
+		Float3 decoded = {};
+		std::memcpy(&decoded, stored, sizeof(Float3));
+
+		float d = std::max({ std::fabs(decoded.x - pos.x), std::fabs(decoded.y - pos.y), std::fabs(decoded.z - pos.z) });
+		report.maxPositionError = std::max(report.maxPositionError, d);
+	}
+
+	void MeasureNormalAndUv(const Float3& normal, const Float2& uv, const int16_t normalOct[2], const uint16_t uvHalf[2], VertexQuantizeReport& report)
+	{
+		Float3 original = Math::Normalize(normal);
+		Float3 decoded = VertexFormat::DecodeOct(normalOct);
+		// acosは1付近で精度が落ちるので、外積の長さと内積から角度を求める
+		float angle = std::atan2(Math::Length(Math::Cross(original, decoded)), Math::Dot(original, decoded)) * RadiansToDegrees;
+		report.maxNormalErrorDeg = std::max(report.maxNormalErrorDeg, angle);
+
+		float du = std::fabs(VertexFormat::HalfToFloat(uvHalf[0]) - uv.x);
+		float dv = std::fabs(VertexFormat::HalfToFloat(uvHalf[1]) - uv.y);
+		report.maxUvError = std::max(report.maxUvError, std::max(du, dv));
+	}
+
+	template<typename Attrib>
+	void MeasureAttribs(const std::vector<SkinVertex>& vertices, const CompactSkinMesh& mesh, VertexQuantizeReport& report)
+	{
+		const uint32_t posSize = sizeof(Float3);
+
+		for (size_t idx = 0; idx < vertices.size(); ++idx)
+		{
+			const uint8_t* src = mesh.splitStreams ? &mesh.stream1[idx * mesh.stride1] : &mesh.stream0[idx * mesh.stride0] + posSize;
+
+			Attrib attrib = {};
+			std::memcpy(&attrib, src, sizeof(Attrib));
+
+			const SkinVertex& vertex = vertices[idx];
+
+			MeasurePosition(vertex.pos, &mesh.stream0[idx * mesh.stride0], report);
+			MeasureNormalAndUv(vertex.normal, vertex.uv, attrib.normalOct, attrib.uvHalf, report);
+
+			for (int w = 0; w < 4; ++w)
+			{
+				float dw = std::fabs(attrib.boneWeight[w] / 255.0F - vertex.boneWeight[w]);
+				report.maxWeightError = std::max(report.maxWeightError, dw);
+			}
+		}
+	}
+}
+
+CompactSkinMesh VertexFormat::Compress(const std::vector<SkinVertex>& vertices, bool splitStreams)
+{
+	CompactSkinMesh mesh = {};
+	mesh.splitStreams = splitStreams;
+
+	for (const SkinVertex& vertex : vertices)
+	{
+		for (int32_t bone : vertex.boneIndex)
+		{
+			if (bone > 0xFF)
+			{
+				mesh.boneIndex16 = true;
+			}
+		}
+	}
+
+	if (mesh.boneIndex16)
+	{
+		WriteStreams<CompactSkinAttrib16>(vertices, mesh);
+	}
+	else
+	{
+		WriteStreams<CompactSkinAttrib8>(vertices, mesh);
+	}
+
+	return mesh;
+}
+
+std::vector<CompactStaticVertex> VertexFormat::Compress(const StaticVertex* vertices, size_t count)
+{
+	std::vector<CompactStaticVertex> compact(count);
+
+	for (size_t idx = 0; idx < count; ++idx)
+	{
+		compact[idx].pos = vertices[idx].pos;
+		EncodeOct(vertices[idx].normal, compact[idx].normalOct);
+		compact[idx].uvHalf[0] = FloatToHalf(vertices[idx].uv.x);
+		compact[idx].uvHalf[1] = FloatToHalf(vertices[idx].uv.y);
+	}
+
+	return compact;
+}
+
+VertexQuantizeReport VertexFormat::Measure(const std::vector<SkinVertex>& vertices, const CompactSkinMesh& mesh)
+{
+	VertexQuantizeReport report = {};
+	report.sourceBytes = vertices.size() * sizeof(SkinVertex);
+	report.compactBytes = mesh.stream0.size() + mesh.stream1.size();
+
+	if (mesh.boneIndex16)
+	{
+		MeasureAttribs<CompactSkinAttrib16>(vertices, mesh, report);
+	}
+	else
+	{
+		MeasureAttribs<CompactSkinAttrib8>(vertices, mesh, report);
+	}
+
+	return report;
+}
+
+VertexQuantizeReport VertexFormat::Measure(const StaticVertex* vertices, const std::vector<CompactStaticVertex>& compact)
+{
+	VertexQuantizeReport report = {};
+	report.sourceBytes = compact.size() * sizeof(StaticVertex);
+	report.compactBytes = compact.size() * sizeof(CompactStaticVertex);
+
+	for (size_t idx = 0; idx < compact.size(); ++idx)
+	{
+		MeasurePosition(vertices[idx].pos, reinterpret_cast<const uint8_t*>(&compact[idx].pos), report);
+		MeasureNormalAndUv(vertices[idx].normal, vertices[idx].uv, compact[idx].normalOct, compact[idx].uvHalf, report);
+	}
+
+	return report;
+}
+
+void VertexFormat::EncodeOct(const Float3& normal, int16_t out[2])
+{
+	float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (l1 <= 0.0F)
+	{
+		out[0] = 0;
+		out[1] = 0;
+		return;
+	}
+
+	float x = normal.x / l1;
+	float y = normal.y / l1;
+
+	// 下半球は外側の三角形に折り返す
+	if (normal.z < 0.0F)
+	{
+		float foldX = (1.0F - std::fabs(y)) * SignNotZero(x);
+		float foldY = (1.0F - std::fabs(x)) * SignNotZero(y);
+		x = foldX;
+		y = foldY;
+	}
+
+	out[0] = ToSnorm16(x);
+	out[1] = ToSnorm16(y);
+}
+
+Float3 VertexFormat::DecodeOct(const int16_t in[2])
+{
+	// SkinShaderHeader.hlsliのDecodeOctと同じ計算
+	float x = std::max(in[0] / 32767.0F, -1.0F);
+	float y = std::max(in[1] / 32767.0F, -1.0F);
+	float z = 1.0F - std::fabs(x) - std::fabs(y);
+
+	if (z < 0.0F)
+	{
+		float foldX = (1.0F - std::fabs(y)) * SignNotZero(x);
+		float foldY = (1.0F - std::fabs(x)) * SignNotZero(y);
+		x = foldX;
+		y = foldY;
+	}
+
+	return Math::Normalize({ x, y, z });
+}
+
+void VertexFormat::EncodeWeights(const float weights[4], uint8_t out[4])
+{
+	float sum = weights[0] + weights[1] + weights[2] + weights[3];
+	float scale = sum > 0.0F ? 255.0F / sum : 0.0F;
+
+	int total = 0;
+	int largest = 0;
+
+	for (int idx = 0; idx < 4; ++idx)
+	{
+		int q = std::clamp(static_cast<int>(std::lround(weights[idx] * scale)), 0, 255);
+		out[idx] = static_cast<uint8_t>(q);
+		total += q;
+
+		if (weights[idx] > weights[largest])
+		{
+			largest = idx;
+		}
+	}
+
+	// 丸め誤差は最大ウェイトに寄せて合計を255に揃える
+	if (sum > 0.0F)
+	{
+		out[largest] = static_cast<uint8_t>(std::clamp(out[largest] + (255 - total), 0, 255));
+	}
+}
+
+uint16_t VertexFormat::FloatToHalf(float value)
+{
+	uint32_t bits = 0;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t floatExponent = (bits >> 23) & 0xFF;
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	// 無限大とNaN(NaNは仮数の最上位を立てて保つ)
+	if (floatExponent == 0xFF)
+	{
+		return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+	}
+
+	int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+
+	if (exponent >= 31)
+	{
+		return static_cast<uint16_t>(sign | 0x7C00);
+	}
+
+	uint32_t half = 0;
+	uint32_t remainder = 0;
+	uint32_t halfway = 0;
+
+	if (exponent <= 0)
+	{
+		// 非正規化数。暗黙の1を足してから右に寄せる
+		if (exponent < -10)
+		{
+			return static_cast<uint16_t>(sign);
+		}
+
+		mantissa |= 0x800000;
+		uint32_t shift = static_cast<uint32_t>(14 - exponent);
+		half = mantissa >> shift;
+		remainder = mantissa & ((1U << shift) - 1);
+		halfway = 1U << (shift - 1);
+	}
+	else
+	{
+		half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		remainder = mantissa & 0x1FFF;
+		halfway = 0x1000;
+	}
+
+	// 最近接偶数丸め。仮数からの繰り上がりはそのまま指数に入る
+	if (remainder > halfway || (remainder == halfway && (half & 1) != 0))
+	{
+		++half;
+	}
+
+	return static_cast<uint16_t>(sign | half);
+}
+
+float VertexFormat::HalfToFloat(uint16_t half)
+{
+	uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+
+	if (exponent == 0)
+	{
+		// 0と非正規化数(仮数×2^-24)
+		float value = std::ldexp(static_cast<float>(mantissa), -24);
+		return sign != 0 ? -value : value;
+	}
+
+	uint32_t bits = exponent == 31 ?
+		(sign | 0x7F800000 | (mantissa << 13)) :
+		(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+
+	float value = 0.0F;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Math/MathTypes.h"
+
+// 入力レイアウトだけがD3D12の型を使う(VertexFormatInputLayout.cpp)
+// 圧縮と復元はd3d12.hに依存させず、Linuxでも誤差を検証できるようにする
+struct D3D12_INPUT_ELEMENT_DESC;
+
+// PMXから読み込んだままの頂点(全てfloat/int32で約68バイト)
+struct SkinVertex
+{
+	Float3 pos;
+	Float3 normal;
+	Float2 uv;
+	int32_t boneIndex[4];
+	float boneWeight[4];
+	float edgeScale;
+};
+
+// スキニングしない頂点(ステージ等)の読み込んだままの形
+struct StaticVertex
+{
+	Float3 pos;
+	Float3 normal;
+	Float2 uv;
+};
+
+// スキニングしない頂点の圧縮形(32バイト→20バイト、BasicVertexShader.hlslの入力)
+struct CompactStaticVertex
+{
+	Float3 pos;
+	int16_t normalOct[2];  // 八面体エンコードした法線(SNORM16)
+	uint16_t uvHalf[2];    // 半精度UV
+};
+
+// 圧縮頂点の属性部分(ボーン番号8ビット版 16バイト)
+struct CompactSkinAttrib8
+{
+	int16_t normalOct[2];
+	uint16_t uvHalf[2];
+	uint8_t boneIndex[4];
+	uint8_t boneWeight[4]; // UNORM8、合計は必ず255
+};
+
+// 圧縮頂点の属性部分(ボーン番号16ビット版 20バイト)
+struct CompactSkinAttrib16
+{
+	int16_t normalOct[2];
+	uint16_t uvHalf[2];
+	uint16_t boneIndex[4];
+	uint8_t boneWeight[4];
+};
+
+static_assert(sizeof(CompactStaticVertex) == 20, "BasicVertexShader.hlslの入力と一致させる");
+static_assert(sizeof(CompactSkinAttrib8) == 16, "SkinShaderHeader.hlsliの入力と一致させる");
+static_assert(sizeof(CompactSkinAttrib16) == 20, "SkinShaderHeader.hlsliの入力と一致させる");
+
+// 圧縮済みの頂点データ
+struct CompactSkinMesh
+{
+	bool boneIndex16 = false;
+
+	// trueなら位置(スロット0)と属性(スロット1)を別ストリームにする
+	bool splitStreams = false;
+
+	// splitStreamsがfalseの時は全てstream0に交互に詰める
+	std::vector<uint8_t> stream0;
+	std::vector<uint8_t> stream1;
+	uint32_t stride0 = 0;
+	uint32_t stride1 = 0;
+};
+
+// 量子化による誤差とサイズ
+struct VertexQuantizeReport
+{
+	size_t sourceBytes = 0;
+	size_t compactBytes = 0;
+
+	// 位置は今のところ無圧縮なので0になる。圧縮する形に変えた時の確認用
+	float maxPositionError = 0.0F;
+	float maxNormalErrorDeg = 0.0F;
+	float maxUvError = 0.0F;
+	float maxWeightError = 0.0F;
+};
+
+class VertexFormat
+{
+public:
+
+	static CompactSkinMesh Compress(const std::vector<SkinVertex>& vertices, bool splitStreams);
+	static std::vector<CompactStaticVertex> Compress(const StaticVertex* vertices, size_t count);
+
+	// PSOに渡す入力レイアウト(SkinShaderHeader.hlsliのSkinInput、BasicVertexShader.hlslの引数と対応)
+	static std::vector<D3D12_INPUT_ELEMENT_DESC> InputLayout(const CompactSkinMesh& mesh);
+	static std::vector<D3D12_INPUT_ELEMENT_DESC> StaticInputLayout();
+
+	// 復元した値と元の値を比べて最大誤差を求める
+	static VertexQuantizeReport Measure(const std::vector<SkinVertex>& vertices, const CompactSkinMesh& mesh);
+	static VertexQuantizeReport Measure(const StaticVertex* vertices, const std::vector<CompactStaticVertex>& compact);
+
+	static void EncodeOct(const Float3& normal, int16_t out[2]);
+	static Float3 DecodeOct(const int16_t in[2]);
+
+	// 合計が255になるようにUNORM8へ量子化する
+	static void EncodeWeights(const float weights[4], uint8_t out[4]);
+
+	// IEEE 754の半精度(最近接偶数丸め、範囲外は無限大)
+	static uint16_t FloatToHalf(float value);
+	static float HalfToFloat(uint16_t half);
+};
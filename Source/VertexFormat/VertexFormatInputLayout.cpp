@@ -0,0 +1,34 @@
+#include "VertexFormat.h"
+
+#include <d3d12.h>
+
+// VertexFormat.hの圧縮形に対応するD3D12の入力レイアウト
+
+std::vector<D3D12_INPUT_ELEMENT_DESC> VertexFormat::InputLayout(const CompactSkinMesh& mesh)
+{
+	UINT attribSlot = mesh.splitStreams ? 1 : 0;
+	DXGI_FORMAT boneFormat = mesh.boneIndex16 ? DXGI_FORMAT_R16G16B16A16_UINT : DXGI_FORMAT_R8G8B8A8_UINT;
+
+	std::vector<D3D12_INPUT_ELEMENT_DESC> layout =
+	{
+		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"NORMAL",0,DXGI_FORMAT_R16G16_SNORM,attribSlot,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TEXCOORD",0,DXGI_FORMAT_R16G16_FLOAT,attribSlot,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"BLENDINDICES",0,boneFormat,attribSlot,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"BLENDWEIGHT",0,DXGI_FORMAT_R8G8B8A8_UNORM,attribSlot,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+	};
+
+	return layout;
+}
+
+std::vector<D3D12_INPUT_ELEMENT_DESC> VertexFormat::StaticInputLayout()
+{
+	std::vector<D3D12_INPUT_ELEMENT_DESC> layout =
+	{
+		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"NORMAL",0,DXGI_FORMAT_R16G16_SNORM,0,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+		{"TEXCOORD",0,DXGI_FORMAT_R16G16_FLOAT,0,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
+	};
+
+	return layout;
+}
@@ -45,26 +45,26 @@
 //	swapchainDesc.SampleDesc.Count = 1;
 //	swapchainDesc.SampleDesc.Quality = 0;
 //	swapchainDesc.BufferUsage = DXGI_USAGE_BACK_BUFFER;
-//	swapchainDesc.BufferCount = 2; // _uobt@OȂ̂2
+//	swapchainDesc.BufferCount = 2; // ダブルバッファリングなので2
 //
-//	// obNobt@͐Lяk݉\
+//	// バックバッファは伸び縮み可能
 //	swapchainDesc.Scaling = DXGI_SCALING_STRETCH;
 //
 //	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 //	swapchainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
 //
-//	// EBhE[hƃtXN[[hؑ։\
+//	// ウィンドウモードとフルスクリーンモード切替可能
 //	swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 //
 //	result = mDxgiFactory->CreateSwapChainForHwnd(mCmdQueue.Get(), hwnd, &swapchainDesc, nullptr, nullptr, (IDXGISwapChain1**)mSwapChain.ReleaseAndGetAddressOf());
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "Xbv`FC쐬s");
+//		assert(false && "スワップチェイン作成失敗");
 //		return -1;
 //	}
 //
-//	// fXNv^q[v̍쐬(_[^[Qbgp)
+//	// デスクリプタヒープの作成(レンダーターゲット用)
 //	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
 //
 //	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
@@ -77,7 +77,7 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "fBXNv^q[v쐬s");
+//		assert(false && "ディスクリプタヒープ作成失敗");
 //		return -1;
 //	}
 //
@@ -86,7 +86,7 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "Xbv`F[p[^擾s");
+//		assert(false && "スワップチェーンパラメータ取得失敗");
 //		return -1;
 //	}
 //
@@ -104,7 +104,7 @@
 //
 //		if (FAILED(result))
 //		{
-//			assert(false && "_[^[QbgƃXbv`F[̕RÂs");
+//			assert(false && "レンダーターゲットとスワップチェーンの紐づけ失敗");
 //			return -1;
 //		}
 //
@@ -119,11 +119,11 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "tFX쐬s");
+//		assert(false && "フェンス作成失敗");
 //		return -1;
 //	}
 //
-//	// _쐻
+//	// 頂点作製
 //	Vertex vertices[] =
 //	{
 //		{ {-1.0F, -1.0F, 0.0F }, { 0.0F, 1.0F } },
@@ -159,30 +159,30 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "o[ebNXobt@[̍쐬s");
+//		assert(false && "バーテックスバッファーの作成失敗");
 //		return -1;
 //	}
 //
 //	Vertex* vertMap = nullptr;
 //
-//	// _obt@[̃}bv
+//	// 頂点バッファーのマップ
 //	result = vertBuff->Map(0, nullptr, (void**)&vertMap);
 //	if (FAILED(result))
 //	{
-//		assert(false && "o[ebNXobt@[̃}bvs");
+//		assert(false && "バーテックスバッファーのマップ失敗");
 //		return -1;
 //	}
 //
 //	std::copy(std::begin(vertices), std::end(vertices), vertMap);
 //	vertBuff->Unmap(0, nullptr);
 //
-//	// _obt@[r[
+//	// 頂点バッファービュー
 //	D3D12_VERTEX_BUFFER_VIEW vbView = {};
-//	vbView.BufferLocation = vertBuff->GetGPUVirtualAddress(); // _obt@[zAhX
-//	vbView.SizeInBytes = sizeof(vertices); // SoCg
-//	vbView.StrideInBytes = sizeof(vertices[0]); // _̃oCg
+//	vbView.BufferLocation = vertBuff->GetGPUVirtualAddress(); // 頂点バッファー仮想アドレス
+//	vbView.SizeInBytes = sizeof(vertices); // 全バイト数
+//	vbView.StrideInBytes = sizeof(vertices[0]); // 頂点一つのバイト数
 //
-//	// CfbNXobt@[
+//	// インデックスバッファー
 //	ComPtr<ID3D12Resource> idxBuff = nullptr;
 //
 //	resdesc.Width = sizeof(indices);
@@ -191,7 +191,7 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "CfbNXobt@[̍쐻s");
+//		assert(false && "インデックスバッファーの作製失敗");
 //		return -1;
 //	}
 //
@@ -200,7 +200,7 @@
 //
 //	if (FAILED(result))
 //	{
-//		assert(false && "CfbNXobt@[̃}bvs");
+//		assert(false && "インデックスバッファーのマップ失敗");
 //		return -1;
 //	}
 //
@@ -246,7 +246,7 @@
 //		ShowErrorMessage(result, errorBlob.Get());
 //	}
 //
-//	// eNX`obt@̐
+//	// テクスチャバッファの生成
 //	DirectX::TexMetadata metadata = {};
 //	DirectX::ScratchImage scratchImg = {};
 //
@@ -330,7 +330,7 @@
 //	rootparam[1].DescriptorTable.pDescriptorRanges = &constantBufferDescriptorRange;
 //	rootparam[1].DescriptorTable.NumDescriptorRanges = 1;
 //
-//	// 萔obt@̍쐬
+//	// 定数バッファの作成
 //	DirectX::XMMATRIX matrix = DirectX::XMMatrixIdentity();
 //	DirectX::XMMATRIX worldMatrix = DirectX::XMMatrixIdentity();
 //
@@ -369,7 +369,7 @@
 //	basicHeapHandle.ptr += mDev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 //	mDev->CreateConstantBufferView(&cbvDesc, basicHeapHandle);
 //
-//	// _CAEg̍쐬
+//	// 頂点レイアウトの作成
 //	D3D12_INPUT_ELEMENT_DESC inputLayout[] =
 //	{
 //		{"POSITION",0,DXGI_FORMAT_R32G32B32_FLOAT,0,D3D12_APPEND_ALIGNED_ELEMENT,D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,0},
@@ -408,7 +408,7 @@
 //	result = mDev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
 //	if (FAILED(result) == true)
 //	{
-//		assert(false && "[gVOl`쐬s");
+//		assert(false && "ルートシグネチャ作成失敗");
 //		return -1;
 //	}
 //
@@ -450,7 +450,7 @@
 //	ComPtr<ID3D12PipelineState> mPipelinestate = nullptr;
 //	result = mDev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(mPipelinestate.ReleaseAndGetAddressOf()));
 //
-//	// r[|[gƃVU[`
+//	// ビューポートとシザー矩形
 //	D3D12_VIEWPORT viewport = {};
 //	viewport.Width = window_width;
 //	viewport.Height = window_height;
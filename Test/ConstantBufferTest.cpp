@@ -0,0 +1,152 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../Source/ConstantBuffer/ConstantBuffer.h"
+
+namespace
+{
+	// アップロードヒープの代わりにCPUのメモリを版として渡す
+	// GPUアドレスは版の区別にしか使わないので、確保した順の番号にする
+	struct FakeConstantMemory
+	{
+		std::vector<std::unique_ptr<uint8_t[]>> buffers;
+		uint32_t freed = 0;
+
+		void Attach(ConstantBufferSystem& system)
+		{
+			system.Init(
+				[this](uint32_t size, ConstantVersion& version)
+				{
+					buffers.emplace_back(new uint8_t[size]());
+					version.cpuAddress = buffers.back().get();
+					version.gpuAddress = 0x10000 * buffers.size();
+					return true;
+				},
+				[this](ConstantVersion&)
+				{
+					++freed;
+				});
+		}
+	};
+
+	struct Block128
+	{
+		float values[32];
+	};
+
+	Block128 MakeBlock(float base)
+	{
+		Block128 block = {};
+		for (int idx = 0; idx < 32; ++idx)
+		{
+			block.values[idx] = base + idx;
+		}
+		return block;
+	}
+}
+
+TEST_CASE(ConstantBuffer_UnchangedSetUploadsNothing)
+{
+	FakeConstantMemory memory;
+	ConstantBufferSystem system;
+	memory.Attach(system);
+
+	ConstantBlock* block = system.CreateBlock("Frame", ConstantFrequency::PerFrame, sizeof(Block128), 1);
+	CHECK(block != nullptr);
+	CHECK(block->Binding() == ConstantBinding::RootCbv);
+
+	block->Set(MakeBlock(1.0F));
+	system.Flush();
+	CHECK(system.Stats().bytesUploaded == sizeof(Block128));
+
+	// 同じ値を入れ直してもダーティにならない
+	block->Set(MakeBlock(1.0F));
+	CHECK(!block->IsDirty());
+	system.Flush();
+	CHECK(system.Stats().bytesUploaded == 0);
+	CHECK(system.Stats().blocksUploaded == 0);
+	CHECK(system.Stats().blocksSkipped == 1);
+}
+
+TEST_CASE(ConstantBuffer_ChangedBlockUploadsOnceAndRotates)
+{
+	FakeConstantMemory memory;
+	ConstantBufferSystem system;
+	memory.Attach(system);
+
+	ConstantBlock* block = system.CreateBlock("Frame", ConstantFrequency::PerFrame, sizeof(Block128), 1);
+	CHECK(memory.buffers.size() == ConstantBlock::VersionCount);
+
+	system.Flush();
+	uint32_t version = block->CurrentVersion();
+	uint64_t address = block->GpuAddress();
+
+	Block128 value = MakeBlock(5.0F);
+	block->Set(value);
+	system.Flush();
+
+	// 書き込んだのは次の版で、前の版(GPUが読んでいるかもしれない)には触らない
+	CHECK(system.Stats().bytesUploaded == sizeof(Block128));
+	CHECK(system.Stats().blocksUploaded == 1);
+	CHECK(block->CurrentVersion() == (version + 1) % ConstantBlock::VersionCount);
+	CHECK(block->GpuAddress() != address);
+	CHECK(std::memcmp(memory.buffers[block->CurrentVersion()].get(), &value, sizeof(value)) == 0);
+
+	// 次のフレームで変わらなければ版も進まない
+	system.Flush();
+	CHECK(system.Stats().bytesUploaded == 0);
+	CHECK(block->CurrentVersion() == (version + 1) % ConstantBlock::VersionCount);
+
+	// 版は3つを巡回する
+	for (uint32_t frame = 1; frame < ConstantBlock::VersionCount; ++frame)
+	{
+		block->Set(MakeBlock(10.0F + frame));
+		system.Flush();
+	}
+	CHECK(block->CurrentVersion() == version);
+}
+
+TEST_CASE(ConstantBuffer_SmallBlockIsRootConstants)
+{
+	FakeConstantMemory memory;
+	ConstantBufferSystem system;
+	memory.Attach(system);
+
+	float matrix[16] = {};
+	float larger[17] = {};
+	ConstantBlock* draw = system.CreateBlock("Draw", ConstantFrequency::PerDraw, sizeof(matrix), 2);
+	ConstantBlock* frame = system.CreateBlock("Frame", ConstantFrequency::PerFrame, sizeof(larger), 1);
+
+	CHECK(draw->Binding() == ConstantBinding::RootConstants);
+	CHECK(draw->Num32BitValues() == 16);
+	CHECK(frame->Binding() == ConstantBinding::RootCbv);
+
+	// ルート定数は版を持たない
+	CHECK(memory.buffers.size() == ConstantBlock::VersionCount);
+
+	matrix[0] = 1.0F;
+	draw->Set(matrix);
+	system.Flush();
+
+	// 64バイトのブロックはアップロード量ではなくルート定数として数える
+	CHECK(system.Stats().rootConstantBytes == sizeof(matrix));
+	CHECK(system.Stats().bytesUploaded == sizeof(larger));
+	CHECK(system.Stats().blocksUploaded == 1);
+	CHECK(!draw->IsDirty());
+}
+
+TEST_CASE(ConstantBuffer_DestructorFreesVersions)
+{
+	FakeConstantMemory memory;
+	{
+		ConstantBufferSystem system;
+		memory.Attach(system);
+		system.CreateBlock("Frame", ConstantFrequency::PerFrame, 256, 1);
+		system.CreateBlock("Draw", ConstantFrequency::PerDraw, 64, 2);
+	}
+	CHECK(memory.freed == ConstantBlock::VersionCount);
+}
@@ -0,0 +1,272 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../Source/Culling/Bvh.h"
+#include "../Source/Culling/SkinnedBounds.h"
+
+namespace
+{
+	// XMMatrixPerspectiveFovLHと同じ行列(原点から+Zを見る)
+	Float4x4 PerspectiveLH(float fovY, float aspect, float nearZ, float farZ)
+	{
+		float yScale = 1.0F / std::tan(fovY * 0.5F);
+		float range = farZ / (farZ - nearZ);
+
+		Float4x4 m = {};
+		m.m[0][0] = yScale / aspect;
+		m.m[1][1] = yScale;
+		m.m[2][2] = range;
+		m.m[2][3] = 1.0F;
+		m.m[3][2] = -range * nearZ;
+		return m;
+	}
+
+	Float4x4 Translation(float x, float y, float z)
+	{
+		Float4x4 m = Math::Identity();
+		m.m[3][0] = x;
+		m.m[3][1] = y;
+		m.m[3][2] = z;
+		return m;
+	}
+
+	Frustum TestFrustum()
+	{
+		return Frustum::FromViewProjection(PerspectiveLH(1.5707963F, 1.0F, 1.0F, 100.0F));
+	}
+
+	std::vector<Aabb> RandomBoxes(size_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-200.0F, 200.0F);
+		std::uniform_real_distribution<float> size(0.1F, 5.0F);
+
+		std::vector<Aabb> boxes(count);
+		for (Aabb& box : boxes)
+		{
+			Float3 min = { position(random), position(random), position(random) };
+			box.Expand(min);
+			box.Expand(Float3{ min.x + size(random), min.y + size(random), min.z + size(random) });
+		}
+		return boxes;
+	}
+
+	uint32_t TreeDepth(const std::vector<BvhNode>& nodes, uint32_t index)
+	{
+		const BvhNode& node = nodes[index];
+		if (node.count > 0)
+		{
+			return 0;
+		}
+		return 1 + std::max(TreeDepth(nodes, index + 1), TreeDepth(nodes, node.offset));
+	}
+}
+
+TEST_CASE(Culling_FrustumPlanesFromPerspective)
+{
+	Frustum frustum = TestFrustum();
+
+	CHECK(frustum.Intersects({ { 0.0F, 0.0F, 10.0F }, 1.0F }));
+	CHECK(!frustum.Intersects({ { 0.0F, 0.0F, -10.0F }, 1.0F }));
+	CHECK(!frustum.Intersects({ { 0.0F, 0.0F, 102.0F }, 1.0F }));
+	CHECK(!frustum.Intersects({ { 30.0F, 0.0F, 10.0F }, 1.0F }));
+	CHECK(!frustum.Intersects({ { 0.0F, -30.0F, 10.0F }, 1.0F }));
+
+	// 90度の画角なので x = z の面が左右の境界
+	CHECK(frustum.Intersects({ { 10.5F, 0.0F, 10.0F }, 1.0F }));
+	CHECK(!frustum.Intersects({ { 12.0F, 0.0F, 10.0F }, 1.0F }));
+
+	// 平面は正規化済み
+	for (const Float4& plane : frustum.planes)
+	{
+		CHECK_NEAR(Math::Length({ plane.x, plane.y, plane.z }), 1.0, 1e-5);
+	}
+}
+
+TEST_CASE(Culling_WorldViewProjectionGivesObjectSpaceFrustum)
+{
+	// ワールドで右に100ずらした物は、モデル空間の原点にあっても見えない
+	Float4x4 viewProj = PerspectiveLH(1.5707963F, 1.0F, 1.0F, 100.0F);
+	Frustum shifted = Frustum::FromViewProjection(Math::Multiply(Translation(100.0F, 0.0F, 10.0F), viewProj));
+	Frustum forward = Frustum::FromViewProjection(Math::Multiply(Translation(0.0F, 0.0F, 10.0F), viewProj));
+
+	BoundingSphere atOrigin = { { 0.0F, 0.0F, 0.0F }, 1.0F };
+	CHECK(!shifted.Intersects(atOrigin));
+	CHECK(forward.Intersects(atOrigin));
+}
+
+TEST_CASE(Culling_SimdMatchesScalar)
+{
+	Frustum frustum = TestFrustum();
+	FrustumSimd simd(frustum);
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> position(-120.0F, 120.0F);
+	std::uniform_real_distribution<float> radius(0.1F, 10.0F);
+
+	for (int i = 0; i < 2000; ++i)
+	{
+		BoundingSphere sphere = { { position(random), position(random), position(random) }, radius(random) };
+		CHECK(simd.Intersects(sphere) == frustum.Intersects(sphere));
+	}
+}
+
+TEST_CASE(Culling_ClassifyBox)
+{
+	FrustumSimd frustum(TestFrustum());
+
+	Aabb inside = {};
+	inside.Expand(Float3{ -1.0F, -1.0F, 10.0F });
+	inside.Expand(Float3{ 1.0F, 1.0F, 12.0F });
+
+	Aabb crossing = {};
+	crossing.Expand(Float3{ -1.0F, -1.0F, -1.0F });
+	crossing.Expand(Float3{ 1.0F, 1.0F, 5.0F });
+
+	Aabb behind = {};
+	behind.Expand(Float3{ -1.0F, -1.0F, -12.0F });
+	behind.Expand(Float3{ 1.0F, 1.0F, -10.0F });
+
+	CHECK(frustum.Classify(inside) == FrustumSimd::Inside);
+	CHECK(frustum.Classify(crossing) == FrustumSimd::Intersect);
+	CHECK(frustum.Classify(behind) == FrustumSimd::Outside);
+}
+
+TEST_CASE(Culling_BvhQueryMatchesBruteForce)
+{
+	std::vector<Aabb> boxes = RandomBoxes(3000, 11);
+
+	Bvh bvh;
+	bvh.Build(boxes);
+	CHECK(bvh.PrimitiveCount() == boxes.size());
+
+	FrustumSimd frustum(TestFrustum());
+
+	std::vector<uint32_t> visible;
+	bvh.Query(frustum, visible);
+
+	std::vector<uint32_t> expected;
+	for (uint32_t idx = 0; idx < boxes.size(); ++idx)
+	{
+		if (frustum.Classify(boxes[idx]) != FrustumSimd::Outside)
+		{
+			expected.push_back(idx);
+		}
+	}
+
+	std::sort(visible.begin(), visible.end());
+	CHECK(!expected.empty());
+	CHECK(visible == expected);
+}
+
+TEST_CASE(Culling_BvhStaysShallowOnSkewedInput)
+{
+	// 間隔が倍々に広がる並びは、SAHだと毎回端の1つだけを切り離して深くなる
+	std::vector<Aabb> boxes;
+	for (int i = 0; i < 100; ++i)
+	{
+		float x = std::ldexp(1.0F, i);
+		Aabb box = {};
+		box.Expand(Float3{ x, -1.0F, 10.0F });
+		box.Expand(Float3{ x + 1.0F, 1.0F, 11.0F });
+		boxes.push_back(box);
+	}
+
+	Bvh bvh;
+	bvh.Build(boxes);
+
+	// Queryの走査スタック(64段)に収まる深さ
+	CHECK(TreeDepth(bvh.Nodes(), 0) < 63);
+
+	FrustumSimd frustum(TestFrustum());
+
+	std::vector<uint32_t> visible;
+	bvh.Query(frustum, visible);
+	std::sort(visible.begin(), visible.end());
+
+	std::vector<uint32_t> expected;
+	for (uint32_t idx = 0; idx < boxes.size(); ++idx)
+	{
+		if (frustum.Classify(boxes[idx]) != FrustumSimd::Outside)
+		{
+			expected.push_back(idx);
+		}
+	}
+
+	CHECK(!expected.empty());
+	CHECK(visible == expected);
+}
+
+TEST_CASE(Culling_BoundingSphereContainsPoints)
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> position(-50.0F, 50.0F);
+
+	std::vector<Float3> points(500);
+	for (Float3& point : points)
+	{
+		point = { position(random), position(random) * 0.2F, position(random) };
+	}
+
+	BoundingSphere sphere = BoundingSphere::FromPoints(points.data(), points.size(), 0.0F);
+
+	for (const Float3& point : points)
+	{
+		CHECK(Math::Length(Math::Subtract(point, sphere.center)) <= sphere.radius + 1e-3F);
+	}
+}
+
+TEST_CASE(Culling_SkinnedBoundsFollowBones)
+{
+	// 根元(原点)と肘(0,2,0)の2本。腕の頂点は肘と根元にまたがってウェイトを持つ
+	std::vector<Float3> bindBones = { { 0.0F, 0.0F, 0.0F }, { 0.0F, 2.0F, 0.0F } };
+
+	std::vector<Float3> positions;
+	std::vector<uint16_t> indices;
+	std::vector<float> weights;
+	for (int i = 0; i <= 8; ++i)
+	{
+		float y = 0.5F * static_cast<float>(i);
+		float w = std::clamp((y - 1.0F) / 2.0F, 0.0F, 1.0F);
+
+		positions.push_back({ 0.3F, y, 0.0F });
+		indices.insert(indices.end(), { 0, 1, 0, 0 });
+		weights.insert(weights.end(), { 1.0F - w, w, 0.0F, 0.0F });
+	}
+
+	SkinnedBounds bounds;
+	bounds.Init(bindBones, positions.data(), indices.data(), weights.data(), positions.size());
+
+	CHECK(bounds.BoneRadii().size() == 2);
+
+	// 肘から先をZ軸周りに90度曲げる(肘ボーンは動かず、子の頂点が回る)
+	auto bendElbow = [](const Float3& p)
+	{
+		Float3 local = { p.x, p.y - 2.0F, p.z };
+		return Float3{ -local.y, 2.0F + local.x, local.z };
+	};
+
+	// 肘ボーンごと平行移動もして、ボーン位置の更新が効くことを見る
+	Float3 offset = { 5.0F, 1.0F, -3.0F };
+	std::vector<Float3> posedBones = { offset, Math::Add(bindBones[1], offset) };
+	BoundingSphere sphere = bounds.Update(posedBones.data(), posedBones.size());
+
+	for (size_t vtx = 0; vtx < positions.size(); ++vtx)
+	{
+		float w = weights[vtx * 4 + 1];
+		Float3 rigid = Math::Add(positions[vtx], offset);
+		Float3 bent = Math::Add(bendElbow(positions[vtx]), offset);
+		Float3 skinned = Math::Add(Math::Scale(rigid, 1.0F - w), Math::Scale(bent, w));
+
+		CHECK(Math::Length(Math::Subtract(skinned, sphere.center)) <= sphere.radius + 1e-4F);
+	}
+
+	// 元の位置には残らない
+	CHECK(Math::Length(Math::Subtract(sphere.center, offset)) < sphere.radius);
+	CHECK(Math::Length(sphere.center) > 1.0F);
+}
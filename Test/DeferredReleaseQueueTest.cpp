@@ -0,0 +1,98 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "../Source/Dx12Wrapper/DeferredReleaseQueue.h"
+
+namespace
+{
+	// Dx12Wrapperと同じく2フレームまでGPUより先行する
+	const uint32_t FrameCount = 2;
+
+	// Dx12Wrapper::EndDrawのフェンスの進め方をGPUなしで再現する
+	struct FrameTimeline
+	{
+		uint64_t fenceValue = 0;
+		uint64_t completedValue = 0;
+		uint64_t frameFenceValues[FrameCount] = {};
+		uint32_t frameIndex = 0;
+
+		// 記録中のフレームが完了した時に通過する値
+		uint64_t CurrentFenceValue() const { return fenceValue + 1; }
+
+		// フレームを送信し、次のフレームで使う番号の前回分だけを待つ
+		void EndFrame()
+		{
+			frameFenceValues[frameIndex] = ++fenceValue;
+			frameIndex = (frameIndex + 1) % FrameCount;
+
+			if (completedValue < frameFenceValues[frameIndex])
+			{
+				completedValue = frameFenceValues[frameIndex];
+			}
+		}
+	};
+}
+
+TEST_CASE(DeferredRelease_WaitsForTheFrameThatUsedTheResource)
+{
+	DeferredReleaseQueue<std::shared_ptr<int>> queue;
+	FrameTimeline timeline;
+
+	std::shared_ptr<int> resource = std::make_shared<int>(1);
+	std::weak_ptr<int> watch = resource;
+
+	// フレーム1で最後に使われた
+	queue.Push(std::move(resource), timeline.CurrentFenceValue());
+
+	// フレーム1の送信直後はまだGPUが実行中(待つのはフレーム-1の分だけ)
+	timeline.EndFrame();
+	CHECK(queue.Collect(timeline.completedValue) == 0);
+	CHECK(!watch.expired());
+
+	// フレーム2を送信する時に同じ番号のフレーム1を待つので、ここで解放される
+	timeline.EndFrame();
+	CHECK(queue.Collect(timeline.completedValue) == 1);
+	CHECK(watch.expired());
+	CHECK(queue.Empty());
+}
+
+TEST_CASE(DeferredRelease_ReleasesInFenceOrder)
+{
+	DeferredReleaseQueue<std::shared_ptr<int>> queue;
+	FrameTimeline timeline;
+
+	std::weak_ptr<int> watches[4];
+	for (int frame = 0; frame < 4; ++frame)
+	{
+		std::shared_ptr<int> resource = std::make_shared<int>(frame);
+		watches[frame] = resource;
+		queue.Push(std::move(resource), timeline.CurrentFenceValue());
+		timeline.EndFrame();
+	}
+
+	// 4フレーム送信した時点で完了しているのは3フレーム目まで
+	CHECK(queue.Collect(timeline.completedValue) == 3);
+	CHECK(watches[2].expired());
+	CHECK(!watches[3].expired());
+	CHECK(queue.Size() == 1);
+
+	// アイドルを待った後(Resizeや終了時)は全て解放できる
+	queue.Collect(timeline.fenceValue);
+	CHECK(watches[3].expired());
+}
+
+TEST_CASE(DeferredRelease_FlushDropsEverything)
+{
+	DeferredReleaseQueue<std::shared_ptr<int>> queue;
+
+	std::shared_ptr<int> resource = std::make_shared<int>(0);
+	std::weak_ptr<int> watch = resource;
+	queue.Push(std::move(resource), 100);
+
+	CHECK(queue.Collect(99) == 0);
+	queue.Flush();
+	CHECK(watch.expired());
+	CHECK(queue.Empty());
+}
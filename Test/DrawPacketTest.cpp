@@ -0,0 +1,222 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Source/DrawPacket/DrawPacket.h"
+
+namespace
+{
+	// 呼ばれた順を文字列で残すだけのコマンドリストの代わり
+	struct CommandLog
+	{
+		std::vector<std::string> calls;
+
+		void SetTriangleList() { calls.push_back("Topology"); }
+		void SetPipelineState(ID3D12PipelineState* pipelineState) { calls.push_back("PSO " + Name(pipelineState)); }
+		void SetRootSignature(ID3D12RootSignature* rootSignature) { calls.push_back("RootSignature " + Name(rootSignature)); }
+		void SetDescriptorHeaps(ID3D12DescriptorHeap* heap, ID3D12DescriptorHeap* samplerHeap) { calls.push_back("Heaps " + Name(heap) + " " + Name(samplerHeap)); }
+		void SetDescriptorTable(uint32_t rootIndex, uint64_t table) { calls.push_back("Table" + std::to_string(rootIndex) + " " + std::to_string(table)); }
+		void SetConstantBuffer(uint32_t rootIndex, uint64_t address) { calls.push_back("Cbv" + std::to_string(rootIndex) + " " + std::to_string(address)); }
+		void SetConstants(uint32_t rootIndex, uint32_t count, const void* values) { calls.push_back("Constants" + std::to_string(rootIndex) + " " + std::to_string(count) + " " + std::to_string(*static_cast<const uint32_t*>(values))); }
+		void SetVertexBuffer(const D3D12_VERTEX_BUFFER_VIEW* view) { calls.push_back("VB " + Name(view)); }
+		void SetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view) { calls.push_back("IB " + Name(view)); }
+		void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) { calls.push_back("Draw " + std::to_string(indexCount) + " " + std::to_string(startIndex)); }
+
+		static std::string Name(const void* pointer) { return std::to_string(reinterpret_cast<uintptr_t>(pointer)); }
+	};
+
+	// D3Dのオブジェクトは比較にしか使わないので、番号をそのままポインタにする
+	template<typename T>
+	T* Handle(uintptr_t id)
+	{
+		return reinterpret_cast<T*>(id);
+	}
+
+	DrawPacket MakePacket(uint16_t pipeline, uint16_t texture, float depth)
+	{
+		DrawPacket packet = {};
+		packet.sortKey = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, pipeline, texture, depth);
+		packet.pipelineState = Handle<ID3D12PipelineState>(100 + pipeline);
+		packet.rootSignature = Handle<ID3D12RootSignature>(1);
+		packet.descriptorHeap = Handle<ID3D12DescriptorHeap>(2);
+		packet.textureTable = 1000 + texture;
+		packet.constantBuffer = 5000;
+		packet.vbView = Handle<const D3D12_VERTEX_BUFFER_VIEW>(7);
+		packet.ibView = Handle<const D3D12_INDEX_BUFFER_VIEW>(8);
+		packet.indexCount = 6;
+		return packet;
+	}
+}
+
+TEST_CASE(DrawPacket_SortKeyOrdersPassPipelineTextureDepth)
+{
+	uint64_t opaqueNear = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 1, 1, 0.1F);
+	uint64_t opaqueFar = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 1, 1, 0.9F);
+	uint64_t otherTexture = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 1, 2, 0.0F);
+	uint64_t otherPipeline = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 2, 0, 0.0F);
+	uint64_t transparentNear = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassTransparent, 0, 0, 0.1F);
+	uint64_t transparentFar = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassTransparent, 0, 0, 0.9F);
+
+	// 不透明は手前から、半透明は奥から
+	CHECK(opaqueNear < opaqueFar);
+	CHECK(opaqueFar < otherTexture);
+	CHECK(otherTexture < otherPipeline);
+	CHECK(otherPipeline < transparentFar);
+	CHECK(transparentFar < transparentNear);
+}
+
+TEST_CASE(DrawPacket_RadixSortIsStableAndOrdered)
+{
+	DrawPacketQueue queue;
+
+	const uint16_t pipelines[] = { 3, 1, 2, 1, 3, 0, 1 };
+	for (size_t i = 0; i < sizeof(pipelines) / sizeof(pipelines[0]); ++i)
+	{
+		DrawPacket packet = MakePacket(pipelines[i], 0, 0.5F);
+		packet.startIndex = static_cast<uint32_t>(i);
+		queue.Add(packet);
+	}
+
+	queue.Sort();
+
+	for (size_t i = 1; i < queue.Size(); ++i)
+	{
+		CHECK(queue.Packet(i - 1).sortKey <= queue.Packet(i).sortKey);
+
+		// 同じキーは追加順のまま
+		if (queue.Packet(i - 1).sortKey == queue.Packet(i).sortKey)
+		{
+			CHECK(queue.Packet(i - 1).startIndex < queue.Packet(i).startIndex);
+		}
+	}
+}
+
+TEST_CASE(DrawPacket_RecordSkipsRepeatedState)
+{
+	DrawPacketQueue queue;
+	queue.Add(MakePacket(1, 4, 0.2F));
+	queue.Add(MakePacket(0, 4, 0.5F));
+	queue.Add(MakePacket(1, 4, 0.1F));
+	queue.Add(MakePacket(1, 5, 0.3F));
+	queue.Sort();
+
+	CommandLog log;
+	queue.Record(log, false);
+
+	const std::vector<std::string> expected =
+	{
+		"Topology",
+		"PSO 100", "RootSignature 1", "Heaps 2 0", "Table0 1004", "Cbv1 5000", "VB 7", "IB 8", "Draw 6 0",
+		"PSO 101", "Draw 6 0",
+		"Draw 6 0",
+		"Table0 1005", "Draw 6 0",
+	};
+
+	CHECK(log.calls == expected);
+
+	const DrawPacketStats& stats = queue.Stats();
+	CHECK(stats.drawCount == 4);
+	CHECK(stats.pipelineStateSet == 2);
+	CHECK(stats.pipelineStateSkipped == 2);
+	CHECK(stats.descriptorTableSet == 2);
+	CHECK(stats.TotalSet() == 9);
+}
+
+TEST_CASE(DrawPacket_RootConstantsAreCopiedAndComparedByValue)
+{
+	// 同じ共有バッファを書き換えながらパケットを作っても、各パケットは追加時の値を持つ
+	uint32_t shared[4] = { 1, 2, 3, 4 };
+
+	DrawPacketQueue queue;
+
+	DrawPacket first = MakePacket(0, 0, 0.1F);
+	first.SetRootConstants(shared, 4);
+	queue.Add(first);
+
+	// 別の場所にある同じ値は積み直さない
+	uint32_t sameValues[4] = { 1, 2, 3, 4 };
+	DrawPacket second = MakePacket(0, 0, 0.2F);
+	second.SetRootConstants(sameValues, 4);
+	queue.Add(second);
+
+	shared[0] = 9;
+	DrawPacket third = MakePacket(0, 0, 0.3F);
+	third.SetRootConstants(shared, 4);
+	queue.Add(third);
+
+	queue.Sort();
+
+	CommandLog log;
+	queue.Record(log, false);
+
+	const std::vector<std::string> expected =
+	{
+		"Topology",
+		"PSO 100", "RootSignature 1", "Heaps 2 0", "Table0 1000", "Cbv1 5000", "Constants2 4 1", "VB 7", "IB 8", "Draw 6 0",
+		"Draw 6 0",
+		"Constants2 4 9", "Draw 6 0",
+	};
+
+	CHECK(log.calls == expected);
+	CHECK(queue.Stats().rootConstantsSet == 2);
+	CHECK(queue.Stats().rootConstantsSkipped == 1);
+}
+
+TEST_CASE(DrawPacket_DepthPrepassThenShadedPass)
+{
+	// 不透明2つ(深度専用PSOあり)、深度専用PSOのない不透明1つ、半透明1つ
+	DrawPacket near = MakePacket(0, 4, 0.1F);
+	near.depthOnlyPipelineState = Handle<ID3D12PipelineState>(200);
+	near.samplerHeap = Handle<ID3D12DescriptorHeap>(3);
+	near.samplerTable = 3000;
+	near.materialTable = 4000;
+	near.materialIndex = 7;
+
+	DrawPacket far = near;
+	far.sortKey = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassOpaque, 0, 5, 0.9F);
+	far.textureTable = 1005;
+	far.startIndex = 60;
+
+	DrawPacket noPrepass = MakePacket(2, 4, 0.5F);
+	noPrepass.startIndex = 120;
+
+	DrawPacket transparent = near;
+	transparent.sortKey = DrawPacketQueue::MakeSortKey(DrawPacketQueue::PassTransparent, 0, 4, 0.5F);
+	transparent.startIndex = 180;
+
+	DrawPacketQueue queue;
+	queue.Add(transparent);
+	queue.Add(noPrepass);
+	queue.Add(far);
+	queue.Add(near);
+	queue.Sort();
+
+	// Renderと同じく、プリパスと本描画を1つのコマンドリストに続けて積む
+	CommandLog log;
+	queue.Record(log, true);
+	queue.Record(log, false);
+
+	const std::vector<std::string> expected =
+	{
+		// プリパス: 深度専用PSOを持つ不透明だけを、テクスチャやマテリアルなしで前から順に
+		"Topology",
+		"PSO 200", "RootSignature 1", "Heaps 2 3", "Cbv1 5000", "VB 7", "IB 8", "Draw 6 0",
+		"Draw 6 60",
+
+		// 本描画: 全パケットを通常のPSOで。ステートは積み直す
+		"Topology",
+		"PSO 100", "RootSignature 1", "Heaps 2 3", "Table0 1004", "Table3 3000", "Table5 4000", "Constants4 1 7", "Cbv1 5000", "VB 7", "IB 8", "Draw 6 0",
+		"Table0 1005", "Draw 6 60",
+		"PSO 102", "Heaps 2 0", "Table0 1004", "Draw 6 120",
+		// ヒープを変えるとテーブルは積み直しになるが、マテリアル番号(ルート定数)は残る
+		"PSO 100", "Heaps 2 3", "Table0 1004", "Table3 3000", "Table5 4000", "Draw 6 180",
+	};
+
+	CHECK(log.calls == expected);
+
+	const DrawPacketStats& stats = queue.Stats();
+	CHECK(stats.depthOnlyDrawCount == 2);
+	CHECK(stats.drawCount == 4);
+}
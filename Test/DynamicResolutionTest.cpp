@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+
+#include <cmath>
+
+#include "../Source/DynamicResolution/DynamicResolution.h"
+
+namespace
+{
+	// GPU時間はピクセル数(倍率の2乗)に比例するとしたシーン
+	double SceneMs(double fullResolutionMs, float scale)
+	{
+		return fullResolutionMs * static_cast<double>(scale) * static_cast<double>(scale);
+	}
+
+	// frames回回して、最後のwindowフレームで倍率が変わった回数を返す
+	int Run(DynamicResolution& controller, double fullResolutionMs, int frames, int window, double noise = 0.0)
+	{
+		int changes = 0;
+		float prev = controller.Scale();
+
+		for (int frame = 0; frame < frames; ++frame)
+		{
+			// 1フレームおきに上下に振れる計測のばらつき
+			double jitter = (frame % 2 == 0) ? 1.0 + noise : 1.0 - noise;
+			float scale = controller.Update(SceneMs(fullResolutionMs, controller.Scale()) * jitter);
+
+			if (frame >= frames - window && scale != prev)
+			{
+				++changes;
+			}
+			prev = scale;
+		}
+		return changes;
+	}
+}
+
+TEST_CASE(DynamicResolution_ConvergesToTarget)
+{
+	DynamicResolution controller;
+
+	// フル解像度では20msかかる
+	int changes = Run(controller, 20.0, 300, 100);
+
+	double settledMs = SceneMs(20.0, controller.Scale());
+	const DynamicResolution::Settings& settings = controller.GetSettings();
+
+	CHECK(controller.Scale() < 1.0F);
+	CHECK(settledMs <= settings.targetMs * (1.0 + settings.deadband));
+	CHECK(settledMs >= settings.targetMs * (1.0 - settings.deadband) - SceneMs(20.0, settings.step) * 2.0);
+	CHECK(changes == 0);
+
+	// 倍率は刻みの倍数
+	double steps = controller.Scale() / settings.step;
+	CHECK_NEAR(steps, std::round(steps), 1e-4);
+}
+
+TEST_CASE(DynamicResolution_StaysAtFullResolutionWhenFast)
+{
+	DynamicResolution controller;
+	Run(controller, 8.0, 200, 0);
+
+	CHECK(controller.Scale() == controller.GetSettings().maxScale);
+}
+
+TEST_CASE(DynamicResolution_RecoversFromMinimumWithoutWindup)
+{
+	DynamicResolution controller;
+
+	// 倍率を最低にしても間に合わない重さが長く続いた
+	Run(controller, 100.0, 600, 0);
+	CHECK(controller.Scale() == controller.GetSettings().minScale);
+
+	// 軽くなったらすぐに戻る(下限に張り付いている間に積分が溜まっていない)
+	int frames = 0;
+	while (controller.Scale() < controller.GetSettings().maxScale && frames < 200)
+	{
+		controller.Update(SceneMs(8.0, controller.Scale()));
+		++frames;
+	}
+
+	CHECK(controller.Scale() == controller.GetSettings().maxScale);
+	CHECK(frames < 60);
+}
+
+TEST_CASE(DynamicResolution_IgnoresFrameToFrameNoise)
+{
+	DynamicResolution controller;
+
+	// ±10%のばらつきがあっても、落ち着いた後は倍率を変えない
+	int changes = Run(controller, 20.0, 400, 200, 0.1);
+	CHECK(changes <= 1);
+}
+
+TEST_CASE(DynamicResolution_ScaledSize)
+{
+	DynamicResolution::Settings settings;
+	settings.maxScale = 0.5F;
+	DynamicResolution controller(settings);
+
+	CHECK(controller.ScaledSize(1920) == 960);
+	CHECK(controller.ScaledSize(1) == 1);
+	CHECK(controller.ScaledSize(0) == 1);
+}
@@ -0,0 +1,94 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Source/IndirectDraw/IndirectCommand.h"
+
+namespace
+{
+	Frustum LookAlongZ()
+	{
+		// XMMatrixPerspectiveFovLH(90度, 1.0, 1, 100)
+		Float4x4 m = {};
+		m.m[0][0] = 1.0F;
+		m.m[1][1] = 1.0F;
+		m.m[2][2] = 100.0F / 99.0F;
+		m.m[2][3] = 1.0F;
+		m.m[3][2] = -100.0F / 99.0F;
+		return Frustum::FromViewProjection(m);
+	}
+
+	IndirectObject MakeObject(float x, float z, uint32_t id)
+	{
+		IndirectObject object = {};
+		object.bounds = { { x, 0.0F, z }, 1.0F };
+		object.indexCount = 6 * (id + 1);
+		object.startIndex = 100 * id;
+		object.baseVertex = -static_cast<int32_t>(id);
+		object.objectId = id;
+		return object;
+	}
+}
+
+TEST_CASE(IndirectCommand_LayoutMatchesShaderAndSignature)
+{
+	// FrustumCullCS.hlslのObjectData: float3 center, float radius, uint, uint, int, uint
+	CHECK(offsetof(IndirectObject, bounds) == 0);
+	CHECK(offsetof(IndirectObject, indexCount) == 16);
+	CHECK(offsetof(IndirectObject, startIndex) == 20);
+	CHECK(offsetof(IndirectObject, baseVertex) == 24);
+	CHECK(offsetof(IndirectObject, objectId) == 28);
+
+	// コマンドシグネチャ: ルート定数1個(4バイト)の直後にDRAW_INDEXEDの引数
+	CHECK(offsetof(IndirectCommand, objectId) == 0);
+	CHECK(offsetof(IndirectCommand, args) == 4);
+	CHECK(offsetof(DrawIndexedArguments, indexCountPerInstance) == 0);
+	CHECK(offsetof(DrawIndexedArguments, instanceCount) == 4);
+	CHECK(offsetof(DrawIndexedArguments, startIndexLocation) == 8);
+	CHECK(offsetof(DrawIndexedArguments, baseVertexLocation) == 12);
+	CHECK(offsetof(DrawIndexedArguments, startInstanceLocation) == 16);
+	CHECK(sizeof(IndirectCommand) == 24);
+
+	// cbufferはfloat4[6]の後にobjectCount、16バイト境界まで詰める
+	CHECK(offsetof(IndirectCullParams, objectCount) == 96);
+	CHECK(sizeof(IndirectCullParams) % 16 == 0);
+}
+
+TEST_CASE(IndirectCommand_CpuCullKeepsVisibleObjectsInOrder)
+{
+	std::vector<IndirectObject> objects =
+	{
+		MakeObject(0.0F, 10.0F, 0),		// 正面
+		MakeObject(0.0F, -10.0F, 1),	// 背後
+		MakeObject(50.0F, 10.0F, 2),	// 右の外
+		MakeObject(-5.0F, 20.0F, 3),	// 左寄りだが内側
+		MakeObject(0.0F, 150.0F, 4),	// 遠すぎる
+	};
+
+	std::vector<IndirectCommand> commands;
+	uint32_t count = CullIndirectCommands(LookAlongZ(), objects, commands);
+
+	CHECK(count == 2);
+	CHECK(commands.size() == 2);
+
+	if (commands.size() == 2)
+	{
+		CHECK(commands[0].objectId == 0);
+		CHECK(commands[1].objectId == 3);
+
+		const DrawIndexedArguments& args = commands[1].args;
+		CHECK(args.indexCountPerInstance == 24);
+		CHECK(args.instanceCount == 1);
+		CHECK(args.startIndexLocation == 300);
+		CHECK(args.baseVertexLocation == -3);
+		CHECK(args.startInstanceLocation == 0);
+	}
+
+	// 前回の結果は消してから詰め直す
+	objects.resize(1);
+	CHECK(CullIndirectCommands(LookAlongZ(), objects, commands) == 1);
+	CHECK(commands.size() == 1);
+}
@@ -0,0 +1,183 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "../Source/Material/SphereMapArray.h"
+#include "../Source/Material/ToonRampAtlas.h"
+
+namespace
+{
+	// 行の末尾にpadding分の余りを持つRGBA8画像
+	struct Image
+	{
+		uint32_t width;
+		uint32_t height;
+		size_t rowPitch;
+		std::vector<uint8_t> pixels;
+
+		Image(uint32_t w, uint32_t h, uint8_t value, size_t padding = 0)
+			: width(w), height(h), rowPitch(w * 4 + padding), pixels(rowPitch * h, 0xCD)
+		{
+			for (uint32_t y = 0; y < h; ++y)
+			{
+				for (uint32_t x = 0; x < w; ++x)
+				{
+					Set(x, y, value, 255);
+				}
+			}
+		}
+
+		void Set(uint32_t x, uint32_t y, uint8_t value, uint8_t alpha)
+		{
+			uint8_t* p = &pixels[rowPitch * y + x * 4];
+			p[0] = p[1] = p[2] = value;
+			p[3] = alpha;
+		}
+	};
+
+	// 上半分が白、下半分が灰色の2階調トゥーン
+	Image TwoToneToon(uint32_t size, size_t padding = 0)
+	{
+		Image image(size, size, 255, padding);
+		for (uint32_t y = size / 2; y < size; ++y)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				image.Set(x, y, 128, 255);
+			}
+		}
+		return image;
+	}
+
+	const uint8_t* Ramp(const ToonRampAtlas& atlas, uint32_t row)
+	{
+		return atlas.Pixels().data() + static_cast<size_t>(row) * ToonRampAtlas::RampWidth * 4;
+	}
+}
+
+TEST_CASE(ToonRampAtlas_ExtractsVerticalRamp)
+{
+	ToonRampAtlas atlas;
+	CHECK(atlas.Count() == 1);
+	CHECK(Ramp(atlas, ToonRampAtlas::DefaultRamp)[0] == 255);
+
+	Image toon = TwoToneToon(32);
+	uint32_t row = atlas.Add(toon.pixels.data(), toon.rowPitch, toon.width, toon.height);
+	CHECK(row == 1);
+	CHECK(atlas.Count() == 2);
+	CHECK(atlas.Pixels().size() == ToonRampAtlas::RampWidth * 4 * 2);
+
+	// v = 0が上端。明るい側から暗い側へ単調に変わる
+	const uint8_t* ramp = Ramp(atlas, row);
+	CHECK(ramp[0] == 255);
+	CHECK(ramp[(ToonRampAtlas::RampWidth - 1) * 4] == 128);
+	CHECK(ramp[3] == 255);
+
+	bool monotonic = true;
+	for (uint32_t i = 1; i < ToonRampAtlas::RampWidth; ++i)
+	{
+		monotonic = monotonic && ramp[i * 4] <= ramp[(i - 1) * 4];
+	}
+	CHECK(monotonic);
+
+	// 境目は真ん中(元の画素の中心の間で補間する)
+	CHECK(ramp[(ToonRampAtlas::RampWidth / 2 - 3) * 4] == 255);
+	CHECK(ramp[(ToonRampAtlas::RampWidth / 2 + 2) * 4] == 128);
+}
+
+TEST_CASE(ToonRampAtlas_AveragesRowsInLinearSpace)
+{
+	// 横に白黒が交互の行は、リニアで平均してsRGBの188になる
+	Image stripes(4, 2, 0);
+	for (uint32_t y = 0; y < 2; ++y)
+	{
+		stripes.Set(0, y, 255, 255);
+		stripes.Set(2, y, 255, 255);
+	}
+
+	uint8_t ramp[ToonRampAtlas::RampWidth * 4] = {};
+	ToonRampAtlas::ExtractRamp(stripes.pixels.data(), stripes.rowPitch, stripes.width, stripes.height, ramp);
+
+	CHECK(ramp[0] == 188);
+	CHECK(ramp[(ToonRampAtlas::RampWidth - 1) * 4 + 2] == 188);
+}
+
+TEST_CASE(ToonRampAtlas_DeduplicatesIdenticalRamps)
+{
+	ToonRampAtlas atlas;
+
+	Image toon = TwoToneToon(32);
+	Image padded = TwoToneToon(32, 12);
+	Image white(8, 8, 255);
+
+	uint32_t first = atlas.Add(toon.pixels.data(), toon.rowPitch, toon.width, toon.height);
+
+	// 行の間隔が違っても同じ階調なら同じ行
+	CHECK(atlas.Add(padded.pixels.data(), padded.rowPitch, padded.width, padded.height) == first);
+
+	// 白一色は最初からある白の行
+	CHECK(atlas.Add(white.pixels.data(), white.rowPitch, white.width, white.height) == ToonRampAtlas::DefaultRamp);
+
+	// 画像が無ければ白
+	CHECK(atlas.Add(nullptr, 0, 0, 0) == ToonRampAtlas::DefaultRamp);
+	CHECK(atlas.Count() == 2);
+
+	atlas.Clear();
+	CHECK(atlas.Count() == 1);
+}
+
+TEST_CASE(SphereMapArray_ResizesToCommonSize)
+{
+	SphereMapArray spheres(4);
+	CHECK(spheres.LayerCount() == 1);
+	CHECK(spheres.Layer(SphereMapArray::DefaultLayer)[0] == 255);
+
+	// 大きい単色は縮めても同じ色
+	Image large(64, 32, 100, 8);
+	uint32_t layer = spheres.Add(large.pixels.data(), large.rowPitch, large.width, large.height);
+	CHECK(layer == 1);
+	CHECK(spheres.Layer(layer).size() == 4 * 4 * 4);
+
+	bool flat = true;
+	for (size_t i = 0; i < spheres.Layer(layer).size(); i += 4)
+	{
+		flat = flat && spheres.Layer(layer)[i] == 100 && spheres.Layer(layer)[i + 3] == 255;
+	}
+	CHECK(flat);
+
+	// 左が黒、右が白の2x1を拡大すると、端はそのままで間は単調に明るくなる
+	Image edge(2, 1, 0);
+	edge.Set(1, 0, 255, 255);
+	layer = spheres.Add(edge.pixels.data(), edge.rowPitch, edge.width, edge.height);
+	CHECK(layer == 2);
+
+	const std::vector<uint8_t>& pixels = spheres.Layer(layer);
+	CHECK(pixels[0] == 0);
+	CHECK(pixels[3 * 4] == 255);
+	CHECK(pixels[1 * 4] < pixels[2 * 4]);
+
+	// 縦はどの行も同じ
+	CHECK(pixels[(3 * 4 + 1) * 4] == pixels[1 * 4]);
+}
+
+TEST_CASE(SphereMapArray_DeduplicatesLayers)
+{
+	SphereMapArray spheres(4);
+
+	// 大きさが違っても、そろえた結果が同じなら同じ層
+	Image a(16, 16, 100);
+	Image b(3, 5, 100);
+	Image c(4, 4, 50);
+
+	uint32_t layerA = spheres.Add(a.pixels.data(), a.rowPitch, a.width, a.height);
+	CHECK(spheres.Add(b.pixels.data(), b.rowPitch, b.width, b.height) == layerA);
+	CHECK(spheres.Add(c.pixels.data(), c.rowPitch, c.width, c.height) == layerA + 1);
+	CHECK(spheres.LayerCount() == 3);
+
+	Image white(2, 2, 255);
+	CHECK(spheres.Add(white.pixels.data(), white.rowPitch, white.width, white.height) == SphereMapArray::DefaultLayer);
+
+	spheres.Clear();
+	CHECK(spheres.LayerCount() == 1);
+}
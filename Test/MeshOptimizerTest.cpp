@@ -0,0 +1,154 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../Source/MeshOptimizer/MeshOptimizer.h"
+
+namespace
+{
+	const uint32_t GridSize = 64;
+
+	struct GridVertex
+	{
+		float x;
+		float y;
+	};
+
+	// GridSize×GridSizeの格子を2三角形ずつに分け、三角形の順番をばらばらにする
+	void MakeShuffledGrid(std::vector<uint8_t>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<GridVertex> grid;
+		for (uint32_t y = 0; y <= GridSize; ++y)
+		{
+			for (uint32_t x = 0; x <= GridSize; ++x)
+			{
+				grid.push_back({ static_cast<float>(x), static_cast<float>(y) });
+			}
+		}
+
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (uint32_t y = 0; y < GridSize; ++y)
+		{
+			for (uint32_t x = 0; x < GridSize; ++x)
+			{
+				uint32_t v0 = y * (GridSize + 1) + x;
+				uint32_t v1 = v0 + 1;
+				uint32_t v2 = v0 + GridSize + 1;
+				uint32_t v3 = v2 + 1;
+				triangles.push_back({ v0, v2, v1 });
+				triangles.push_back({ v1, v2, v3 });
+			}
+		}
+
+		std::mt19937 random(5);
+		std::shuffle(triangles.begin(), triangles.end(), random);
+
+		indices.clear();
+		for (const auto& triangle : triangles)
+		{
+			indices.insert(indices.end(), triangle.begin(), triangle.end());
+		}
+
+		vertices.resize(grid.size() * sizeof(GridVertex));
+		std::memcpy(vertices.data(), grid.data(), vertices.size());
+	}
+
+	// 頂点の中身で三角形を表し、並べ替えの前後で同じ集合か比べる
+	std::vector<std::array<float, 6>> TriangleSet(const std::vector<uint8_t>& vertices, const std::vector<uint32_t>& indices)
+	{
+		const GridVertex* grid = reinterpret_cast<const GridVertex*>(vertices.data());
+
+		std::vector<std::array<float, 6>> set;
+		for (size_t idx = 0; idx + 2 < indices.size(); idx += 3)
+		{
+			// 巻き順は保ったまま、先頭が最小になるよう回す
+			std::array<GridVertex, 3> corners = { grid[indices[idx]], grid[indices[idx + 1]], grid[indices[idx + 2]] };
+			auto less = [](const GridVertex& a, const GridVertex& b) { return a.y < b.y || (a.y == b.y && a.x < b.x); };
+			std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end(), less), corners.end());
+
+			set.push_back({ corners[0].x, corners[0].y, corners[1].x, corners[1].y, corners[2].x, corners[2].y });
+		}
+
+		std::sort(set.begin(), set.end());
+		return set;
+	}
+}
+
+TEST_CASE(MeshOptimizer_AcmrGoesDownOnShuffledGrid)
+{
+	std::vector<uint8_t> vertices;
+	std::vector<uint32_t> indices;
+	MakeShuffledGrid(vertices, indices);
+
+	auto before = TriangleSet(vertices, indices);
+
+	std::vector<MeshSubset> subsets(1);
+	subsets[0].indexCount = static_cast<uint32_t>(indices.size());
+
+	MeshOptimizeStats stats = MeshOptimizer::Optimize(vertices, sizeof(GridVertex), indices, subsets);
+
+	// ばらばらの順では三角形ごとにほぼ頂点を全部読み直す(理想の格子は0.5付近)
+	CHECK(stats.acmrBefore > 2.0F);
+	CHECK(stats.acmrAfter < 1.0F);
+	CHECK(stats.acmrAfter < stats.acmrBefore);
+
+	// 並べ替えても同じ三角形(巻き順込み)が残る
+	CHECK(TriangleSet(vertices, indices) == before);
+
+	// 頂点フェッチの最適化後は、初出の頂点番号が0から順に現れる
+	uint32_t nextNew = 0;
+	bool firstUseOrder = true;
+	for (uint32_t index : indices)
+	{
+		if (index == nextNew)
+		{
+			++nextNew;
+		}
+		else if (index > nextNew)
+		{
+			firstUseOrder = false;
+		}
+	}
+	CHECK(firstUseOrder);
+
+	CHECK(subsets[0].baseVertex == 0);
+	CHECK(!subsets[0].index32);
+	CHECK(stats.index16SubsetCount == 1);
+}
+
+TEST_CASE(MeshOptimizer_SubsetsKeepTheirTriangles)
+{
+	std::vector<uint8_t> vertices;
+	std::vector<uint32_t> indices;
+	MakeShuffledGrid(vertices, indices);
+
+	// 前半と後半を別マテリアルにする
+	std::vector<MeshSubset> subsets(2);
+	uint32_t half = static_cast<uint32_t>(indices.size() / 6) * 3;
+	subsets[0].indexCount = half;
+	subsets[1].indexOffset = half;
+	subsets[1].indexCount = static_cast<uint32_t>(indices.size()) - half;
+
+	std::vector<uint32_t> firstHalf(indices.begin(), indices.begin() + half);
+	auto firstBefore = TriangleSet(vertices, firstHalf);
+
+	MeshOptimizer::Optimize(vertices, sizeof(GridVertex), indices, subsets);
+
+	std::vector<uint32_t> firstAfter(indices.begin(), indices.begin() + half);
+	CHECK(TriangleSet(vertices, firstAfter) == firstBefore);
+
+	// 相対インデックスはbaseVertexを足すと元に戻る
+	std::vector<uint16_t> index16 = MeshOptimizer::ToIndex16(indices, subsets[1]);
+	CHECK(index16.size() == subsets[1].indexCount);
+	bool rebased = true;
+	for (size_t idx = 0; idx < index16.size(); ++idx)
+	{
+		rebased = rebased && index16[idx] + subsets[1].baseVertex == indices[subsets[1].indexOffset + idx];
+	}
+	CHECK(rebased);
+}
@@ -0,0 +1,160 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../Source/Texture/MipGenerator.h"
+
+namespace
+{
+	MipLevel MakeLevel(uint32_t width, uint32_t height, uint8_t value)
+	{
+		MipLevel level;
+		level.width = width;
+		level.height = height;
+		level.pixels.assign(static_cast<size_t>(width) * height * 4, value);
+		return level;
+	}
+
+	void SetPixel(MipLevel& level, uint32_t x, uint32_t y, uint8_t value)
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			level.pixels[(static_cast<size_t>(y) * level.width + x) * 4 + c] = value;
+		}
+	}
+
+	uint8_t Pixel(const MipLevel& level, uint32_t x, uint32_t y, uint32_t channel)
+	{
+		return level.pixels[(static_cast<size_t>(y) * level.width + x) * 4 + channel];
+	}
+}
+
+TEST_CASE(MipGenerator_SrgbRoundTripAndReference)
+{
+	// 8ビットの値は全てリニアを経由しても元に戻る
+	bool roundTrip = true;
+	for (int value = 0; value < 256; ++value)
+	{
+		roundTrip = roundTrip && MipGenerator::LinearToSrgb(MipGenerator::SrgbToLinear(static_cast<uint8_t>(value))) == value;
+	}
+	CHECK(roundTrip);
+
+	// 表引きのエンコードがpowで計算した最も近い値と一致する
+	int mismatches = 0;
+	for (int i = 0; i <= 10000; ++i)
+	{
+		double linear = i / 10000.0;
+		double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+		int expected = static_cast<int>(std::lround(srgb * 255.0));
+
+		if (MipGenerator::LinearToSrgb(static_cast<float>(linear)) != expected)
+		{
+			++mismatches;
+		}
+	}
+	CHECK(mismatches == 0);
+
+	CHECK(MipGenerator::LinearToSrgb(-1.0F) == 0);
+	CHECK(MipGenerator::LinearToSrgb(2.0F) == 255);
+}
+
+TEST_CASE(MipGenerator_CheckerboardAveragesInLinearSpace)
+{
+	MipLevel checker = MakeLevel(2, 2, 0);
+	SetPixel(checker, 0, 0, 255);
+	SetPixel(checker, 1, 1, 255);
+
+	MipLevel srgb;
+	MipGenerator::Downsample(checker, MipColorSpace::Srgb, srgb);
+
+	// 白黒半々はリニアで0.5、sRGBでは188(128にすると暗くなる)
+	CHECK(srgb.width == 1 && srgb.height == 1);
+	CHECK(Pixel(srgb, 0, 0, 0) == 188);
+	CHECK(Pixel(srgb, 0, 0, 1) == 188);
+	CHECK(Pixel(srgb, 0, 0, 2) == 188);
+
+	// アルファはsRGBでもそのまま平均する
+	CHECK(Pixel(srgb, 0, 0, 3) == 128);
+
+	MipLevel linear;
+	MipGenerator::Downsample(checker, MipColorSpace::Linear, linear);
+	CHECK(Pixel(linear, 0, 0, 0) == 128);
+}
+
+TEST_CASE(MipGenerator_OddSizesUseCoverageWeights)
+{
+	// 幅5 -> 2。出力0は元の[0, 2.5)、出力1は[2.5, 5)を覆う(重み0.4, 0.4, 0.2)
+	MipLevel row = MakeLevel(5, 1, 0);
+	SetPixel(row, 2, 0, 255);
+
+	MipLevel half;
+	MipGenerator::Downsample(row, MipColorSpace::Linear, half);
+
+	// 真ん中の画素は両方に同じだけ入り、左右にずれない
+	CHECK(half.width == 2 && half.height == 1);
+	CHECK(Pixel(half, 0, 0, 0) == 51);
+	CHECK(Pixel(half, 1, 0, 0) == 51);
+
+	// 3x3 -> 1x1は9画素の平均
+	MipLevel square = MakeLevel(3, 3, 0);
+	SetPixel(square, 1, 1, 255);
+	MipLevel one;
+	MipGenerator::Downsample(square, MipColorSpace::Linear, one);
+	CHECK(Pixel(one, 0, 0, 0) == 28);
+
+	// 重みの合計は1なので、単色は奇数の大きさでも色が変わらない
+	MipLevel flat = MakeLevel(7, 5, 200);
+	MipLevel flatHalf;
+	MipGenerator::Downsample(flat, MipColorSpace::Srgb, flatHalf);
+
+	bool unchanged = flatHalf.width == 3 && flatHalf.height == 2;
+	for (uint8_t value : flatHalf.pixels)
+	{
+		unchanged = unchanged && value == 200;
+	}
+	CHECK(unchanged);
+}
+
+TEST_CASE(MipGenerator_ChainSizesAndRowPitch)
+{
+	CHECK(MipGenerator::MipCount(1, 1) == 1);
+	CHECK(MipGenerator::MipCount(256, 256) == 9);
+	CHECK(MipGenerator::MipCount(640, 480) == 10);
+	CHECK(MipGenerator::MipCount(5, 3) == 3);
+
+	// 行の末尾に余りがある画像(WICのストライド等)
+	const uint32_t width = 5;
+	const uint32_t height = 3;
+	const size_t rowPitch = 32;
+	std::vector<uint8_t> pixels(rowPitch * height, 0xEE);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		for (uint32_t x = 0; x < width * 4; ++x)
+		{
+			pixels[rowPitch * y + x] = 100;
+		}
+	}
+
+	std::vector<MipLevel> levels;
+	CHECK(MipGenerator::Generate(pixels.data(), rowPitch, width, height, MipColorSpace::Srgb, levels));
+	CHECK(levels.size() == 3);
+	if (levels.size() == 3)
+	{
+		CHECK(levels[0].width == 5 && levels[0].height == 3);
+		CHECK(levels[1].width == 2 && levels[1].height == 1);
+		CHECK(levels[2].width == 1 && levels[2].height == 1);
+
+		// 余りの0xEEは混ざらない
+		CHECK(levels[0].pixels.size() == width * height * 4);
+		CHECK(Pixel(levels[2], 0, 0, 0) == 100);
+	}
+
+	CHECK(MipGenerator::Generate(pixels.data(), rowPitch, width, height, MipColorSpace::Srgb, levels, 2));
+	CHECK(levels.size() == 2);
+
+	// 行の間隔が幅より短いものは受け付けない
+	CHECK(!MipGenerator::Generate(pixels.data(), 8, width, height, MipColorSpace::Srgb, levels));
+	CHECK(levels.empty());
+}
@@ -0,0 +1,427 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../Source/Motion/BakedMotionReader.h"
+#include "../Source/Motion/MotionBaker.h"
+#include "../Source/Motion/MotionBinding.h"
+#include "../Source/Motion/MotionSampler.h"
+#include "../Source/Motion/Skeleton.h"
+#include "../Source/Motion/VmdMotion.h"
+
+namespace
+{
+	// Shift-JISの名前(ソースの文字コードに依らないようにバイトで書く)
+	const std::string Center = "\x83\x5A\x83\x93\x83\x5E\x81\x5B";	// センター
+	const std::string LeftArm = "\x8D\xB6\x98\x72";					// 左腕
+	const std::string RightArm = "\x89\x45\x98\x72";				// 右腕
+	const std::string MouthA = "\x82\xA0";							// あ
+
+	// 直線の補間曲線
+	const uint8_t LinearCurve[4] = { 20, 20, 107, 107 };
+
+	// テスト用のVMDをメモリ上に組み立てる
+	class VmdBuilder
+	{
+	public:
+
+		VmdBuilder()
+		{
+			Name("Vocaloid Motion Data 0002", 30);
+			Name("model", VmdMotion::ModelNameLength);
+		}
+
+		void AddBone(const std::string& name, uint32_t frame, const Float3& position, const Float4& rotation, const uint8_t curve[4])
+		{
+			uint8_t interpolation[64] = {};
+			for (int channel = 0; channel < 4; ++channel)
+			{
+				for (int i = 0; i < 4; ++i)
+				{
+					interpolation[channel + i * 4] = curve[i];
+				}
+			}
+
+			mBones.push_back(name);
+			Append(mBoneBytes, name, frame, &position, sizeof(position));
+			mBoneBytes.insert(mBoneBytes.end(), reinterpret_cast<const uint8_t*>(&rotation), reinterpret_cast<const uint8_t*>(&rotation) + sizeof(rotation));
+			mBoneBytes.insert(mBoneBytes.end(), interpolation, interpolation + sizeof(interpolation));
+			++mBoneCount;
+		}
+
+		void AddMorph(const std::string& name, uint32_t frame, float weight)
+		{
+			Append(mMorphBytes, name, frame, &weight, sizeof(weight));
+			++mMorphCount;
+		}
+
+		std::vector<uint8_t> Build() const
+		{
+			std::vector<uint8_t> data = mHeader;
+			Count(data, mBoneCount);
+			data.insert(data.end(), mBoneBytes.begin(), mBoneBytes.end());
+			Count(data, mMorphCount);
+			data.insert(data.end(), mMorphBytes.begin(), mMorphBytes.end());
+			return data;
+		}
+
+	private:
+
+		void Name(const std::string& name, size_t length)
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				mHeader.push_back(i < name.size() ? static_cast<uint8_t>(name[i]) : 0);
+			}
+		}
+
+		static void Append(std::vector<uint8_t>& out, const std::string& name, uint32_t frame, const void* value, size_t size)
+		{
+			for (size_t i = 0; i < VmdMotion::BoneNameLength; ++i)
+			{
+				out.push_back(i < name.size() ? static_cast<uint8_t>(name[i]) : 0);
+			}
+
+			const uint8_t* frameBytes = reinterpret_cast<const uint8_t*>(&frame);
+			out.insert(out.end(), frameBytes, frameBytes + sizeof(frame));
+
+			const uint8_t* valueBytes = static_cast<const uint8_t*>(value);
+			out.insert(out.end(), valueBytes, valueBytes + size);
+		}
+
+		static void Count(std::vector<uint8_t>& out, uint32_t count)
+		{
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&count);
+			out.insert(out.end(), bytes, bytes + sizeof(count));
+		}
+
+		std::vector<uint8_t> mHeader;
+		std::vector<std::string> mBones;
+		std::vector<uint8_t> mBoneBytes;
+		std::vector<uint8_t> mMorphBytes;
+		uint32_t mBoneCount = 0;
+		uint32_t mMorphCount = 0;
+	};
+
+	const Float4 IdentityRotation = { 0.0F, 0.0F, 0.0F, 1.0F };
+
+	// ベジェの媒介変数を細かく刻んで、xに一番近い点のyを返す
+	float ReferenceBezier(float x, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+	{
+		auto bezier = [](float p1, float p2, float t)
+		{
+			float s = 1.0F - t;
+			return 3.0F * s * s * t * p1 + 3.0F * s * t * t * p2 + t * t * t;
+		};
+
+		float bestT = 0.0F;
+		float bestError = 2.0F;
+		for (int i = 0; i <= 100000; ++i)
+		{
+			float t = i / 100000.0F;
+			float error = std::abs(bezier(x1 / 127.0F, x2 / 127.0F, t) - x);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestT = t;
+			}
+		}
+
+		return bezier(y1 / 127.0F, y2 / 127.0F, bestT);
+	}
+}
+
+TEST_CASE(Motion_BezierCurve)
+{
+	// 直線と端点
+	CHECK_NEAR(MotionSampler::EvaluateBezier(0.3F, 20, 20, 107, 107), 0.3F, 1.0e-6F);
+	CHECK_NEAR(MotionSampler::EvaluateBezier(0.0F, 127, 0, 0, 127), 0.0F, 1.0e-4F);
+	CHECK_NEAR(MotionSampler::EvaluateBezier(1.0F, 127, 0, 0, 127), 1.0F, 1.0e-4F);
+
+	// 緩急の曲線は点対称で、前半は遅い
+	float quarter = MotionSampler::EvaluateBezier(0.25F, 127, 0, 0, 127);
+	CHECK_NEAR(MotionSampler::EvaluateBezier(0.5F, 127, 0, 0, 127), 0.5F, 1.0e-4F);
+	CHECK_NEAR(quarter + MotionSampler::EvaluateBezier(0.75F, 127, 0, 0, 127), 1.0F, 1.0e-4F);
+	CHECK(quarter < 0.25F);
+
+	// 総当たりで求めた値と一致し、単調に増える
+	// (127,0,0,127)はx(t)の傾きが途中で0になり、総当たりの方が誤差が大きいので除く
+	const uint8_t curves[][4] = { { 100, 10, 30, 120 }, { 64, 0, 64, 127 }, { 10, 100, 30, 127 }, { 0, 127, 127, 0 } };
+	for (const auto& curve : curves)
+	{
+		float previous = 0.0F;
+		bool monotonic = true;
+
+		for (int i = 0; i <= 20; ++i)
+		{
+			float x = i / 20.0F;
+			float y = MotionSampler::EvaluateBezier(x, curve[0], curve[1], curve[2], curve[3]);
+
+			CHECK_NEAR(y, ReferenceBezier(x, curve[0], curve[1], curve[2], curve[3]), 1.0e-3F);
+			monotonic = monotonic && y >= previous - 1.0e-5F;
+			previous = y;
+		}
+
+		CHECK(monotonic);
+	}
+}
+
+TEST_CASE(Motion_SlerpStaysNormalized)
+{
+	// ほぼ同じ向き(線形補間になる)でも長さは1のまま
+	const Float4 a = { 0.0F, 0.0F, 0.0F, 1.0F };
+	const Float4 b = { 0.0F, std::sin(0.002F), 0.0F, std::cos(0.002F) };
+
+	for (float t : { 0.25F, 0.5F, 0.75F })
+	{
+		Float4 q = Math::Slerp(a, b, t);
+		CHECK_NEAR(Math::Dot(q, q), 1.0F, 1.0e-6F);
+		CHECK_NEAR(q.y, std::sin(0.002F * t), 1.0e-6F);
+	}
+
+	// -bはbと同じ回転なので、短い方の弧を通る
+	const Float4 c = { 0.0F, 0.70710678F, 0.0F, 0.70710678F };
+	const Float4 negativeC = { -c.x, -c.y, -c.z, -c.w };
+	Float4 q = Math::Slerp(a, negativeC, 0.5F);
+	CHECK_NEAR(std::abs(q.y), std::sin(3.14159265F / 8.0F), 1.0e-5F);
+	CHECK_NEAR(std::abs(q.w), std::cos(3.14159265F / 8.0F), 1.0e-5F);
+}
+
+TEST_CASE(Motion_BindsTracksByNameAndCaches)
+{
+	Skeleton skeleton;
+	int center = skeleton.AddBone(Center, -1);
+	int leftArm = skeleton.AddBone(LeftArm, center);
+	int mouthA = skeleton.AddMorph(MouthA);
+
+	VmdBuilder builder;
+	builder.AddBone(LeftArm, 0, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddBone(RightArm, 0, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddBone(Center, 0, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddBone(LeftArm, 5, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddMorph(MouthA, 0, 1.0F);
+
+	std::vector<uint8_t> data = builder.Build();
+	VmdMotion motion;
+	CHECK(motion.LoadFromMemory(data.data(), data.size()));
+	CHECK(motion.ModelName() == "model");
+	CHECK(motion.LastFrame() == 5);
+
+	// 同じ名前のキーは1つのトラックにまとまる
+	CHECK(motion.BoneTracks().size() == 3);
+	CHECK(motion.BoneTracks()[0].keys.size() == 2);
+
+	MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+	CHECK(binding.boneTargets.size() == 3);
+	CHECK(binding.boneTargets[0] == leftArm);
+	CHECK(binding.boneTargets[1] == -1);
+	CHECK(binding.boneTargets[2] == center);
+	CHECK(binding.unresolvedBones == 1);
+	CHECK(binding.morphTargets.size() == 1 && binding.morphTargets[0] == mouthA);
+	CHECK(binding.unresolvedMorphs == 0);
+
+	// 同じ組は照合し直さない
+	MotionBindingCache cache;
+	auto first = cache.Get(skeleton, motion);
+	CHECK(cache.Get(skeleton, motion) == first);
+	CHECK(cache.Size() == 1);
+
+	// 同じ中身を読み直したモーションも同じ組
+	VmdMotion reloaded;
+	CHECK(reloaded.LoadFromMemory(data.data(), data.size()));
+	CHECK(reloaded.Hash() == motion.Hash());
+	CHECK(cache.Get(skeleton, reloaded) == first);
+
+	// 構成が違うモデルは別の組
+	Skeleton other = skeleton;
+	other.AddBone(RightArm, center);
+	CHECK(other.Hash() != skeleton.Hash());
+
+	auto second = cache.Get(other, motion);
+	CHECK(second != first);
+	CHECK(second->boneTargets[1] == 2);
+	CHECK(cache.Size() == 2);
+}
+
+TEST_CASE(Motion_TruncatesShiftJisNames)
+{
+	// 「右」を8文字並べた16バイトの名前は、VMDには2バイト文字の途中で切った15バイトで入る
+	std::string longName;
+	for (int i = 0; i < 8; ++i)
+	{
+		longName += "\x89\x45";
+	}
+
+	Skeleton skeleton;
+	skeleton.AddBone(Center, -1);
+	int longBone = skeleton.AddBone(longName, 0);
+
+	VmdBuilder builder;
+	builder.AddBone(longName.substr(0, VmdMotion::BoneNameLength), 0, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+
+	std::vector<uint8_t> data = builder.Build();
+	VmdMotion motion;
+	CHECK(motion.LoadFromMemory(data.data(), data.size()));
+	CHECK(motion.BoneTracks()[0].name.size() == VmdMotion::BoneNameLength);
+
+	MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+	CHECK(binding.boneTargets[0] == longBone);
+	CHECK(binding.unresolvedBones == 0);
+
+	// 名前欄は最初の0まで。2バイト目が0x5C(ソ)でも切れない
+	const char field[VmdMotion::BoneNameLength] = { '\x83', '\x5C', '\x82', '\xA0', '\0', 'x', 'y' };
+	CHECK(VmdMotion::ReadName(field, sizeof(field)) == std::string("\x83\x5C\x82\xA0"));
+
+	// 0が無ければ欄いっぱい
+	CHECK(VmdMotion::ReadName(longName.data(), VmdMotion::BoneNameLength).size() == VmdMotion::BoneNameLength);
+}
+
+TEST_CASE(Motion_SamplesBetweenKeys)
+{
+	Skeleton skeleton;
+	int center = skeleton.AddBone(Center, -1);
+	int leftArm = skeleton.AddBone(LeftArm, center);
+	int mouthA = skeleton.AddMorph(MouthA);
+
+	// Y軸回りに90度
+	const float half = 0.70710678F;
+	const Float4 quarterTurn = { 0.0F, half, 0.0F, half };
+
+	// ファイル上は順不同でも、読み込み後はフレーム順
+	VmdBuilder builder;
+	builder.AddBone(Center, 10, { 10.0F, 0.0F, -4.0F }, quarterTurn, LinearCurve);
+	builder.AddBone(Center, 0, { 0.0F, 2.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddMorph(MouthA, 0, 0.0F);
+	builder.AddMorph(MouthA, 10, 1.0F);
+
+	std::vector<uint8_t> data = builder.Build();
+	VmdMotion motion;
+	CHECK(motion.LoadFromMemory(data.data(), data.size()));
+
+	MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+
+	skeleton.LocalTranslations()[leftArm] = { 1.0F, 1.0F, 1.0F };
+	MotionSampler::Sample(motion, binding, 5.0F, skeleton);
+
+	const Float3& position = skeleton.LocalTranslations()[center];
+	CHECK_NEAR(position.x, 5.0F, 1.0e-4F);
+	CHECK_NEAR(position.y, 1.0F, 1.0e-4F);
+	CHECK_NEAR(position.z, -2.0F, 1.0e-4F);
+
+	// 45度
+	const Float4& rotation = skeleton.LocalRotations()[center];
+	CHECK_NEAR(rotation.y, std::sin(3.14159265F / 8.0F), 1.0e-4F);
+	CHECK_NEAR(rotation.w, std::cos(3.14159265F / 8.0F), 1.0e-4F);
+	CHECK_NEAR(skeleton.MorphWeights()[mouthA], 0.5F, 1.0e-5F);
+
+	// バインドされていないボーンは書き換えない
+	CHECK(skeleton.LocalTranslations()[leftArm].x == 1.0F);
+
+	// 範囲外は端のキー
+	MotionSampler::Sample(motion, binding, 30.0F, skeleton);
+	CHECK_NEAR(skeleton.LocalTranslations()[center].x, 10.0F, 1.0e-6F);
+	CHECK_NEAR(skeleton.LocalRotations()[center].y, half, 1.0e-6F);
+	CHECK_NEAR(skeleton.MorphWeights()[mouthA], 1.0F, 1.0e-6F);
+
+	skeleton.ResetPose();
+	CHECK(skeleton.LocalTranslations()[leftArm].x == 0.0F);
+	CHECK(skeleton.LocalRotations()[center].w == 1.0F);
+	CHECK(skeleton.MorphWeights()[mouthA] == 0.0F);
+}
+
+TEST_CASE(Motion_BakedFileMatchesVmd)
+{
+	const float half = 0.70710678F;
+	const uint8_t easeCurve[4] = { 127, 0, 0, 127 };
+
+	VmdBuilder builder;
+	builder.AddBone(Center, 0, { 0.0F, 0.0F, 0.0F }, IdentityRotation, LinearCurve);
+	builder.AddBone(Center, 30, { 8.0F, 2.0F, 0.0F }, { 0.0F, half, 0.0F, half }, easeCurve);
+	builder.AddBone(Center, 60, { 8.0F, 2.0F, 0.0F }, { 0.0F, half, 0.0F, half }, LinearCurve);
+	builder.AddBone(LeftArm, 0, { 0.0F, 0.0F, 0.0F }, { half, 0.0F, 0.0F, half }, LinearCurve);
+	builder.AddMorph(MouthA, 10, 0.0F);
+	builder.AddMorph(MouthA, 20, 1.0F);
+
+	std::vector<uint8_t> data = builder.Build();
+	VmdMotion motion;
+	CHECK(motion.LoadFromMemory(data.data(), data.size()));
+
+	// モデルが無いのでトラック名からスケルトンを作る
+	Skeleton skeleton = Skeleton::FromMotion(motion);
+	CHECK(skeleton.BoneCount() == 2 && skeleton.MorphCount() == 1);
+	CHECK(skeleton.FindBone(Center) == 0);
+	CHECK(skeleton.FindBone(RightArm) == -1);
+	CHECK(Skeleton::FromMotion(motion).Hash() == skeleton.Hash());
+
+	MotionBinding binding = MotionBindingCache::Bind(skeleton, motion);
+	MotionBakeSettings settings;
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "MotionTest.bmot";
+	MotionBakeReport report;
+	CHECK(MotionBaker::BakeToFile(motion, skeleton, binding, settings, path.string(), &report));
+	CHECK(report.frameCount == 61);
+	CHECK(report.bakedBytes < report.rawBytes);
+	CHECK(report.maxRotationError <= settings.rotationError);
+
+	BakedMotionReader reader;
+	CHECK(reader.Open(path.string()));
+	CHECK(reader.FrameCount() == 61);
+	CHECK(reader.SkeletonHash() == skeleton.Hash());
+	CHECK(reader.MotionHash() == motion.Hash());
+
+	// 順に再生しても、巻き戻しても、整数フレームでは元のVMDとの差が許した誤差に収まる
+	Skeleton baked = skeleton;
+	Skeleton reference = skeleton;
+
+	float maxPosition = 0.0F;
+	float maxWeight = 0.0F;
+	float minDot = 1.0F;
+	bool sampled = true;
+
+	for (float frame : { 0.0F, 5.0F, 12.0F, 15.0F, 29.0F, 45.0F, 60.0F, 3.0F, 31.0F })
+	{
+		sampled = sampled && reader.Sample(frame, baked);
+		MotionSampler::Sample(motion, binding, frame, reference);
+
+		for (size_t b = 0; b < skeleton.BoneCount(); ++b)
+		{
+			Float3 delta = Math::Subtract(baked.LocalTranslations()[b], reference.LocalTranslations()[b]);
+			maxPosition = std::max(maxPosition, Math::Length(delta));
+			minDot = std::min(minDot, std::abs(Math::Dot(baked.LocalRotations()[b], reference.LocalRotations()[b])));
+		}
+
+		maxWeight = std::max(maxWeight, std::abs(baked.MorphWeights()[0] - reference.MorphWeights()[0]));
+	}
+
+	CHECK(sampled);
+	CHECK(maxPosition <= settings.translationError * 1.01F);
+	CHECK(maxWeight <= settings.morphError * 1.01F);
+	CHECK(2.0F * std::acos(std::min(minDot, 1.0F)) <= settings.rotationError * 1.01F);
+
+	// 別のスケルトンには書き込まない
+	Skeleton other = skeleton;
+	other.AddBone(RightArm, -1);
+	CHECK(!reader.Sample(0.0F, other));
+
+	reader.Close();
+	CHECK(!reader.IsOpen());
+
+	// 途中で切れたファイルは開かない
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		std::vector<uint8_t> bytes;
+		MotionBaker::Bake(motion, skeleton, binding, settings, bytes);
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size() - 2));
+	}
+	CHECK(!reader.Open(path.string()));
+
+	std::filesystem::remove(path);
+	CHECK(!reader.Open(path.string()));
+}
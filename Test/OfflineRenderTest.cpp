@@ -0,0 +1,249 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Source/OfflineRender/FrameEncoder.h"
+
+namespace
+{
+	// D3Dの読み戻しバッファの代わり。行の間隔は読み戻しと同じ256バイト境界にする
+	// GPUのコピーの代わりに、AcquireSlotで取ったスロットをテストが直接塗る
+	class FakeReadback
+	{
+	public:
+
+		static const size_t RowPitch = 256;
+
+		FakeReadback(uint32_t slotCount, uint32_t height) : mSlots(slotCount, std::vector<uint8_t>(RowPitch * height)) {}
+
+		void Fill(uint32_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+		{
+			std::vector<uint8_t>& pixels = mSlots[slot];
+			for (size_t i = 0; i + 3 < pixels.size(); i += 4)
+			{
+				pixels[i + 0] = r;
+				pixels[i + 1] = g;
+				pixels[i + 2] = b;
+				pixels[i + 3] = a;
+			}
+		}
+
+		// trueにするまでReadは戻らない(GPUのコピーが終わらない状態)
+		void Hold(bool hold)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mHold = hold;
+			}
+			mCondition.notify_all();
+		}
+
+		// 変換の終わる順をばらけさせる
+		void SetDelay(bool delay) { mDelay = delay; }
+
+		FrameEncoder::ReadbackFunction Function()
+		{
+			return [this](uint32_t slot, uint64_t fenceValue)
+			{
+				++mReads;
+
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this] { return !mHold; });
+				lock.unlock();
+
+				if (mDelay)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds((fenceValue * 7) % 4));
+				}
+
+				return static_cast<const uint8_t*>(mSlots[slot].data());
+			};
+		}
+
+		uint32_t Reads() const { return mReads; }
+
+	private:
+
+		std::vector<std::vector<uint8_t>> mSlots;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		bool mHold = false;
+		bool mDelay = false;
+		std::atomic<uint32_t> mReads{ 0 };
+	};
+
+	std::string TempFile(const char* name)
+	{
+		return (std::filesystem::temp_directory_path() / name).generic_string();
+	}
+
+	std::vector<uint8_t> ReadFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	OfflineRenderSettings MakeSettings(const std::string& path, VideoFormat format, uint32_t slots, uint32_t workers)
+	{
+		OfflineRenderSettings settings;
+		settings.path = path;
+		settings.format = format;
+		settings.framesPerSecond = 30;
+		settings.readbackSlots = slots;
+		settings.workerCount = workers;
+		return settings;
+	}
+}
+
+TEST_CASE(OfflineRender_Y4mHeaderAndFrameChunks)
+{
+	const std::string path = TempFile("OfflineRenderTest.y4m");
+	const uint32_t width = 5;
+	const uint32_t height = 3;
+
+	FakeReadback readback(2, height);
+	{
+		FrameEncoder encoder;
+		CHECK(encoder.Start(MakeSettings(path, VideoFormat::Y4m, 2, 1), width, height, FakeReadback::RowPitch, readback.Function()));
+
+		// 白、黒の順
+		for (uint8_t value : { 255, 0 })
+		{
+			uint32_t slot = encoder.AcquireSlot();
+			readback.Fill(slot, value, value, value, 255);
+			encoder.Submit(slot, 0);
+		}
+
+		encoder.Finish();
+		CHECK(encoder.SubmittedFrames() == 2);
+	}
+
+	std::vector<uint8_t> file = ReadFile(path);
+	std::filesystem::remove(path);
+
+	const std::string header = "YUV4MPEG2 W5 H3 F30:1 Ip A1:1 C420jpeg\n";
+	CHECK(file.size() >= header.size());
+	CHECK(std::string(file.begin(), file.begin() + header.size()) == header);
+
+	// 輝度5x3、色差は切り上げて3x2が2面
+	const size_t lumaBytes = 15;
+	const size_t chromaBytes = 6;
+	const size_t frameBytes = 6 + lumaBytes + chromaBytes * 2;
+	CHECK(VideoWriter::FrameSize(VideoFormat::Y4m, width, height) == lumaBytes + chromaBytes * 2);
+	CHECK(file.size() == header.size() + frameBytes * 2);
+
+	const uint8_t expectedY[2] = { 255, 0 };
+	for (size_t frame = 0; frame < 2 && file.size() == header.size() + frameBytes * 2; ++frame)
+	{
+		size_t offset = header.size() + frameBytes * frame;
+		CHECK(std::string(file.begin() + offset, file.begin() + offset + 6) == "FRAME\n");
+
+		const uint8_t* planeY = file.data() + offset + 6;
+		const uint8_t* planeU = planeY + lumaBytes;
+		const uint8_t* planeV = planeU + chromaBytes;
+
+		// 灰色は色差が中央(128)になる
+		CHECK(planeY[0] == expectedY[frame] && planeY[lumaBytes - 1] == expectedY[frame]);
+		CHECK(planeU[0] == 128 && planeU[chromaBytes - 1] == 128);
+		CHECK(planeV[0] == 128 && planeV[chromaBytes - 1] == 128);
+	}
+}
+
+TEST_CASE(OfflineRender_FramesStayInOrderWithSeveralWorkers)
+{
+	const std::string path = TempFile("OfflineRenderTest.raw");
+	const uint32_t width = 4;
+	const uint32_t height = 2;
+	const uint32_t frameCount = 24;
+
+	FakeReadback readback(3, height);
+	readback.SetDelay(true);
+	{
+		FrameEncoder encoder;
+		CHECK(encoder.Start(MakeSettings(path, VideoFormat::Raw, 3, 4), width, height, FakeReadback::RowPitch, readback.Function()));
+
+		for (uint32_t frame = 0; frame < frameCount; ++frame)
+		{
+			uint32_t slot = encoder.AcquireSlot();
+			uint8_t value = static_cast<uint8_t>(frame);
+			readback.Fill(slot, value, value, value, value);
+			encoder.Submit(slot, frame);
+		}
+
+		encoder.Finish();
+	}
+
+	CHECK(readback.Reads() == frameCount);
+
+	std::vector<uint8_t> file = ReadFile(path);
+	std::filesystem::remove(path);
+
+	// Rawは行を詰めたRGBA8だけ。変換の終わる順に関係なく、積んだ順に並ぶ
+	const size_t frameBytes = width * height * 4;
+	CHECK(file.size() == frameBytes * frameCount);
+
+	bool ordered = file.size() == frameBytes * frameCount;
+	for (size_t i = 0; ordered && i < file.size(); ++i)
+	{
+		ordered = file[i] == i / frameBytes;
+	}
+	CHECK(ordered);
+}
+
+TEST_CASE(OfflineRender_StallsOnlyWhenEverySlotIsInFlight)
+{
+	const std::string path = TempFile("OfflineRenderTest_stall.raw");
+	const uint32_t width = 2;
+	const uint32_t height = 2;
+
+	FakeReadback readback(2, height);
+	readback.Hold(true);
+
+	FrameEncoder encoder;
+	CHECK(encoder.Start(MakeSettings(path, VideoFormat::Raw, 2, 1), width, height, FakeReadback::RowPitch, readback.Function()));
+
+	// スロットが空いている間は待たない
+	for (uint32_t frame = 0; frame < 2; ++frame)
+	{
+		encoder.Submit(encoder.AcquireSlot(), frame);
+	}
+	CHECK(encoder.StallCount() == 0);
+
+	// 2つともコピー待ちなので、次のAcquireSlotはどちらかの変換が終わるまで戻らない
+	std::atomic<bool> acquired{ false };
+	uint32_t slot = 0;
+	std::thread capture([&]
+	{
+		slot = encoder.AcquireSlot();
+		acquired = true;
+	});
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CHECK(!acquired);
+
+	readback.Hold(false);
+	capture.join();
+
+	CHECK(acquired);
+	CHECK(slot < 2);
+	CHECK(encoder.StallCount() == 1);
+	CHECK(encoder.StallMs() >= 10.0);
+
+	encoder.Submit(slot, 2);
+	encoder.Finish();
+	CHECK(encoder.SubmittedFrames() == 3);
+
+	CHECK(ReadFile(path).size() == static_cast<size_t>(width) * height * 4 * 3);
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,301 @@
+#include "TestFramework.h"
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Source/Profiler/CpuProfiler.h"
+#include "../Source/Profiler/FrameStats.h"
+#include "../Source/Profiler/TraceExporter.h"
+
+namespace
+{
+	// JSONの構文だけを確かめる最小の再帰下降パーサ
+	class JsonChecker
+	{
+	public:
+
+		explicit JsonChecker(const std::string& text) : mText(text) {}
+
+		bool Valid()
+		{
+			mPos = 0;
+			bool ok = Value();
+			SkipSpace();
+			return ok && mPos == mText.size();
+		}
+
+	private:
+
+		void SkipSpace()
+		{
+			while (mPos < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPos])))
+			{
+				++mPos;
+			}
+		}
+
+		bool Consume(char c)
+		{
+			SkipSpace();
+			if (mPos < mText.size() && mText[mPos] == c)
+			{
+				++mPos;
+				return true;
+			}
+			return false;
+		}
+
+		bool String()
+		{
+			if (!Consume('"'))
+			{
+				return false;
+			}
+
+			while (mPos < mText.size())
+			{
+				char c = mText[mPos++];
+				if (c == '"')
+				{
+					return true;
+				}
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					return false;
+				}
+				if (c == '\\')
+				{
+					if (mPos >= mText.size())
+					{
+						return false;
+					}
+					char escaped = mText[mPos++];
+					if (escaped == 'u')
+					{
+						for (int i = 0; i < 4; ++i)
+						{
+							if (mPos >= mText.size() || !std::isxdigit(static_cast<unsigned char>(mText[mPos++])))
+							{
+								return false;
+							}
+						}
+					}
+					else if (std::string("\"\\/bfnrt").find(escaped) == std::string::npos)
+					{
+						return false;
+					}
+				}
+			}
+			return false;
+		}
+
+		bool Number()
+		{
+			SkipSpace();
+			size_t begin = mPos;
+			while (mPos < mText.size() && (std::isdigit(static_cast<unsigned char>(mText[mPos])) || std::string("+-.eE").find(mText[mPos]) != std::string::npos))
+			{
+				++mPos;
+			}
+			return mPos > begin;
+		}
+
+		bool Value()
+		{
+			SkipSpace();
+			if (mPos >= mText.size())
+			{
+				return false;
+			}
+
+			char c = mText[mPos];
+			if (c == '{')
+			{
+				++mPos;
+				if (Consume('}'))
+				{
+					return true;
+				}
+				do
+				{
+					if (!String() || !Consume(':') || !Value())
+					{
+						return false;
+					}
+				} while (Consume(','));
+				return Consume('}');
+			}
+			if (c == '[')
+			{
+				++mPos;
+				if (Consume(']'))
+				{
+					return true;
+				}
+				do
+				{
+					if (!Value())
+					{
+						return false;
+					}
+				} while (Consume(','));
+				return Consume(']');
+			}
+			if (c == '"')
+			{
+				return String();
+			}
+			return Number();
+		}
+
+		const std::string& mText;
+		size_t mPos = 0;
+	};
+
+	size_t CountOf(const std::string& text, const std::string& pattern)
+	{
+		size_t count = 0;
+		for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+		{
+			++count;
+		}
+		return count;
+	}
+
+	// 他のテストや他スレッドの記録と混ざらないよう、専用スレッドで記録してそのスレッドの分だけを取り出す
+	template<typename Body>
+	std::vector<ProfileEvent> RecordOnThread(const char* threadName, Body body)
+	{
+		std::thread worker([&]()
+		{
+			CpuProfiler::Instance().SetThreadName(threadName);
+			body();
+		});
+		worker.join();
+
+		uint32_t threadId = UINT32_MAX;
+		for (const auto& thread : CpuProfiler::Instance().ThreadNames())
+		{
+			if (thread.second == threadName)
+			{
+				threadId = thread.first;
+			}
+		}
+
+		std::vector<ProfileEvent> all;
+		CpuProfiler::Instance().Collect(all);
+
+		std::vector<ProfileEvent> events;
+		for (const ProfileEvent& event : all)
+		{
+			if (event.threadId == threadId)
+			{
+				events.push_back(event);
+			}
+		}
+		return events;
+	}
+}
+
+TEST_CASE(Profiler_TraceIsValidChromeJson)
+{
+	std::vector<ProfileEvent> cpu =
+	{
+		{ "Frame", 1000000, 17000000, 0, 0 },
+		{ "Quote\"Back\\slash", 2000000, 3500000, 0, 1 },
+		{ "Line\nBreak", 4000000, 4001500, 1, 0 },
+	};
+	std::vector<std::pair<uint32_t, std::string>> threads = { { 0, "Main" }, { 1, "Render\tThread" } };
+	std::vector<ProfileEvent> gpu = { { "Scene", 5000000, 9000000, 0, 0 } };
+
+	std::string json = TraceExporter::ToChromeTrace(cpu, threads, gpu);
+
+	CHECK(JsonChecker(json).Valid());
+	CHECK(CountOf(json, "\"ph\":\"X\"") == 4);
+	CHECK(CountOf(json, "\"thread_name\"") == 2);
+	CHECK(CountOf(json, "\"process_name\"") == 1);
+
+	// 一番早いイベントが0、単位はマイクロ秒
+	CHECK(json.find("\"name\":\"Frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":0.000,\"dur\":16000.000") != std::string::npos);
+	CHECK(json.find("\"name\":\"Scene\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":4000.000,\"dur\":4000.000") != std::string::npos);
+	CHECK(json.find("\"dur\":1.500") != std::string::npos);
+
+	// エスケープ
+	CHECK(json.find("Quote\\\"Back\\\\slash") != std::string::npos);
+	CHECK(json.find("Line\\u000aBreak") != std::string::npos);
+	CHECK(json.find("Render\\u0009Thread") != std::string::npos);
+}
+
+TEST_CASE(Profiler_EmptyTraceIsValid)
+{
+	std::string json = TraceExporter::ToChromeTrace({}, {}, {});
+	CHECK(JsonChecker(json).Valid());
+	CHECK(CountOf(json, "\"ph\"") == 0);
+}
+
+TEST_CASE(Profiler_ScopesRecordNestingAndOrder)
+{
+	std::vector<ProfileEvent> events = RecordOnThread("ProfilerTestNested", []()
+	{
+		PROFILE_SCOPE("Outer");
+		{
+			PROFILE_SCOPE("Inner");
+		}
+		{
+			PROFILE_SCOPE("Inner2");
+		}
+	});
+
+	// 区間は閉じた順に記録される
+	CHECK(events.size() == 3);
+	if (events.size() == 3)
+	{
+		CHECK(std::string(events[0].name) == "Inner" && events[0].depth == 1);
+		CHECK(std::string(events[1].name) == "Inner2" && events[1].depth == 1);
+		CHECK(std::string(events[2].name) == "Outer" && events[2].depth == 0);
+
+		// 内側の区間は外側に含まれる
+		CHECK(events[2].beginNs <= events[0].beginNs && events[0].endNs <= events[1].beginNs);
+		CHECK(events[1].endNs <= events[2].endNs);
+	}
+}
+
+TEST_CASE(Profiler_RingKeepsNewestEvents)
+{
+	const uint32_t extra = 100;
+
+	std::vector<ProfileEvent> events = RecordOnThread("ProfilerTestOverflow", [&]()
+	{
+		for (uint32_t idx = 0; idx < CpuProfiler::RingSize + extra; ++idx)
+		{
+			CpuProfiler::Instance().Record("Tick", idx, idx + 1, 0);
+		}
+	});
+
+	CHECK(events.size() == CpuProfiler::RingSize);
+	if (!events.empty())
+	{
+		CHECK(events.front().beginNs == extra);
+		CHECK(events.back().beginNs == CpuProfiler::RingSize + extra - 1);
+	}
+}
+
+TEST_CASE(Profiler_FrameStatsPercentiles)
+{
+	FrameStats stats(100);
+	for (int frame = 1; frame <= 150; ++frame)
+	{
+		stats.AddFrame(static_cast<double>(frame));
+	}
+
+	// 窓は直近100フレーム(51～150)
+	CHECK(stats.FrameCount() == 100);
+	CHECK_NEAR(stats.Percentile(50.0), 100.0, 1e-9);
+	CHECK_NEAR(stats.Percentile(99.0), 149.0, 1e-9);
+	CHECK_NEAR(stats.Percentile(100.0), 150.0, 1e-9);
+	CHECK_NEAR(stats.Percentile(0.0), 51.0, 1e-9);
+	CHECK_NEAR(stats.Average(), 100.5, 1e-9);
+}
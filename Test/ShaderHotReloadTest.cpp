@@ -0,0 +1,184 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Source/ShaderHotReload/ChangeDebouncer.h"
+#include "../Source/ShaderHotReload/FileWatcher.h"
+#include "../Source/ShaderHotReload/ShaderIncludeGraph.h"
+
+namespace
+{
+	// テスト毎の空の一時フォルダ。抜ける時に消す
+	class TempDirectory
+	{
+	public:
+
+		explicit TempDirectory(const char* name)
+		{
+			mPath = std::filesystem::temp_directory_path() / name;
+			std::filesystem::remove_all(mPath);
+			std::filesystem::create_directories(mPath);
+		}
+
+		~TempDirectory()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(mPath, error);
+		}
+
+		std::string Path(const std::string& relative = "") const
+		{
+			return relative.empty() ? mPath.generic_string() : (mPath / relative).generic_string();
+		}
+
+		void Write(const std::string& relative, const std::string& text) const
+		{
+			std::filesystem::create_directories((mPath / relative).parent_path());
+			std::ofstream file(mPath / relative, std::ios::binary);
+			file << text;
+		}
+
+	private:
+
+		std::filesystem::path mPath;
+	};
+
+	bool Contains(const std::vector<std::string>& paths, const std::string& path)
+	{
+		std::string normalized = ShaderIncludeGraph::Normalize(path);
+		return std::any_of(paths.begin(), paths.end(), [&](const std::string& p) { return ShaderIncludeGraph::Normalize(p) == normalized; });
+	}
+
+	// 監視スレッドからの通知とdebounceを待つ
+	std::vector<std::string> WaitForChanges(FileWatcher& watcher, size_t count)
+	{
+		std::vector<std::string> changes;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+
+		while (changes.size() < count && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			watcher.PollChanges(changes);
+		}
+		return changes;
+	}
+}
+
+TEST_CASE(ShaderIncludeGraph_InvalidatesIndirectDependents)
+{
+	TempDirectory dir("ShaderIncludeGraphTest");
+	dir.Write("Basic/BasicVS.hlsl", "#include \"BasicHeader.hlsli\"\nfloat4 main() : SV_POSITION { return 0; }\n");
+	dir.Write("Basic/BasicPS.hlsl", "  #  include \"BasicHeader.hlsli\"\n");
+	dir.Write("Basic/BasicHeader.hlsli", "#include \"../Common/VertexDecode.hlsli\"\n");
+	dir.Write("Skin/SkinVS.hlsl", "#include \"../Common/VertexDecode.hlsli\"\n");
+	dir.Write("Common/VertexDecode.hlsli", "// 循環していても止まる\n#include \"../Basic/BasicHeader.hlsli\"\n");
+
+	ShaderIncludeGraph graph;
+	graph.AddRoot(dir.Path("Basic/BasicVS.hlsl"));
+	graph.AddRoot(dir.Path("Basic/BasicPS.hlsl"));
+	graph.AddRoot(dir.Path("Skin/SkinVS.hlsl"));
+
+	// 共通ヘッダーは全てのシェーダーを作り直す
+	std::vector<std::string> roots = graph.AffectedRoots(dir.Path("Common/VertexDecode.hlsli"));
+	CHECK(roots.size() == 3);
+
+	// 区切りや".."が違っても同じファイル
+	roots = graph.AffectedRoots(dir.Path("Skin/../Basic/BasicHeader.hlsli"));
+	CHECK(roots.size() == 3);
+
+	// エントリポイントのファイルは自分だけ
+	roots = graph.AffectedRoots(dir.Path("Basic/BasicPS.hlsl"));
+	CHECK(roots.size() == 1 && Contains(roots, dir.Path("Basic/BasicPS.hlsl")));
+
+	CHECK(!graph.IsTracked(dir.Path("Basic/Unrelated.hlsli")));
+}
+
+TEST_CASE(ShaderIncludeGraph_RescanPicksUpEditedIncludes)
+{
+	TempDirectory dir("ShaderIncludeGraphRescanTest");
+	dir.Write("Main.hlsl", "#include \"Old.hlsli\"\n");
+	dir.Write("Old.hlsli", "");
+	dir.Write("New.hlsli", "");
+
+	ShaderIncludeGraph graph;
+	graph.AddRoot(dir.Path("Main.hlsl"));
+	CHECK(graph.IsTracked(dir.Path("Old.hlsli")));
+	CHECK(!graph.IsTracked(dir.Path("New.hlsli")));
+
+	// 保存でインクルードが差し替わった
+	dir.Write("Main.hlsl", "#include \"New.hlsli\"\n");
+	graph.Rescan(dir.Path("Main.hlsl"));
+
+	CHECK(!graph.IsTracked(dir.Path("Old.hlsli")));
+	CHECK(graph.IsTracked(dir.Path("New.hlsli")));
+}
+
+TEST_CASE(ChangeDebouncer_WaitsForWritesToSettle)
+{
+	using namespace std::chrono;
+
+	ChangeDebouncer debouncer(milliseconds(100));
+	ChangeDebouncer::Clock::time_point t0;
+
+	// 1回の保存で数回書き込まれる
+	debouncer.Add("a.hlsl", t0);
+	debouncer.Add("a.hlsl", t0 + milliseconds(30));
+	debouncer.Add("a.hlsl", t0 + milliseconds(60));
+	debouncer.Add("b.hlsli", t0 + milliseconds(10));
+
+	std::vector<std::string> settled;
+	debouncer.TakeSettled(t0 + milliseconds(100), settled);
+	CHECK(settled.empty());
+
+	// bは落ち着いたが、aは最後の書き込みから100ms経っていない
+	debouncer.TakeSettled(t0 + milliseconds(110), settled);
+	CHECK(settled == std::vector<std::string>({ "b.hlsli" }));
+
+	settled.clear();
+	debouncer.TakeSettled(t0 + milliseconds(160), settled);
+	CHECK(settled == std::vector<std::string>({ "a.hlsl" }));
+	CHECK(debouncer.Empty());
+
+	// 古い時刻の通知で待ちが縮むことはない
+	debouncer.Add("c.hlsl", t0 + milliseconds(500));
+	debouncer.Add("c.hlsl", t0 + milliseconds(400));
+	settled.clear();
+	debouncer.TakeSettled(t0 + milliseconds(550), settled);
+	CHECK(settled.empty());
+}
+
+TEST_CASE(FileWatcher_ReportsEachSavedFileOnce)
+{
+	TempDirectory dir("FileWatcherTest");
+	dir.Write("Basic/Existing.hlsl", "");
+
+	FileWatcher watcher;
+	CHECK(watcher.Start(dir.Path(), std::chrono::milliseconds(50)));
+
+	// 既存のサブフォルダへの保存(複数回の書き込み)
+	for (int i = 0; i < 5; ++i)
+	{
+		dir.Write("Basic/Existing.hlsl", std::string(i + 1, 'x'));
+	}
+
+	std::vector<std::string> changes = WaitForChanges(watcher, 1);
+	CHECK(changes.size() == 1);
+	CHECK(Contains(changes, dir.Path("Basic/Existing.hlsl")));
+
+	// 監視を始めた後に作られたフォルダ
+	std::filesystem::create_directories(dir.Path("Added"));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	dir.Write("Added/New.hlsli", "float4 x;");
+
+	changes = WaitForChanges(watcher, 1);
+	CHECK(changes.size() == 1);
+	CHECK(Contains(changes, dir.Path("Added/New.hlsli")));
+
+	watcher.Stop();
+}
@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "../Source/FramePacket/SpscQueue.h"
+
+TEST_CASE(SpscQueue_FifoAndCapacity)
+{
+	SpscQueue<int, 2> queue;
+	int value = 0;
+
+	CHECK(queue.Empty());
+	CHECK(!queue.TryPop(value));
+
+	CHECK(queue.TryPush(1));
+	CHECK(queue.TryPush(2));
+	CHECK(queue.Full());
+
+	// 満杯の時は書き込み側が1つ以上先行できない
+	CHECK(!queue.TryPush(3));
+
+	CHECK(queue.TryPop(value) && value == 1);
+	CHECK(queue.TryPush(3));
+	CHECK(queue.TryPop(value) && value == 2);
+	CHECK(queue.TryPop(value) && value == 3);
+	CHECK(queue.Empty());
+}
+
+TEST_CASE(SpscQueue_WrapsAroundManyTimes)
+{
+	SpscQueue<std::string, 3> queue;
+	std::string value;
+
+	// 位置はCapacityの倍数を何度も越える
+	for (int i = 0; i < 1000; ++i)
+	{
+		CHECK(queue.TryPush(std::to_string(i)));
+		if (i % 2 == 1)
+		{
+			CHECK(queue.TryPop(value) && value == std::to_string(i - 1));
+			CHECK(queue.TryPop(value) && value == std::to_string(i));
+		}
+	}
+	CHECK(queue.Empty());
+}
+
+TEST_CASE(SpscQueue_TwoThreadsKeepOrder)
+{
+	const uint64_t count = 2000000;
+
+	// FramePacketQueueと同じ容量2で、スロットの再利用が最も頻繁な状態
+	struct Packet
+	{
+		uint64_t index;
+		uint64_t check;
+	};
+	SpscQueue<Packet, 2> queue;
+
+	std::thread producer([&]()
+	{
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			Packet packet = { i, i * 0x9E3779B97F4A7C15ULL };
+			while (!queue.TryPush(packet))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	uint64_t expected = 0;
+	uint64_t torn = 0;
+	uint64_t outOfOrder = 0;
+
+	while (expected < count)
+	{
+		Packet packet;
+		if (!queue.TryPop(packet))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// 書き込み途中のスロットを読んでいれば2つの値が合わない
+		if (packet.check != packet.index * 0x9E3779B97F4A7C15ULL)
+		{
+			++torn;
+		}
+		if (packet.index != expected)
+		{
+			++outOfOrder;
+		}
+		++expected;
+	}
+
+	producer.join();
+
+	CHECK(torn == 0);
+	CHECK(outOfOrder == 0);
+	CHECK(queue.Empty());
+}
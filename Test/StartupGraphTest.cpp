@@ -0,0 +1,156 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Source/Startup/StartupGraph.h"
+
+namespace
+{
+	using TaskThread = StartupGraph::TaskThread;
+
+	// 実行したスレッドと順番を記録する
+	struct RunLog
+	{
+		std::mutex mutex;
+		std::vector<std::string> order;
+		std::vector<std::thread::id> threads;
+
+		StartupGraph::TaskFunction Task(const char* name, int sleepMs, bool result = true)
+		{
+			return [this, name, sleepMs, result]
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+
+					std::lock_guard<std::mutex> lock(mutex);
+					order.push_back(name);
+					threads.push_back(std::this_thread::get_id());
+					return result;
+				};
+		}
+
+		bool Ran(const char* name) const
+		{
+			return Index(name) < order.size();
+		}
+
+		bool RanOn(const char* name, std::thread::id thread) const
+		{
+			return Ran(name) && threads[Index(name)] == thread;
+		}
+
+		size_t Index(const char* name) const
+		{
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				if (order[i] == name)
+				{
+					return i;
+				}
+			}
+			return order.size();
+		}
+	};
+}
+
+TEST_CASE(StartupGraph_CriticalPathFollowsLatestDependency)
+{
+	RunLog log;
+	StartupGraph graph;
+
+	// Shaderの方が遅いので、Renderの開始を決めたのはShader
+	StartupGraph::TaskId window = graph.Add("Window", log.Task("Window", 2), {}, TaskThread::Main);
+	StartupGraph::TaskId texture = graph.Add("Texture", log.Task("Texture", 5));
+	StartupGraph::TaskId shader = graph.Add("Shader", log.Task("Shader", 40));
+	StartupGraph::TaskId render = graph.Add("Render", log.Task("Render", 2), { window, texture, shader }, TaskThread::Main);
+
+	CHECK(graph.Run(2));
+
+	std::vector<StartupGraph::TaskId> path = graph.CriticalPath();
+	CHECK(path.size() == 2);
+	CHECK(path.size() == 2 && path[0] == shader && path[1] == render);
+
+	CHECK(log.Index("Render") == 3);
+	CHECK(graph.TaskTotalMs() >= 49.0);
+	CHECK(graph.WallMs() >= 42.0);
+
+	std::string report = graph.Report();
+	CHECK(report.find("critical path: Shader -> Render") != std::string::npos);
+	CHECK(report.find("FAILED") == std::string::npos);
+}
+
+TEST_CASE(StartupGraph_MainThreadRunsOnlyMainTasksWhilePending)
+{
+	RunLog log;
+	StartupGraph graph;
+
+	// DeviceはSwapChainより先に終わるが、その間に呼び出し元のスレッドが
+	// 長いAnyのタスクを拾うとSwapChainが遅れる
+	StartupGraph::TaskId window = graph.Add("Window", log.Task("Window", 2), {}, TaskThread::Main);
+	StartupGraph::TaskId device = graph.Add("Device", log.Task("Device", 5));
+	graph.Add("Texture0", log.Task("Texture0", 20));
+	graph.Add("Texture1", log.Task("Texture1", 20));
+	StartupGraph::TaskId swapChain = graph.Add("SwapChain", log.Task("SwapChain", 2), { window, device }, TaskThread::Main);
+
+	// Mainのタスクが無くなった後は、待つだけになるので呼び出し元も手伝う
+	graph.Add("Tail0", log.Task("Tail0", 20), { swapChain });
+	graph.Add("Tail1", log.Task("Tail1", 20), { swapChain });
+
+	const std::thread::id main = std::this_thread::get_id();
+
+	CHECK(graph.Run(1));
+
+	CHECK(log.RanOn("Window", main));
+	CHECK(log.RanOn("SwapChain", main));
+	CHECK(!log.RanOn("Device", main));
+
+	// SwapChainが終わるまで、呼び出し元のスレッドはAnyのタスクを拾わない
+	for (const char* name : { "Texture0", "Texture1" })
+	{
+		CHECK(!log.RanOn(name, main) || log.Index(name) > log.Index("SwapChain"));
+	}
+	CHECK(log.Index("SwapChain") < log.Index("Texture1"));
+
+	CHECK(log.RanOn("Tail0", main) || log.RanOn("Tail1", main) || log.RanOn("Texture1", main));
+}
+
+TEST_CASE(StartupGraph_RunsEverythingWithoutWorkers)
+{
+	RunLog log;
+	StartupGraph graph;
+
+	StartupGraph::TaskId a = graph.Add("A", log.Task("A", 0));
+	StartupGraph::TaskId b = graph.Add("B", log.Task("B", 0), { a }, TaskThread::Main);
+	graph.Add("C", log.Task("C", 0), { a, b });
+
+	CHECK(graph.Run(0));
+	CHECK(log.order.size() == 3);
+	CHECK(log.Index("A") < log.Index("B") && log.Index("B") < log.Index("C"));
+}
+
+TEST_CASE(StartupGraph_FailureStopsNewTasks)
+{
+	RunLog log;
+	StartupGraph graph;
+
+	StartupGraph::TaskId device = graph.Add("Device", log.Task("Device", 0, false), {}, TaskThread::Main);
+	graph.Add("Render", log.Task("Render", 0), { device }, TaskThread::Main);
+	graph.Add("Shader", log.Task("Shader", 0), { device });
+
+	CHECK(!graph.Run(1));
+	CHECK(log.Ran("Device"));
+	CHECK(!log.Ran("Render"));
+	CHECK(!log.Ran("Shader"));
+
+	std::string report = graph.Report();
+	CHECK(report.find("FAILED") != std::string::npos);
+	CHECK(report.find("Render (not run)") != std::string::npos);
+
+	// 失敗した後でも、もう一度最初から実行できる
+	StartupGraph retry;
+	retry.Add("Only", log.Task("Only", 0));
+	CHECK(retry.Run(1));
+}
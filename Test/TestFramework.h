@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// D3Dに依存しないモジュールのテスト(CMakeのPortableTestsでビルドする)
+// TEST_CASEで登録し、CHECKが失敗しても同じテストの残りは続ける
+namespace TestFramework
+{
+	using TestFunction = void(*)();
+
+	struct TestCase
+	{
+		const char* name;
+		TestFunction function;
+	};
+
+	inline std::vector<TestCase>& Registry()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	inline int& FailureCount()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestFunction function)
+		{
+			Registry().push_back({ name, function });
+		}
+	};
+
+	inline void Fail(const char* file, int line, const char* expression)
+	{
+		std::printf("  FAILED %s:%d: %s\n", file, line, expression);
+		++FailureCount();
+	}
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static TestFramework::Registrar name##Registrar(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) { TestFramework::Fail(__FILE__, __LINE__, #expression); } } while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	do { if (!(std::abs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))) { TestFramework::Fail(__FILE__, __LINE__, #actual " ~= " #expected); } } while (false)
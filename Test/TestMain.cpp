@@ -0,0 +1,28 @@
+#include "TestFramework.h"
+
+#include <cstring>
+
+// 引数を渡すと、名前にその文字列を含むテストだけを実行する
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	int run = 0;
+
+	for (const TestFramework::TestCase& test : TestFramework::Registry())
+	{
+		if (filter != nullptr && std::strstr(test.name, filter) == nullptr)
+		{
+			continue;
+		}
+
+		int before = TestFramework::FailureCount();
+		test.function();
+		++run;
+
+		std::printf("%s %s\n", TestFramework::FailureCount() == before ? "[ OK ]" : "[FAIL]", test.name);
+	}
+
+	std::printf("%d tests, %d failures\n", run, TestFramework::FailureCount());
+
+	return TestFramework::FailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../Source/GpuMemory/TlsfAllocator.h"
+
+namespace
+{
+	// 使用中の範囲が重ならず、容量内に収まっているか
+	bool Disjoint(std::vector<TlsfAllocator::Allocation> allocations, uint64_t capacity)
+	{
+		std::sort(allocations.begin(), allocations.end(), [](const TlsfAllocator::Allocation& a, const TlsfAllocator::Allocation& b)
+		{
+			return a.offset < b.offset;
+		});
+
+		for (size_t i = 0; i < allocations.size(); ++i)
+		{
+			if (allocations[i].offset + allocations[i].size > capacity)
+			{
+				return false;
+			}
+			if (i > 0 && allocations[i - 1].offset + allocations[i - 1].size > allocations[i].offset)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE(Tlsf_FreeCoalescesBackToOneBlock)
+{
+	TlsfAllocator tlsf;
+	tlsf.Init(1 << 20, 256);
+
+	TlsfAllocator::Allocation a, b, c;
+	CHECK(tlsf.Allocate(1000, 256, a));
+	CHECK(tlsf.Allocate(5000, 256, b));
+	CHECK(tlsf.Allocate(300, 256, c));
+
+	// 粒度に切り上げられ、先頭から詰めて置かれる
+	CHECK(a.offset == 0 && a.size == 1024);
+	CHECK(b.offset == 1024 && b.size == 5120);
+	CHECK(c.offset == 6144 && c.size == 512);
+	CHECK(tlsf.GetStats().allocationCount == 3);
+
+	// 真ん中を先に解放しても、最後は前後とつながって1塊に戻る
+	tlsf.Free(b);
+	CHECK(!b.IsValid());
+	CHECK(tlsf.GetStats().freeBlockCount == 2);
+	tlsf.Free(a);
+	tlsf.Free(c);
+
+	TlsfAllocator::Stats stats = tlsf.GetStats();
+	CHECK(tlsf.IsEmpty());
+	CHECK(stats.freeBlockCount == 1);
+	CHECK(stats.largestFreeBlock == (1 << 20));
+	CHECK(stats.Fragmentation() == 0.0);
+}
+
+TEST_CASE(Tlsf_RespectsAlignment)
+{
+	TlsfAllocator tlsf;
+	tlsf.Init(16 << 20, 256);
+
+	// ずらしてから大きな境界を要求する
+	TlsfAllocator::Allocation small, aligned, msaa;
+	CHECK(tlsf.Allocate(256, 256, small));
+	CHECK(tlsf.Allocate(64 * 1024, 64 * 1024, aligned));
+	CHECK(tlsf.Allocate(100, 4 * 1024 * 1024, msaa));
+
+	CHECK(aligned.offset % (64 * 1024) == 0);
+	CHECK(msaa.offset % (4 * 1024 * 1024) == 0);
+
+	// 境界合わせで空いた先頭の余りも、後から小さい割り当てに使える
+	TlsfAllocator::Allocation filler;
+	CHECK(tlsf.Allocate(512, 256, filler));
+	CHECK(filler.offset < aligned.offset);
+
+	CHECK(Disjoint({ small, aligned, msaa, filler }, tlsf.Capacity()));
+}
+
+TEST_CASE(Tlsf_FailsWhenFullAndRecovers)
+{
+	TlsfAllocator tlsf;
+	tlsf.Init(4096, 256);
+
+	std::vector<TlsfAllocator::Allocation> blocks(16);
+	for (auto& block : blocks)
+	{
+		CHECK(tlsf.Allocate(256, 256, block));
+	}
+
+	TlsfAllocator::Allocation extra;
+	CHECK(!tlsf.Allocate(1, 1, extra));
+	CHECK(!extra.IsValid());
+
+	// 1つおきに解放すると空きは足りても連続していない
+	for (size_t i = 0; i < blocks.size(); i += 2)
+	{
+		tlsf.Free(blocks[i]);
+	}
+	CHECK(tlsf.GetStats().freeBytes == 2048);
+	CHECK(tlsf.GetStats().largestFreeBlock == 256);
+	CHECK(!tlsf.Allocate(512, 256, extra));
+	CHECK_NEAR(tlsf.GetStats().Fragmentation(), 1.0 - 256.0 / 2048.0, 1e-9);
+
+	// 隣を解放すれば結合されて入る
+	tlsf.Free(blocks[1]);
+	CHECK(tlsf.Allocate(512, 256, extra));
+	CHECK(extra.offset == 0);
+}
+
+TEST_CASE(Tlsf_RandomStressKeepsRangesDisjoint)
+{
+	const uint64_t capacity = 64ULL << 20;
+
+	TlsfAllocator tlsf;
+	tlsf.Init(capacity, 256);
+
+	std::mt19937 random(7);
+	std::uniform_int_distribution<uint64_t> size(1, 512 * 1024);
+	std::uniform_int_distribution<int> alignLog2(8, 16);
+
+	std::vector<TlsfAllocator::Allocation> live;
+	uint64_t expectedUsed = 0;
+
+	for (int step = 0; step < 20000; ++step)
+	{
+		if (!live.empty() && random() % 3 == 0)
+		{
+			size_t index = random() % live.size();
+			expectedUsed -= live[index].size;
+			tlsf.Free(live[index]);
+			live[index] = live.back();
+			live.pop_back();
+			continue;
+		}
+
+		uint64_t alignment = 1ULL << alignLog2(random);
+		TlsfAllocator::Allocation allocation;
+		if (tlsf.Allocate(size(random), alignment, allocation))
+		{
+			CHECK(allocation.offset % alignment == 0);
+			expectedUsed += allocation.size;
+			live.push_back(allocation);
+		}
+	}
+
+	CHECK(Disjoint(live, capacity));
+	CHECK(tlsf.GetStats().usedBytes == expectedUsed);
+	CHECK(tlsf.GetStats().allocationCount == live.size());
+
+	for (auto& allocation : live)
+	{
+		tlsf.Free(allocation);
+	}
+	CHECK(tlsf.IsEmpty());
+	CHECK(tlsf.GetStats().freeBlockCount == 1);
+}
@@ -0,0 +1,161 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../Source/VertexFormat/VertexFormat.h"
+
+namespace
+{
+	std::vector<SkinVertex> RandomSkinVertices(size_t count, int32_t maxBone)
+	{
+		std::mt19937 random(17);
+		std::normal_distribution<float> gauss(0.0F, 1.0F);
+		std::uniform_real_distribution<float> unit(0.0F, 1.0F);
+		std::uniform_int_distribution<int32_t> bone(0, maxBone);
+
+		std::vector<SkinVertex> vertices(count);
+		for (SkinVertex& vertex : vertices)
+		{
+			vertex.pos = { gauss(random), gauss(random), gauss(random) };
+			vertex.normal = Math::Normalize({ gauss(random), gauss(random), gauss(random) });
+			vertex.uv = { unit(random), unit(random) };
+
+			float sum = 0.0F;
+			for (int idx = 0; idx < 4; ++idx)
+			{
+				vertex.boneIndex[idx] = idx < 2 ? bone(random) : -1;
+				vertex.boneWeight[idx] = idx < 2 ? unit(random) : 0.0F;
+				sum += vertex.boneWeight[idx];
+			}
+			for (float& weight : vertex.boneWeight)
+			{
+				weight /= sum;
+			}
+			vertex.edgeScale = 1.0F;
+		}
+		return vertices;
+	}
+}
+
+TEST_CASE(VertexFormat_HalfRoundTripsEveryHalf)
+{
+	// NaN以外の全ての半精度値は、floatを経由して同じビットに戻る
+	bool allExact = true;
+	for (uint32_t bits = 0; bits <= 0xFFFF; ++bits)
+	{
+		uint16_t half = static_cast<uint16_t>(bits);
+		bool isNan = (half & 0x7C00) == 0x7C00 && (half & 0x3FF) != 0;
+		if (!isNan && VertexFormat::FloatToHalf(VertexFormat::HalfToFloat(half)) != half)
+		{
+			allExact = false;
+		}
+	}
+	CHECK(allExact);
+
+	CHECK(VertexFormat::FloatToHalf(1.0F) == 0x3C00);
+	CHECK(VertexFormat::FloatToHalf(-2.0F) == 0xC000);
+	CHECK(VertexFormat::FloatToHalf(0.1F) == 0x2E66);
+	CHECK(VertexFormat::FloatToHalf(65504.0F) == 0x7BFF);
+	CHECK(VertexFormat::FloatToHalf(1.0e6F) == 0x7C00);
+	CHECK(VertexFormat::FloatToHalf(std::ldexp(1.0F, -24)) == 0x0001);
+	CHECK(VertexFormat::FloatToHalf(std::ldexp(1.0F, -26)) == 0x0000);
+
+	// ちょうど中間は偶数側に丸める(1 + 2^-11 は 1 に、1 + 3×2^-11 は 1 + 2^-9 に)
+	CHECK(VertexFormat::FloatToHalf(1.0F + std::ldexp(1.0F, -11)) == 0x3C00);
+	CHECK(VertexFormat::FloatToHalf(1.0F + 3.0F * std::ldexp(1.0F, -11)) == 0x3C02);
+}
+
+TEST_CASE(VertexFormat_OctNormalRoundTrip)
+{
+	const Float3 axes[] =
+	{
+		{ 1.0F, 0.0F, 0.0F }, { -1.0F, 0.0F, 0.0F }, { 0.0F, 1.0F, 0.0F },
+		{ 0.0F, -1.0F, 0.0F }, { 0.0F, 0.0F, 1.0F }, { 0.0F, 0.0F, -1.0F },
+	};
+
+	for (const Float3& axis : axes)
+	{
+		int16_t oct[2] = {};
+		VertexFormat::EncodeOct(axis, oct);
+		Float3 decoded = VertexFormat::DecodeOct(oct);
+		CHECK(Math::Dot(axis, decoded) > 0.99999F);
+	}
+}
+
+TEST_CASE(VertexFormat_SkinRoundTripErrorIsBounded)
+{
+	for (bool splitStreams : { false, true })
+	{
+		std::vector<SkinVertex> vertices = RandomSkinVertices(5000, 200);
+		CompactSkinMesh mesh = VertexFormat::Compress(vertices, splitStreams);
+
+		CHECK(!mesh.boneIndex16);
+		CHECK(mesh.stride0 + mesh.stride1 == 28);
+
+		VertexQuantizeReport report = VertexFormat::Measure(vertices, mesh);
+
+		CHECK(report.compactBytes * 2 < report.sourceBytes);
+
+		// SNORM16の八面体は0.01度未満、[0,1]の半精度UVは半ULP(2^-12)以内、ウェイトは1/255以内
+		CHECK(report.maxNormalErrorDeg < 0.01F);
+		CHECK(report.maxUvError <= std::ldexp(1.0F, -12));
+		CHECK(report.maxWeightError <= 1.0F / 255.0F);
+
+		// 位置は無圧縮
+		CHECK(report.maxPositionError == 0.0F);
+		float pos[3] = {};
+		std::memcpy(pos, &mesh.stream0[mesh.stride0 * 10], sizeof(pos));
+		CHECK(pos[0] == vertices[10].pos.x && pos[1] == vertices[10].pos.y && pos[2] == vertices[10].pos.z);
+	}
+
+	// 256番以降のボーンがあれば16ビット版になる
+	std::vector<SkinVertex> many = RandomSkinVertices(100, 1000);
+	CompactSkinMesh mesh16 = VertexFormat::Compress(many, false);
+	CHECK(mesh16.boneIndex16);
+	CHECK(mesh16.stride0 == 32);
+}
+
+TEST_CASE(VertexFormat_WeightsSumTo255)
+{
+	const float cases[][4] =
+	{
+		{ 0.333F, 0.333F, 0.334F, 0.0F },
+		{ 0.5F, 0.5F, 0.0F, 0.0F },
+		{ 0.1F, 0.2F, 0.3F, 0.4F },
+		{ 1.0F, 0.0F, 0.0F, 0.0F },
+		{ 0.25F, 0.25F, 0.25F, 0.25F },
+	};
+
+	for (const auto& weights : cases)
+	{
+		uint8_t packed[4] = {};
+		VertexFormat::EncodeWeights(weights, packed);
+		CHECK(packed[0] + packed[1] + packed[2] + packed[3] == 255);
+	}
+}
+
+TEST_CASE(VertexFormat_StaticVertexRoundTrip)
+{
+	std::vector<StaticVertex> vertices =
+	{
+		{ { -1.0F, -1.0F, 0.0F }, { 0.0F, 0.0F, -1.0F }, { 0.0F, 1.0F } },
+		{ { 1.0F, 1.0F, 0.0F }, { 0.577F, 0.577F, 0.577F }, { 0.3F, 0.7F } },
+		{ { 2.0F, 0.5F, 3.0F }, { -0.2F, 0.9F, -0.4F }, { 12.5F, -3.25F } },
+	};
+
+	std::vector<CompactStaticVertex> compact = VertexFormat::Compress(vertices.data(), vertices.size());
+	CHECK(compact.size() == vertices.size());
+
+	VertexQuantizeReport report = VertexFormat::Measure(vertices.data(), compact);
+	CHECK(report.compactBytes == vertices.size() * 20);
+	CHECK(report.maxPositionError == 0.0F);
+	CHECK(report.maxNormalErrorDeg < 0.01F);
+
+	// 16を超えるUVは半精度のULPが大きくなるが、相対誤差は2^-11以内
+	CHECK(report.maxUvError <= 12.5F * std::ldexp(1.0F, -11));
+	CHECK(VertexFormat::HalfToFloat(compact[0].uvHalf[1]) == 1.0F);
+}
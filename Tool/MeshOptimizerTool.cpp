@@ -0,0 +1,272 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../Source/MeshOptimizer/MeshOptimizer.h"
+
+// Wavefront OBJを読み、MeshOptimizerで頂点キャッシュと頂点フェッチの順に並べ替えて書き出す
+// usage: MeshOptimizerTool <in.obj> <out.obj>
+// usemtlの切れ目をサブセットとして扱い、マテリアルを跨いで三角形を入れ替えない
+namespace
+{
+	// v/vt/vnの組を1頂点にまとめたもの
+	struct ObjVertex
+	{
+		float position[3];
+		float uv[2];
+		float normal[3];
+	};
+
+	struct ObjMesh
+	{
+		std::vector<ObjVertex> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<MeshSubset> subsets;
+		std::vector<std::string> materials;
+		bool hasUv = false;
+		bool hasNormal = false;
+	};
+
+	// OBJの番号は1始まりで、負なら末尾からの相対
+	int ResolveIndex(int index, size_t count)
+	{
+		return index < 0 ? static_cast<int>(count) + index : index - 1;
+	}
+
+	bool LoadObj(const char* path, ObjMesh& mesh)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot open %s\n", path);
+			return false;
+		}
+
+		std::vector<float> positions;
+		std::vector<float> uvs;
+		std::vector<float> normals;
+		std::map<std::tuple<int, int, int>, uint32_t> vertexOf;
+
+		auto beginSubset = [&](const std::string& material)
+		{
+			if (!mesh.subsets.empty() && mesh.subsets.back().indexCount == 0)
+			{
+				mesh.materials.back() = material;
+				return;
+			}
+
+			MeshSubset subset = {};
+			subset.indexOffset = static_cast<uint32_t>(mesh.indices.size());
+			mesh.subsets.push_back(subset);
+			mesh.materials.push_back(material);
+		};
+
+		beginSubset("");
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::istringstream stream(line);
+			std::string tag;
+			stream >> tag;
+
+			if (tag == "v")
+			{
+				float x = 0.0F, y = 0.0F, z = 0.0F;
+				stream >> x >> y >> z;
+				positions.insert(positions.end(), { x, y, z });
+			}
+			else if (tag == "vt")
+			{
+				float u = 0.0F, v = 0.0F;
+				stream >> u >> v;
+				uvs.insert(uvs.end(), { u, v });
+			}
+			else if (tag == "vn")
+			{
+				float x = 0.0F, y = 0.0F, z = 0.0F;
+				stream >> x >> y >> z;
+				normals.insert(normals.end(), { x, y, z });
+			}
+			else if (tag == "usemtl")
+			{
+				std::string material;
+				stream >> material;
+				beginSubset(material);
+			}
+			else if (tag == "f")
+			{
+				std::vector<uint32_t> polygon;
+				std::string corner;
+
+				while (stream >> corner)
+				{
+					int p = 0, t = 0, n = 0;
+					if (std::sscanf(corner.c_str(), "%d/%d/%d", &p, &t, &n) != 3 &&
+						std::sscanf(corner.c_str(), "%d//%d", &p, &n) != 2)
+					{
+						t = 0;
+						n = 0;
+						if (std::sscanf(corner.c_str(), "%d/%d", &p, &t) != 2 && std::sscanf(corner.c_str(), "%d", &p) != 1)
+						{
+							std::fprintf(stderr, "bad face: %s\n", line.c_str());
+							return false;
+						}
+					}
+
+					int pi = ResolveIndex(p, positions.size() / 3);
+					int ti = t != 0 ? ResolveIndex(t, uvs.size() / 2) : -1;
+					int ni = n != 0 ? ResolveIndex(n, normals.size() / 3) : -1;
+
+					if (pi < 0 || static_cast<size_t>(pi) * 3 >= positions.size() ||
+						(ti >= 0 && static_cast<size_t>(ti) * 2 >= uvs.size()) ||
+						(ni >= 0 && static_cast<size_t>(ni) * 3 >= normals.size()))
+					{
+						std::fprintf(stderr, "index out of range: %s\n", line.c_str());
+						return false;
+					}
+
+					auto key = std::make_tuple(pi, ti, ni);
+					auto found = vertexOf.find(key);
+					if (found == vertexOf.end())
+					{
+						ObjVertex vertex = {};
+						std::memcpy(vertex.position, &positions[pi * 3], sizeof(vertex.position));
+						if (ti >= 0)
+						{
+							std::memcpy(vertex.uv, &uvs[ti * 2], sizeof(vertex.uv));
+							mesh.hasUv = true;
+						}
+						if (ni >= 0)
+						{
+							std::memcpy(vertex.normal, &normals[ni * 3], sizeof(vertex.normal));
+							mesh.hasNormal = true;
+						}
+
+						found = vertexOf.emplace(key, static_cast<uint32_t>(mesh.vertices.size())).first;
+						mesh.vertices.push_back(vertex);
+					}
+
+					polygon.push_back(found->second);
+				}
+
+				// 多角形は扇形に三角形へ分割する
+				for (size_t idx = 2; idx < polygon.size(); ++idx)
+				{
+					mesh.indices.insert(mesh.indices.end(), { polygon[0], polygon[idx - 1], polygon[idx] });
+					mesh.subsets.back().indexCount += 3;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool SaveObj(const char* path, const ObjMesh& mesh)
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot create %s\n", path);
+			return false;
+		}
+
+		for (const ObjVertex& vertex : mesh.vertices)
+		{
+			file << "v " << vertex.position[0] << " " << vertex.position[1] << " " << vertex.position[2] << "\n";
+			if (mesh.hasUv)
+			{
+				file << "vt " << vertex.uv[0] << " " << vertex.uv[1] << "\n";
+			}
+			if (mesh.hasNormal)
+			{
+				file << "vn " << vertex.normal[0] << " " << vertex.normal[1] << " " << vertex.normal[2] << "\n";
+			}
+		}
+
+		for (size_t s = 0; s < mesh.subsets.size(); ++s)
+		{
+			const MeshSubset& subset = mesh.subsets[s];
+			if (subset.indexCount == 0)
+			{
+				continue;
+			}
+
+			if (!mesh.materials[s].empty())
+			{
+				file << "usemtl " << mesh.materials[s] << "\n";
+			}
+
+			for (uint32_t idx = subset.indexOffset; idx < subset.indexOffset + subset.indexCount; idx += 3)
+			{
+				file << "f";
+				for (uint32_t corner = 0; corner < 3; ++corner)
+				{
+					uint32_t v = mesh.indices[idx + corner] + 1;
+					file << " " << v;
+					if (mesh.hasUv || mesh.hasNormal)
+					{
+						file << "/";
+						if (mesh.hasUv)
+						{
+							file << v;
+						}
+						if (mesh.hasNormal)
+						{
+							file << "/" << v;
+						}
+					}
+				}
+				file << "\n";
+			}
+		}
+
+		return static_cast<bool>(file);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "usage: %s <in.obj> <out.obj>\n", argv[0]);
+		return 1;
+	}
+
+	ObjMesh mesh;
+	if (!LoadObj(argv[1], mesh))
+	{
+		return 1;
+	}
+
+	std::vector<uint8_t> vertexBytes(mesh.vertices.size() * sizeof(ObjVertex));
+	if (!mesh.vertices.empty())
+	{
+		std::memcpy(vertexBytes.data(), mesh.vertices.data(), vertexBytes.size());
+	}
+
+	MeshOptimizeStats stats = MeshOptimizer::Optimize(vertexBytes, sizeof(ObjVertex), mesh.indices, mesh.subsets);
+
+	if (!mesh.vertices.empty())
+	{
+		std::memcpy(mesh.vertices.data(), vertexBytes.data(), vertexBytes.size());
+	}
+
+	if (!SaveObj(argv[2], mesh))
+	{
+		return 1;
+	}
+
+	std::printf("vertices=%zu triangles=%zu subsets=%u (16bit %u)\n",
+		mesh.vertices.size(), mesh.indices.size() / 3, stats.subsetCount, stats.index16SubsetCount);
+	std::printf("ACMR %.3f -> %.3f (FIFO %u)\n", stats.acmrBefore, stats.acmrAfter, MeshOptimizer::FifoCacheSize);
+
+	return 0;
+}
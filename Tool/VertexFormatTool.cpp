@@ -0,0 +1,376 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../Source/VertexFormat/VertexFormat.h"
+
+// モデルの頂点をVertexFormatで圧縮し、サイズと復元誤差を表示する
+// usage: VertexFormatTool <model.pmx|model.obj> ...
+// PMXはスキニングする形とスキニングしない形の両方、OBJはスキニングしない形だけを測る
+namespace
+{
+	// PMXを頭から順に読む。範囲外に出たらokをfalseにして以降は0を返す
+	class PmxReader
+	{
+	public:
+
+		explicit PmxReader(const std::vector<uint8_t>& data) : mData(data) {}
+
+		bool Ok() const { return mOk; }
+
+		void Read(void* out, size_t size)
+		{
+			if (!mOk || mOffset + size > mData.size())
+			{
+				mOk = false;
+				std::memset(out, 0, size);
+				return;
+			}
+			std::memcpy(out, mData.data() + mOffset, size);
+			mOffset += size;
+		}
+
+		template<typename T>
+		T Read()
+		{
+			T value = {};
+			Read(&value, sizeof(T));
+			return value;
+		}
+
+		void Skip(size_t size)
+		{
+			if (!mOk || mOffset + size > mData.size())
+			{
+				mOk = false;
+				return;
+			}
+			mOffset += size;
+		}
+
+		// 先頭に長さを持つ文字列
+		void SkipText()
+		{
+			int32_t length = Read<int32_t>();
+			if (length < 0)
+			{
+				mOk = false;
+				return;
+			}
+			Skip(static_cast<size_t>(length));
+		}
+
+		// PMXのボーン番号は1/2/4バイトの符号付き
+		int32_t ReadIndex(uint8_t size)
+		{
+			switch (size)
+			{
+			case 1: return Read<int8_t>();
+			case 2: return Read<int16_t>();
+			case 4: return Read<int32_t>();
+			default:
+				mOk = false;
+				return -1;
+			}
+		}
+
+	private:
+
+		const std::vector<uint8_t>& mData;
+		size_t mOffset = 0;
+		bool mOk = true;
+	};
+
+	bool LoadFile(const char* path, std::vector<uint8_t>& data)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot open %s\n", path);
+			return false;
+		}
+
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// PMX 2.0/2.1の頂点だけを読む
+	bool LoadPmx(const char* path, std::vector<SkinVertex>& vertices)
+	{
+		std::vector<uint8_t> data;
+		if (!LoadFile(path, data))
+		{
+			return false;
+		}
+
+		PmxReader reader(data);
+
+		char magic[4] = {};
+		reader.Read(magic, sizeof(magic));
+		if (std::memcmp(magic, "PMX ", 4) != 0)
+		{
+			std::fprintf(stderr, "not a PMX file: %s\n", path);
+			return false;
+		}
+
+		reader.Read<float>();
+
+		// [1]追加UV数 [5]ボーン番号のバイト数
+		uint8_t globalCount = reader.Read<uint8_t>();
+		uint8_t globals[8] = {};
+		for (uint8_t idx = 0; idx < globalCount; ++idx)
+		{
+			uint8_t value = reader.Read<uint8_t>();
+			if (idx < 8)
+			{
+				globals[idx] = value;
+			}
+		}
+		const uint8_t additionalUvCount = globals[1];
+		const uint8_t boneIndexSize = globals[5];
+
+		// モデル名(日/英)とコメント(日/英)
+		for (int idx = 0; idx < 4; ++idx)
+		{
+			reader.SkipText();
+		}
+
+		int32_t vertexCount = reader.Read<int32_t>();
+		if (!reader.Ok() || vertexCount < 0)
+		{
+			std::fprintf(stderr, "broken PMX header: %s\n", path);
+			return false;
+		}
+
+		vertices.assign(static_cast<size_t>(vertexCount), SkinVertex());
+
+		for (SkinVertex& vertex : vertices)
+		{
+			vertex.pos = reader.Read<Float3>();
+			vertex.normal = reader.Read<Float3>();
+			vertex.uv = reader.Read<Float2>();
+			reader.Skip(sizeof(Float4) * additionalUvCount);
+
+			for (int w = 0; w < 4; ++w)
+			{
+				vertex.boneIndex[w] = -1;
+				vertex.boneWeight[w] = 0.0F;
+			}
+
+			uint8_t type = reader.Read<uint8_t>();
+			switch (type)
+			{
+			case 0:	// BDEF1
+				vertex.boneIndex[0] = reader.ReadIndex(boneIndexSize);
+				vertex.boneWeight[0] = 1.0F;
+				break;
+			case 1:	// BDEF2
+			case 3:	// SDEF(補正用のC,R0,R1は使わない)
+				vertex.boneIndex[0] = reader.ReadIndex(boneIndexSize);
+				vertex.boneIndex[1] = reader.ReadIndex(boneIndexSize);
+				vertex.boneWeight[0] = reader.Read<float>();
+				vertex.boneWeight[1] = 1.0F - vertex.boneWeight[0];
+				if (type == 3)
+				{
+					reader.Skip(sizeof(Float3) * 3);
+				}
+				break;
+			case 2:	// BDEF4
+			case 4:	// QDEF
+				for (int w = 0; w < 4; ++w)
+				{
+					vertex.boneIndex[w] = reader.ReadIndex(boneIndexSize);
+				}
+				for (int w = 0; w < 4; ++w)
+				{
+					vertex.boneWeight[w] = reader.Read<float>();
+				}
+				break;
+			default:
+				std::fprintf(stderr, "unknown weight type %u: %s\n", type, path);
+				return false;
+			}
+
+			vertex.edgeScale = reader.Read<float>();
+
+			if (!reader.Ok())
+			{
+				std::fprintf(stderr, "truncated vertices: %s\n", path);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// v/vt/vnの組を1頂点にまとめて読む。面の並びは要らない
+	bool LoadObj(const char* path, std::vector<StaticVertex>& vertices)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			std::fprintf(stderr, "cannot open %s\n", path);
+			return false;
+		}
+
+		std::vector<Float3> positions;
+		std::vector<Float2> uvs;
+		std::vector<Float3> normals;
+		std::map<std::tuple<int, int, int>, uint32_t> vertexOf;
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::istringstream stream(line);
+			std::string tag;
+			stream >> tag;
+
+			if (tag == "v")
+			{
+				Float3 p = {};
+				stream >> p.x >> p.y >> p.z;
+				positions.push_back(p);
+			}
+			else if (tag == "vt")
+			{
+				Float2 t = {};
+				stream >> t.x >> t.y;
+				uvs.push_back(t);
+			}
+			else if (tag == "vn")
+			{
+				Float3 n = {};
+				stream >> n.x >> n.y >> n.z;
+				normals.push_back(n);
+			}
+			else if (tag == "f")
+			{
+				std::string corner;
+				while (stream >> corner)
+				{
+					int p = 0, t = 0, n = 0;
+					if (std::sscanf(corner.c_str(), "%d/%d/%d", &p, &t, &n) != 3 &&
+						std::sscanf(corner.c_str(), "%d//%d", &p, &n) != 2)
+					{
+						t = 0;
+						n = 0;
+						if (std::sscanf(corner.c_str(), "%d/%d", &p, &t) != 2 && std::sscanf(corner.c_str(), "%d", &p) != 1)
+						{
+							std::fprintf(stderr, "bad face: %s\n", line.c_str());
+							return false;
+						}
+					}
+
+					// OBJの番号は1始まりで、負なら末尾からの相対
+					auto resolve = [](int index, size_t count) { return index < 0 ? static_cast<int>(count) + index : index - 1; };
+					int pi = resolve(p, positions.size());
+					int ti = t != 0 ? resolve(t, uvs.size()) : -1;
+					int ni = n != 0 ? resolve(n, normals.size()) : -1;
+
+					if (pi < 0 || static_cast<size_t>(pi) >= positions.size() ||
+						(ti >= 0 && static_cast<size_t>(ti) >= uvs.size()) ||
+						(ni >= 0 && static_cast<size_t>(ni) >= normals.size()))
+					{
+						std::fprintf(stderr, "index out of range: %s\n", line.c_str());
+						return false;
+					}
+
+					auto key = std::make_tuple(pi, ti, ni);
+					if (vertexOf.find(key) != vertexOf.end())
+					{
+						continue;
+					}
+
+					StaticVertex vertex = {};
+					vertex.pos = positions[pi];
+					vertex.normal = ni >= 0 ? normals[ni] : Float3{ 0.0F, 0.0F, 1.0F };
+					vertex.uv = ti >= 0 ? uvs[ti] : Float2{ 0.0F, 0.0F };
+
+					vertexOf.emplace(key, static_cast<uint32_t>(vertices.size()));
+					vertices.push_back(vertex);
+				}
+			}
+		}
+
+		return true;
+	}
+
+	void PrintReport(const char* layout, size_t count, const VertexQuantizeReport& report)
+	{
+		std::printf("  %-7s %zu -> %zu bytes (%zu -> %zu B/vertex)\n", layout,
+			report.sourceBytes, report.compactBytes,
+			count > 0 ? report.sourceBytes / count : 0, count > 0 ? report.compactBytes / count : 0);
+		std::printf("          max error: position %g, normal %.4f deg, uv %g, weight %g\n",
+			report.maxPositionError, report.maxNormalErrorDeg, report.maxUvError, report.maxWeightError);
+	}
+
+	void MeasureStatic(const std::vector<StaticVertex>& vertices)
+	{
+		std::vector<CompactStaticVertex> compact = VertexFormat::Compress(vertices.data(), vertices.size());
+		PrintReport("static", vertices.size(), VertexFormat::Measure(vertices.data(), compact));
+	}
+
+	bool IsPmx(const std::string& path)
+	{
+		return path.size() >= 4 && (path.compare(path.size() - 4, 4, ".pmx") == 0 || path.compare(path.size() - 4, 4, ".PMX") == 0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <model.pmx|model.obj> ...\n", argv[0]);
+		return 1;
+	}
+
+	int result = 0;
+
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		const char* path = argv[arg];
+
+		if (IsPmx(path))
+		{
+			std::vector<SkinVertex> skin;
+			if (!LoadPmx(path, skin))
+			{
+				result = 1;
+				continue;
+			}
+
+			CompactSkinMesh mesh = VertexFormat::Compress(skin, true);
+			std::printf("%s: vertices=%zu bone index %s\n", path, skin.size(), mesh.boneIndex16 ? "16bit" : "8bit");
+			PrintReport("skinned", skin.size(), VertexFormat::Measure(skin, mesh));
+
+			// ボーンを使わずに描く場合と比べる
+			std::vector<StaticVertex> rigid(skin.size());
+			for (size_t idx = 0; idx < skin.size(); ++idx)
+			{
+				rigid[idx] = { skin[idx].pos, skin[idx].normal, skin[idx].uv };
+			}
+			MeasureStatic(rigid);
+		}
+		else
+		{
+			std::vector<StaticVertex> vertices;
+			if (!LoadObj(path, vertices))
+			{
+				result = 1;
+				continue;
+			}
+
+			std::printf("%s: vertices=%zu\n", path, vertices.size());
+			MeasureStatic(vertices);
+		}
+	}
+
+	return result;
+}